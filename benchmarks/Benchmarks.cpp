@@ -0,0 +1,29 @@
+/** Including all benchmarks */
+#include <benchmark/benchmark.h>
+
+#include "SphericalUtil/pairs.hpp"
+#include "SphericalUtil/paths.hpp"
+#include "SphericalUtil/offsets.hpp"
+#include "SphericalBatch/computeDistances.hpp"
+#include "EllipsoidalUtil/geodesics.hpp"
+
+#include "PolyUtil/containsLocation.hpp"
+#include "PolyUtil/containsLocationBatch.hpp"
+#include "PolyUtil/isLocationOnEdgeOrPath.hpp"
+#include "PolyUtil/distanceToLine.hpp"
+#include "PolyUtil/simplify.hpp"
+
+#include "EncodedPolyline/decode.hpp"
+#include "EncodedPolyline/encode.hpp"
+#include "GeometryDecoder/decode.hpp"
+#include "E7Path/computeLength.hpp"
+#include "PolygonIndex/find.hpp"
+#include "GeofenceRegistry/findAll.hpp"
+#include "PolygonStore/open.hpp"
+#include "PreparedPath/locationIndexOnEdgeOrPath.hpp"
+#include "PolygonRaster/containsLocation.hpp"
+#include "MeasuredPath/pointAtDistance.hpp"
+#include "VectorUtil/locationIndexOnPath.hpp"
+
+
+BENCHMARK_MAIN();
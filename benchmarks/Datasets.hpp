@@ -0,0 +1,107 @@
+#ifndef GEOMETRY_LIBRARY_BENCHMARK_DATASETS
+#define GEOMETRY_LIBRARY_BENCHMARK_DATASETS
+
+#include <benchmark/benchmark.h>
+#include <random>
+#include <vector>
+
+#include "MathUtil.hpp"
+#include "LatLng.hpp"
+
+
+/**
+ * Where a dataset lies; the benchmark argument named "region".
+ */
+enum DatasetRegion {
+    REGION_CITY         = 0,  // Around Moscow, a few tens of kilometers across
+    REGION_ANTIMERIDIAN = 1,  // Around (0, 180), the polygons crossing the antimeridian
+    REGION_POLAR        = 2,  // Around the North Pole, the polygons winding around it
+    REGION_GLOBAL       = 3,  // Points only: uniform over the sphere
+};
+
+/**
+ * Polygon sizes for the "vertices" argument: 10 to 10^6.
+ */
+static void datasetPolygonSizes(benchmark::internal::Benchmark* benchmark) {
+    benchmark->ArgNames({ "vertices", "region" });
+    for (int64_t size = 10; size <= 1000000; size *= 10) {
+        benchmark->Args({ size, REGION_CITY });
+    }
+    benchmark->Args({ 1000, REGION_ANTIMERIDIAN });
+    benchmark->Args({ 1000, REGION_POLAR });
+}
+
+/**
+ * Regions for the "region" argument of the point-to-point benchmarks.
+ */
+static void datasetPointRegions(benchmark::internal::Benchmark* benchmark) {
+    benchmark->ArgNames({ "region" });
+    for (int64_t region : { REGION_GLOBAL, REGION_CITY, REGION_ANTIMERIDIAN, REGION_POLAR }) {
+        benchmark->Arg(region);
+    }
+}
+
+/**
+ * A closed ring of the given number of vertices with a jittered radius, like a city
+ * boundary; the first vertex is not repeated.
+ */
+static std::vector<LatLng> datasetPolygon(size_t size, int64_t region) {
+    std::mt19937 random(static_cast<unsigned>(size * 4 + region));
+    std::uniform_real_distribution<double> unit(0, 1);
+    std::vector<LatLng> polygon;
+    polygon.reserve(size);
+    for (size_t i = 0; i < size; ++i) {
+        double angle = i * 2 * M_PI / size;
+        double jitter = 0.8 + 0.4 * unit(random);
+        if (region == REGION_POLAR) {
+            polygon.push_back(LatLng(80 + 5 * (jitter - 1), rad2deg(angle) - 180));
+        } else if (region == REGION_ANTIMERIDIAN) {
+            double r = 5 * jitter;
+            polygon.push_back(LatLng(r * sin(angle), MathUtil::wrap(180 + r * cos(angle), -180, 180)));
+        } else {
+            double r = 0.2 * jitter;
+            polygon.push_back(LatLng(55.75 + r * sin(angle), 37.61 + 1.7 * r * cos(angle)));
+        }
+    }
+    return polygon;
+}
+
+/**
+ * Points in and around the polygons of a region, or over the whole sphere.
+ */
+static std::vector<LatLng> datasetPoints(size_t size, int64_t region) {
+    std::mt19937 random(static_cast<unsigned>(1000 + region));
+    std::uniform_real_distribution<double> unit(0, 1);
+    std::vector<LatLng> points;
+    points.reserve(size);
+    for (size_t i = 0; i < size; ++i) {
+        if (region == REGION_GLOBAL) {
+            points.push_back(LatLng(rad2deg(asin(2 * unit(random) - 1)), unit(random) * 360 - 180));
+        } else if (region == REGION_POLAR) {
+            points.push_back(LatLng(70 + 20 * unit(random), unit(random) * 360 - 180));
+        } else if (region == REGION_ANTIMERIDIAN) {
+            points.push_back(LatLng(unit(random) * 14 - 7, MathUtil::wrap(173 + 14 * unit(random), -180, 180)));
+        } else {
+            points.push_back(LatLng(55.75 + (unit(random) - 0.5) * 0.6, 37.61 + (unit(random) - 0.5) * 1.0));
+        }
+    }
+    return points;
+}
+
+/**
+ * Runs function(point, polygon) on the polygon of the vertices and region arguments,
+ * over 1024 points in and around it.
+ */
+template <typename Function>
+static void runPolygonPoints(benchmark::State& state, Function function) {
+    std::vector<LatLng> polygon = datasetPolygon(static_cast<size_t>(state.range(0)), state.range(1));
+    std::vector<LatLng> points = datasetPoints(1024, state.range(1));
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(function(points[i++ & 1023], polygon));
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * polygon.size() * sizeof(LatLng)));
+}
+
+#endif // GEOMETRY_LIBRARY_BENCHMARK_DATASETS
@@ -0,0 +1,43 @@
+#include <benchmark/benchmark.h>
+#include <random>
+#include <vector>
+
+#include "SphericalUtil.hpp"
+#include "E7Path.hpp"
+
+
+/**
+ * A GPS-like track of the given size in E7 coordinates, steps of up to about 100 meters.
+ */
+static std::vector<E7LatLng> e7Track(size_t size) {
+    std::mt19937 random(1);
+    std::uniform_int_distribution<int32_t> step(-10000, 10000);
+    std::vector<E7LatLng> track;
+    E7LatLng point(557500000, 376100000);
+    for (size_t i = 0; i < size; ++i) {
+        point = E7LatLng(point.latE7 + step(random), point.lngE7 + step(random));
+        track.push_back(point);
+    }
+    return track;
+}
+
+static void BM_E7Path_computeLength_Vector(benchmark::State& state) {
+    std::vector<E7LatLng> track = e7Track(static_cast<size_t>(state.range(0)));
+    std::vector<LatLng> path(track.begin(), track.end());
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(SphericalUtil::computeLength(path));
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * path.size()));
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * path.size() * sizeof(LatLng)));
+}
+BENCHMARK(BM_E7Path_computeLength_Vector)->ArgName("vertices")->Arg(1 << 10)->Arg(1 << 22);
+
+static void BM_E7Path_computeLength_E7Path(benchmark::State& state) {
+    E7Path path(e7Track(static_cast<size_t>(state.range(0))));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(SphericalUtil::computeLength(path));
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * path.size()));
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * path.byteSize()));
+}
+BENCHMARK(BM_E7Path_computeLength_E7Path)->ArgName("vertices")->Arg(1 << 10)->Arg(1 << 22);
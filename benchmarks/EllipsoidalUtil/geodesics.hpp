@@ -0,0 +1,80 @@
+#include <benchmark/benchmark.h>
+#include <vector>
+
+#include "EllipsoidalUtil.hpp"
+#include "SphericalUtil.hpp"
+#include "../Datasets.hpp"
+
+
+/**
+ * Distances from one point to 1024 points of the region argument, pair by pair.
+ */
+static void BM_EllipsoidalUtil_computeDistanceBetween(benchmark::State& state) {
+    std::vector<LatLng> targets = datasetPoints(1024, state.range(0));
+    LatLng depot(55.75, 37.61);
+    for (auto _ : state) {
+        for (const auto & target : targets) {
+            benchmark::DoNotOptimize(EllipsoidalUtil::computeDistanceBetween(depot, target));
+        }
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * targets.size()));
+}
+BENCHMARK(BM_EllipsoidalUtil_computeDistanceBetween)->Apply(datasetPointRegions);
+
+/**
+ * Same as above from a cached EllipsoidalOrigin.
+ */
+static void BM_EllipsoidalOrigin_computeDistances(benchmark::State& state) {
+    std::vector<LatLng> targets = datasetPoints(1024, state.range(0));
+    std::vector<double> out(targets.size());
+    EllipsoidalOrigin<> origin(LatLng(55.75, 37.61));
+    for (auto _ : state) {
+        origin.computeDistances(targets, out.data());
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * targets.size()));
+}
+BENCHMARK(BM_EllipsoidalOrigin_computeDistances)->Apply(datasetPointRegions);
+
+/**
+ * 1024 points along one heading, each an offset of its own.
+ */
+static void BM_EllipsoidalUtil_computeOffset(benchmark::State& state) {
+    LatLng depot(55.75, 37.61);
+    for (auto _ : state) {
+        for (int i = 0; i < 1024; ++i) {
+            benchmark::DoNotOptimize(EllipsoidalUtil::computeOffset(depot, i * 10000.0, 30));
+        }
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * 1024));
+}
+BENCHMARK(BM_EllipsoidalUtil_computeOffset);
+
+/**
+ * Same as above along a cached EllipsoidalLine.
+ */
+static void BM_EllipsoidalLine_position(benchmark::State& state) {
+    EllipsoidalLine<> line(LatLng(55.75, 37.61), 30);
+    for (auto _ : state) {
+        for (int i = 0; i < 1024; ++i) {
+            benchmark::DoNotOptimize(line.position(i * 10000.0));
+        }
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * 1024));
+}
+BENCHMARK(BM_EllipsoidalLine_position);
+
+/**
+ * The sphere for comparison.
+ */
+static void BM_EllipsoidalUtil_SphericalBaseline(benchmark::State& state) {
+    std::vector<LatLng> targets = datasetPoints(1024, state.range(0));
+    LatLng depot(55.75, 37.61);
+    for (auto _ : state) {
+        for (const auto & target : targets) {
+            benchmark::DoNotOptimize(SphericalUtil::computeDistanceBetween(depot, target));
+        }
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * targets.size()));
+}
+BENCHMARK(BM_EllipsoidalUtil_SphericalBaseline)->Apply(datasetPointRegions);
@@ -0,0 +1,123 @@
+#include <benchmark/benchmark.h>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "PolyUtil.hpp"
+#include "SphericalUtil.hpp"
+#include "EncodedPolyline.hpp"
+
+
+/**
+ * A GPS-like track: steps of up to about a hundred meters, so most values take 2 to 4 bytes.
+ */
+static std::string encodedTrack(size_t size) {
+    std::mt19937 random(1);
+    std::uniform_real_distribution<double> step(-1e-3, 1e-3);
+    std::vector<LatLng> path;
+    LatLng point(55.75, 37.61);
+    for (size_t i = 0; i < size; ++i) {
+        point = LatLng(point.lat + step(random), point.lng + step(random));
+        path.push_back(point);
+    }
+    return PolyUtil::encode(path);
+}
+
+/**
+ * Byte-by-byte decoder, as in the Java original.
+ */
+static std::vector<LatLng> decodeBytewise(const std::string& encoded) {
+    std::vector<LatLng> path;
+    size_t index = 0;
+    int64_t lat = 0;
+    int64_t lng = 0;
+    while (index < encoded.size()) {
+        int64_t values[2];
+        for (auto& value : values) {
+            int64_t result = 1;
+            int shift = 0;
+            int b;
+            do {
+                b = encoded[index++] - 63 - 1;
+                result += static_cast<int64_t>(b) << shift;
+                shift += 5;
+            } while (b >= 0x1f);
+            value = (result & 1) != 0 ? ~(result >> 1) : (result >> 1);
+        }
+        lat += values[0];
+        lng += values[1];
+        path.push_back(LatLng(lat * 1e-5, lng * 1e-5));
+    }
+    return path;
+}
+
+static void BM_PolyUtil_decode_Bytewise(benchmark::State& state) {
+    std::string encoded = encodedTrack(static_cast<size_t>(state.range(0)));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(decodeBytewise(encoded));
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * encoded.size()));
+}
+BENCHMARK(BM_PolyUtil_decode_Bytewise)->Arg(1 << 10)->Arg(1 << 16);
+
+static void BM_PolyUtil_decode(benchmark::State& state) {
+    std::string encoded = encodedTrack(static_cast<size_t>(state.range(0)));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(PolyUtil::decode(encoded));
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * encoded.size()));
+}
+BENCHMARK(BM_PolyUtil_decode)->Arg(1 << 10)->Arg(1 << 16);
+
+static void BM_PolylineDecoder_read(benchmark::State& state) {
+    std::string encoded = encodedTrack(static_cast<size_t>(state.range(0)));
+    double lat[256];
+    double lng[256];
+    for (auto _ : state) {
+        PolylineDecoder decoder(encoded);
+        while (decoder.read(lat, lng, 256) != 0) {
+            benchmark::ClobberMemory();
+        }
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * encoded.size()));
+}
+BENCHMARK(BM_PolylineDecoder_read)->Arg(1 << 10)->Arg(1 << 16);
+
+static void BM_PolylineDecoder_readAll(benchmark::State& state) {
+    std::string encoded = encodedTrack(static_cast<size_t>(state.range(0)));
+    LatLngArray array;
+    for (auto _ : state) {
+        array.clear();
+        PolylineDecoder(encoded).readAll(array);
+        benchmark::DoNotOptimize(array.lat());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * encoded.size()));
+}
+BENCHMARK(BM_PolylineDecoder_readAll)->Arg(1 << 10)->Arg(1 << 16);
+
+static void BM_PolylineDecoder_count(benchmark::State& state) {
+    std::string encoded = encodedTrack(static_cast<size_t>(state.range(0)));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(PolylineDecoder::count(encoded.data(), encoded.size()));
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * encoded.size()));
+}
+BENCHMARK(BM_PolylineDecoder_count)->Arg(1 << 10)->Arg(1 << 16);
+
+static void BM_EncodedPolyline_computeLength(benchmark::State& state) {
+    std::string encoded = encodedTrack(static_cast<size_t>(state.range(0)));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(SphericalUtil::computeLength(EncodedPolyline(encoded)));
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * encoded.size()));
+}
+BENCHMARK(BM_EncodedPolyline_computeLength)->Arg(1 << 10)->Arg(1 << 16);
+
+static void BM_PolyUtil_decode_computeLength(benchmark::State& state) {
+    std::string encoded = encodedTrack(static_cast<size_t>(state.range(0)));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(SphericalUtil::computeLength(PolyUtil::decode(encoded)));
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * encoded.size()));
+}
+BENCHMARK(BM_PolyUtil_decode_computeLength)->Arg(1 << 10)->Arg(1 << 16);
@@ -0,0 +1,27 @@
+#include <benchmark/benchmark.h>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "PolyUtil.hpp"
+
+
+static void BM_PolyUtil_encode(benchmark::State& state) {
+    std::mt19937 random(2);
+    std::uniform_real_distribution<double> step(-1e-3, 1e-3);
+    std::vector<LatLng> path;
+    LatLng point(55.75, 37.61);
+    for (int64_t i = 0; i < state.range(0); ++i) {
+        point = LatLng(point.lat + step(random), point.lng + step(random));
+        path.push_back(point);
+    }
+
+    std::string out;
+    for (auto _ : state) {
+        out.clear();
+        PolyUtil::encode(path, out);
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * out.size()));
+}
+BENCHMARK(BM_PolyUtil_encode)->Arg(1 << 10)->Arg(1 << 16);
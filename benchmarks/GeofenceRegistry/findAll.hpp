@@ -0,0 +1,60 @@
+#include <benchmark/benchmark.h>
+#include <vector>
+
+#include "GeofenceRegistry.hpp"
+
+
+// randomZones() and randomPoints() come from PolygonIndex/find.hpp.
+static GeofenceRegistry& registryOfZones() {
+    static GeofenceRegistry registry;
+    static bool filled = [] {
+        std::vector<std::vector<LatLng> > zones = randomZones(10000);
+        GeofenceRegistry::Batch batch(registry);
+        for (size_t i = 0; i < zones.size(); ++i) {
+            batch.insert(i, zones[i]);
+        }
+        registry.apply(batch);
+        return true;
+    }();
+    (void) filled;
+    return registry;
+}
+
+/**
+ * findAll() of 10000 zones from every thread, against BM_PolygonIndex_findAll.
+ */
+static void BM_GeofenceRegistry_findAll(benchmark::State& state) {
+    GeofenceRegistry::Reader reader(registryOfZones());
+    std::vector<LatLng> points = randomPoints(1024);
+    std::vector<uint64_t> found;
+    size_t i = 0;
+    for (auto _ : state) {
+        found.clear();
+        reader.findAll(points[i++ & 1023], found);
+        benchmark::DoNotOptimize(found.data());
+        if ((i & 63) == 0) {
+            reader.quiescent();
+        }
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+BENCHMARK(BM_GeofenceRegistry_findAll)->ThreadRange(1, 8)->UseRealTime();
+
+/**
+ * Replacing one of the 10000 zones, and publishing the snapshot.
+ */
+static void BM_GeofenceRegistry_insert(benchmark::State& state) {
+    GeofenceRegistry registry;
+    std::vector<std::vector<LatLng> > zones = randomZones(10000);
+    GeofenceRegistry::Batch batch(registry);
+    for (size_t i = 0; i < zones.size(); ++i) {
+        batch.insert(i, zones[i]);
+    }
+    registry.apply(batch);
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(registry.insert(i % zones.size(), zones[i % zones.size()]));
+        ++i;
+    }
+}
+BENCHMARK(BM_GeofenceRegistry_insert)->Unit(benchmark::kMicrosecond);
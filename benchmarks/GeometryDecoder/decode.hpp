@@ -0,0 +1,237 @@
+#include <benchmark/benchmark.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "GeometryDecoder.hpp"
+#include "LatLngArray.hpp"
+
+
+/**
+ * Zone-like polygons with 8 to 24 vertices at 7 decimals, as a FeatureCollection and as
+ * concatenated little-endian WKB.
+ */
+static std::vector<std::vector<LatLng> > decoderZones(size_t size) {
+    std::mt19937 random(5);
+    std::uniform_real_distribution<double> unit(0, 1);
+    std::vector<std::vector<LatLng> > zones;
+    for (size_t zone = 0; zone < size; ++zone) {
+        double centerLat = unit(random) * 160 - 80;
+        double centerLng = unit(random) * 340 - 170;
+        size_t vertices = 8 + random() % 17;
+        std::vector<LatLng> polygon;
+        for (size_t i = 0; i <= vertices; ++i) {
+            double angle = (i % vertices) * 2 * M_PI / vertices;
+            polygon.push_back(LatLng(centerLat + 0.05 * std::sin(angle), centerLng + 0.05 * std::cos(angle)));
+        }
+        zones.push_back(polygon);
+    }
+    return zones;
+}
+
+static std::string decoderGeoJson(size_t size) {
+    std::string text = "{\"type\":\"FeatureCollection\",\"features\":[";
+    char number[32];
+    std::vector<std::vector<LatLng> > zones = decoderZones(size);
+    for (size_t zone = 0; zone < zones.size(); ++zone) {
+        text += zone == 0 ? "\n" : ",\n";
+        text += "{\"type\":\"Feature\",\"properties\":{\"id\":" + std::to_string(zone) + ",\"name\":\"zone " +
+                std::to_string(zone) + "\"},\"geometry\":{\"type\":\"Polygon\",\"coordinates\":[[";
+        for (size_t i = 0; i < zones[zone].size(); ++i) {
+            std::snprintf(number, sizeof(number), "%s[%.7f,%.7f]", i == 0 ? "" : ",", zones[zone][i].lng, zones[zone][i].lat);
+            text += number;
+        }
+        text += "]]}}";
+    }
+    return text + "\n]}";
+}
+
+static std::string decoderWkb(size_t size) {
+    std::string bytes;
+    auto put = [&bytes](const void* value, size_t length) {
+        bytes.append(static_cast<const char*>(value), length);
+    };
+    uint8_t order = 1;
+    uint32_t type = 3;
+    uint32_t rings = 1;
+    for (const auto& zone : decoderZones(size)) {
+        uint32_t count = static_cast<uint32_t>(zone.size());
+        put(&order, 1);
+        put(&type, 4);
+        put(&rings, 4);
+        put(&count, 4);
+        for (const LatLng& point : zone) {
+            put(&point.lng, 8);
+            put(&point.lat, 8);
+        }
+    }
+    return bytes;
+}
+
+/**
+ * The naive baseline: a JSON document tree, then the rings copied out of it.
+ */
+struct JsonValue {
+    enum Kind { NUL, BOOLEAN, NUMBER, STRING, ARRAY, OBJECT } kind = NUL;
+    double number = 0;
+    std::string string;
+    std::vector<JsonValue> items;
+    std::map<std::string, JsonValue> members;
+};
+
+static void jsonSpace(const char*& p) {
+    while (*p == ' ' || *p == '\n' || *p == '\r' || *p == '\t') {
+        ++p;
+    }
+}
+
+static JsonValue jsonParse(const char*& p) {
+    JsonValue value;
+    jsonSpace(p);
+    if (*p == '{' || *p == '[') {
+        bool object = *p++ == '{';
+        value.kind = object ? JsonValue::OBJECT : JsonValue::ARRAY;
+        jsonSpace(p);
+        while (*p != '}' && *p != ']') {
+            if (object) {
+                std::string key = jsonParse(p).string;
+                jsonSpace(p);
+                ++p;  // ':'
+                value.members[key] = jsonParse(p);
+            } else {
+                value.items.push_back(jsonParse(p));
+            }
+            jsonSpace(p);
+            p += *p == ',';
+            jsonSpace(p);
+        }
+        ++p;
+    } else if (*p == '"') {
+        value.kind = JsonValue::STRING;
+        for (++p; *p != '"'; ++p) {
+            p += *p == '\\';
+            value.string += *p;
+        }
+        ++p;
+    } else if (*p == 't' || *p == 'f' || *p == 'n') {
+        value.kind = *p == 'n' ? JsonValue::NUL : JsonValue::BOOLEAN;
+        p += *p == 'f' ? 5 : 4;
+    } else {
+        value.kind = JsonValue::NUMBER;
+        char* next;
+        value.number = std::strtod(p, &next);
+        p = next;
+    }
+    return value;
+}
+
+static void jsonRings(const JsonValue& value, std::vector<std::vector<LatLng> >& rings) {
+    for (const auto& member : value.members) {
+        if (member.first != "coordinates") {
+            jsonRings(member.second, rings);
+            continue;
+        }
+        for (const JsonValue& ring : member.second.items) {
+            rings.push_back(std::vector<LatLng>());
+            for (const JsonValue& position : ring.items) {
+                rings.back().push_back(LatLng(position.items[1].number, position.items[0].number));
+            }
+        }
+    }
+    for (const JsonValue& item : value.items) {
+        jsonRings(item, rings);
+    }
+}
+
+static void BM_GeoJson_decode_Dom(benchmark::State& state) {
+    std::string text = decoderGeoJson(static_cast<size_t>(state.range(0)));
+    for (auto _ : state) {
+        const char* p = text.c_str();
+        std::vector<std::vector<LatLng> > rings;
+        jsonRings(jsonParse(p), rings);
+        benchmark::DoNotOptimize(rings.data());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * text.size()));
+}
+BENCHMARK(BM_GeoJson_decode_Dom)->Arg(1000)->Arg(20000);
+
+static void BM_GeoJsonDecoder_decode(benchmark::State& state) {
+    std::string text = decoderGeoJson(static_cast<size_t>(state.range(0)));
+    LatLngArray array;
+    for (auto _ : state) {
+        array.clear();
+        GeometryCollector<LatLngArray> collector(array);
+        GeoJsonDecoder decoder(text);
+        while (decoder.decode(collector)) {}
+        benchmark::DoNotOptimize(array.lat());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * text.size()));
+}
+BENCHMARK(BM_GeoJsonDecoder_decode)->Arg(1000)->Arg(20000);
+
+/**
+ * The naive baseline: a tree of geometries read value by value, then the rings copied out of it.
+ */
+struct WkbGeometry {
+    uint32_t type;
+    std::vector<std::vector<LatLng> > rings;
+};
+
+static void BM_Wkb_decode_Dom(benchmark::State& state) {
+    std::string bytes = decoderWkb(static_cast<size_t>(state.range(0)));
+    for (auto _ : state) {
+        std::vector<WkbGeometry> geometries;
+        const char* p = bytes.data();
+        const char* end = p + bytes.size();
+        auto read = [&p](void* value, size_t length) {
+            std::memcpy(value, p, length);
+            p += length;
+        };
+        while (p != end) {
+            WkbGeometry geometry;
+            uint8_t order;
+            uint32_t rings;
+            read(&order, 1);
+            read(&geometry.type, 4);
+            read(&rings, 4);
+            for (uint32_t ring = 0; ring < rings; ++ring) {
+                uint32_t count;
+                read(&count, 4);
+                geometry.rings.push_back(std::vector<LatLng>());
+                for (uint32_t i = 0; i < count; ++i) {
+                    double x;
+                    double y;
+                    read(&x, 8);
+                    read(&y, 8);
+                    geometry.rings.back().push_back(LatLng(y, x));
+                }
+            }
+            geometries.push_back(geometry);
+        }
+        std::vector<std::vector<LatLng> > rings;
+        for (const WkbGeometry& geometry : geometries) {
+            rings.insert(rings.end(), geometry.rings.begin(), geometry.rings.end());
+        }
+        benchmark::DoNotOptimize(rings.data());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * bytes.size()));
+}
+BENCHMARK(BM_Wkb_decode_Dom)->Arg(1000)->Arg(20000);
+
+static void BM_WkbDecoder_decode(benchmark::State& state) {
+    std::string bytes = decoderWkb(static_cast<size_t>(state.range(0)));
+    LatLngArray array;
+    for (auto _ : state) {
+        array.clear();
+        GeometryCollector<LatLngArray> collector(array);
+        WkbDecoder decoder(bytes);
+        while (decoder.decode(collector)) {}
+        benchmark::DoNotOptimize(array.lat());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * bytes.size()));
+}
+BENCHMARK(BM_WkbDecoder_decode)->Arg(1000)->Arg(20000);
@@ -0,0 +1,70 @@
+#include <benchmark/benchmark.h>
+#include <vector>
+
+#include "MeasuredPath.hpp"
+#include "SphericalUtil.hpp"
+#include "../Datasets.hpp"
+
+
+/**
+ * The point at 1024 distances along the polygon of the vertices and region
+ * arguments, taken as a route: the loop over computeDistanceBetween() and
+ * interpolate(), then MeasuredPath.
+ */
+static void BM_MeasuredPath_WalkBaseline(benchmark::State& state) {
+    std::vector<LatLng> route = datasetPolygon(static_cast<size_t>(state.range(0)), state.range(1));
+    double length = SphericalUtil::computeLength(route);
+    size_t i = 0;
+    for (auto _ : state) {
+        double distance = length * static_cast<double>(i++ & 1023) / 1024;
+        LatLng point = route.back();
+        for (size_t j = 1; j < route.size(); ++j) {
+            double segment = SphericalUtil::computeDistanceBetween(route[j - 1], route[j]);
+            if (distance <= segment) {
+                point = SphericalUtil::interpolate(route[j - 1], route[j], distance / segment);
+                break;
+            }
+            distance -= segment;
+        }
+        benchmark::DoNotOptimize(point);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+BENCHMARK(BM_MeasuredPath_WalkBaseline)->ArgNames({ "vertices", "region" })->Args({ 100, REGION_CITY })->Args({ 10000, REGION_CITY });
+
+static void BM_MeasuredPath_pointAtDistance(benchmark::State& state) {
+    MeasuredPath path(datasetPolygon(static_cast<size_t>(state.range(0)), state.range(1)));
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(path.pointAtDistance(path.length() * static_cast<double>(i++ & 1023) / 1024));
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+BENCHMARK(BM_MeasuredPath_pointAtDistance)->ArgNames({ "vertices", "region" })->Args({ 100, REGION_CITY })->Args({ 10000, REGION_CITY })->Args({ 1000000, REGION_CITY });
+
+/**
+ * Resampling at the spacing giving about as many points as vertices.
+ */
+static void BM_MeasuredPath_resample(benchmark::State& state) {
+    MeasuredPath path(datasetPolygon(static_cast<size_t>(state.range(0)), state.range(1)));
+    double spacing = path.length() / static_cast<double>(path.size());
+    size_t count = 0;
+    for (auto _ : state) {
+        std::vector<LatLng> points = path.resample(spacing);
+        count = points.size();
+        benchmark::DoNotOptimize(points.data());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * count));
+}
+BENCHMARK(BM_MeasuredPath_resample)->ArgNames({ "vertices", "region" })->Args({ 10000, REGION_CITY });
+
+static void BM_MeasuredPath_measure(benchmark::State& state) {
+    MeasuredPath path(datasetPolygon(static_cast<size_t>(state.range(0)), state.range(1)));
+    std::vector<LatLng> points = datasetPoints(1024, state.range(1));
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(path.measure(points[i++ & 1023]));
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+BENCHMARK(BM_MeasuredPath_measure)->ArgNames({ "vertices", "region" })->Args({ 100, REGION_CITY })->Args({ 10000, REGION_CITY });
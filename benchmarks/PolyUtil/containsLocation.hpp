@@ -0,0 +1,41 @@
+#include <benchmark/benchmark.h>
+#include <vector>
+
+#include "LatLngBounds.hpp"
+#include "PolyUtil.hpp"
+#include "../Datasets.hpp"
+
+
+static void BM_PolyUtil_containsLocation_Geodesic(benchmark::State& state) {
+    runPolygonPoints(state, [](const LatLng& point, const std::vector<LatLng>& polygon) {
+        return PolyUtil::containsLocation(point, polygon, true);
+    });
+}
+BENCHMARK(BM_PolyUtil_containsLocation_Geodesic)->Apply(datasetPolygonSizes);
+
+static void BM_PolyUtil_containsLocation_Rhumb(benchmark::State& state) {
+    runPolygonPoints(state, [](const LatLng& point, const std::vector<LatLng>& polygon) {
+        return PolyUtil::containsLocation(point, polygon, false);
+    });
+}
+BENCHMARK(BM_PolyUtil_containsLocation_Rhumb)->Apply(datasetPolygonSizes);
+
+/**
+ * containsLocation() of points over the whole sphere, nearly all misses, with the
+ * polygon of the vertices argument plain (bounded 0) or Bounded (bounded 1).
+ */
+static void BM_PolyUtil_containsLocation_Misses(benchmark::State& state) {
+    std::vector<LatLng> polygon = datasetPolygon(static_cast<size_t>(state.range(0)), REGION_CITY);
+    Bounded<std::vector<LatLng> > bounded(polygon);
+    std::vector<LatLng> points = datasetPoints(1024, REGION_GLOBAL);
+    size_t i = 0;
+    for (auto _ : state) {
+        const LatLng& point = points[i++ & 1023];
+        benchmark::DoNotOptimize(state.range(1) ?
+            PolyUtil::containsLocation(point, bounded, true) :
+            PolyUtil::containsLocation(point, polygon, true));
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+BENCHMARK(BM_PolyUtil_containsLocation_Misses)->ArgNames({ "vertices", "bounded" })
+    ->Args({ 100, 0 })->Args({ 100, 1 })->Args({ 10000, 0 })->Args({ 10000, 1 });
@@ -0,0 +1,61 @@
+#include <benchmark/benchmark.h>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "PolyUtil.hpp"
+
+
+/**
+ * A city boundary-like polygon around Moscow with the given number of vertices.
+ */
+static std::vector<LatLng> cityBoundary(size_t size) {
+    std::mt19937 random(5);
+    std::uniform_real_distribution<double> unit(0, 1);
+    std::vector<LatLng> city;
+    for (size_t i = 0; i < size; ++i) {
+        double angle = i * 2 * M_PI / size;
+        double r = 0.2 * (0.8 + 0.4 * unit(random));
+        city.push_back(LatLng(55.75 + r * std::sin(angle), 37.61 + 1.7 * r * std::cos(angle)));
+    }
+    return city;
+}
+
+static std::vector<LatLng> cityPoints(size_t size) {
+    std::mt19937 random(6);
+    std::uniform_real_distribution<double> unit(0, 1);
+    std::vector<LatLng> points;
+    for (size_t i = 0; i < size; ++i) {
+        points.push_back(LatLng(55.75 + (unit(random) - 0.5) * 0.6, 37.61 + (unit(random) - 0.5) * 1.0));
+    }
+    return points;
+}
+
+static void BM_PolyUtil_containsLocation_Loop(benchmark::State& state) {
+    std::vector<LatLng> city = cityBoundary(static_cast<size_t>(state.range(0)));
+    std::vector<LatLng> points = cityPoints(100000);
+    std::unique_ptr<bool[]> out(new bool[points.size()]);
+    for (auto _ : state) {
+        for (size_t i = 0; i < points.size(); ++i) {
+            out[i] = PolyUtil::containsLocation(points[i], city, false);
+        }
+        benchmark::DoNotOptimize(out.get());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * points.size()));
+}
+BENCHMARK(BM_PolyUtil_containsLocation_Loop)->Arg(100)->Arg(1000)->Unit(benchmark::kMillisecond);
+
+static void BM_PolyUtil_containsLocationBatch(benchmark::State& state) {
+    std::vector<LatLng> city = cityBoundary(static_cast<size_t>(state.range(0)));
+    std::vector<LatLng> points = cityPoints(100000);
+    unsigned threads = static_cast<unsigned>(state.range(1));
+    std::unique_ptr<bool[]> out(new bool[points.size()]);
+    for (auto _ : state) {
+        PolyUtil::containsLocationBatch(points, city, out.get(), false, threads);
+        benchmark::DoNotOptimize(out.get());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * points.size()));
+}
+// Threads 0: one per hardware thread.
+BENCHMARK(BM_PolyUtil_containsLocationBatch)->Args({ 100, 1 })->Args({ 100, 0 })
+    ->Args({ 1000, 1 })->Args({ 1000, 0 })->Unit(benchmark::kMillisecond);
@@ -0,0 +1,18 @@
+#include <benchmark/benchmark.h>
+#include <vector>
+
+#include "PolyUtil.hpp"
+#include "../Datasets.hpp"
+
+
+static void BM_PolyUtil_distanceToLine(benchmark::State& state) {
+    std::vector<LatLng> points = datasetPoints(3072, state.range(0));
+    size_t i = 0;
+    for (auto _ : state) {
+        size_t j = i++ & 1023;
+        benchmark::DoNotOptimize(PolyUtil::distanceToLine(points[j], points[1024 + j], points[2048 + j]));
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * 3 * sizeof(LatLng)));
+}
+BENCHMARK(BM_PolyUtil_distanceToLine)->Apply(datasetPointRegions);
@@ -0,0 +1,57 @@
+#include <benchmark/benchmark.h>
+#include <vector>
+
+#include "PolyUtil.hpp"
+#include "../Datasets.hpp"
+
+
+// Most points are off the edge, so the whole polygon is scanned.
+
+static void BM_PolyUtil_isLocationOnEdge_Geodesic(benchmark::State& state) {
+    runPolygonPoints(state, [](const LatLng& point, const std::vector<LatLng>& polygon) {
+        return PolyUtil::isLocationOnEdge(point, polygon, 10, true);
+    });
+}
+BENCHMARK(BM_PolyUtil_isLocationOnEdge_Geodesic)->Apply(datasetPolygonSizes);
+
+static void BM_PolyUtil_isLocationOnEdge_Rhumb(benchmark::State& state) {
+    runPolygonPoints(state, [](const LatLng& point, const std::vector<LatLng>& polygon) {
+        return PolyUtil::isLocationOnEdge(point, polygon, 10, false);
+    });
+}
+BENCHMARK(BM_PolyUtil_isLocationOnEdge_Rhumb)->Apply(datasetPolygonSizes);
+
+static void BM_PolyUtil_isLocationOnPath(benchmark::State& state) {
+    runPolygonPoints(state, [](const LatLng& point, const std::vector<LatLng>& polyline) {
+        return PolyUtil::isLocationOnPath(point, polyline, 10);
+    });
+}
+BENCHMARK(BM_PolyUtil_isLocationOnPath)->Apply(datasetPolygonSizes);
+
+static void BM_PolyUtil_isLocationOnEdgeOrPath(benchmark::State& state) {
+    runPolygonPoints(state, [](const LatLng& point, const std::vector<LatLng>& polygon) {
+        return PolyUtil::isLocationOnEdgeOrPath(point, polygon, true, true, 10);
+    });
+}
+BENCHMARK(BM_PolyUtil_isLocationOnEdgeOrPath)->Apply(datasetPolygonSizes);
+
+static void BM_PolyUtil_locationIndexOnEdge(benchmark::State& state) {
+    runPolygonPoints(state, [](const LatLng& point, const std::vector<LatLng>& polygon) {
+        return PolyUtil::locationIndexOnEdge(point, polygon, 10);
+    });
+}
+BENCHMARK(BM_PolyUtil_locationIndexOnEdge)->Apply(datasetPolygonSizes);
+
+static void BM_PolyUtil_locationIndexOnEdgeOrPath_Geodesic(benchmark::State& state) {
+    runPolygonPoints(state, [](const LatLng& point, const std::vector<LatLng>& polyline) {
+        return PolyUtil::locationIndexOnEdgeOrPath(point, polyline, false, true, 10);
+    });
+}
+BENCHMARK(BM_PolyUtil_locationIndexOnEdgeOrPath_Geodesic)->Apply(datasetPolygonSizes);
+
+static void BM_PolyUtil_locationIndexOnEdgeOrPath_Rhumb(benchmark::State& state) {
+    runPolygonPoints(state, [](const LatLng& point, const std::vector<LatLng>& polyline) {
+        return PolyUtil::locationIndexOnEdgeOrPath(point, polyline, false, false, 10);
+    });
+}
+BENCHMARK(BM_PolyUtil_locationIndexOnEdgeOrPath_Rhumb)->Apply(datasetPolygonSizes);
@@ -0,0 +1,93 @@
+#include <benchmark/benchmark.h>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "PolyUtil.hpp"
+#include "SphericalUtil.hpp"
+
+
+/**
+ * A GPS-like track: a point every 10 meters, the heading drifting randomly.
+ */
+static std::vector<LatLng> gpsTrack(size_t size) {
+    std::mt19937 random(2);
+    std::normal_distribution<double> turn(0, 10);
+    std::vector<LatLng> track;
+    LatLng point(55.75, 37.61);
+    double heading = 0;
+    for (size_t i = 0; i < size; ++i) {
+        heading += turn(random);
+        point = SphericalUtil::computeOffset(point, 10, heading);
+        track.push_back(point);
+    }
+    return track;
+}
+
+/**
+ * Douglas-Peucker as in the Java original: distanceToLine() for every point.
+ */
+static std::vector<LatLng> simplifyNaive(const std::vector<LatLng>& poly, double tolerance) {
+    size_t n = poly.size();
+    std::vector<double> dists(n, 0);
+    dists[0] = 1;
+    dists[n - 1] = 1;
+    std::vector<std::pair<size_t, size_t> > stack(1, std::make_pair(size_t(0), n - 1));
+    while (!stack.empty()) {
+        std::pair<size_t, size_t> current = stack.back();
+        stack.pop_back();
+        double maxDist = 0;
+        size_t maxIdx = 0;
+        for (size_t idx = current.first + 1; idx < current.second; ++idx) {
+            double dist = PolyUtil::distanceToLine(poly[idx], poly[current.first], poly[current.second]);
+            if (dist > maxDist) {
+                maxDist = dist;
+                maxIdx = idx;
+            }
+        }
+        if (maxDist > tolerance) {
+            dists[maxIdx] = maxDist;
+            stack.push_back(std::make_pair(current.first, maxIdx));
+            stack.push_back(std::make_pair(maxIdx, current.second));
+        }
+    }
+    std::vector<LatLng> simplified;
+    for (size_t i = 0; i < n; ++i) {
+        if (dists[i] != 0) {
+            simplified.push_back(poly[i]);
+        }
+    }
+    return simplified;
+}
+
+static void BM_PolyUtil_simplify_Naive(benchmark::State& state) {
+    std::vector<LatLng> track = gpsTrack(static_cast<size_t>(state.range(0)));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(simplifyNaive(track, 5));
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * track.size()));
+}
+BENCHMARK(BM_PolyUtil_simplify_Naive)->Arg(100000)->Arg(1000000)->Unit(benchmark::kMillisecond);
+
+static void BM_PolyUtil_simplifyIndices(benchmark::State& state) {
+    std::vector<LatLng> track = gpsTrack(static_cast<size_t>(state.range(0)));
+    unsigned threads = static_cast<unsigned>(state.range(1));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(PolyUtil::simplifyIndices(track, 5, threads));
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * track.size()));
+}
+// Threads 0: one per hardware thread.
+BENCHMARK(BM_PolyUtil_simplifyIndices)->Args({ 100000, 1 })->Args({ 100000, 0 })
+    ->Args({ 1000000, 1 })->Args({ 1000000, 0 })->Unit(benchmark::kMillisecond);
+
+static void BM_PolyUtil_simplify(benchmark::State& state) {
+    std::vector<LatLng> track = gpsTrack(static_cast<size_t>(state.range(0)));
+    unsigned threads = static_cast<unsigned>(state.range(1));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(PolyUtil::simplify(track, 5, threads));
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * track.size()));
+}
+BENCHMARK(BM_PolyUtil_simplify)->Args({ 100000, 1 })->Args({ 100000, 0 })
+    ->Args({ 1000000, 1 })->Args({ 1000000, 0 })->Unit(benchmark::kMillisecond);
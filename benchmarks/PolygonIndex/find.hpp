@@ -0,0 +1,91 @@
+#include <benchmark/benchmark.h>
+#include <random>
+#include <vector>
+
+#include "PolyUtil.hpp"
+#include "PolygonIndex.hpp"
+
+
+/**
+ * Small delivery-zone-like polygons all over the globe, 8 to 24 vertices each.
+ */
+static std::vector<std::vector<LatLng> > randomZones(size_t size) {
+    std::mt19937 random(3);
+    std::uniform_real_distribution<double> unit(0, 1);
+    std::vector<std::vector<LatLng> > zones;
+    for (size_t zone = 0; zone < size; ++zone) {
+        double centerLat = unit(random) * 160 - 80;
+        double centerLng = unit(random) * 360 - 180;
+        size_t vertices = 8 + random() % 17;
+        std::vector<LatLng> polygon;
+        for (size_t i = 0; i < vertices; ++i) {
+            double angle = i * 2 * M_PI / vertices;
+            double r = 0.05 * (0.5 + unit(random));
+            polygon.push_back(LatLng(centerLat + r * std::sin(angle),
+                                     MathUtil::wrap(centerLng + r * std::cos(angle), -180, 180)));
+        }
+        zones.push_back(polygon);
+    }
+    return zones;
+}
+
+static std::vector<LatLng> randomPoints(size_t size) {
+    std::mt19937 random(4);
+    std::uniform_real_distribution<double> unit(0, 1);
+    std::vector<LatLng> points;
+    for (size_t i = 0; i < size; ++i) {
+        points.push_back(LatLng(unit(random) * 160 - 80, unit(random) * 360 - 180));
+    }
+    return points;
+}
+
+static void BM_PolygonIndex_findAny_Scan(benchmark::State& state) {
+    std::vector<std::vector<LatLng> > zones = randomZones(static_cast<size_t>(state.range(0)));
+    std::vector<LatLng> points = randomPoints(1024);
+    size_t i = 0;
+    for (auto _ : state) {
+        const LatLng& point = points[i++ % points.size()];
+        bool found = false;
+        for (const auto& zone : zones) {
+            if (PolyUtil::containsLocation(point, zone, false)) {
+                found = true;
+                break;
+            }
+        }
+        benchmark::DoNotOptimize(found);
+    }
+}
+BENCHMARK(BM_PolygonIndex_findAny_Scan)->Arg(10000)->Arg(200000)->Unit(benchmark::kMicrosecond);
+
+static void BM_PolygonIndex_findAny(benchmark::State& state) {
+    PolygonIndex index(randomZones(static_cast<size_t>(state.range(0))));
+    std::vector<LatLng> points = randomPoints(1024);
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(index.findAny(points[i++ % points.size()]));
+    }
+}
+BENCHMARK(BM_PolygonIndex_findAny)->Arg(10000)->Arg(200000)->Unit(benchmark::kMicrosecond);
+
+static void BM_PolygonIndex_findAll(benchmark::State& state) {
+    PolygonIndex index(randomZones(static_cast<size_t>(state.range(0))));
+    std::vector<LatLng> points = randomPoints(1024);
+    std::vector<size_t> found;
+    size_t i = 0;
+    for (auto _ : state) {
+        found.clear();
+        index.findAll(points[i++ % points.size()], found);
+        benchmark::DoNotOptimize(found.data());
+    }
+}
+BENCHMARK(BM_PolygonIndex_findAll)->Arg(10000)->Arg(200000)->Unit(benchmark::kMicrosecond);
+
+static void BM_PolygonIndex_build(benchmark::State& state) {
+    std::vector<std::vector<LatLng> > zones = randomZones(static_cast<size_t>(state.range(0)));
+    for (auto _ : state) {
+        PolygonIndex index(zones);
+        benchmark::DoNotOptimize(index.size());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * zones.size()));
+}
+BENCHMARK(BM_PolygonIndex_build)->Arg(200000)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,62 @@
+#include <benchmark/benchmark.h>
+#include <vector>
+
+#include "PolygonRaster.hpp"
+#include "PreparedPolygon.hpp"
+#include "../Datasets.hpp"
+
+
+/**
+ * containsLocation() of 1024 points in and around the polygon of the vertices and region
+ * arguments, rasterized once.
+ */
+static void BM_PolygonRaster_containsLocation(benchmark::State& state) {
+    std::vector<LatLng> polygon = datasetPolygon(static_cast<size_t>(state.range(0)), state.range(1));
+    std::vector<LatLng> points = datasetPoints(1024, state.range(1));
+    PolygonRaster raster(polygon, true);
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(raster.containsLocation(points[i++ & 1023]));
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+    state.counters["bytes"] = static_cast<double>(raster.memoryUsage());
+}
+BENCHMARK(BM_PolygonRaster_containsLocation)->Apply(datasetPolygonSizes);
+
+/**
+ * Same as above with a PreparedPolygon, for comparison.
+ */
+static void BM_PolygonRaster_PreparedBaseline(benchmark::State& state) {
+    std::vector<LatLng> polygon = datasetPolygon(static_cast<size_t>(state.range(0)), state.range(1));
+    std::vector<LatLng> points = datasetPoints(1024, state.range(1));
+    PreparedPolygon prepared(polygon, true);
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(prepared.containsLocation(points[i++ & 1023]));
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+BENCHMARK(BM_PolygonRaster_PreparedBaseline)->Apply(datasetPolygonSizes);
+
+/**
+ * Building the raster of the vertices argument, against reading it back serialized.
+ */
+static void BM_PolygonRaster_build(benchmark::State& state) {
+    std::vector<LatLng> polygon = datasetPolygon(static_cast<size_t>(state.range(0)), REGION_CITY);
+    for (auto _ : state) {
+        PolygonRaster raster(polygon, true);
+        benchmark::DoNotOptimize(raster.boundaryCells());
+    }
+}
+BENCHMARK(BM_PolygonRaster_build)->ArgName("vertices")->Arg(1000)->Arg(10000);
+
+static void BM_PolygonRaster_deserialize(benchmark::State& state) {
+    std::vector<LatLng> polygon = datasetPolygon(static_cast<size_t>(state.range(0)), REGION_CITY);
+    std::vector<uint8_t> bytes = PolygonRaster(polygon, true).serialize();
+    for (auto _ : state) {
+        PolygonRaster raster;
+        benchmark::DoNotOptimize(PolygonRaster::deserialize(bytes.data(), bytes.size(), &raster));
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * bytes.size()));
+}
+BENCHMARK(BM_PolygonRaster_deserialize)->ArgName("vertices")->Arg(1000)->Arg(10000);
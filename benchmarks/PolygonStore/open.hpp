@@ -0,0 +1,57 @@
+#include <benchmark/benchmark.h>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "PolygonStore.hpp"
+
+
+// randomZones() and randomPoints() come from PolygonIndex/find.hpp.
+static const std::string& storeOfZones() {
+    // The file of 200000 zones, removed at exit.
+    static struct File {
+        std::string path = "PolygonStore.benchmark.glps";
+        File() {
+            PolygonStore::Writer writer;
+            for (const auto& zone : randomZones(200000)) {
+                writer.addPolygon(zone);
+            }
+            writer.save(path);
+        }
+        ~File() {
+            std::remove(path.c_str());
+        }
+    } file;
+    return file.path;
+}
+
+/**
+ * Opening 200000 zones and answering a first query, against BM_PolygonIndex_build.
+ */
+static void BM_PolygonStore_open(benchmark::State& state) {
+    const std::string& path = storeOfZones();
+    LatLng point = randomPoints(1)[0];
+    for (auto _ : state) {
+        PolygonStore store;
+        store.open(path);
+        benchmark::DoNotOptimize(store.findAny(point));
+    }
+}
+BENCHMARK(BM_PolygonStore_open)->Unit(benchmark::kMicrosecond);
+
+/**
+ * findAll() of 200000 zones in the mapped file, against BM_PolygonIndex_findAll.
+ */
+static void BM_PolygonStore_findAll(benchmark::State& state) {
+    PolygonStore store;
+    store.open(storeOfZones());
+    std::vector<LatLng> points = randomPoints(1024);
+    std::vector<size_t> found;
+    size_t i = 0;
+    for (auto _ : state) {
+        found.clear();
+        store.findAll(points[i++ % points.size()], found);
+        benchmark::DoNotOptimize(found.data());
+    }
+}
+BENCHMARK(BM_PolygonStore_findAll)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,62 @@
+#include <benchmark/benchmark.h>
+#include <random>
+#include <vector>
+
+#include "PolyUtil.hpp"
+#include "PreparedPath.hpp"
+#include "SphericalUtil.hpp"
+
+
+/**
+ * A road-like route: a vertex every 20 to 120 meters, the heading drifting randomly.
+ */
+static std::vector<LatLng> randomRoute(size_t size) {
+    std::mt19937 random(7);
+    std::normal_distribution<double> turn(0, 15);
+    std::uniform_real_distribution<double> unit(0, 1);
+    std::vector<LatLng> route;
+    LatLng point(55.75, 37.61);
+    double heading = 0;
+    for (size_t i = 0; i < size; ++i) {
+        heading += turn(random);
+        point = SphericalUtil::computeOffset(point, 20 + 100 * unit(random), heading);
+        route.push_back(point);
+    }
+    return route;
+}
+
+/**
+ * Vehicle positions within 50 meters of the route, most of them off it.
+ */
+static std::vector<LatLng> routePositions(const std::vector<LatLng>& route, size_t size) {
+    std::mt19937 random(8);
+    std::uniform_real_distribution<double> unit(0, 1);
+    std::vector<LatLng> positions;
+    for (size_t i = 0; i < size; ++i) {
+        const LatLng& near = route[random() % route.size()];
+        positions.push_back(SphericalUtil::computeOffset(near, 50 * unit(random), 360 * unit(random)));
+    }
+    return positions;
+}
+
+static void BM_PolyUtil_locationIndexOnPath(benchmark::State& state) {
+    std::vector<LatLng> route = randomRoute(20000);
+    std::vector<LatLng> positions = routePositions(route, 1024);
+    bool geodesic = state.range(0) != 0;
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(PolyUtil::locationIndexOnPath(positions[i++ % positions.size()], route, 10, geodesic));
+    }
+}
+BENCHMARK(BM_PolyUtil_locationIndexOnPath)->Arg(1)->Arg(0)->Unit(benchmark::kMicrosecond);
+
+static void BM_PreparedPath_locationIndexOnEdgeOrPath(benchmark::State& state) {
+    std::vector<LatLng> route = randomRoute(20000);
+    std::vector<LatLng> positions = routePositions(route, 1024);
+    PreparedPath prepared(route, false, state.range(0) != 0, 10);
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(prepared.locationIndexOnEdgeOrPath(positions[i++ % positions.size()]));
+    }
+}
+BENCHMARK(BM_PreparedPath_locationIndexOnEdgeOrPath)->Arg(1)->Arg(0)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,33 @@
+#include <benchmark/benchmark.h>
+#include <vector>
+
+#include "SphericalBatch.hpp"
+#include "../Datasets.hpp"
+
+
+/**
+ * Distances from one point to the targets argument of points over the sphere, with
+ * the coordinates stored as T and the results written as T.
+ */
+template <typename T>
+static void runSphericalBatchDistances(benchmark::State& state) {
+    std::vector<LatLng> points = datasetPoints(static_cast<size_t>(state.range(0)), REGION_GLOBAL);
+    std::vector<LatLngT<T> > targets(points.begin(), points.end());
+    std::vector<T> out(targets.size());
+    for (auto _ : state) {
+        SphericalBatch::computeDistances(LatLng(55.75, 37.61), targets, out.data());
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * targets.size()));
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * targets.size() * (sizeof(LatLngT<T>) + sizeof(T))));
+}
+
+static void BM_SphericalBatch_computeDistances_Double(benchmark::State& state) {
+    runSphericalBatchDistances<double>(state);
+}
+BENCHMARK(BM_SphericalBatch_computeDistances_Double)->ArgName("targets")->Arg(1 << 10)->Arg(1 << 22);
+
+static void BM_SphericalBatch_computeDistances_Float(benchmark::State& state) {
+    runSphericalBatchDistances<float>(state);
+}
+BENCHMARK(BM_SphericalBatch_computeDistances_Float)->ArgName("targets")->Arg(1 << 10)->Arg(1 << 22);
@@ -0,0 +1,49 @@
+#include <benchmark/benchmark.h>
+#include <vector>
+
+#include "SphericalUtil.hpp"
+
+
+/**
+ * A geofence circle of the vertices argument: computeOffset() per heading, the
+ * computeOffsets() fan, and circlePolygon().
+ */
+static void BM_SphericalUtil_circleByComputeOffset(benchmark::State& state) {
+    size_t n = static_cast<size_t>(state.range(0));
+    std::vector<LatLng> circle(n, LatLng(0, 0));
+    LatLng center(55.75, 37.61);
+    for (auto _ : state) {
+        for (size_t i = 0; i < n; ++i) {
+            circle[i] = SphericalUtil::computeOffset(center, 10000, 360.0 * i / n);
+        }
+        benchmark::DoNotOptimize(circle.data());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * n));
+}
+BENCHMARK(BM_SphericalUtil_circleByComputeOffset)->ArgName("vertices")->Arg(360)->Arg(1 << 16);
+
+static void BM_SphericalUtil_computeOffsets(benchmark::State& state) {
+    size_t n = static_cast<size_t>(state.range(0));
+    std::vector<LatLng> circle(n, LatLng(0, 0));
+    std::vector<double> headings(n);
+    for (size_t i = 0; i < n; ++i) {
+        headings[i] = 360.0 * i / n;
+    }
+    for (auto _ : state) {
+        SphericalUtil::computeOffsets(LatLng(55.75, 37.61), 10000.0, headings, circle.data());
+        benchmark::DoNotOptimize(circle.data());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * n));
+}
+BENCHMARK(BM_SphericalUtil_computeOffsets)->ArgName("vertices")->Arg(360)->Arg(1 << 16);
+
+static void BM_SphericalUtil_circlePolygon(benchmark::State& state) {
+    size_t n = static_cast<size_t>(state.range(0));
+    std::vector<LatLng> circle(n, LatLng(0, 0));
+    for (auto _ : state) {
+        SphericalUtil::circlePolygon(LatLng(55.75, 37.61), 10000, n, circle.data());
+        benchmark::DoNotOptimize(circle.data());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * n));
+}
+BENCHMARK(BM_SphericalUtil_circlePolygon)->ArgName("vertices")->Arg(360)->Arg(1 << 16);
@@ -0,0 +1,72 @@
+#include <benchmark/benchmark.h>
+#include <random>
+#include <vector>
+
+#include "SphericalUtil.hpp"
+#include "../Datasets.hpp"
+
+
+/**
+ * Runs function(from, to, parameter) over 1024 point pairs of the region argument;
+ * parameter is a distance up to 1000 km, a heading or a fraction as the function needs.
+ */
+template <typename Function>
+static void runSphericalPairs(benchmark::State& state, Function function) {
+    std::vector<LatLng> from = datasetPoints(1024, state.range(0));
+    std::vector<LatLng> to = datasetPoints(2048, state.range(0));
+    std::mt19937 random(17);
+    std::uniform_real_distribution<double> unit(0, 1);
+    std::vector<double> parameters;
+    for (size_t i = 0; i < from.size(); ++i) {
+        parameters.push_back(unit(random));
+    }
+    size_t i = 0;
+    for (auto _ : state) {
+        size_t j = i++ & 1023;
+        benchmark::DoNotOptimize(function(from[j], to[1024 + j], parameters[j]));
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * 2 * sizeof(LatLng)));
+}
+
+static void BM_SphericalUtil_computeHeading(benchmark::State& state) {
+    runSphericalPairs(state, [](const LatLng& from, const LatLng& to, double) {
+        return SphericalUtil::computeHeading(from, to);
+    });
+}
+BENCHMARK(BM_SphericalUtil_computeHeading)->Apply(datasetPointRegions);
+
+static void BM_SphericalUtil_computeOffset(benchmark::State& state) {
+    runSphericalPairs(state, [](const LatLng& from, const LatLng&, double parameter) {
+        return SphericalUtil::computeOffset(from, parameter * 1e6, parameter * 360);
+    });
+}
+BENCHMARK(BM_SphericalUtil_computeOffset)->Apply(datasetPointRegions);
+
+static void BM_SphericalUtil_computeOffsetOrigin(benchmark::State& state) {
+    runSphericalPairs(state, [](const LatLng&, const LatLng& to, double parameter) {
+        return SphericalUtil::computeOffsetOrigin(to, parameter * 1e6, parameter * 360);
+    });
+}
+BENCHMARK(BM_SphericalUtil_computeOffsetOrigin)->Apply(datasetPointRegions);
+
+static void BM_SphericalUtil_interpolate(benchmark::State& state) {
+    runSphericalPairs(state, [](const LatLng& from, const LatLng& to, double parameter) {
+        return SphericalUtil::interpolate(from, to, parameter);
+    });
+}
+BENCHMARK(BM_SphericalUtil_interpolate)->Apply(datasetPointRegions);
+
+static void BM_SphericalUtil_computeAngleBetween(benchmark::State& state) {
+    runSphericalPairs(state, [](const LatLng& from, const LatLng& to, double) {
+        return SphericalUtil::computeAngleBetween(from, to);
+    });
+}
+BENCHMARK(BM_SphericalUtil_computeAngleBetween)->Apply(datasetPointRegions);
+
+static void BM_SphericalUtil_computeDistanceBetween(benchmark::State& state) {
+    runSphericalPairs(state, [](const LatLng& from, const LatLng& to, double) {
+        return SphericalUtil::computeDistanceBetween(from, to);
+    });
+}
+BENCHMARK(BM_SphericalUtil_computeDistanceBetween)->Apply(datasetPointRegions);
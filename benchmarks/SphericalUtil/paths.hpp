@@ -0,0 +1,61 @@
+#include <benchmark/benchmark.h>
+#include <vector>
+
+#include "SphericalUtil.hpp"
+#include "../Datasets.hpp"
+
+
+/**
+ * Runs function(polygon) on the polygon of the vertices and region arguments.
+ */
+template <typename Function>
+static void runSphericalPath(benchmark::State& state, Function function) {
+    std::vector<LatLng> polygon = datasetPolygon(static_cast<size_t>(state.range(0)), state.range(1));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(function(polygon));
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * polygon.size()));
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * polygon.size() * sizeof(LatLng)));
+}
+
+static void BM_SphericalUtil_computeLength(benchmark::State& state) {
+    runSphericalPath(state, [](const std::vector<LatLng>& path) {
+        return SphericalUtil::computeLength(path);
+    });
+}
+BENCHMARK(BM_SphericalUtil_computeLength)->Apply(datasetPolygonSizes);
+
+static void BM_SphericalUtil_computeArea(benchmark::State& state) {
+    runSphericalPath(state, [](const std::vector<LatLng>& path) {
+        return SphericalUtil::computeArea(path);
+    });
+}
+BENCHMARK(BM_SphericalUtil_computeArea)->Apply(datasetPolygonSizes);
+
+static void BM_SphericalUtil_computeSignedArea(benchmark::State& state) {
+    runSphericalPath(state, [](const std::vector<LatLng>& path) {
+        return SphericalUtil::computeSignedArea(path);
+    });
+}
+BENCHMARK(BM_SphericalUtil_computeSignedArea)->Apply(datasetPolygonSizes);
+
+static void BM_SphericalUtil_computeLengthParallel(benchmark::State& state) {
+    runSphericalPath(state, [](const std::vector<LatLng>& path) {
+        return SphericalUtil::computeLengthParallel(path);
+    });
+}
+BENCHMARK(BM_SphericalUtil_computeLengthParallel)->Apply(datasetPolygonSizes)->UseRealTime();
+
+static void BM_SphericalUtil_computeAreaParallel(benchmark::State& state) {
+    runSphericalPath(state, [](const std::vector<LatLng>& path) {
+        return SphericalUtil::computeAreaParallel(path);
+    });
+}
+BENCHMARK(BM_SphericalUtil_computeAreaParallel)->Apply(datasetPolygonSizes)->UseRealTime();
+
+static void BM_SphericalUtil_computeSignedAreaParallel(benchmark::State& state) {
+    runSphericalPath(state, [](const std::vector<LatLng>& path) {
+        return SphericalUtil::computeSignedAreaParallel(path);
+    });
+}
+BENCHMARK(BM_SphericalUtil_computeSignedAreaParallel)->Apply(datasetPolygonSizes)->UseRealTime();
@@ -0,0 +1,91 @@
+#include <benchmark/benchmark.h>
+#include <random>
+#include <vector>
+
+#include "PolyUtil.hpp"
+#include "SphericalUtil.hpp"
+#include "UnitVec3.hpp"
+#include "VectorUtil.hpp"
+
+
+/**
+ * A road-like route of 2000 vertices and positions within 50 meters of it.
+ */
+static void vectorUtilRoute(std::vector<LatLng>* route, std::vector<LatLng>* positions) {
+    std::mt19937 random(15);
+    std::normal_distribution<double> turn(0, 15);
+    std::uniform_real_distribution<double> unit(0, 1);
+    LatLng point(55.75, 37.61);
+    double heading = 0;
+    for (size_t i = 0; i < 2000; ++i) {
+        heading += turn(random);
+        point = SphericalUtil::computeOffset(point, 20 + 100 * unit(random), heading);
+        route->push_back(point);
+    }
+    for (size_t i = 0; i < 1024; ++i) {
+        const LatLng& near = (*route)[random() % route->size()];
+        positions->push_back(SphericalUtil::computeOffset(near, 50 * unit(random), 360 * unit(random)));
+    }
+}
+
+static void BM_PolyUtil_locationIndexOnPath_geodesic(benchmark::State& state) {
+    std::vector<LatLng> route;
+    std::vector<LatLng> positions;
+    vectorUtilRoute(&route, &positions);
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(PolyUtil::locationIndexOnPath(positions[i++ % positions.size()], route, 10));
+    }
+}
+BENCHMARK(BM_PolyUtil_locationIndexOnPath_geodesic)->Unit(benchmark::kMicrosecond);
+
+static void BM_VectorUtil_locationIndexOnPath(benchmark::State& state) {
+    std::vector<LatLng> route;
+    std::vector<LatLng> positions;
+    vectorUtilRoute(&route, &positions);
+    std::vector<UnitVec3> path;
+    for (const auto & point : route) {
+        path.push_back(UnitVec3(point));
+    }
+    std::vector<UnitVec3> vectors;
+    for (const auto & point : positions) {
+        vectors.push_back(UnitVec3(point));
+    }
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(VectorUtil::locationIndexOnPath(vectors[i++ % vectors.size()], path, 10));
+    }
+}
+BENCHMARK(BM_VectorUtil_locationIndexOnPath)->Unit(benchmark::kMicrosecond);
+
+static void BM_SphericalUtil_computeDistanceBetween_Route(benchmark::State& state) {
+    std::vector<LatLng> route;
+    std::vector<LatLng> positions;
+    vectorUtilRoute(&route, &positions);
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(SphericalUtil::computeDistanceBetween(route[i % route.size()], positions[i % positions.size()]));
+        ++i;
+    }
+}
+BENCHMARK(BM_SphericalUtil_computeDistanceBetween_Route);
+
+static void BM_VectorUtil_computeDistanceBetween(benchmark::State& state) {
+    std::vector<LatLng> route;
+    std::vector<LatLng> positions;
+    vectorUtilRoute(&route, &positions);
+    std::vector<UnitVec3> path;
+    for (const auto & point : route) {
+        path.push_back(UnitVec3(point));
+    }
+    std::vector<UnitVec3> vectors;
+    for (const auto & point : positions) {
+        vectors.push_back(UnitVec3(point));
+    }
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(VectorUtil::computeDistanceBetween(path[i % path.size()], vectors[i % vectors.size()]));
+        ++i;
+    }
+}
+BENCHMARK(BM_VectorUtil_computeDistanceBetween);
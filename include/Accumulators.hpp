@@ -0,0 +1,186 @@
+//******************************************************************************
+// Copyright 2013 Google Inc.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// This software and the related documents are provided  as is,  with no express
+// or implied  warranties,  other than  those that are  expressly stated  in the
+// License.
+//******************************************************************************
+
+
+#ifndef GEOMETRY_LIBRARY_ACCUMULATORS
+#define GEOMETRY_LIBRARY_ACCUMULATORS
+
+#include <deque>
+
+#include "MathUtil.hpp"
+#include "LatLng.hpp"
+#include "SphericalUtil.hpp"
+
+
+/**
+ * The length of a live track, updated in O(1) per point instead of calling
+ * SphericalUtil::computeLength() on the whole track after each one.
+ *
+ * Segments are summed with ChunkedSum in push order, as computeLength() sums
+ * them, so while no point has been popped length() is bit-identical to
+ * computeLength() of the same points. pop() removes the oldest point for a sliding
+ * window by subtracting its segment; the result then stays within a few units in the
+ * last place of computeLength() over the window.
+ */
+class LengthAccumulator {
+public:
+    /**
+     * Appends a point to the track.
+     */
+    inline void push(const LatLng& point) {
+        Vertex vertex = { deg2rad(point.lat), deg2rad(point.lng) };
+        if (!points.empty()) {
+            sum.add(LengthAccumulator::segment(points.back(), vertex));
+        }
+        points.push_back(vertex);
+    }
+
+    /**
+     * Removes the oldest point of the track, if any.
+     */
+    inline void pop() {
+        if (points.size() >= 2U) {
+            sum.add(-LengthAccumulator::segment(points[0], points[1]));
+        }
+        if (!points.empty()) {
+            points.pop_front();
+        }
+        if (points.size() < 2U) {
+            sum = ChunkedSum();
+        }
+    }
+
+    inline void clear() {
+        points.clear();
+        sum = ChunkedSum();
+    }
+
+    /**
+     * Returns the number of points in the track.
+     */
+    inline size_t size() const {
+        return points.size();
+    }
+
+    /**
+     * Returns the length of the track, in meters, on Earth.
+     */
+    inline double length() const {
+        return sum.value() * MathUtil::EARTH_RADIUS;
+    }
+
+
+private:
+    struct Vertex {
+        double lat;  // Radians
+        double lng;
+    };
+
+    std::deque<Vertex> points;
+    ChunkedSum sum;
+
+    static inline double segment(const Vertex& from, const Vertex& to) {
+        return SphericalUtil::distanceRadians(from.lat, from.lng, to.lat, to.lng);
+    }
+};
+
+
+/**
+ * The signed area of a live track taken as a closed path, updated in O(1) per point
+ * instead of calling SphericalUtil::computeSignedArea() on the whole track after
+ * each one; "inside" is the surface that does not contain the South Pole.
+ *
+ * The polar triangles of the open edges are summed with ChunkedSum in push order
+ * and the closing edge, from the newest point back to the oldest, is added when
+ * queried, as computeSignedArea() does: while no point has been popped signedArea()
+ * is bit-identical to computeSignedArea() of the same points. pop() removes the
+ * oldest point for a sliding window; the result then stays within a few units in the
+ * last place of computeSignedArea() over the window, relative to the largest sum of
+ * triangles seen.
+ */
+class AreaAccumulator {
+public:
+    /**
+     * Appends a point to the track.
+     */
+    inline void push(const LatLng& point) {
+        Vertex vertex = { SphericalUtil::polarTan<double>(deg2rad(point.lat)), deg2rad(point.lng) };
+        if (!points.empty()) {
+            sum.add(AreaAccumulator::triangle(points.back(), vertex));
+        }
+        points.push_back(vertex);
+    }
+
+    /**
+     * Removes the oldest point of the track, if any.
+     */
+    inline void pop() {
+        if (points.size() >= 2U) {
+            sum.add(-AreaAccumulator::triangle(points[0], points[1]));
+        }
+        if (!points.empty()) {
+            points.pop_front();
+        }
+        if (points.size() < 2U) {
+            sum = ChunkedSum();
+        }
+    }
+
+    inline void clear() {
+        points.clear();
+        sum = ChunkedSum();
+    }
+
+    /**
+     * Returns the number of points in the track.
+     */
+    inline size_t size() const {
+        return points.size();
+    }
+
+    /**
+     * Returns the signed area of the closed track, in square meters, on Earth; 0 for
+     * fewer than 3 points.
+     */
+    inline double signedArea() const {
+        if (points.size() < 3U) {
+            return 0;
+        }
+        ChunkedSum total = sum;
+        total.add(AreaAccumulator::triangle(points.back(), points.front()));
+        return total.value() * (MathUtil::EARTH_RADIUS * MathUtil::EARTH_RADIUS);
+    }
+
+    /**
+     * Returns the area of the closed track, in square meters, on Earth.
+     */
+    inline double area() const {
+        return std::fabs(signedArea());
+    }
+
+
+private:
+    struct Vertex {
+        double tanLat;  // tan((pi/2 - latitude)/2), see SphericalUtil::polarTriangleArea()
+        double lng;     // Radians
+    };
+
+    std::deque<Vertex> points;
+    ChunkedSum sum;
+
+    static inline double triangle(const Vertex& from, const Vertex& to) {
+        return SphericalUtil::polarTriangleArea(to.tanLat, to.lng, from.tanLat, from.lng);
+    }
+};
+
+#endif // GEOMETRY_LIBRARY_ACCUMULATORS
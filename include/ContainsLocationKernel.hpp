@@ -0,0 +1,61 @@
+//******************************************************************************
+// Copyright 2013 Google Inc.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// This software and the related documents are provided  as is,  with no express
+// or implied  warranties,  other than  those that are  expressly stated  in the
+// License.
+//******************************************************************************
+
+// No include guard: PolyUtil.hpp includes this file once per instruction set,
+// inside the matching "#pragma GCC target" region, with GEOMETRY_LIBRARY_SIMD_ISA
+// naming the primitive set from Simd.hpp.
+
+template <>
+struct ContainsLocationKernel<GEOMETRY_LIBRARY_SIMD_ISA> {
+    typedef GEOMETRY_LIBRARY_SIMD_ISA Isa;
+    typedef Isa::Double Double;
+    typedef Isa::Mask   Mask;
+
+    /**
+     * Prefilters the first n - n % Isa::LANES edges for the meridian from (lat3, lng3)
+     * to the South Pole, all in radians: appends to candidates the edges whose
+     * longitude span holds lng3, the only ones PolyUtil::intersects() may count.
+     *
+     * Returns how many edges were scanned. It stops early before a vector of edges
+     * holding one the scalar path must see: a vertex equal to the point, or an edge
+     * for which MathUtil::wrap() would change lng3 - lng1.
+     */
+    static inline size_t scan(double lat3, double lng3, const double* lat1, const double* lng1, const double* lng2,
+                              size_t n, uint32_t* candidates, size_t* count) {
+        Double vLat3 = Isa::broadcast(lat3);
+        Double vLng3 = Isa::broadcast(lng3);
+        size_t found = *count;
+        size_t i = 0;
+        for (; i + Isa::LANES <= n; i += Isa::LANES) {
+            Double dLng3 = vLng3 - Isa::load(lng1 + i);
+            Double dLng2 = Isa::load(lng2 + i);
+            Mask stop = ~((dLng3 >= -M_PI) & (dLng3 < M_PI)) | ((vLat3 == Isa::load(lat1 + i)) & (dLng3 == 0.0));
+            if (Isa::any(stop)) {
+                break;
+            }
+            // Not both ends on the same side of lng3.
+            Mask candidate = ~(((dLng3 >= 0.0) & (dLng3 >= dLng2)) | ((dLng3 < 0.0) & (dLng3 < dLng2)));
+            if (Isa::any(candidate)) {
+                int64_t lanes[Isa::LANES];
+                std::memcpy(lanes, &candidate, sizeof(lanes));
+                for (size_t j = 0; j < Isa::LANES; ++j) {
+                    if (lanes[j] != 0) {
+                        candidates[found++] = static_cast<uint32_t>(i + j);
+                    }
+                }
+            }
+        }
+        *count = found;
+        return i;
+    }
+};
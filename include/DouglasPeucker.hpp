@@ -0,0 +1,269 @@
+//******************************************************************************
+// Copyright 2013 Google Inc.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// This software and the related documents are provided  as is,  with no express
+// or implied  warranties,  other than  those that are  expressly stated  in the
+// License.
+//******************************************************************************
+
+#ifndef GEOMETRY_LIBRARY_DOUGLAS_PEUCKER
+#define GEOMETRY_LIBRARY_DOUGLAS_PEUCKER
+
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "MathUtil.hpp"
+#include "LatLng.hpp"
+
+
+/**
+ * Douglas-Peucker decimation of a path, the engine of PolyUtil::simplify().
+ *
+ * The constructor copies the points once with their radians and cos(lat). Ranges
+ * are split on an explicit stack; the distance of a point to a range is the one
+ * of PolyUtil::distanceToLine(), compared as haversine, so the asin() is only taken
+ * for the farthest point of every range.
+ *
+ * The two halves of a split range are independent, so long ranges are handed to
+ * other threads. The kept points do not depend on the order the ranges are split
+ * in, hence neither on the number of threads.
+ */
+class DouglasPeucker {
+public:
+    // Paths with fewer points are simplified on the calling thread.
+    static constexpr size_t PARALLEL_MIN_POINTS = 1 << 14;
+
+    // Ranges with fewer points are not handed to other threads.
+    static constexpr size_t PARALLEL_GRAIN = 1 << 11;
+
+    // Degrees the last point of a closed polygon is moved by, as in android-maps-utils.
+    static constexpr double CLOSED_POLYGON_OFFSET = 0.00000000001;
+
+    template <typename LatLngList>
+    explicit DouglasPeucker(const LatLngList& path) {
+        points.reserve(path.size());
+        for (const auto& point : path) {
+            Point copy;
+            copy.lat = point.lat;
+            copy.lng = point.lng;
+            copy.latRad = latRadians(point);
+            copy.lngRad = lngRadians(point);
+            copy.cosLat = cos(copy.latRad);
+            points.push_back(copy);
+        }
+        // As in android-maps-utils, the last point of a closed polygon is moved off
+        // the first one, so that the first range has a segment to measure against.
+        // The kept indices still select the original points.
+        size_t size = points.size();
+        if (size > 2 && LatLng(points[0].lat, points[0].lng) == LatLng(points[size - 1].lat, points[size - 1].lng)) {
+            Point& last = points[size - 1];
+            last.lat += CLOSED_POLYGON_OFFSET;
+            last.lng += CLOSED_POLYGON_OFFSET;
+            last.latRad = deg2rad(last.lat);
+            last.lngRad = deg2rad(last.lng);
+            last.cosLat = cos(last.latRad);
+        }
+    }
+
+    /**
+     * Returns the indices of the points kept for the given tolerance in meters, in
+     * increasing order. The first and the last point are always kept. A tolerance
+     * of zero or below is rejected with an empty result, where android-maps-utils
+     * throws.
+     *
+     * @param threads the number of threads to use, 0 for one per hardware thread
+     */
+    inline std::vector<size_t> simplify(double tolerance, unsigned threads = 0) const {
+        size_t size = points.size();
+        if (!(tolerance > 0)) {
+            return std::vector<size_t>();
+        }
+        std::vector<char> keep(size, 0);
+        if (size != 0) {
+            keep[0] = 1;
+            keep[size - 1] = 1;
+        }
+        if (size > 2) {
+            if (threads == 0) {
+                threads = std::max(std::thread::hardware_concurrency(), 1U);
+            }
+            Range all = { 0, size - 1 };
+            if (threads == 1 || size < PARALLEL_MIN_POINTS) {
+                split(all, tolerance, keep, nullptr);
+            } else {
+                splitParallel(all, tolerance, keep, threads);
+            }
+        }
+
+        std::vector<size_t> kept;
+        for (size_t i = 0; i < size; ++i) {
+            if (keep[i] != 0) {
+                kept.push_back(i);
+            }
+        }
+        return kept;
+    }
+
+
+private:
+    struct Point {
+        double lat;     // Degrees
+        double lng;
+        double latRad;  // Radians
+        double lngRad;
+        double cosLat;  // cos(latRad)
+    };
+
+    /**
+     * The segment of a range, with the values shared by all points of the range.
+     */
+    struct Segment {
+        const Point& start;
+        const Point& end;
+        bool   degenerate;  // start == end
+        double s2s1lat;
+        double s2s1lng;
+        double length2;
+
+        Segment(const Point& start, const Point& end)
+            : start(start), end(end),
+              degenerate(LatLng(start.lat, start.lng) == LatLng(end.lat, end.lng)),
+              s2s1lat(end.latRad - start.latRad),
+              s2s1lng(end.lngRad - start.lngRad),
+              length2(s2s1lat * s2s1lat + s2s1lng * s2s1lng) {}
+
+        /**
+         * Returns the haversine of PolyUtil::distanceToLine(p, start, end) over the
+         * earth radius, with the operations in the same order.
+         */
+        inline double havDistance(const Point& p) const {
+            if (degenerate) {
+                return DouglasPeucker::havDistance(end, p);
+            }
+            double u = ((p.latRad - start.latRad) * s2s1lat + (p.lngRad - start.lngRad) * s2s1lng) / length2;
+            if (u <= 0) {
+                return DouglasPeucker::havDistance(p, start);
+            }
+            if (u >= 1) {
+                return DouglasPeucker::havDistance(p, end);
+            }
+            double suLat = deg2rad(start.lat + u * (end.lat - start.lat));
+            double suLng = deg2rad(start.lng + u * (end.lng - start.lng));
+            return MathUtil::hav(p.latRad - suLat) + MathUtil::hav(p.lngRad - suLng) * p.cosLat * cos(suLat);
+        }
+    };
+
+    struct Range {
+        size_t first;
+        size_t last;
+    };
+
+    /**
+     * Ranges waiting for a thread, shared by the workers of splitParallel().
+     */
+    struct Queue {
+        std::mutex mutex;
+        std::condition_variable changed;
+        std::vector<Range> ranges;
+        unsigned busy;  // Workers splitting a range, which may queue more
+    };
+
+    std::vector<Point> points;
+
+    /**
+     * Splits range and its halves until no point is farther than tolerance from its
+     * range, marking the split points in keep. With a queue, long halves go there.
+     */
+    inline void split(Range range, double tolerance, std::vector<char>& keep, Queue* queue) const {
+        std::vector<Range> stack(1, range);
+        while (!stack.empty()) {
+            Range current = stack.back();
+            stack.pop_back();
+
+            Segment segment(points[current.first], points[current.last]);
+            size_t farthest = current.first + 1;
+            double maxHav = -1;
+            for (size_t i = current.first + 1; i < current.last; ++i) {
+                double hav = segment.havDistance(points[i]);
+                if (hav > maxHav) {
+                    maxHav = hav;
+                    farthest = i;
+                }
+            }
+            if (MathUtil::arcHav(std::max(maxHav, 0.0)) * MathUtil::EARTH_RADIUS <= tolerance) {
+                continue;
+            }
+            keep[farthest] = 1;
+
+            Range halves[2] = { { current.first, farthest }, { farthest, current.last } };
+            for (const Range& half : halves) {
+                if (half.last - half.first < 2) {
+                    continue;
+                }
+                if (queue != nullptr && half.last - half.first >= PARALLEL_GRAIN) {
+                    std::lock_guard<std::mutex> lock(queue->mutex);
+                    queue->ranges.push_back(half);
+                    queue->changed.notify_one();
+                } else {
+                    stack.push_back(half);
+                }
+            }
+        }
+    }
+
+    inline void splitParallel(Range range, double tolerance, std::vector<char>& keep, unsigned threads) const {
+        Queue queue;
+        queue.ranges.push_back(range);
+        queue.busy = 0;
+
+        // Different ranges never mark the same point, so keep needs no lock.
+        auto worker = [this, tolerance, &keep, &queue]() {
+            std::unique_lock<std::mutex> lock(queue.mutex);
+            for (;;) {
+                queue.changed.wait(lock, [&queue]() {
+                    return !queue.ranges.empty() || queue.busy == 0;
+                });
+                if (queue.ranges.empty()) {
+                    return;
+                }
+                Range next = queue.ranges.back();
+                queue.ranges.pop_back();
+                ++queue.busy;
+                lock.unlock();
+
+                split(next, tolerance, keep, &queue);
+
+                lock.lock();
+                if (--queue.busy == 0 && queue.ranges.empty()) {
+                    queue.changed.notify_all();
+                }
+            }
+        };
+
+        std::vector<std::thread> workers;
+        for (unsigned i = 1; i < threads; ++i) {
+            workers.emplace_back(worker);
+        }
+        worker();
+        for (auto& thread : workers) {
+            thread.join();
+        }
+    }
+
+    /**
+     * MathUtil::havDistance() of two points, using their cached cos(lat).
+     */
+    static inline double havDistance(const Point& from, const Point& to) {
+        return MathUtil::hav(from.latRad - to.latRad) + MathUtil::hav(from.lngRad - to.lngRad) * from.cosLat * to.cosLat;
+    }
+};
+
+#endif // GEOMETRY_LIBRARY_DOUGLAS_PEUCKER
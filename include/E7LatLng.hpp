@@ -0,0 +1,81 @@
+//******************************************************************************
+// Copyright 2013 Google Inc.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// This software and the related documents are provided  as is,  with no express
+// or implied  warranties,  other than  those that are  expressly stated  in the
+// License.
+//******************************************************************************
+
+#ifndef GEOMETRY_LIBRARY_E7_LATLNG
+#define GEOMETRY_LIBRARY_E7_LATLNG
+
+#include <cmath>
+#include <cstdint>
+
+#include "MathUtil.hpp"
+#include "LatLng.hpp"
+
+
+/**
+ * A location in fixed point: int32 degrees times 1e7, about a centimeter, at 8 bytes
+ * per point.
+ *
+ * The degrees are latE7 / 1e7, correctly rounded, so they equal the double parsed
+ * from the same decimal coordinate, e.g. E7LatLng(557512345, 376123456) and
+ * LatLng(55.7512345, 37.6123456). The path templates read the vertices through
+ * latRadians() and lngRadians(); a point converted to LatLng meets a vertex with the
+ * same coordinates exactly, as the vertex test of containsLocation() needs.
+ *
+ * The coordinates are not named lat and lng: a template reading point.lat directly
+ * does not compile rather than take the integers for degrees.
+ */
+class E7LatLng {
+public:
+    int32_t latE7; // The latitude  of this location, in 1e-7 degrees
+    int32_t lngE7; // The longitude of this location, in 1e-7 degrees
+
+    E7LatLng(int32_t latE7, int32_t lngE7)
+        : latE7(latE7), lngE7(lngE7) {}
+
+    /**
+     * Converts a location, rounding to the nearest 1e-7 degrees.
+     */
+    explicit E7LatLng(const LatLng& point)
+        : latE7(static_cast<int32_t>(std::lround(point.lat * 1e7))),
+          lngE7(static_cast<int32_t>(std::lround(point.lng * 1e7))) {}
+
+    E7LatLng(const E7LatLng & point) = default;
+
+    E7LatLng& operator=(const E7LatLng & other) = default;
+
+    inline double latDegrees() const {
+        return latE7 / 1e7;
+    }
+
+    inline double lngDegrees() const {
+        return lngE7 / 1e7;
+    }
+
+    inline operator LatLng() const {
+        return LatLng(latDegrees(), lngDegrees());
+    }
+
+    bool operator==(const E7LatLng & other) const {
+        return latE7 == other.latE7 && lngE7 == other.lngE7;
+    }
+
+    friend inline double latRadians(const E7LatLng& point) {
+        return deg2rad(point.latDegrees());
+    }
+
+    friend inline double lngRadians(const E7LatLng& point) {
+        return deg2rad(point.lngDegrees());
+    }
+};
+
+#endif // GEOMETRY_LIBRARY_E7_LATLNG
@@ -0,0 +1,198 @@
+//******************************************************************************
+// Copyright 2013 Google Inc.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// This software and the related documents are provided  as is,  with no express
+// or implied  warranties,  other than  those that are  expressly stated  in the
+// License.
+//******************************************************************************
+
+#ifndef GEOMETRY_LIBRARY_E7_PATH
+#define GEOMETRY_LIBRARY_E7_PATH
+
+#include <cstdint>
+#include <iterator>
+#include <vector>
+
+#include "LatLng.hpp"
+#include "E7LatLng.hpp"
+
+
+/**
+ * A compressed LatLngList of E7LatLng points: every point is the pair of latitude and
+ * longitude deltas from the previous one, zigzag encoded and written as a varint, 7
+ * bits per byte with the high bit set on all bytes but the last. A GPS track with
+ * steps of up to a kilometer takes 2 or 3 bytes per coordinate, about 4 times less
+ * than std::vector<LatLng>.
+ *
+ * Iterating decodes on the fly, so SphericalUtil::computeLength(), computeSignedArea(),
+ * PolyUtil::containsLocation() and isLocationOnPath() run over the path without
+ * decompressing it. operator[] is constant time for the first and the last point,
+ * the ones those templates index, and linear in the index otherwise.
+ */
+class E7Path {
+public:
+    class const_iterator {
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef E7LatLng  value_type;
+        typedef ptrdiff_t difference_type;
+        typedef const E7LatLng* pointer;
+        typedef const E7LatLng& reference;
+
+        const_iterator(const uint8_t* position, const uint8_t* end)
+            : position(position), end(end), point(0, 0), atEnd(position == end) {
+            ++*this;
+        }
+
+        inline const E7LatLng& operator*() const { return point; }
+        inline const E7LatLng* operator->() const { return &point; }
+
+        inline const_iterator& operator++() {
+            atEnd = position == end;
+            if (!atEnd) {
+                // Sums wrap in uint32_t like the deltas were taken.
+                point.latE7 = static_cast<int32_t>(static_cast<uint32_t>(point.latE7) + E7Path::unzigzag(E7Path::read(&position)));
+                point.lngE7 = static_cast<int32_t>(static_cast<uint32_t>(point.lngE7) + E7Path::unzigzag(E7Path::read(&position)));
+            }
+            return *this;
+        }
+
+        inline const_iterator operator++(int) {
+            const_iterator copy = *this;
+            ++*this;
+            return copy;
+        }
+
+        inline bool operator==(const const_iterator& other) const {
+            return atEnd == other.atEnd && (atEnd || position == other.position);
+        }
+
+        inline bool operator!=(const const_iterator& other) const {
+            return !(*this == other);
+        }
+
+    private:
+        const uint8_t* position;  // Past the current point
+        const uint8_t* end;
+        E7LatLng point;
+        bool atEnd;
+    };
+
+    typedef const_iterator iterator;
+    typedef E7LatLng value_type;
+
+    E7Path() : points(0), first(0, 0), last(0, 0) {}
+
+    /**
+     * Compresses the given points, LatLng rounded to 1e-7 degrees or E7LatLng.
+     */
+    template <typename LatLngList>
+    explicit E7Path(const LatLngList& path)
+        : E7Path() {
+        for (const auto& point : path) {
+            push_back(E7LatLng(point));
+        }
+    }
+
+    inline void push_back(const E7LatLng& point) {
+        E7LatLng previous = points == 0 ? E7LatLng(0, 0) : last;
+        E7Path::write(E7Path::zigzag(static_cast<uint32_t>(point.latE7) - static_cast<uint32_t>(previous.latE7)));
+        E7Path::write(E7Path::zigzag(static_cast<uint32_t>(point.lngE7) - static_cast<uint32_t>(previous.lngE7)));
+        if (points == 0) {
+            first = point;
+        }
+        last = point;
+        ++points;
+    }
+
+    inline const_iterator begin() const {
+        return const_iterator(bytes.data(), bytes.data() + bytes.size());
+    }
+
+    inline const_iterator end() const {
+        return const_iterator(bytes.data() + bytes.size(), bytes.data() + bytes.size());
+    }
+
+    inline size_t size() const {
+        return points;
+    }
+
+    inline bool empty() const {
+        return points == 0;
+    }
+
+    /**
+     * Returns the number of bytes of the compressed points.
+     */
+    inline size_t byteSize() const {
+        return bytes.size();
+    }
+
+    inline void reserveBytes(size_t capacity) {
+        bytes.reserve(capacity);
+    }
+
+    inline void clear() {
+        bytes.clear();
+        points = 0;
+    }
+
+    /**
+     * Returns point i; decodes points 0 to i unless i is the first or the last.
+     */
+    inline E7LatLng operator[](size_t i) const {
+        if (i == 0) {
+            return first;
+        }
+        if (i + 1 == points) {
+            return last;
+        }
+        const_iterator it = begin();
+        for (size_t j = 0; j < i; ++j) {
+            ++it;
+        }
+        return *it;
+    }
+
+
+private:
+    std::vector<uint8_t> bytes;
+    size_t points;
+    E7LatLng first;
+    E7LatLng last;
+
+    // The deltas are taken modulo 2^32, so the zigzag of any pair of points fits in 32
+    // bits; a varint takes at most 5 bytes.
+    static inline uint32_t zigzag(uint32_t delta) {
+        return (delta << 1) ^ static_cast<uint32_t>(-static_cast<int32_t>(delta >> 31));
+    }
+
+    static inline uint32_t unzigzag(uint32_t value) {
+        return (value >> 1) ^ static_cast<uint32_t>(-static_cast<int32_t>(value & 1));
+    }
+
+    inline void write(uint32_t value) {
+        while (value >= 0x80) {
+            bytes.push_back(static_cast<uint8_t>(value | 0x80));
+            value >>= 7;
+        }
+        bytes.push_back(static_cast<uint8_t>(value));
+    }
+
+    static inline uint32_t read(const uint8_t** position) {
+        const uint8_t* p = *position;
+        uint32_t value = *p & 0x7F;
+        for (unsigned shift = 7; (*p++ & 0x80) != 0; shift += 7) {
+            value |= static_cast<uint32_t>(*p & 0x7F) << shift;
+        }
+        *position = p;
+        return value;
+    }
+};
+
+#endif // GEOMETRY_LIBRARY_E7_PATH
@@ -0,0 +1,953 @@
+//******************************************************************************
+// Copyright 2013 Google Inc.
+// Geodesic algorithms after GeographicLib, Copyright (c) Charles Karney
+// (2011-2022), MIT/X11 License, https://geographiclib.sourceforge.io/ ; see
+// C. F. F. Karney, Algorithms for geodesics, J. Geodesy 87, 43-55 (2013).
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// This software and the related documents are provided  as is,  with no express
+// or implied  warranties,  other than  those that are  expressly stated  in the
+// License.
+//******************************************************************************
+
+#ifndef GEOMETRY_LIBRARY_ELLIPSOIDAL_UTIL
+#define GEOMETRY_LIBRARY_ELLIPSOIDAL_UTIL
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstddef>
+
+#include "MathUtil.hpp"
+#include "LatLng.hpp"
+#include "Policies.hpp"
+
+
+template <typename Ellipsoid>
+class EllipsoidalLine;
+
+template <typename Ellipsoid>
+class EllipsoidalOrigin;
+
+class EllipsoidalUtil;
+
+
+/**
+ * The geodesic solver behind EllipsoidalUtil, EllipsoidalOrigin and EllipsoidalLine:
+ * Karney's series to the sixth order in the flattening, accurate to about 15 nm.
+ * The coefficients depending on the ellipsoid only are computed once, on first use.
+ */
+template <typename Ellipsoid>
+class EllipsoidalSolver {
+private:
+    template <typename> friend class EllipsoidalLine;
+    template <typename> friend class EllipsoidalOrigin;
+    friend class EllipsoidalUtil;
+
+    static_assert(Ellipsoid::FLATTENING >= 0 && Ellipsoid::FLATTENING <= 0.01,
+                  "The series are accurate for oblate ellipsoids with a flattening of at most 1/100");
+
+    static constexpr int ORDER = 6;
+    static constexpr int MAX_IT1 = 20;
+    static constexpr int MAX_IT2 = MAX_IT1 + DBL_MANT_DIG + 10;
+
+    /**
+     * A point, with the sine and cosine of its reduced latitude.
+     */
+    struct Endpoint {
+        double lat;   // Latitude, degrees, tiny values rounded to 0
+        double lng;   // Longitude, degrees
+        double sbet;  // sin(reduced latitude)
+        double cbet;  // cos(reduced latitude), at least TINY at the poles
+
+        explicit Endpoint(const LatLng& point) {
+            const EllipsoidalSolver& g = EllipsoidalSolver::get();
+            lat = EllipsoidalSolver::angRound(std::fabs(point.lat) > 90 ? NAN : point.lat);
+            lng = point.lng;
+            EllipsoidalSolver::sincosd(lat, sbet, cbet);
+            sbet *= g.f1;
+            EllipsoidalSolver::norm(sbet, cbet);
+            cbet = std::max(TINY, cbet);
+        }
+    };
+
+    static constexpr double TINY = 1.4916681462400413e-154;  // sqrt(DBL_MIN)
+    static constexpr double TOL0 = DBL_EPSILON;
+    static constexpr double TOL1 = 200 * TOL0;
+    static constexpr double TOL2 = 1.4901161193847656e-08;   // sqrt(DBL_EPSILON)
+    static constexpr double XTHRESH = 1000 * TOL2;
+
+    double a;      // Equatorial radius
+    double f;      // Flattening
+    double f1;     // 1 - f
+    double ep2;    // Second eccentricity squared
+    double n;      // Third flattening
+    double b;      // Polar semi-axis
+    double etol2;  // The arc under which a line is solved on the auxiliary sphere
+    double A3x[ORDER];
+    double C3x[ORDER * (ORDER - 1) / 2];
+
+    static inline const EllipsoidalSolver& get() {
+        static const EllipsoidalSolver solver;
+        return solver;
+    }
+
+    EllipsoidalSolver()
+        : a(Ellipsoid::EQUATORIAL_RADIUS), f(Ellipsoid::FLATTENING) {
+        f1 = 1 - f;
+        double e2 = f * (2 - f);
+        ep2 = e2 / (f1 * f1);
+        n = f / (2 - f);
+        b = a * f1;
+        etol2 = 0.1 * TOL2 / std::sqrt(std::max(0.001, f) * std::min(1.0, 1 - f / 2) / 2);
+
+        static const double A3[] = {
+            -3, 128,
+            -2, -3, 64,
+            -1, -3, -1, 16,
+            3, -1, -2, 8,
+            1, -1, 2,
+            1, 1,
+        };
+        int o = 0;
+        int k = 0;
+        for (int j = ORDER - 1; j >= 0; --j) {
+            int m = std::min(ORDER - j - 1, j);
+            A3x[k++] = polyval(m, A3 + o, n) / A3[o + m + 1];
+            o += m + 2;
+        }
+
+        static const double C3[] = {
+            3, 128,
+            2, 5, 128,
+            -1, 3, 3, 64,
+            -1, 0, 1, 8,
+            -1, 1, 4,
+            5, 256,
+            1, 3, 128,
+            -3, -2, 3, 64,
+            1, -3, 2, 32,
+            7, 512,
+            -10, 9, 384,
+            5, -9, 5, 192,
+            7, 512,
+            -14, 7, 512,
+            21, 2560,
+        };
+        o = 0;
+        k = 0;
+        for (int l = 1; l < ORDER; ++l) {
+            for (int j = ORDER - 1; j >= l; --j) {
+                int m = std::min(ORDER - j - 1, j);
+                C3x[k++] = polyval(m, C3 + o, n) / C3[o + m + 1];
+                o += m + 2;
+            }
+        }
+    }
+
+    /**
+     * Solves the inverse problem: the distance in meters, and the sines and cosines
+     * of the azimuths at both ends.
+     */
+    inline double inverse(const Endpoint& from, const Endpoint& to,
+                          double& salp1, double& calp1, double& salp2, double& calp2) const {
+        double lng12s;
+        double lng12 = angDiff(from.lng, to.lng, lng12s);
+        // Make the longitude difference positive.
+        double lngSign = std::copysign(1.0, lng12);
+        lng12 *= lngSign;
+        lng12s *= lngSign;
+        double lam12 = deg2rad(lng12);
+        double slam12;
+        double clam12;
+        sincosde(lng12, lng12s, slam12, clam12);
+        lng12s = (180 - lng12) - lng12s;
+
+        // Swap the points so that the one with the higher (abs) latitude is point 1,
+        // and make its latitude negative.
+        bool swap = std::fabs(from.lat) < std::fabs(to.lat) || std::isnan(to.lat);
+        const Endpoint& p1 = swap ? to : from;
+        const Endpoint& p2 = swap ? from : to;
+        if (swap) {
+            lngSign = -lngSign;
+        }
+        double latSign = std::copysign(1.0, -p1.lat);
+        double sbet1 = p1.sbet * latSign;
+        double cbet1 = p1.cbet;
+        double sbet2 = p2.sbet * latSign;
+        double cbet2 = p2.cbet;
+
+        // Force bet2 = +/-bet1 when they nearly are.
+        if (cbet1 < -sbet1) {
+            if (cbet2 == cbet1) {
+                sbet2 = std::copysign(sbet1, sbet2);
+            }
+        } else if (std::fabs(sbet2) == -sbet1) {
+            cbet2 = cbet1;
+        }
+        double dn1 = std::sqrt(1 + ep2 * sbet1 * sbet1);
+        double dn2 = std::sqrt(1 + ep2 * sbet2 * sbet2);
+
+        double C1a[ORDER + 1];
+        double C2a[ORDER + 1];
+        double C3a[ORDER];
+        double s12x = 0;
+        double sig12;
+        bool meridian = p1.lat * latSign == -90 || slam12 == 0;
+
+        if (meridian) {
+            // The ends lie on a single full meridian; the geodesic might run along it.
+            calp1 = clam12;
+            salp1 = slam12;
+            calp2 = 1;
+            salp2 = 0;
+            double ssig1 = sbet1;
+            double csig1 = calp1 * cbet1;
+            double ssig2 = sbet2;
+            double csig2 = calp2 * cbet2;
+            sig12 = std::atan2(std::max(0.0, csig1 * ssig2 - ssig1 * csig2) + 0.0, csig1 * csig2 + ssig1 * ssig2);
+            double m12x;
+            double m0;
+            lengths(n, sig12, ssig1, csig1, dn1, ssig2, csig2, dn2, true, C1a, C2a, s12x, m12x, m0);
+            // Past half a meridian the meridian is not the shortest path.
+            if (sig12 < TOL2 || m12x >= 0) {
+                if (sig12 < 3 * TINY || (sig12 < TOL0 && (s12x < 0 || m12x < 0))) {
+                    s12x = 0;
+                }
+                s12x *= b;
+            } else {
+                meridian = false;
+            }
+        }
+
+        if (!meridian && sbet1 == 0 && lng12s >= f * 180) {
+            // Along the equator.
+            calp1 = calp2 = 0;
+            salp1 = salp2 = 1;
+            s12x = a * lam12;
+        } else if (!meridian) {
+            double dnm;
+            sig12 = inverseStart(sbet1, cbet1, sbet2, cbet2, lam12, slam12, clam12,
+                                 salp1, calp1, salp2, calp2, dnm);
+            if (sig12 >= 0) {
+                // Short lines, solved on the auxiliary sphere.
+                s12x = sig12 * b * dnm;
+            } else {
+                // Newton's method on alp1, keeping a bracket [alp1a, alp1b] of the root.
+                double ssig1 = 0;
+                double csig1 = 0;
+                double ssig2 = 0;
+                double csig2 = 0;
+                double eps = 0;
+                int numit = 0;
+                bool tripn = false;
+                bool tripb = false;
+                double salp1a = TINY;
+                double calp1a = 1;
+                double salp1b = TINY;
+                double calp1b = -1;
+                for (;;) {
+                    double dv;
+                    double v = lambda12(sbet1, cbet1, dn1, sbet2, cbet2, dn2, salp1, calp1, slam12, clam12,
+                                        numit < MAX_IT1, salp2, calp2, sig12, ssig1, csig1, ssig2, csig2, eps, dv,
+                                        C1a, C2a, C3a);
+                    if (tripb || !(std::fabs(v) >= (tripn ? 8 : 1) * TOL0) || numit == MAX_IT2) {
+                        break;
+                    }
+                    if (v > 0 && (numit > MAX_IT1 || calp1 / salp1 > calp1b / salp1b)) {
+                        salp1b = salp1;
+                        calp1b = calp1;
+                    } else if (v < 0 && (numit > MAX_IT1 || calp1 / salp1 < calp1a / salp1a)) {
+                        salp1a = salp1;
+                        calp1a = calp1;
+                    }
+                    ++numit;
+                    if (numit < MAX_IT1 && dv > 0) {
+                        double dalp1 = -v / dv;
+                        if (std::fabs(dalp1) < M_PI) {
+                            double sdalp1 = std::sin(dalp1);
+                            double cdalp1 = std::cos(dalp1);
+                            double nsalp1 = salp1 * cdalp1 + calp1 * sdalp1;
+                            if (nsalp1 > 0) {
+                                calp1 = calp1 * cdalp1 - salp1 * sdalp1;
+                                salp1 = nsalp1;
+                                norm(salp1, calp1);
+                                tripn = std::fabs(v) <= 16 * TOL0;
+                                continue;
+                            }
+                        }
+                    }
+                    // The step left (0, pi) or the slope was not positive: bisect.
+                    salp1 = (salp1a + salp1b) / 2;
+                    calp1 = (calp1a + calp1b) / 2;
+                    norm(salp1, calp1);
+                    tripn = false;
+                    tripb = std::fabs(salp1a - salp1) + (calp1a - calp1) < TOL0 ||
+                            std::fabs(salp1 - salp1b) + (calp1 - calp1b) < TOL0;
+                }
+                double m12x;
+                double m0;
+                lengths(eps, sig12, ssig1, csig1, dn1, ssig2, csig2, dn2, false, C1a, C2a, s12x, m12x, m0);
+                s12x *= b;
+            }
+        }
+
+        if (swap) {
+            std::swap(salp1, salp2);
+            std::swap(calp1, calp2);
+        }
+        double swapSign = swap ? -1 : 1;
+        salp1 *= swapSign * lngSign;
+        calp1 *= swapSign * latSign;
+        salp2 *= swapSign * lngSign;
+        calp2 *= swapSign * latSign;
+        return s12x + 0.0;
+    }
+
+    /**
+     * The distance s12b and reduced length m12b, both divided by b, and the secular
+     * coefficient m0 of the reduced length; the reduced length only if reduced.
+     */
+    static inline void lengths(double eps, double sig12, double ssig1, double csig1, double dn1,
+                               double ssig2, double csig2, double dn2, bool reduced,
+                               double* C1a, double* C2a, double& s12b, double& m12b, double& m0) {
+        double A1 = A1m1f(eps);
+        C1f(eps, C1a);
+        double B1 = sinCosSeries(true, ssig2, csig2, C1a, ORDER + 1) - sinCosSeries(true, ssig1, csig1, C1a, ORDER + 1);
+        s12b = (1 + A1) * (sig12 + B1);
+        if (reduced) {
+            double A2 = A2m1f(eps);
+            C2f(eps, C2a);
+            m0 = A1 - A2;
+            double B2 = sinCosSeries(true, ssig2, csig2, C2a, ORDER + 1) - sinCosSeries(true, ssig1, csig1, C2a, ORDER + 1);
+            double J12 = m0 * sig12 + ((1 + A1) * B1 - (1 + A2) * B2);
+            m12b = dn2 * (csig1 * ssig2) - dn1 * (ssig1 * csig2) - csig1 * csig2 * J12;
+        }
+    }
+
+    /**
+     * Returns sig12 of a short line solved on the auxiliary sphere, with salp2,
+     * calp2 and dnm set; otherwise -1, with the starting salp1, calp1 for Newton's
+     * method.
+     */
+    inline double inverseStart(double sbet1, double cbet1, double sbet2, double cbet2,
+                               double lam12, double slam12, double clam12,
+                               double& salp1, double& calp1, double& salp2, double& calp2, double& dnm) const {
+        double sig12 = -1;
+        double sbet12 = sbet2 * cbet1 - cbet2 * sbet1;
+        double cbet12 = cbet2 * cbet1 + sbet2 * sbet1;
+        double sbet12a = sbet2 * cbet1;
+        sbet12a += cbet2 * sbet1;
+
+        bool shortline = cbet12 >= 0 && sbet12 < 0.5 && cbet2 * lam12 < 0.5;
+        double somg12;
+        double comg12;
+        if (shortline) {
+            double sbetm2 = (sbet1 + sbet2) * (sbet1 + sbet2);
+            sbetm2 /= sbetm2 + (cbet1 + cbet2) * (cbet1 + cbet2);
+            dnm = std::sqrt(1 + ep2 * sbetm2);
+            double omg12 = lam12 / (f1 * dnm);
+            somg12 = std::sin(omg12);
+            comg12 = std::cos(omg12);
+        } else {
+            somg12 = slam12;
+            comg12 = clam12;
+        }
+
+        salp1 = cbet2 * somg12;
+        calp1 = comg12 >= 0 ?
+            sbet12 + cbet2 * sbet1 * somg12 * somg12 / (1 + comg12) :
+            sbet12a - cbet2 * sbet1 * somg12 * somg12 / (1 - comg12);
+
+        double ssig12 = std::hypot(salp1, calp1);
+        double csig12 = sbet1 * sbet2 + cbet1 * cbet2 * comg12;
+
+        if (shortline && ssig12 < etol2) {
+            salp2 = cbet1 * somg12;
+            calp2 = sbet12 - cbet1 * sbet2 * (comg12 >= 0 ? somg12 * somg12 / (1 + comg12) : 1 - comg12);
+            norm(salp2, calp2);
+            sig12 = std::atan2(ssig12, csig12);
+        } else if (std::fabs(n) >= 0.1 || csig12 >= 0 || ssig12 >= 6 * std::fabs(n) * M_PI * cbet1 * cbet1) {
+            // The spherical approximation is good enough to start from.
+        } else {
+            // Nearly antipodal: scale to the coordinates where the antipode is at the
+            // origin and the singular point at y = 0, x = -1, and solve the astroid.
+            double lam12x = std::atan2(-slam12, -clam12);
+            double k2 = sbet1 * sbet1 * ep2;
+            double eps = k2 / (2 * (1 + std::sqrt(1 + k2)) + k2);
+            double lamScale = f * cbet1 * A3f(eps) * M_PI;
+            double betScale = lamScale * cbet1;
+            double x = lam12x / lamScale;
+            double y = sbet12a / betScale;
+            if (y > -TOL1 && x > -1 - XTHRESH) {
+                salp1 = std::min(1.0, -x);
+                calp1 = -std::sqrt(1 - salp1 * salp1);
+            } else {
+                double k = astroid(x, y);
+                double omg12a = lamScale * (-x * k / (1 + k));
+                somg12 = std::sin(omg12a);
+                comg12 = -std::cos(omg12a);
+                salp1 = cbet2 * somg12;
+                calp1 = sbet12a - cbet2 * sbet1 * somg12 * somg12 / (1 - comg12);
+            }
+        }
+        // The backwards test lets NaN through.
+        if (!(salp1 <= 0)) {
+            norm(salp1, calp1);
+        } else {
+            salp1 = 1;
+            calp1 = 0;
+        }
+        return sig12;
+    }
+
+    /**
+     * Returns lam12 - lam120 for the geodesic leaving point 1 at alp1, with the values
+     * at point 2 and, if diffp, the derivative dlam12 with respect to alp1.
+     */
+    inline double lambda12(double sbet1, double cbet1, double dn1, double sbet2, double cbet2, double dn2,
+                           double salp1, double calp1, double slam120, double clam120, bool diffp,
+                           double& salp2, double& calp2, double& sig12, double& ssig1, double& csig1,
+                           double& ssig2, double& csig2, double& eps, double& dlam12,
+                           double* C1a, double* C2a, double* C3a) const {
+        if (sbet1 == 0 && calp1 == 0) {
+            // Break the degeneracy of the equatorial line.
+            calp1 = -TINY;
+        }
+        double salp0 = salp1 * cbet1;
+        double calp0 = std::hypot(calp1, salp1 * sbet1);
+
+        ssig1 = sbet1;
+        double somg1 = salp0 * sbet1;
+        csig1 = calp1 * cbet1;
+        double comg1 = csig1;
+        norm(ssig1, csig1);
+
+        salp2 = cbet2 != cbet1 ? salp0 / cbet2 : salp1;
+        calp2 = cbet2 != cbet1 || std::fabs(sbet2) != -sbet1 ?
+            std::sqrt(calp1 * cbet1 * calp1 * cbet1 +
+                      (cbet1 < -sbet1 ? (cbet2 - cbet1) * (cbet1 + cbet2) : (sbet1 - sbet2) * (sbet1 + sbet2))) / cbet2 :
+            std::fabs(calp1);
+        ssig2 = sbet2;
+        double somg2 = salp0 * sbet2;
+        csig2 = calp2 * cbet2;
+        double comg2 = csig2;
+        norm(ssig2, csig2);
+
+        sig12 = std::atan2(std::max(0.0, csig1 * ssig2 - ssig1 * csig2) + 0.0, csig1 * csig2 + ssig1 * ssig2);
+        double somg12 = std::max(0.0, comg1 * somg2 - somg1 * comg2) + 0.0;
+        double comg12 = comg1 * comg2 + somg1 * somg2;
+        double eta = std::atan2(somg12 * clam120 - comg12 * slam120, comg12 * clam120 + somg12 * slam120);
+
+        double k2 = calp0 * calp0 * ep2;
+        eps = k2 / (2 * (1 + std::sqrt(1 + k2)) + k2);
+        C3f(eps, C3a);
+        double B312 = sinCosSeries(true, ssig2, csig2, C3a, ORDER) - sinCosSeries(true, ssig1, csig1, C3a, ORDER);
+        double lam12 = eta - f * A3f(eps) * salp0 * (sig12 + B312);
+
+        if (diffp) {
+            if (calp2 == 0) {
+                dlam12 = -2 * f1 * dn1 / sbet1;
+            } else {
+                double s12b;
+                double m0;
+                lengths(eps, sig12, ssig1, csig1, dn1, ssig2, csig2, dn2, true, C1a, C2a, s12b, dlam12, m0);
+                dlam12 *= f1 / (calp2 * cbet2);
+            }
+        } else {
+            dlam12 = NAN;
+        }
+        return lam12;
+    }
+
+    inline double A3f(double eps) const {
+        return polyval(ORDER - 1, A3x, eps);
+    }
+
+    /**
+     * Sets c[1] to c[ORDER - 1].
+     */
+    inline void C3f(double eps, double* c) const {
+        double mult = 1;
+        int o = 0;
+        for (int l = 1; l < ORDER; ++l) {
+            int m = ORDER - l - 1;
+            mult *= eps;
+            c[l] = mult * polyval(m, C3x + o, eps);
+            o += m + 1;
+        }
+    }
+
+    static inline double A1m1f(double eps) {
+        static const double coeff[] = { 1, 4, 64, 0, 256 };
+        double t = polyval(ORDER / 2, coeff, eps * eps) / coeff[ORDER / 2 + 1];
+        return (t + eps) / (1 - eps);
+    }
+
+    static inline double A2m1f(double eps) {
+        static const double coeff[] = { -11, -28, -192, 0, 256 };
+        double t = polyval(ORDER / 2, coeff, eps * eps) / coeff[ORDER / 2 + 1];
+        return (t - eps) / (1 + eps);
+    }
+
+    static inline void C1f(double eps, double* c) {
+        static const double coeff[] = {
+            -1, 6, -16, 32,
+            -9, 64, -128, 2048,
+            9, -16, 768,
+            3, -5, 512,
+            -7, 1280,
+            -7, 2048,
+        };
+        series(coeff, eps, c);
+    }
+
+    static inline void C1pf(double eps, double* c) {
+        static const double coeff[] = {
+            205, -432, 768, 1536,
+            4005, -4736, 3840, 12288,
+            -225, 116, 384,
+            -7173, 2695, 7680,
+            3467, 7680,
+            38081, 61440,
+        };
+        series(coeff, eps, c);
+    }
+
+    static inline void C2f(double eps, double* c) {
+        static const double coeff[] = {
+            1, 2, 16, 32,
+            35, 64, 384, 2048,
+            15, 80, 768,
+            7, 35, 512,
+            63, 1280,
+            77, 2048,
+        };
+        series(coeff, eps, c);
+    }
+
+    /**
+     * Sets c[1] to c[ORDER] to the series of the given coefficients, c[l] a polynomial
+     * in eps^2 times eps^l.
+     */
+    static inline void series(const double* coeff, double eps, double* c) {
+        double eps2 = eps * eps;
+        double d = eps;
+        int o = 0;
+        for (int l = 1; l <= ORDER; ++l) {
+            int m = (ORDER - l) / 2;
+            c[l] = d * polyval(m, coeff + o, eps2) / coeff[o + m + 1];
+            o += m + 2;
+            d *= eps;
+        }
+    }
+
+    /**
+     * Evaluates sum(c[i] * sin(2 * i * x), i = 1 .. size - 1) if sinp, and
+     * sum(c[i] * cos((2 * i + 1) * x), i = 0 .. size - 1) otherwise, by Clenshaw
+     * summation.
+     */
+    static inline double sinCosSeries(bool sinp, double sinx, double cosx, const double* c, int size) {
+        int k = size;
+        int count = size - (sinp ? 1 : 0);
+        double ar = 2 * (cosx - sinx) * (cosx + sinx);
+        double y0 = (count & 1) != 0 ? c[--k] : 0;
+        double y1 = 0;
+        for (count /= 2; count > 0; --count) {
+            y1 = ar * y0 - y1 + c[--k];
+            y0 = ar * y1 - y0 + c[--k];
+        }
+        return sinp ? 2 * sinx * cosx * y0 : cosx * (y0 - y1);
+    }
+
+    /**
+     * Returns the positive root k of k^4 + 2 k^3 - (x^2 + y^2 - 1) k^2 - 2 y^2 k - y^2.
+     */
+    static inline double astroid(double x, double y) {
+        double p = x * x;
+        double q = y * y;
+        double r = (p + q - 1) / 6;
+        if (q == 0 && r <= 0) {
+            return 0;
+        }
+        double S = p * q / 4;
+        double r2 = r * r;
+        double r3 = r * r2;
+        double disc = S * (S + 2 * r3);
+        double u = r;
+        if (disc >= 0) {
+            double T3 = S + r3;
+            T3 += T3 < 0 ? -std::sqrt(disc) : std::sqrt(disc);
+            double T = std::cbrt(T3);
+            u += T + (T != 0 ? r2 / T : 0);
+        } else {
+            double ang = std::atan2(std::sqrt(-disc), -(S + r3));
+            u += 2 * r * std::cos(ang / 3);
+        }
+        double v = std::sqrt(u * u + q);
+        double uv = u < 0 ? q / (v - u) : u + v;
+        double w = (uv - q) / (2 * v);
+        return uv / (std::sqrt(uv + w * w) + w);
+    }
+
+    static inline double polyval(int degree, const double* p, double x) {
+        double y = degree < 0 ? 0 : p[0];
+        for (int i = 1; i <= degree; ++i) {
+            y = y * x + p[i];
+        }
+        return y;
+    }
+
+    static inline void norm(double& x, double& y) {
+        double r = std::hypot(x, y);
+        x /= r;
+        y /= r;
+    }
+
+    /**
+     * Rounds tiny angles so that they underflow to zero.
+     */
+    static inline double angRound(double x) {
+        const double z = 1 / 16.0;
+        volatile double y = std::fabs(x);
+        if (y < z) {
+            y = z - (z - y);
+        }
+        return std::copysign(static_cast<double>(y), x);
+    }
+
+    /**
+     * Returns y - x reduced to [-180, 180], with the rounding error in e.
+     */
+    static inline double angDiff(double x, double y, double& e) {
+        double t;
+        double d = twoSum(std::remainder(-x, 360.0), std::remainder(y, 360.0), t);
+        d = twoSum(std::remainder(d, 360.0), t, e);
+        if (d == 0 || std::fabs(d) == 180) {
+            d = std::copysign(d, e == 0 ? y - x : -e);
+        }
+        return d;
+    }
+
+    /**
+     * Returns u + v rounded, with the rounding error in t.
+     */
+    static inline double twoSum(double u, double v, double& t) {
+        volatile double s = u + v;
+        volatile double up = s - v;
+        volatile double vpp = s - up;
+        up -= u;
+        vpp -= v;
+        t = s != 0 ? 0.0 - (up + vpp) : static_cast<double>(s);
+        return s;
+    }
+
+    /**
+     * Sets s and c to the sine and cosine of x degrees, exact at multiples of 90.
+     */
+    static inline void sincosd(double x, double& s, double& c) {
+        int q = 0;
+        double r = deg2rad(std::remquo(x, 90.0, &q));
+        quadrant(std::sin(r), std::cos(r), q, x, s, c);
+    }
+
+    /**
+     * Same as above for x + t degrees, x in [-180, 180] and t small.
+     */
+    static inline void sincosde(double x, double t, double& s, double& c) {
+        int q = static_cast<int>(std::lround(x / 90));
+        double r = deg2rad(angRound((x - 90 * q) + t));
+        quadrant(std::sin(r), std::cos(r), q, x, s, c);
+    }
+
+    static inline void quadrant(double sinr, double cosr, int q, double x, double& s, double& c) {
+        switch (static_cast<unsigned>(q) & 3U) {
+            case 0U: s =  sinr; c =  cosr; break;
+            case 1U: s =  cosr; c = -sinr; break;
+            case 2U: s = -sinr; c = -cosr; break;
+            default: s = -cosr; c =  sinr; break;
+        }
+        c += 0.0;
+        if (s == 0) {
+            s = std::copysign(s, x);
+        }
+    }
+
+    /**
+     * Returns atan2(y, x) in degrees, exact at multiples of 45.
+     */
+    static inline double atan2d(double y, double x) {
+        int q = 0;
+        if (std::fabs(y) > std::fabs(x)) {
+            std::swap(x, y);
+            q = 2;
+        }
+        if (std::signbit(x)) {
+            x = -x;
+            ++q;
+        }
+        double angle = rad2deg(std::atan2(y, x));
+        switch (q) {
+            case 1: return std::copysign(180.0, y) - angle;
+            case 2: return 90 - angle;
+            case 3: return -90 + angle;
+            default: return angle;
+        }
+    }
+};
+
+
+template <typename Ellipsoid>
+constexpr double EllipsoidalSolver<Ellipsoid>::TINY;
+
+template <typename Ellipsoid>
+constexpr double EllipsoidalSolver<Ellipsoid>::TOL0;
+
+template <typename Ellipsoid>
+constexpr double EllipsoidalSolver<Ellipsoid>::TOL1;
+
+template <typename Ellipsoid>
+constexpr double EllipsoidalSolver<Ellipsoid>::TOL2;
+
+template <typename Ellipsoid>
+constexpr double EllipsoidalSolver<Ellipsoid>::XTHRESH;
+
+
+/**
+ * A geodesic on the ellipsoid from a start point along an initial heading, with
+ * the series coefficients of the line computed once: position() is then a direct
+ * solution without iteration, a few dozen multiplies and a handful of trig calls.
+ */
+template <typename Ellipsoid = Wgs84Ellipsoid>
+class EllipsoidalLine {
+public:
+    /**
+     * Constructs the geodesic leaving from at the given heading, in degrees
+     * clockwise from north.
+     */
+    EllipsoidalLine(const LatLng& from, double heading)
+        : EllipsoidalLine(Endpoint(from), heading) {}
+
+    /**
+     * Returns the point at the given distance, in meters, along the line; negative
+     * distances go backwards.
+     */
+    inline LatLng position(double distance) const {
+        double heading;
+        return position(distance, heading);
+    }
+
+    /**
+     * Same as above, with the heading of the line at that point in heading, in
+     * degrees clockwise from north within [-180, 180).
+     */
+    inline LatLng position(double distance, double& heading) const {
+        const Solver& g = Solver::get();
+        double tau12 = distance / (g.b * (1 + A1m1));
+        double s = std::sin(tau12);
+        double c = std::cos(tau12);
+        double B12 = -Solver::sinCosSeries(true, stau1 * c + ctau1 * s, ctau1 * c - stau1 * s, C1pa, Solver::ORDER + 1);
+        double sig12 = tau12 - (B12 - B11);
+        double ssig12 = std::sin(sig12);
+        double csig12 = std::cos(sig12);
+
+        double ssig2 = ssig1 * csig12 + csig1 * ssig12;
+        double csig2 = csig1 * csig12 - ssig1 * ssig12;
+        double sbet2 = calp0 * ssig2;
+        double cbet2 = std::hypot(salp0, calp0 * csig2);
+        if (cbet2 == 0) {
+            cbet2 = csig2 = Solver::TINY;
+        }
+        double somg2 = salp0 * ssig2;
+        double comg2 = csig2;
+        double omg12 = std::atan2(somg2 * comg1 - comg2 * somg1, comg2 * comg1 + somg2 * somg1);
+        double lam12 = omg12 + A3c * (sig12 + (Solver::sinCosSeries(true, ssig2, csig2, C3a, Solver::ORDER) - B31));
+
+        heading = MathUtil::wrap(Solver::atan2d(salp0, calp0 * csig2), -180, 180);
+        double lng = MathUtil::wrap(MathUtil::wrap(lng1, -180, 180) + MathUtil::wrap(rad2deg(lam12), -180, 180), -180, 180);
+        return LatLng(Solver::atan2d(sbet2, g.f1 * cbet2), lng);
+    }
+
+
+private:
+    template <typename> friend class EllipsoidalOrigin;
+
+    typedef EllipsoidalSolver<Ellipsoid> Solver;
+    typedef typename Solver::Endpoint Endpoint;
+
+    double lng1;
+    double salp0, calp0;         // The azimuth at the equator
+    double ssig1, csig1;         // The arc from the equator crossing to the start
+    double somg1, comg1;         // The longitude on the auxiliary sphere
+    double stau1, ctau1;         // The arc plus the distance series
+    double A1m1, B11, A3c, B31;
+    double C1pa[Solver::ORDER + 1];
+    double C3a[Solver::ORDER];
+
+    EllipsoidalLine(const Endpoint& from, double heading)
+        : lng1(from.lng) {
+        const Solver& g = Solver::get();
+        double salp1;
+        double calp1;
+        Solver::sincosd(Solver::angRound(heading), salp1, calp1);
+
+        salp0 = salp1 * from.cbet;
+        calp0 = std::hypot(calp1, salp1 * from.sbet);
+        ssig1 = from.sbet;
+        somg1 = salp0 * from.sbet;
+        csig1 = comg1 = from.sbet != 0 || calp1 != 0 ? from.cbet * calp1 : 1;
+        Solver::norm(ssig1, csig1);
+
+        double k2 = calp0 * calp0 * g.ep2;
+        double eps = k2 / (2 * (1 + std::sqrt(1 + k2)) + k2);
+
+        double C1a[Solver::ORDER + 1];
+        A1m1 = Solver::A1m1f(eps);
+        Solver::C1f(eps, C1a);
+        B11 = Solver::sinCosSeries(true, ssig1, csig1, C1a, Solver::ORDER + 1);
+        double s = std::sin(B11);
+        double c = std::cos(B11);
+        stau1 = ssig1 * c + csig1 * s;
+        ctau1 = csig1 * c - ssig1 * s;
+        Solver::C1pf(eps, C1pa);
+
+        g.C3f(eps, C3a);
+        A3c = -g.f * salp0 * g.A3f(eps);
+        B31 = Solver::sinCosSeries(true, ssig1, csig1, C3a, Solver::ORDER);
+    }
+};
+
+
+/**
+ * An origin on the ellipsoid for one-to-many queries, e.g. from a depot: the
+ * reduced latitude of the origin and its sine and cosine are computed once, and
+ * every query solves the rest of the inverse problem only.
+ */
+template <typename Ellipsoid = Wgs84Ellipsoid>
+class EllipsoidalOrigin {
+public:
+    explicit EllipsoidalOrigin(const LatLng& origin)
+        : origin(origin) {}
+
+    /**
+     * Returns the length of the shortest geodesic from the origin to the given
+     * point, in meters.
+     */
+    inline double computeDistanceTo(const LatLng& to) const {
+        double salp1, calp1, salp2, calp2;
+        return Solver::get().inverse(origin, Endpoint(to), salp1, calp1, salp2, calp2);
+    }
+
+    /**
+     * Returns the initial heading of the shortest geodesic from the origin to the
+     * given point, in degrees clockwise from north within [-180, 180).
+     */
+    inline double computeHeadingTo(const LatLng& to) const {
+        double salp1, calp1, salp2, calp2;
+        Solver::get().inverse(origin, Endpoint(to), salp1, calp1, salp2, calp2);
+        return MathUtil::wrap(Solver::atan2d(salp1, calp1), -180, 180);
+    }
+
+    /**
+     * Writes computeDistanceTo() of every target into out[0 .. targets.size()).
+     */
+    template <typename LatLngList>
+    inline void computeDistances(const LatLngList& targets, double* out) const {
+        const Solver& g = Solver::get();
+        double salp1, calp1, salp2, calp2;
+        for (const auto& target : targets) {
+            *out++ = g.inverse(origin, Endpoint(LatLng(target)), salp1, calp1, salp2, calp2);
+        }
+    }
+
+    /**
+     * Returns the point at the given distance, in meters, from the origin along the
+     * given heading.
+     */
+    inline LatLng computeOffset(double distance, double heading) const {
+        return EllipsoidalLine<Ellipsoid>(origin, heading).position(distance);
+    }
+
+    /**
+     * Returns the geodesic leaving the origin at the given heading.
+     */
+    inline EllipsoidalLine<Ellipsoid> line(double heading) const {
+        return EllipsoidalLine<Ellipsoid>(origin, heading);
+    }
+
+
+private:
+    typedef EllipsoidalSolver<Ellipsoid> Solver;
+    typedef typename Solver::Endpoint Endpoint;
+
+    Endpoint origin;
+};
+
+
+/**
+ * Distance, heading and offset on an ellipsoid, by default WGS-84, counterparts of
+ * the SphericalUtil functions on the sphere. Results agree with GeographicLib to
+ * about 15 nanometers; the inverse problem converges for every pair, nearly
+ * antipodal ones included.
+ *
+ * The ellipsoid is a policy, any type with static constexpr double
+ * EQUATORIAL_RADIUS, in meters, and FLATTENING, e.g.
+ * EllipsoidalUtil::computeDistanceBetween<Wgs84Ellipsoid>(); see Policies.hpp.
+ */
+class EllipsoidalUtil {
+public:
+    /**
+     * Returns the length of the shortest geodesic between two points, in meters.
+     */
+    template <typename Ellipsoid = Wgs84Ellipsoid>
+    static inline double computeDistanceBetween(const LatLng& from, const LatLng& to) {
+        return EllipsoidalOrigin<Ellipsoid>(from).computeDistanceTo(to);
+    }
+
+    /**
+     * Returns the initial heading of the shortest geodesic from one point to
+     * another, in degrees clockwise from north within [-180, 180).
+     */
+    template <typename Ellipsoid = Wgs84Ellipsoid>
+    static inline double computeHeading(const LatLng& from, const LatLng& to) {
+        return EllipsoidalOrigin<Ellipsoid>(from).computeHeadingTo(to);
+    }
+
+    /**
+     * Returns the point resulting from moving a distance, in meters, from an origin
+     * along the geodesic leaving at the given heading, in degrees clockwise from
+     * north.
+     */
+    template <typename Ellipsoid = Wgs84Ellipsoid>
+    static inline LatLng computeOffset(const LatLng& from, double distance, double heading) {
+        return EllipsoidalLine<Ellipsoid>(from, heading).position(distance);
+    }
+
+    /**
+     * Returns the length of the given path, in meters, along geodesics.
+     */
+    template <typename Ellipsoid = Wgs84Ellipsoid, typename LatLngList>
+    static inline double computeLength(const LatLngList& path) {
+        typedef EllipsoidalSolver<Ellipsoid> Solver;
+        const Solver& g = Solver::get();
+        CompensatedSum length;
+        auto it = path.begin();
+        if (it == path.end()) {
+            return 0;
+        }
+        typename Solver::Endpoint prev((LatLng(*it)));
+        double salp1, calp1, salp2, calp2;
+        for (++it; it != path.end(); ++it) {
+            typename Solver::Endpoint next((LatLng(*it)));
+            length.add(g.inverse(prev, next, salp1, calp1, salp2, calp2));
+            prev = next;
+        }
+        return length.value();
+    }
+};
+
+#endif // GEOMETRY_LIBRARY_ELLIPSOIDAL_UTIL
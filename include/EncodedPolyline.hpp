@@ -0,0 +1,447 @@
+//******************************************************************************
+// Copyright 2013 Google Inc.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// This software and the related documents are provided  as is,  with no express
+// or implied  warranties,  other than  those that are  expressly stated  in the
+// License.
+//******************************************************************************
+
+#ifndef GEOMETRY_LIBRARY_ENCODED_POLYLINE
+#define GEOMETRY_LIBRARY_ENCODED_POLYLINE
+
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <string>
+
+#include "LatLng.hpp"
+#include "LatLngArray.hpp"
+#include "Simd.hpp"
+
+
+// The Google encoded polyline format: every point is the pair of latitude and longitude
+// deltas from the previous point, in 1e-5 degrees, zigzag encoded and written as 5-bit
+// chunks, least significant first. Each chunk is offset by 63 ('?'); all chunks but the
+// last of a value carry 0x20. So every byte is within ['?', '~'] and a value ends at
+// the first byte below '_'.
+
+#ifdef GEOMETRY_LIBRARY_HAS_SIMD
+#pragma GCC push_options
+#pragma GCC target("avx2")
+struct PolylineScanAvx2 {
+    /**
+     * Counts the values ending in data[0 .. size), stopping at the first byte outside
+     * the alphabet.
+     */
+    static inline size_t countValues(const char* data, size_t size) {
+        const __m256i below = _mm256_set1_epi8('?' - 1);
+        const __m256i above = _mm256_set1_epi8('~' + 1);
+        const __m256i last  = _mm256_set1_epi8('_');
+        size_t count = 0;
+        size_t i = 0;
+        for (; i + 32 <= size; i += 32) {
+            __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+            // Signed compares: bytes from 0x80 up are negative, hence outside too.
+            uint32_t inside = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_and_si256(
+                _mm256_cmpgt_epi8(bytes, below), _mm256_cmpgt_epi8(above, bytes))));
+            uint32_t ends = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpgt_epi8(last, bytes))) & inside;
+            if (inside != 0xFFFFFFFFU) {
+                uint32_t before = (1U << __builtin_ctz(~inside)) - 1;
+                return count + __builtin_popcount(ends & before);
+            }
+            count += __builtin_popcount(ends);
+        }
+        for (; i < size; ++i) {
+            char c = data[i];
+            if (c < '?' || c > '~') {
+                break;
+            }
+            count += c < '_';
+        }
+        return count;
+    }
+
+    /**
+     * Returns the mask of the bytes ending a value in p[0 .. 64), cut at the first
+     * byte outside the alphabet. See PolylineDecoder::endMask().
+     */
+    static inline uint64_t endMask(const char* p) {
+        const __m256i below = _mm256_set1_epi8('?' - 1);
+        const __m256i above = _mm256_set1_epi8('~' + 1);
+        const __m256i last  = _mm256_set1_epi8('_');
+        uint64_t inside = 0;
+        uint64_t ends = 0;
+        for (int half = 0; half < 2; ++half) {
+            __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + 32 * half));
+            inside |= static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_and_si256(
+                _mm256_cmpgt_epi8(bytes, below), _mm256_cmpgt_epi8(above, bytes))))) << (32 * half);
+            ends |= static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(
+                _mm256_cmpgt_epi8(last, bytes)))) << (32 * half);
+        }
+        return ends & ((~inside & (inside + 1)) - 1);
+    }
+};
+#pragma GCC pop_options
+#endif
+
+// Decoding finds the value ends of 64 bytes at once, which needs little-endian words.
+#if defined(__GNUC__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#define GEOMETRY_LIBRARY_POLYLINE_WINDOW
+#endif
+
+
+/**
+ * Streams the points of an encoded polyline without allocating.
+ *
+ * Decoding stops at the end of the data, at the first byte outside the encoding
+ * alphabet or at a value cut short; failed() tells the latter two apart.
+ */
+class PolylineDecoder {
+public:
+    PolylineDecoder(const char* data, size_t size)
+        : position(data), end(data + size), lat(0), lng(0), error(false), base(data), ends(0), avx2(false) {
+#ifdef GEOMETRY_LIBRARY_HAS_SIMD
+        avx2 = Simd::level() >= Simd::AVX2;
+#endif
+    }
+
+    explicit PolylineDecoder(const std::string& encoded)
+        : PolylineDecoder(encoded.data(), encoded.size()) {}
+
+    // The data is not copied; a temporary string would be gone before decoding.
+    explicit PolylineDecoder(std::string&& encoded) = delete;
+
+    /**
+     * Decodes the next point. Returns false once no point is left.
+     */
+    inline bool next(LatLng* point) {
+        return decode(1, [point](size_t, double pointLat, double pointLng) {
+            *point = LatLng(pointLat, pointLng);
+        }) != 0;
+    }
+
+    /**
+     * Decodes up to capacity points into lat[] and lng[], in degrees, and returns how
+     * many were written; 0 once no point is left. Call again for the following points.
+     */
+    inline size_t read(double* latOut, double* lngOut, size_t capacity) {
+        return decode(capacity, [latOut, lngOut](size_t i, double pointLat, double pointLng) {
+            latOut[i] = pointLat;
+            lngOut[i] = pointLng;
+        });
+    }
+
+    /**
+     * Appends all remaining points to the given container, a LatLngArray or a
+     * std::vector<LatLng> for example.
+     */
+    template <typename Container>
+    inline void readAll(Container& out) {
+        out.reserve(out.size() + PolylineDecoder::count(position, static_cast<size_t>(end - position)));
+        // Through a buffer, which keeps the growth of out away from the decoding loop.
+        double latBuffer[256];
+        double lngBuffer[256];
+        while (size_t n = read(latBuffer, lngBuffer, 256)) {
+            for (size_t i = 0; i < n; ++i) {
+                out.push_back(LatLng(latBuffer[i], lngBuffer[i]));
+            }
+        }
+    }
+
+    /**
+     * Returns true when decoding stopped at malformed data rather than at the end.
+     */
+    inline bool failed() const {
+        return error;
+    }
+
+    /**
+     * Returns the number of points in data[0 .. size), the same number a decoder reads.
+     * Scans 32 bytes at a time with AVX2 when available.
+     */
+    static inline size_t count(const char* data, size_t size) {
+#ifdef GEOMETRY_LIBRARY_HAS_SIMD
+        if (Simd::level() >= Simd::AVX2) {
+            return PolylineScanAvx2::countValues(data, size) / 2;
+        }
+#endif
+        size_t values = 0;
+        for (size_t i = 0; i < size; ++i) {
+            char c = data[i];
+            if (c < '?' || c > '~') {
+                break;
+            }
+            values += c < '_';
+        }
+        return values / 2;
+    }
+
+
+private:
+    const char* position;
+    const char* end;
+    uint64_t lat;  // Running sums, in 1e-5 degrees; unsigned so malformed input cannot overflow.
+    uint64_t lng;
+    bool error;
+    // The value ends not yet read within the WINDOW bytes at base. Knowing where a
+    // value ends beforehand, the short ones are gathered without a loop.
+    const char* base;
+    uint64_t ends;
+    bool avx2;
+
+    /**
+     * Decodes up to capacity points, passing (index, lat, lng) of each to emit, and
+     * returns how many were decoded. The state is kept in locals while decoding.
+     */
+    template <typename Emit>
+    inline size_t decode(size_t capacity, Emit emit) {
+        const char* p = position;
+        uint64_t sumLat = lat;
+        uint64_t sumLng = lng;
+        const char* windowBase = base;
+        uint64_t windowEnds = ends;
+        size_t count = 0;
+        for (; count < capacity && p != end; ++count) {
+            uint64_t dLat;
+            uint64_t dLng;
+            bool gathered = false;
+#ifdef GEOMETRY_LIBRARY_POLYLINE_WINDOW
+            // Both values of the point end within the window, and the gather reads 8
+            // bytes from the start of any value in it.
+            if ((windowEnds & (windowEnds - 1)) == 0 && end - p >= WINDOW + 8) {
+                windowBase = p;
+                windowEnds = PolylineDecoder::endMask(p, avx2);
+            }
+            if ((windowEnds & (windowEnds - 1)) != 0) {
+                const char* latLast = windowBase + __builtin_ctzll(windowEnds);
+                windowEnds &= windowEnds - 1;
+                const char* lngLast = windowBase + __builtin_ctzll(windowEnds);
+                windowEnds &= windowEnds - 1;
+                if (latLast - p < 8 && lngLast - latLast <= 8) {
+                    dLat = PolylineDecoder::gather(p, static_cast<unsigned>(latLast - p) + 1);
+                    dLng = PolylineDecoder::gather(latLast + 1, static_cast<unsigned>(lngLast - latLast));
+                    p = lngLast + 1;
+                    gathered = true;
+                }
+            }
+#endif
+            if (!gathered && (!PolylineDecoder::value(&p, end, &dLat) || !PolylineDecoder::value(&p, end, &dLng))) {
+                error = true;
+                p = end;
+                windowEnds = 0;
+                break;
+            }
+            sumLat += PolylineDecoder::unzigzag(dLat);
+            sumLng += PolylineDecoder::unzigzag(dLng);
+            emit(count, static_cast<int64_t>(sumLat) * 1e-5, static_cast<int64_t>(sumLng) * 1e-5);
+        }
+        position = p;
+        base = windowBase;
+        ends = windowEnds;
+        lat = sumLat;
+        lng = sumLng;
+        return count;
+    }
+
+    static inline uint64_t unzigzag(uint64_t value) {
+        return (value & 1) != 0 ? ~(value >> 1) : value >> 1;
+    }
+
+    /**
+     * Reads one value at *p byte by byte and advances *p past it. Returns false when
+     * the value is malformed or cut short.
+     */
+    static inline bool value(const char** p, const char* end, uint64_t* result) {
+        uint64_t v = 0;
+        unsigned shift = 0;
+        for (const char* q = *p; q != end; ++q) {
+            char c = *q;
+            if (c < '?' || c > '~') {
+                *p = q;
+                return false;
+            }
+            uint64_t chunk = static_cast<uint64_t>(c - '?');
+            if (shift < 64) {
+                v |= (chunk & 0x1F) << shift;
+            }
+            shift += 5;
+            if (chunk < 0x20) {
+                *result = v;
+                *p = q + 1;
+                return true;
+            }
+        }
+        *p = end;
+        return false;
+    }
+
+#ifdef GEOMETRY_LIBRARY_POLYLINE_WINDOW
+    static constexpr ptrdiff_t WINDOW = 64;
+
+    /**
+     * Returns the mask of the bytes ending a value in p[0 .. WINDOW): bit i is set when
+     * p[i] is below '_'. Only bytes before the first one outside the alphabet count.
+     */
+    static inline uint64_t endMask(const char* p, bool avx2) {
+#ifdef GEOMETRY_LIBRARY_HAS_SIMD
+        if (avx2) {
+            return PolylineScanAvx2::endMask(p);
+        }
+#else
+        (void) avx2;
+#endif
+        uint64_t inside = 0;
+        uint64_t ends = 0;
+        for (int i = 0; i < 8; ++i) {
+            uint64_t word;
+            std::memcpy(&word, p + 8 * i, sizeof(word));
+            // Bytes in the alphabet become chunks within [0, 0x3F]; a byte that is not
+            // sets bit 6 or 7, and may borrow from the bytes after it.
+            uint64_t chunks = word - 0x3F3F3F3F3F3F3F3FULL;
+            inside |= PolylineDecoder::highBits(~(chunks | (chunks << 1))) << (8 * i);
+            ends |= PolylineDecoder::highBits(~chunks << 2) << (8 * i);
+        }
+        return ends & ((~inside & (inside + 1)) - 1);
+    }
+
+    /**
+     * Returns bit 7 of every byte, packed into the low 8 bits.
+     */
+    static inline uint64_t highBits(uint64_t word) {
+        return ((word & 0x8080808080808080ULL) * 0x0002040810204081ULL) >> 56;
+    }
+
+    /**
+     * Returns the value of the length bytes at p, all in the alphabet; 8 bytes at p
+     * must be readable.
+     */
+    static inline uint64_t gather(const char* p, unsigned length) {
+        uint64_t word;
+        std::memcpy(&word, p, sizeof(word));
+        uint64_t mask = length == 8 ? ~0ULL : (1ULL << (8 * length)) - 1;
+        // The low 5 bits of every byte, packed by pairs, quads, then the two halves.
+        uint64_t v = (word - 0x3F3F3F3F3F3F3F3FULL) & mask & 0x1F1F1F1F1F1F1F1FULL;
+        v = (v & 0x00FF00FF00FF00FFULL) | ((v & 0xFF00FF00FF00FF00ULL) >> 3);
+        v = (v & 0x0000FFFF0000FFFFULL) | ((v & 0xFFFF0000FFFF0000ULL) >> 6);
+        v = (v & 0x00000000FFFFFFFFULL) | ((v & 0xFFFFFFFF00000000ULL) >> 12);
+        return v;
+    }
+#endif
+};
+
+
+/**
+ * A LatLngList over an encoded polyline, decoded lazily while iterating; the
+ * SphericalUtil and PolyUtil templates can take it without building a vector.
+ *
+ * The encoded data is not copied and must outlive the view. size() scans the data
+ * once; operator[] decodes from the start, so it is linear in the index (the
+ * templates only index the first and the last point).
+ */
+class EncodedPolyline {
+public:
+    class const_iterator {
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef LatLng    value_type;
+        typedef ptrdiff_t difference_type;
+        typedef const LatLng* pointer;
+        typedef const LatLng& reference;
+
+        const_iterator(const char* data, size_t size, bool atEnd)
+            : decoder(data, size), point(0, 0), atEnd(atEnd), index(0) {
+            if (!atEnd) {
+                ++*this;
+                index = 0;
+            }
+        }
+
+        inline const LatLng& operator*() const { return point; }
+        inline const LatLng* operator->() const { return &point; }
+
+        inline const_iterator& operator++() {
+            atEnd = !decoder.next(&point);
+            ++index;
+            return *this;
+        }
+
+        inline const_iterator operator++(int) {
+            const_iterator copy = *this;
+            ++*this;
+            return copy;
+        }
+
+        inline bool operator==(const const_iterator& other) const {
+            return atEnd == other.atEnd && (atEnd || index == other.index);
+        }
+
+        inline bool operator!=(const const_iterator& other) const {
+            return !(*this == other);
+        }
+
+    private:
+        PolylineDecoder decoder;
+        LatLng point;
+        bool atEnd;
+        size_t index;
+    };
+
+    typedef const_iterator iterator;
+    typedef LatLng value_type;
+
+    EncodedPolyline(const char* data, size_t size)
+        : data(data), length(size), points(UNKNOWN) {}
+
+    explicit EncodedPolyline(const std::string& encoded)
+        : EncodedPolyline(encoded.data(), encoded.size()) {}
+
+    explicit EncodedPolyline(std::string&& encoded) = delete;
+
+    inline const_iterator begin() const {
+        return const_iterator(data, length, false);
+    }
+
+    inline const_iterator end() const {
+        return const_iterator(data, length, true);
+    }
+
+    /**
+     * Returns the number of points; computed on the first call.
+     */
+    inline size_t size() const {
+        if (points == UNKNOWN) {
+            points = PolylineDecoder::count(data, length);
+        }
+        return points;
+    }
+
+    inline bool empty() const {
+        return size() == 0;
+    }
+
+    /**
+     * Returns point i, decoding points 0 to i.
+     */
+    inline LatLng operator[](size_t i) const {
+        PolylineDecoder decoder(data, length);
+        LatLng point(0, 0);
+        for (size_t j = 0; j <= i && decoder.next(&point); ++j) {
+        }
+        return point;
+    }
+
+
+private:
+    static constexpr size_t UNKNOWN = ~static_cast<size_t>(0);
+
+    const char* data;
+    size_t length;
+    mutable size_t points;
+};
+
+#endif // GEOMETRY_LIBRARY_ENCODED_POLYLINE
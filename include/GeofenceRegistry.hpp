@@ -0,0 +1,428 @@
+//******************************************************************************
+// Copyright 2013 Google Inc.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// This software and the related documents are provided  as is,  with no express
+// or implied  warranties,  other than  those that are  expressly stated  in the
+// License.
+//******************************************************************************
+
+#ifndef GEOMETRY_LIBRARY_GEOFENCE_REGISTRY
+#define GEOMETRY_LIBRARY_GEOFENCE_REGISTRY
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "LatLng.hpp"
+#include "PolygonIndex.hpp"
+#include "PreparedPolygon.hpp"
+
+
+/**
+ * A set of geofences, polygons keyed by id, queried by many threads while it changes.
+ *
+ * The registry publishes immutable snapshots: the zones sorted by id, each with its
+ * PreparedPolygon, and a PolygonIndex over them. An update builds the next snapshot
+ * beside the current one, sharing the unchanged zones, and swaps a pointer; the old
+ * snapshot is freed once every Reader has passed a quiescent state since (RCU with
+ * quiescent-state-based reclamation).
+ *
+ * Queries go through a Reader, one per thread. A query loads the snapshot pointer and
+ * nothing else shared: no lock, no atomic write, no reference count. In return the
+ * reader calls quiescent() between queries now and then, promising it holds no
+ * reference into an older snapshot; until all readers have, old snapshots stay
+ * allocated. Answers are those of PolyUtil::containsLocation() on every zone of one
+ * snapshot, with the geodesic flag of the registry.
+ */
+class GeofenceRegistry {
+private:
+    // The zones, shared by the snapshots, and the other types the public classes use.
+    struct Zone {
+        uint64_t id;
+        std::vector<LatLng> vertices;
+        PreparedPolygon prepared;
+
+        template <typename LatLngList>
+        Zone(uint64_t id, const LatLngList& polygon, bool geodesic)
+            : id(id), prepared(polygon, geodesic) {
+            vertices.reserve(polygon.size());
+            for (const auto& point : polygon) {
+                vertices.push_back(LatLng(point.lat, point.lng));
+            }
+        }
+    };
+
+    typedef std::shared_ptr<const Zone> ZonePtr;
+
+    struct Change {
+        uint64_t id;
+        ZonePtr zone;  // nullptr to erase
+    };
+
+    // The epoch a reader last passed a quiescent state in, padded away from the next
+    // reader's (alignas() would not hold for a Reader from new in C++14).
+    struct Slot {
+        std::atomic<uint64_t> seen;
+        char padding[56];
+    };
+
+public:
+    class Snapshot;
+
+    /**
+     * Changes applied together, in one snapshot. The polygons are prepared by insert(),
+     * on the calling thread, not under the registry lock.
+     */
+    class Batch {
+    public:
+        explicit Batch(const GeofenceRegistry& registry) : geodesic(registry.geodesic) {}
+
+        /**
+         * Adds the zone, or replaces the zone of the same id.
+         */
+        template <typename LatLngList>
+        inline void insert(uint64_t id, const LatLngList& polygon) {
+            changes.push_back(Change{ id, std::make_shared<const Zone>(id, polygon, geodesic) });
+        }
+
+        /**
+         * Removes the zone, if there is one of this id.
+         */
+        inline void erase(uint64_t id) {
+            changes.push_back(Change{ id, nullptr });
+        }
+
+        inline size_t size() const {
+            return changes.size();
+        }
+
+    private:
+        friend class GeofenceRegistry;
+
+        bool geodesic;
+        std::vector<Change> changes;  // In call order; the last change of an id wins
+    };
+
+    /**
+     * The queries of one thread. A Reader must not outlive its registry, nor be used
+     * by two threads at once.
+     */
+    class Reader {
+    public:
+        explicit Reader(GeofenceRegistry& registry) : registry(registry) {
+            std::lock_guard<std::mutex> lock(registry.mutex);
+            slot.seen.store(registry.epoch.load());
+            registry.readers.push_back(&slot);
+        }
+
+        ~Reader() {
+            std::lock_guard<std::mutex> lock(registry.mutex);
+            auto found = std::find(registry.readers.begin(), registry.readers.end(), &slot);
+            *found = registry.readers.back();
+            registry.readers.pop_back();
+        }
+
+        Reader(const Reader&) = delete;
+        Reader& operator=(const Reader&) = delete;
+
+        /**
+         * Returns the current snapshot, valid until the next quiescent() or offline().
+         */
+        inline const Snapshot& snapshot() const {
+            return *registry.current.load();
+        }
+
+        /**
+         * Returns whether any zone contains the given point, and stores the id of one of them.
+         */
+        inline bool findAny(const LatLng& point, uint64_t* id = nullptr) const {
+            return snapshot().findAny(point, id);
+        }
+
+        /**
+         * Returns the ids of all zones containing the given point, in increasing order.
+         */
+        inline std::vector<uint64_t> findAll(const LatLng& point) const {
+            return snapshot().findAll(point);
+        }
+
+        /**
+         * Same as above, appending to out.
+         */
+        inline void findAll(const LatLng& point, std::vector<uint64_t>& out) const {
+            snapshot().findAll(point, out);
+        }
+
+        /**
+         * Declares that this thread holds no reference into a snapshot, so the snapshots
+         * replaced before now may be freed. One atomic store; call it every few queries,
+         * or every few milliseconds.
+         */
+        inline void quiescent() {
+            slot.seen.store(registry.epoch.load());
+        }
+
+        /**
+         * Declares that this thread makes no queries until online(), e.g. before it
+         * blocks, so it holds back no snapshot meanwhile.
+         */
+        inline void offline() {
+            slot.seen.store(OFFLINE);
+        }
+
+        inline void online() {
+            quiescent();
+        }
+
+    private:
+        GeofenceRegistry& registry;
+        Slot slot;
+    };
+
+    /**
+     * The zones at one version of the registry; immutable.
+     */
+    class Snapshot {
+    public:
+        inline bool findAny(const LatLng& point, uint64_t* id = nullptr) const {
+            return index.candidates(point, [&](size_t i) {
+                if (!zones[i]->prepared.containsLocation(point)) {
+                    return false;
+                }
+                if (id != nullptr) {
+                    *id = zones[i]->id;
+                }
+                return true;
+            });
+        }
+
+        inline std::vector<uint64_t> findAll(const LatLng& point) const {
+            std::vector<uint64_t> result;
+            findAll(point, result);
+            return result;
+        }
+
+        inline void findAll(const LatLng& point, std::vector<uint64_t>& out) const {
+            size_t first = out.size();
+            index.candidates(point, [&](size_t i) {
+                if (zones[i]->prepared.containsLocation(point)) {
+                    out.push_back(zones[i]->id);
+                }
+                return false;
+            });
+            // A zone across the antimeridian has a box on each side of it.
+            std::sort(out.begin() + first, out.end());
+            out.erase(std::unique(out.begin() + first, out.end()), out.end());
+        }
+
+        /**
+         * Returns whether there is a zone of this id.
+         */
+        inline bool contains(uint64_t id) const {
+            auto found = std::lower_bound(zones.begin(), zones.end(), id, [](const ZonePtr& zone, uint64_t id) {
+                return zone->id < id;
+            });
+            return found != zones.end() && (*found)->id == id;
+        }
+
+        /**
+         * Returns the number of zones.
+         */
+        inline size_t size() const {
+            return zones.size();
+        }
+
+        /**
+         * Returns the number of updates published before this snapshot.
+         */
+        inline uint64_t version() const {
+            return number;
+        }
+
+    private:
+        friend class GeofenceRegistry;
+
+        std::vector<ZonePtr> zones;  // By increasing id
+        PolygonIndex index;                              // Polygon i is zones[i]
+        uint64_t number;
+
+        Snapshot(std::vector<ZonePtr>&& zones, bool geodesic, uint64_t number)
+            : zones(std::move(zones)), index(Snapshot::rings(this->zones), geodesic), number(number) {}
+
+        static inline std::vector<PolygonIndex::Polygon> rings(const std::vector<ZonePtr>& zones) {
+            std::vector<PolygonIndex::Polygon> rings;
+            rings.reserve(zones.size());
+            for (const auto& zone : zones) {
+                const LatLng* first = zone->vertices.data();
+                rings.push_back(PolygonIndex::Polygon(first, first + zone->vertices.size()));
+            }
+            return rings;
+        }
+    };
+
+    /**
+     * @param geodesic the zones are composed of great circle segments if geodesic is true,
+     *                 and of Rhumb segments otherwise
+     */
+    explicit GeofenceRegistry(bool geodesic = false) : geodesic(geodesic), epoch(1) {
+        current.store(new Snapshot(std::vector<ZonePtr>(), geodesic, 0));
+    }
+
+    /**
+     * No Reader may be left.
+     */
+    ~GeofenceRegistry() {
+        delete current.load();
+        for (const auto& snapshot : retired) {
+            delete snapshot.second;
+        }
+    }
+
+    GeofenceRegistry(const GeofenceRegistry&) = delete;
+    GeofenceRegistry& operator=(const GeofenceRegistry&) = delete;
+
+    /**
+     * Adds the zone, or replaces the zone of the same id, in a snapshot of its own.
+     * Returns the version of that snapshot.
+     */
+    template <typename LatLngList>
+    inline uint64_t insert(uint64_t id, const LatLngList& polygon) {
+        Batch batch(*this);
+        batch.insert(id, polygon);
+        return apply(batch);
+    }
+
+    /**
+     * Removes the zone of this id, if any, in a snapshot of its own.
+     */
+    inline uint64_t erase(uint64_t id) {
+        Batch batch(*this);
+        batch.erase(id);
+        return apply(batch);
+    }
+
+    /**
+     * Publishes the changes of the batch in one snapshot, which the queries starting
+     * after this returns see; returns its version. Writers are serialized. The new
+     * snapshot shares the unchanged zones, but its index is built over all of them:
+     * many changes at once cost about as much as one.
+     */
+    inline uint64_t apply(const Batch& batch) {
+        std::lock_guard<std::mutex> lock(mutex);
+        const Snapshot* old = current.load(std::memory_order_relaxed);
+        if (batch.changes.empty()) {
+            return old->number;
+        }
+        std::vector<Change> changes(batch.changes);
+        std::stable_sort(changes.begin(), changes.end(), [](const Change& a, const Change& b) {
+            return a.id < b.id;
+        });
+
+        // Merge the zones and the changes, both by id.
+        std::vector<ZonePtr> zones;
+        zones.reserve(old->zones.size() + changes.size());
+        auto zone = old->zones.begin();
+        for (size_t i = 0; i < changes.size(); ++i) {
+            if (i + 1 < changes.size() && changes[i + 1].id == changes[i].id) {
+                continue;
+            }
+            uint64_t id = changes[i].id;
+            while (zone != old->zones.end() && (*zone)->id < id) {
+                zones.push_back(*zone++);
+            }
+            if (zone != old->zones.end() && (*zone)->id == id) {
+                ++zone;
+            }
+            if (changes[i].zone != nullptr) {
+                zones.push_back(changes[i].zone);
+            }
+        }
+        zones.insert(zones.end(), zone, old->zones.end());
+
+        uint64_t number = old->number + 1;
+        current.store(new Snapshot(std::move(zones), geodesic, number));
+        retired.push_back(std::make_pair(epoch.fetch_add(1) + 1, old));
+        reclaimLocked();
+        return number;
+    }
+
+    /**
+     * Frees the replaced snapshots every reader has passed a quiescent state since.
+     * Updates do so too. Returns the number of snapshots still held back.
+     */
+    inline size_t reclaim() {
+        std::lock_guard<std::mutex> lock(mutex);
+        reclaimLocked();
+        return retired.size();
+    }
+
+    /**
+     * Returns the number of zones of the current snapshot.
+     */
+    inline size_t size() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return current.load(std::memory_order_relaxed)->size();
+    }
+
+    /**
+     * Returns the version of the current snapshot.
+     */
+    inline uint64_t version() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return current.load(std::memory_order_relaxed)->number;
+    }
+
+    inline bool isGeodesic() const {
+        return geodesic;
+    }
+
+
+private:
+    // The epoch of a reader which makes no queries.
+    static constexpr uint64_t OFFLINE = ~static_cast<uint64_t>(0);
+
+    bool geodesic;
+
+    // Read by every query; written by the writers only.
+    std::atomic<const Snapshot*> current;
+
+    // Advanced by every update: a reader which has seen epoch e no longer uses the
+    // snapshots replaced up to e.
+    std::atomic<uint64_t> epoch;
+
+    // Serializes the writers, and guards what follows.
+    mutable std::mutex mutex;
+    std::vector<Slot*> readers;
+    std::vector<std::pair<uint64_t, const Snapshot*>> retired;  // Epoch of the replacement, snapshot
+
+    /**
+     * The memory orders are sequentially consistent throughout. A reader coming back
+     * online stores its epoch then loads the snapshot; an update stores the snapshot,
+     * advances the epoch then loads the readers' epochs. One of them sees the other.
+     */
+    inline void reclaimLocked() {
+        uint64_t oldest = OFFLINE;
+        for (const Slot* reader : readers) {
+            oldest = std::min(oldest, reader->seen.load());
+        }
+        size_t kept = 0;
+        for (const auto& snapshot : retired) {
+            if (snapshot.first <= oldest) {
+                delete snapshot.second;
+            } else {
+                retired[kept++] = snapshot;
+            }
+        }
+        retired.resize(kept);
+    }
+};
+
+#endif // GEOMETRY_LIBRARY_GEOFENCE_REGISTRY
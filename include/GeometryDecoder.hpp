@@ -0,0 +1,821 @@
+//******************************************************************************
+// Copyright 2013 Google Inc.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// This software and the related documents are provided  as is,  with no express
+// or implied  warranties,  other than  those that are  expressly stated  in the
+// License.
+//******************************************************************************
+
+#ifndef GEOMETRY_LIBRARY_GEOMETRY_DECODER
+#define GEOMETRY_LIBRARY_GEOMETRY_DECODER
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "LatLng.hpp"
+
+
+/**
+ * The events of GeoJsonDecoder and WkbDecoder, which call them on a handler of their
+ * template parameter: derive from this class and hide the events of interest, the
+ * others do nothing.
+ *
+ * A geometry is a sequence of rings between beginGeometry() and endGeometry(), its
+ * points handed out in chunks between beginRing() and endRing(). A Point is one VERTEX
+ * ring of one point, a LineString one LINE ring, a Polygon a SHELL ring followed by its
+ * HOLE rings, and a MultiPolygon the rings of all its polygons, each starting with a SHELL.
+ */
+class GeometryHandler {
+public:
+    // The geometry types, numbered as in WKB.
+    enum Type {
+        POINT = 1,
+        LINE_STRING = 2,
+        POLYGON = 3,
+        MULTI_POLYGON = 6,
+    };
+
+    enum Ring {
+        VERTEX,  // The one point of a Point
+        LINE,
+        SHELL,
+        HOLE,
+    };
+
+    inline void beginGeometry(Type) {}
+    inline void beginRing(Ring) {}
+
+    /**
+     * Points of the current ring: lat[0 .. count) and lng[0 .. count), in degrees,
+     * valid during the call only.
+     */
+    inline void points(const double*, const double*, size_t) {}
+
+    inline void endRing() {}
+    inline void endGeometry() {}
+};
+
+
+/**
+ * A handler appending the points of every ring to a container, a LatLngArray or a
+ * std::vector<LatLng> for example, and recording where each ring starts.
+ *
+ * After a failed decode the last ring may be left open; clear() it.
+ */
+template <typename Container = std::vector<LatLng> >
+class GeometryCollector : public GeometryHandler {
+public:
+    /**
+     * Appends to the given container, which must outlive the collector.
+     */
+    explicit GeometryCollector(Container& out) : out(out) {
+        offsets.push_back(out.size());
+    }
+
+    inline void beginRing(Ring ring) {
+        kinds.push_back(ring);
+    }
+
+    inline void points(const double* lat, const double* lng, size_t count) {
+        for (size_t i = 0; i < count; ++i) {
+            out.push_back(LatLng(lat[i], lng[i]));
+        }
+    }
+
+    inline void endRing() {
+        offsets.push_back(out.size());
+    }
+
+    /**
+     * Returns the number of rings collected.
+     */
+    inline size_t size() const {
+        return offsets.size() - 1;
+    }
+
+    /**
+     * Returns the index in the container of the first point of ring i; ring i is the
+     * points [offset(i), offset(i + 1)).
+     */
+    inline size_t offset(size_t i) const {
+        return offsets[i];
+    }
+
+    inline Ring kind(size_t i) const {
+        return kinds[i];
+    }
+
+    /**
+     * Forgets the rings, so that the next ones start at the current end of the container.
+     */
+    inline void clear() {
+        offsets.assign(1, out.size());
+        kinds.clear();
+    }
+
+private:
+    Container& out;
+    std::vector<size_t> offsets;
+    std::vector<Ring> kinds;
+};
+
+
+/**
+ * Reads the geometries of a GeoJSON text in a single pass, without building a document
+ * and without allocating: every "coordinates" member is turned into handler events as
+ * it is read, and everything else is checked for syntax and skipped.
+ *
+ * The "type" member of the object gives the type, before or after the coordinates:
+ * when it comes after, the coordinates are checked, and read again once it is known.
+ * Coordinates nested otherwise than the type says are malformed. Objects of other
+ * types or without one are skipped, as are the members of a GeometryCollection; so is
+ * a geometry without a single position. Positions are [longitude, latitude], further
+ * values (altitude) are ignored. Numbers are converted exactly, with std::strtod for
+ * those of more than 19 significant digits, above 2^53 or with large exponents.
+ *
+ * Decoding stops at the end of the text or at malformed JSON; failed() tells them apart.
+ */
+class GeoJsonDecoder {
+public:
+    GeoJsonDecoder(const char* data, size_t size)
+        : position(data), end(data + size), error(false), buffered(0) {}
+
+    explicit GeoJsonDecoder(const std::string& text)
+        : GeoJsonDecoder(text.data(), text.size()) {}
+
+    // The data is not copied; a temporary string would be gone before decoding.
+    explicit GeoJsonDecoder(std::string&& text) = delete;
+
+    /**
+     * Reads the next JSON value, usually the whole text, calling the handler for the
+     * geometries within. Returns false once no value is left or at malformed data,
+     * possibly in the middle of a geometry. Newline-delimited GeoJSON takes a call
+     * per line.
+     */
+    template <typename Handler>
+    inline bool decode(Handler& handler) {
+        skipSpace();
+        if (error || position == end) {
+            return false;
+        }
+        if (!value(handler, 0)) {
+            error = true;
+            position = end;
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * Returns true when decoding stopped at malformed data rather than at the end.
+     */
+    inline bool failed() const {
+        return error;
+    }
+
+
+private:
+    // Points handed to the handler per points() call.
+    static constexpr size_t BUFFER = 256;
+
+    // Nested arrays and objects, the coordinates excepted.
+    static constexpr int MAX_DEPTH = 64;
+
+    // The type of an object, besides the GeometryHandler::Type values: none seen yet,
+    // or one which is not read.
+    static constexpr int NO_TYPE = 0;
+    static constexpr int OTHER_TYPE = -1;
+
+    const char* position;
+    const char* end;
+    bool error;
+    size_t buffered;
+    double latBuffer[BUFFER];
+    double lngBuffer[BUFFER];
+
+    static inline bool isDigit(char c) {
+        return c >= '0' && c <= '9';
+    }
+
+    inline void skipSpace() {
+        while (position != end && (*position == ' ' || *position == '\n' || *position == '\r' || *position == '\t')) {
+            ++position;
+        }
+    }
+
+    inline bool consume(char c) {
+        skipSpace();
+        if (position == end || *position != c) {
+            return false;
+        }
+        ++position;
+        return true;
+    }
+
+    /**
+     * Reads a comma separated list up to close, calling item() at each element.
+     */
+    template <typename Item>
+    inline bool list(char close, Item item) {
+        skipSpace();
+        if (position != end && *position == close) {
+            ++position;
+            return true;
+        }
+        while (true) {
+            if (!item()) {
+                return false;
+            }
+            skipSpace();
+            if (position == end) {
+                return false;
+            }
+            char c = *position++;
+            if (c == close) {
+                return true;
+            }
+            if (c != ',') {
+                return false;
+            }
+        }
+    }
+
+    template <typename Handler>
+    inline bool value(Handler& handler, int depth) {
+        skipSpace();
+        if (position == end || depth > MAX_DEPTH) {
+            return false;
+        }
+        switch (*position) {
+            case '{': {
+                ++position;
+                int type = NO_TYPE;
+                const char* coordinates = nullptr;
+                bool read = list('}', [&] {
+                    skipSpace();
+                    const char* key = position + 1;
+                    if (!string()) {
+                        return false;
+                    }
+                    size_t length = static_cast<size_t>(position - 1 - key);
+                    if (!consume(':')) {
+                        return false;
+                    }
+                    skipSpace();
+                    if (position == end) {
+                        return false;
+                    }
+                    if (isWord(key, length, "type") && *position == '"') {
+                        const char* name = position + 1;
+                        if (!string()) {
+                            return false;
+                        }
+                        type = GeoJsonDecoder::geometryType(name, static_cast<size_t>(position - 1 - name));
+                        return true;
+                    }
+                    if (isWord(key, length, "coordinates") && *position == '[') {
+                        if (type > 0) {
+                            return geometry(handler, depth, static_cast<GeometryHandler::Type>(type));
+                        }
+                        // Read again at the end of the object if the type follows.
+                        coordinates = position;
+                    }
+                    if (isWord(key, length, "geometries")) {
+                        GeometryHandler ignored;
+                        return value(ignored, depth + 1);
+                    }
+                    return value(handler, depth + 1);
+                });
+                if (read && coordinates != nullptr && type > 0) {
+                    const char* next = position;
+                    position = coordinates;
+                    read = geometry(handler, depth, static_cast<GeometryHandler::Type>(type));
+                    position = next;
+                }
+                return read;
+            }
+            case '[':
+                ++position;
+                return list(']', [&] {
+                    return value(handler, depth + 1);
+                });
+            case '"':
+                return string();
+            case 't':
+                return literal("true");
+            case 'f':
+                return literal("false");
+            case 'n':
+                return literal("null");
+            default:
+                double skipped;
+                return GeoJsonDecoder::number(&position, end, &skipped);
+        }
+    }
+
+    /**
+     * Skips a string, its escapes unchecked.
+     */
+    inline bool string() {
+        if (position == end || *position != '"') {
+            return false;
+        }
+        for (const char* p = position + 1; p != end; ++p) {
+            if (*p == '"') {
+                position = p + 1;
+                return true;
+            }
+            if (*p == '\\' && ++p == end) {
+                break;
+            }
+        }
+        return false;
+    }
+
+    static inline bool isWord(const char* text, size_t length, const char* word) {
+        return length == std::strlen(word) && std::memcmp(text, word, length) == 0;
+    }
+
+    /**
+     * Returns the GeometryHandler::Type of a "type" name, or OTHER_TYPE.
+     */
+    static inline int geometryType(const char* name, size_t length) {
+        if (isWord(name, length, "Point")) {
+            return GeometryHandler::POINT;
+        }
+        if (isWord(name, length, "LineString")) {
+            return GeometryHandler::LINE_STRING;
+        }
+        if (isWord(name, length, "Polygon")) {
+            return GeometryHandler::POLYGON;
+        }
+        if (isWord(name, length, "MultiPolygon")) {
+            return GeometryHandler::MULTI_POLYGON;
+        }
+        return OTHER_TYPE;
+    }
+
+    inline bool literal(const char* word) {
+        size_t length = std::strlen(word);
+        if (static_cast<size_t>(end - position) < length || std::memcmp(position, word, length) != 0) {
+            return false;
+        }
+        position += length;
+        return true;
+    }
+
+    /**
+     * Reads the coordinates array at position as a geometry of the given type.
+     */
+    template <typename Handler>
+    inline bool geometry(Handler& handler, int depth, GeometryHandler::Type type) {
+        if (!hasPosition()) {
+            return value(handler, depth + 1);
+        }
+        switch (type) {
+            case GeometryHandler::POINT:
+                handler.beginGeometry(GeometryHandler::POINT);
+                handler.beginRing(GeometryHandler::VERTEX);
+                if (!readPosition()) {
+                    return false;
+                }
+                flush(handler);
+                handler.endRing();
+                break;
+            case GeometryHandler::LINE_STRING:
+                handler.beginGeometry(GeometryHandler::LINE_STRING);
+                if (!ring(handler, GeometryHandler::LINE)) {
+                    return false;
+                }
+                break;
+            case GeometryHandler::POLYGON:
+                handler.beginGeometry(GeometryHandler::POLYGON);
+                if (!polygon(handler)) {
+                    return false;
+                }
+                break;
+            case GeometryHandler::MULTI_POLYGON:
+                handler.beginGeometry(GeometryHandler::MULTI_POLYGON);
+                if (!consume('[') || !list(']', [&] { return polygon(handler); })) {
+                    return false;
+                }
+                break;
+            default:
+                return false;
+        }
+        handler.endGeometry();
+        return true;
+    }
+
+    /**
+     * Returns whether the array at position holds a value other than arrays, which
+     * stops the scan at the first position of all but empty geometries.
+     */
+    inline bool hasPosition() const {
+        int nesting = 0;
+        for (const char* p = position; p != end; ++p) {
+            switch (*p) {
+                case '[':
+                    ++nesting;
+                    break;
+                case ']':
+                    if (--nesting == 0) {
+                        return false;
+                    }
+                    break;
+                case ',': case ' ': case '\n': case '\r': case '\t':
+                    break;
+                default:
+                    return true;
+            }
+        }
+        return false;
+    }
+
+    template <typename Handler>
+    inline bool polygon(Handler& handler) {
+        GeometryHandler::Ring kind = GeometryHandler::SHELL;
+        return consume('[') && list(']', [&] {
+            bool read = ring(handler, kind);
+            kind = GeometryHandler::HOLE;
+            return read;
+        });
+    }
+
+    template <typename Handler>
+    inline bool ring(Handler& handler, GeometryHandler::Ring kind) {
+        handler.beginRing(kind);
+        if (!consume('[')) {
+            return false;
+        }
+        bool read = list(']', [&] {
+            if (!readPosition()) {
+                return false;
+            }
+            if (buffered == BUFFER) {
+                flush(handler);
+            }
+            return true;
+        });
+        if (!read) {
+            return false;
+        }
+        flush(handler);
+        handler.endRing();
+        return true;
+    }
+
+    /**
+     * Reads a position into the buffer, which has room for it.
+     */
+    inline bool readPosition() {
+        double values[2];
+        size_t count = 0;
+        bool read = consume('[') && list(']', [&] {
+            skipSpace();
+            double coordinate;
+            if (!GeoJsonDecoder::number(&position, end, &coordinate)) {
+                return false;
+            }
+            if (count < 2) {
+                values[count] = coordinate;
+            }
+            ++count;
+            return true;
+        });
+        if (!read || count < 2) {
+            return false;
+        }
+        lngBuffer[buffered] = values[0];
+        latBuffer[buffered] = values[1];
+        ++buffered;
+        return true;
+    }
+
+    template <typename Handler>
+    inline void flush(Handler& handler) {
+        if (buffered != 0) {
+            handler.points(latBuffer, lngBuffer, buffered);
+            buffered = 0;
+        }
+    }
+
+    /**
+     * Reads a JSON number at *p and advances *p past it. Up to 19 significant digits
+     * are gathered in an integer; when it is below 2^53 and the power of ten within
+     * 10^22 both are exact doubles and one multiplication or division rounds correctly.
+     */
+    static inline bool number(const char** p, const char* end, double* result) {
+        static const double POWERS[] = {
+            1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+            1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+        };
+        const char* start = *p;
+        const char* s = start;
+        bool negative = s != end && *s == '-';
+        s += negative;
+        if (s == end || !isDigit(*s)) {
+            return false;
+        }
+        uint64_t mantissa = 0;
+        int digits = 0;
+        int exponent = 0;
+        bool dropped = false;
+        if (*s == '0') {
+            ++s;
+        } else {
+            for (; s != end && isDigit(*s); ++s) {
+                if (digits < 19) {
+                    mantissa = mantissa * 10 + static_cast<uint64_t>(*s - '0');
+                    ++digits;
+                } else {
+                    ++exponent;
+                    dropped = true;
+                }
+            }
+        }
+        if (s != end && *s == '.') {
+            ++s;
+            if (s == end || !isDigit(*s)) {
+                return false;
+            }
+            for (; s != end && isDigit(*s); ++s) {
+                if (digits < 19) {
+                    mantissa = mantissa * 10 + static_cast<uint64_t>(*s - '0');
+                    digits += mantissa != 0;
+                    --exponent;
+                } else {
+                    dropped = true;
+                }
+            }
+        }
+        if (s != end && (*s == 'e' || *s == 'E')) {
+            ++s;
+            bool negativeExponent = s != end && *s == '-';
+            s += s != end && (*s == '-' || *s == '+');
+            if (s == end || !isDigit(*s)) {
+                return false;
+            }
+            int value = 0;
+            for (; s != end && isDigit(*s); ++s) {
+                value = value < 100000 ? value * 10 + (*s - '0') : value;
+            }
+            exponent += negativeExponent ? -value : value;
+        }
+        *p = s;
+
+        if (!dropped && mantissa <= (static_cast<uint64_t>(1) << 53) && exponent >= -22 && exponent <= 22) {
+            double value = static_cast<double>(mantissa);
+            value = exponent < 0 ? value / POWERS[-exponent] : value * POWERS[exponent];
+            *result = negative ? -value : value;
+            return true;
+        }
+        // The rare rest, through a terminated copy.
+        char copy[128];
+        size_t length = static_cast<size_t>(s - start);
+        if (length >= sizeof(copy)) {
+            return false;
+        }
+        std::memcpy(copy, start, length);
+        copy[length] = '\0';
+        *result = std::strtod(copy, nullptr);
+        return true;
+    }
+};
+
+
+/**
+ * Reads WKB and EWKB geometries one after another: Point, LineString, Polygon and
+ * MultiPolygon, in either byte order, with the Z and M values of EWKB flags or ISO type
+ * codes skipped. Coordinates are (x, y), that is longitude then latitude.
+ *
+ * Decoding stops at the end of the data, at a geometry cut short, or at another type;
+ * failed() tells them apart.
+ */
+class WkbDecoder {
+public:
+    WkbDecoder(const uint8_t* data, size_t size)
+        : position(data), end(data + size), error(false), lastSrid(0) {}
+
+    explicit WkbDecoder(const std::string& bytes)
+        : WkbDecoder(reinterpret_cast<const uint8_t*>(bytes.data()), bytes.size()) {}
+
+    // The data is not copied; a temporary string would be gone before decoding.
+    explicit WkbDecoder(std::string&& bytes) = delete;
+
+    /**
+     * Reads the next geometry, calling the handler. Returns false once none is left or
+     * at malformed data, possibly in the middle of the geometry.
+     */
+    template <typename Handler>
+    inline bool decode(Handler& handler) {
+        if (error || position == end) {
+            return false;
+        }
+        lastSrid = 0;
+        if (!geometry(handler)) {
+            error = true;
+            position = end;
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * Returns true when decoding stopped at malformed data rather than at the end.
+     */
+    inline bool failed() const {
+        return error;
+    }
+
+    /**
+     * Returns the SRID of the last geometry, from EWKB, or 0 without.
+     */
+    inline uint32_t srid() const {
+        return lastSrid;
+    }
+
+
+private:
+    static constexpr size_t BUFFER = 256;
+
+    // EWKB flags in the type.
+    static constexpr uint32_t EWKB_Z = 0x80000000;
+    static constexpr uint32_t EWKB_M = 0x40000000;
+    static constexpr uint32_t EWKB_SRID = 0x20000000;
+
+    const uint8_t* position;
+    const uint8_t* end;
+    bool error;
+    uint32_t lastSrid;
+
+    // The byte order and the number of values per point of a geometry.
+    struct Layout {
+        bool bigEndian;
+        size_t dimensions;
+    };
+
+    template <typename Handler>
+    inline bool geometry(Handler& handler) {
+        Layout layout;
+        uint32_t type;
+        if (!header(&layout, &type)) {
+            return false;
+        }
+        uint32_t count = 1;
+        switch (type) {
+            case GeometryHandler::POINT:
+                handler.beginGeometry(GeometryHandler::POINT);
+                if (!ring(handler, GeometryHandler::VERTEX, count, layout)) {
+                    return false;
+                }
+                break;
+            case GeometryHandler::LINE_STRING:
+                handler.beginGeometry(GeometryHandler::LINE_STRING);
+                if (!read(&count, layout) || !ring(handler, GeometryHandler::LINE, count, layout)) {
+                    return false;
+                }
+                break;
+            case GeometryHandler::POLYGON:
+                handler.beginGeometry(GeometryHandler::POLYGON);
+                if (!polygon(handler, layout)) {
+                    return false;
+                }
+                break;
+            case GeometryHandler::MULTI_POLYGON:
+                handler.beginGeometry(GeometryHandler::MULTI_POLYGON);
+                if (!read(&count, layout)) {
+                    return false;
+                }
+                for (uint32_t i = 0; i < count; ++i) {
+                    Layout part;
+                    if (!header(&part, &type) || type != GeometryHandler::POLYGON || !polygon(handler, part)) {
+                        return false;
+                    }
+                }
+                break;
+            default:
+                return false;
+        }
+        handler.endGeometry();
+        return true;
+    }
+
+    /**
+     * Reads the byte order and the type, with its Z, M and SRID flags and the SRID.
+     */
+    inline bool header(Layout* layout, uint32_t* type) {
+        if (position == end || *position > 1) {
+            return false;
+        }
+        layout->bigEndian = *position++ == 0;
+        uint32_t code;
+        if (!read(&code, *layout)) {
+            return false;
+        }
+        bool z = (code & EWKB_Z) != 0;
+        bool m = (code & EWKB_M) != 0;
+        if ((code & EWKB_SRID) != 0 && !read(&lastSrid, *layout)) {
+            return false;
+        }
+        code &= ~(EWKB_Z | EWKB_M | EWKB_SRID);
+        // ISO: 1000 more with Z, 2000 with M, 3000 with both.
+        if (code >= 1000 && code < 4000) {
+            z = z || code / 1000 != 2;
+            m = m || code / 1000 != 1;
+            code %= 1000;
+        }
+        layout->dimensions = 2 + z + m;
+        *type = code;
+        return true;
+    }
+
+    template <typename Handler>
+    inline bool polygon(Handler& handler, const Layout& layout) {
+        uint32_t rings;
+        if (!read(&rings, layout)) {
+            return false;
+        }
+        for (uint32_t i = 0; i < rings; ++i) {
+            uint32_t count;
+            if (!read(&count, layout) || !ring(handler, i == 0 ? GeometryHandler::SHELL : GeometryHandler::HOLE, count, layout)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    template <typename Handler>
+    inline bool ring(Handler& handler, GeometryHandler::Ring kind, uint32_t count, const Layout& layout) {
+        size_t stride = layout.dimensions * 8;
+        if (count > static_cast<size_t>(end - position) / stride) {
+            return false;
+        }
+        handler.beginRing(kind);
+        if (layout.bigEndian) {
+            points<true>(handler, count, stride);
+        } else {
+            points<false>(handler, count, stride);
+        }
+        handler.endRing();
+        return true;
+    }
+
+    /**
+     * Hands out count points at position, which are within the data, in chunks.
+     */
+    template <bool BigEndian, typename Handler>
+    inline void points(Handler& handler, size_t count, size_t stride) {
+        double lat[BUFFER];
+        double lng[BUFFER];
+        const uint8_t* p = position;
+        for (size_t done = 0; done < count;) {
+            size_t n = count - done < BUFFER ? count - done : BUFFER;
+            for (size_t i = 0; i < n; ++i, p += stride) {
+                lng[i] = WkbDecoder::toDouble(WkbDecoder::load<BigEndian, 8>(p));
+                lat[i] = WkbDecoder::toDouble(WkbDecoder::load<BigEndian, 8>(p + 8));
+            }
+            handler.points(lat, lng, n);
+            done += n;
+        }
+        position = p;
+    }
+
+    inline bool read(uint32_t* value, const Layout& layout) {
+        if (end - position < 4) {
+            return false;
+        }
+        *value = static_cast<uint32_t>(layout.bigEndian ? WkbDecoder::load<true, 4>(position) : WkbDecoder::load<false, 4>(position));
+        position += 4;
+        return true;
+    }
+
+    /**
+     * Assembles an integer from its bytes; compilers make it one load, and a byte swap
+     * for the other order.
+     */
+    template <bool BigEndian, size_t Bytes>
+    static inline uint64_t load(const uint8_t* p) {
+        uint64_t value = 0;
+        for (size_t i = 0; i < Bytes; ++i) {
+            value |= static_cast<uint64_t>(p[i]) << (8 * (BigEndian ? Bytes - 1 - i : i));
+        }
+        return value;
+    }
+
+    static inline double toDouble(uint64_t bits) {
+        double value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+};
+
+#endif // GEOMETRY_LIBRARY_GEOMETRY_DECODER
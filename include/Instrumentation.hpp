@@ -0,0 +1,282 @@
+//******************************************************************************
+// Copyright 2013 Google Inc.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// This software and the related documents are provided  as is,  with no express
+// or implied  warranties,  other than  those that are  expressly stated  in the
+// License.
+//******************************************************************************
+
+#ifndef GEOMETRY_LIBRARY_INSTRUMENTATION
+#define GEOMETRY_LIBRARY_INSTRUMENTATION
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+// The hot paths count their work only when GEOMETRY_LIBRARY_INSTRUMENT is defined
+// before the library headers are included; otherwise the macros below expand to
+// nothing and cost nothing. Instrumentation itself is always there, its counters
+// staying at zero.
+#ifdef GEOMETRY_LIBRARY_INSTRUMENT
+#define GEOMETRY_LIBRARY_COUNT(function, event, n) \
+    Instrumentation::add(Instrumentation::function, Instrumentation::event, static_cast<uint64_t>(n))
+#define GEOMETRY_LIBRARY_TIMER(function) \
+    Instrumentation::ScopedTimer geometryLibraryTimer(Instrumentation::function)
+#else
+#define GEOMETRY_LIBRARY_COUNT(function, event, n) ((void) 0)
+#define GEOMETRY_LIBRARY_TIMER(function) ((void) 0)
+#endif
+
+
+/**
+ * Per-thread counters of the work done by the hot functions, and a hook timing
+ * their calls.
+ *
+ * Every thread counts into its own block, with relaxed atomic stores and no shared
+ * cache line; snapshot() sums the blocks of the live threads and of the threads which
+ * have exited. A TimerHook, once set, receives the duration of every call.
+ */
+class Instrumentation {
+public:
+#ifdef GEOMETRY_LIBRARY_INSTRUMENT
+    static constexpr bool ENABLED = true;
+#else
+    static constexpr bool ENABLED = false;
+#endif
+
+    /**
+     * The instrumented functions.
+     */
+    enum Function {
+        CONTAINS_LOCATION = 0,         // PolyUtil::containsLocation(), containsLocationBatch()
+        LOCATION_ON_EDGE_OR_PATH = 1,  // PolyUtil::isLocationOnEdge(), isLocationOnPath() and their index
+                                       // versions, PreparedPath::locationIndexOnEdgeOrPath()
+        PREPARED_POLYGON = 2,          // PreparedPolygon::containsLocation()
+        POLYGON_RASTER = 3,            // PolygonRaster::containsLocation(); edges visited are not
+                                       // broken down by EDGE_ event, nor their trig counted
+        FUNCTION_COUNT = 4,
+    };
+
+    /**
+     * What is counted. An edge the function visits is decided by its longitude span,
+     * by latitudes, or else by trigonometry: EDGES - EDGE_LONGITUDE - EDGE_LATITUDE -
+     * EDGE_CROSS_TRACK edges needed the TRIG evaluations.
+     */
+    enum Event {
+        CALLS = 0,             // Calls of the function
+        EDGES = 1,             // Edges visited
+        TRIG = 2,              // Evaluations of sin, cos, tan, asin, atan, log and exp
+        EXIT_EMPTY = 3,        // Returned at once for an empty polygon or path
+        EXIT_BOUNDS = 4,       // Returned at once outside the cached bounds, band index or grid
+        EXIT_VERTEX = 5,       // Returned early for a point on a vertex, or within tolerance of one
+        EXIT_CELL = 6,         // Returned from a PolygonRaster cell of known state
+        EDGE_LONGITUDE = 7,    // Edges whose longitude span misses the point
+        EDGE_LATITUDE = 8,     // Edges decided by latitude alone, e.g. the lat-lng line shortcut
+        EDGE_CROSS_TRACK = 9,  // Edges too far across track from the point
+        EVENT_COUNT = 10,
+    };
+
+    /**
+     * A copy of the counters.
+     */
+    struct Counters {
+        uint64_t values[FUNCTION_COUNT][EVENT_COUNT];
+
+        inline uint64_t get(Function function, Event event) const {
+            return values[function][event];
+        }
+
+        inline Counters& operator+=(const Counters& other) {
+            for (int f = 0; f < FUNCTION_COUNT; ++f) {
+                for (int e = 0; e < EVENT_COUNT; ++e) {
+                    values[f][e] += other.values[f][e];
+                }
+            }
+            return *this;
+        }
+
+        inline Counters& operator-=(const Counters& other) {
+            for (int f = 0; f < FUNCTION_COUNT; ++f) {
+                for (int e = 0; e < EVENT_COUNT; ++e) {
+                    values[f][e] -= other.values[f][e];
+                }
+            }
+            return *this;
+        }
+    };
+
+    /**
+     * Called with the function and the duration of a call, in nanoseconds, by the thread
+     * making the call; context is the pointer given to setTimerHook().
+     */
+    typedef void (*TimerHook)(Function function, uint64_t nanoseconds, void* context);
+
+    /**
+     * Adds n to a counter of the calling thread.
+     */
+    static inline void add(Function function, Event event, uint64_t n) {
+        std::atomic<uint64_t>& counter = Instrumentation::local().values[function][event];
+        counter.store(counter.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+
+    /**
+     * Returns the counters summed over all threads since the last reset().
+     */
+    static inline Counters snapshot() {
+        Registry& registry = Instrumentation::registry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        Counters total = registry.exited;
+        for (const ThreadCounters* thread : registry.threads) {
+            total += thread->load();
+        }
+        total -= registry.baseline;
+        return total;
+    }
+
+    /**
+     * Returns the counters of the calling thread alone, since it started.
+     */
+    static inline Counters threadSnapshot() {
+        return Instrumentation::local().load();
+    }
+
+    /**
+     * Starts snapshot() over from zero. The threads keep counting meanwhile.
+     */
+    static inline void reset() {
+        Counters total = Instrumentation::snapshot();
+        Registry& registry = Instrumentation::registry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        registry.baseline += total;
+    }
+
+    /**
+     * Sets the hook timing every instrumented call, or removes it with nullptr. Set it
+     * before the threads it should see start calling.
+     */
+    static inline void setTimerHook(TimerHook hook, void* context = nullptr) {
+        Instrumentation::timerContext().store(context, std::memory_order_relaxed);
+        Instrumentation::timerHook().store(hook, std::memory_order_release);
+    }
+
+    static inline const char* functionName(Function function) {
+        static const char* const names[FUNCTION_COUNT] = {
+            "containsLocation", "locationOnEdgeOrPath", "PreparedPolygon", "PolygonRaster",
+        };
+        return names[function];
+    }
+
+    static inline const char* eventName(Event event) {
+        static const char* const names[EVENT_COUNT] = {
+            "calls", "edges", "trig", "exitEmpty", "exitBounds", "exitVertex", "exitCell",
+            "edgeLongitude", "edgeLatitude", "edgeCrossTrack",
+        };
+        return names[event];
+    }
+
+    /**
+     * Times its scope for the TimerHook, if one is set when it is constructed.
+     */
+    class ScopedTimer {
+    public:
+        explicit ScopedTimer(Function function)
+            : function(function), hook(Instrumentation::timerHook().load(std::memory_order_acquire)) {
+            if (hook != nullptr) {
+                start = std::chrono::steady_clock::now();
+            }
+        }
+
+        ~ScopedTimer() {
+            if (hook != nullptr) {
+                auto elapsed = std::chrono::steady_clock::now() - start;
+                hook(function, static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()),
+                     Instrumentation::timerContext().load(std::memory_order_relaxed));
+            }
+        }
+
+        ScopedTimer(const ScopedTimer&) = delete;
+        ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+    private:
+        Function function;
+        TimerHook hook;
+        std::chrono::steady_clock::time_point start;
+    };
+
+
+private:
+    // The block of one thread. Only its thread stores; snapshot() loads from any thread.
+    struct ThreadCounters {
+        std::atomic<uint64_t> values[FUNCTION_COUNT][EVENT_COUNT];
+
+        ThreadCounters() {
+            for (auto& row : values) {
+                for (auto& value : row) {
+                    value.store(0, std::memory_order_relaxed);
+                }
+            }
+            Registry& registry = Instrumentation::registry();
+            std::lock_guard<std::mutex> lock(registry.mutex);
+            registry.threads.push_back(this);
+        }
+
+        ~ThreadCounters() {
+            Registry& registry = Instrumentation::registry();
+            std::lock_guard<std::mutex> lock(registry.mutex);
+            registry.exited += load();
+            for (auto& thread : registry.threads) {
+                if (thread == this) {
+                    thread = registry.threads.back();
+                    registry.threads.pop_back();
+                    break;
+                }
+            }
+        }
+
+        inline Counters load() const {
+            Counters counters;
+            for (int f = 0; f < FUNCTION_COUNT; ++f) {
+                for (int e = 0; e < EVENT_COUNT; ++e) {
+                    counters.values[f][e] = values[f][e].load(std::memory_order_relaxed);
+                }
+            }
+            return counters;
+        }
+    };
+
+    struct Registry {
+        std::mutex mutex;
+        std::vector<ThreadCounters*> threads;
+        Counters exited = {};     // Sum of the threads which have exited
+        Counters baseline = {};   // Sum at the last reset()
+    };
+
+    static inline Registry& registry() {
+        static Registry registry;
+        return registry;
+    }
+
+    static inline ThreadCounters& local() {
+        static thread_local ThreadCounters counters;
+        return counters;
+    }
+
+    static inline std::atomic<TimerHook>& timerHook() {
+        static std::atomic<TimerHook> hook(nullptr);
+        return hook;
+    }
+
+    static inline std::atomic<void*>& timerContext() {
+        static std::atomic<void*> context(nullptr);
+        return context;
+    }
+};
+
+#endif // GEOMETRY_LIBRARY_INSTRUMENTATION
@@ -15,11 +15,22 @@
 #define GEOMETRY_LIBRARY_LATLNG
 
 #include <cmath>
+#include <type_traits>
 
-class LatLng {
+/**
+ * A location with coordinates of type T, double or float. LatLng is LatLngT<double>;
+ * LatLngF, at 8 bytes per point, halves the memory of large stores.
+ *
+ * A LatLngF converts implicitly to a LatLng, so every function taking a LatLng takes
+ * it too, computing in double; the conversion the other way rounds and is explicit.
+ */
+template <typename T>
+class LatLngT {
 public:
-    double lat; // The latitude  of this location
-    double lng; // The longitude of this location
+    typedef T value_type;
+
+    T lat; // The latitude  of this location
+    T lng; // The longitude of this location
 
     /**
      * Constructs a location with a latitude/longitude pair.
@@ -27,23 +38,40 @@ public:
      * @param lat   The latitude  of this location.
      * @param lng   The longitude of this location.
      */
-    LatLng(double lat, double lng)
+    LatLngT(T lat, T lng)
         : lat(lat), lng(lng) {}
 
-    LatLng(const LatLng & point) = default;
+    LatLngT(const LatLngT & point) = default;
+
+    /**
+     * Converts a location of a type no wider than T.
+     */
+    template <typename U, typename std::enable_if<(sizeof(U) < sizeof(T)), int>::type = 0>
+    LatLngT(const LatLngT<U> & point)
+        : lat(point.lat), lng(point.lng) {}
+
+    /**
+     * Converts a location of a wider type, rounding its coordinates.
+     */
+    template <typename U, typename std::enable_if<(sizeof(U) > sizeof(T)), int>::type = 0>
+    explicit LatLngT(const LatLngT<U> & point)
+        : lat(static_cast<T>(point.lat)), lng(static_cast<T>(point.lng)) {}
 
-    LatLng& operator=(const LatLng & other) = default;
+    LatLngT& operator=(const LatLngT & other) = default;
 
-    bool operator==(const LatLng & other) const {
+    bool operator==(const LatLngT & other) const {
         return isCoordinateEqual(lat, other.lat) && 
                isCoordinateEqual(lng, other.lng);
     }
 
 
 private:
-    bool isCoordinateEqual(double first, double second) const {
+    bool isCoordinateEqual(T first, T second) const {
         return std::fabs(first - second) < 1e-12;
     }
 };
 
+typedef LatLngT<double> LatLng;
+typedef LatLngT<float>  LatLngF;
+
 #endif // GEOMETRY_LIBRARY_LATLNG
@@ -0,0 +1,338 @@
+//******************************************************************************
+// Copyright 2013 Google Inc.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// This software and the related documents are provided  as is,  with no express
+// or implied  warranties,  other than  those that are  expressly stated  in the
+// License.
+//******************************************************************************
+
+#ifndef GEOMETRY_LIBRARY_LATLNG_ARRAY
+#define GEOMETRY_LIBRARY_LATLNG_ARRAY
+
+#include <cstdint>
+#include <cstdlib>
+#include <iterator>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+#include "MathUtil.hpp"
+#include "LatLng.hpp"
+#include "UnitVec3.hpp"
+
+
+/**
+ * Allocator returning memory aligned to Alignment bytes (a cache line by default),
+ * so SIMD kernels can stream the columns of a LatLngArray with aligned loads.
+ */
+template <typename T, size_t Alignment = 64>
+class AlignedAllocator {
+public:
+    typedef T value_type;
+
+    template <typename U>
+    struct rebind {
+        typedef AlignedAllocator<U, Alignment> other;
+    };
+
+    AlignedAllocator() = default;
+
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U, Alignment>&) {}
+
+    inline T* allocate(size_t n) {
+        // Over-allocate and keep the pointer returned by malloc() right before the aligned block.
+        void* raw = std::malloc(n * sizeof(T) + Alignment + sizeof(void*));
+        if (raw == nullptr) {
+            throw std::bad_alloc();
+        }
+        uintptr_t start = reinterpret_cast<uintptr_t>(raw) + sizeof(void*);
+        uintptr_t aligned = (start + Alignment - 1) & ~static_cast<uintptr_t>(Alignment - 1);
+        reinterpret_cast<void**>(aligned)[-1] = raw;
+        return reinterpret_cast<T*>(aligned);
+    }
+
+    inline void deallocate(T* p, size_t) {
+        std::free(reinterpret_cast<void**>(p)[-1]);
+    }
+
+    template <typename U>
+    inline bool operator==(const AlignedAllocator<U, Alignment>&) const {
+        return true;
+    }
+
+    template <typename U>
+    inline bool operator!=(const AlignedAllocator<U, Alignment>&) const {
+        return false;
+    }
+};
+
+
+/**
+ * A structure-of-arrays LatLngList: latitudes and longitudes are stored in separate,
+ * contiguous, aligned columns. Optionally the container also keeps the radians,
+ * sin/cos and ECEF unit vector (x, y, z on the unit sphere) of every point, computed
+ * once on insertion.
+ *
+ * It can be passed to every SphericalUtil and PolyUtil template. Its vertices carry
+ * their radians, so those templates skip the per-call deg2rad() conversions (see
+ * latRadians() in MathUtil.hpp); results are identical to a std::vector<LatLng>.
+ */
+class LatLngArray {
+public:
+    typedef std::vector<double, AlignedAllocator<double> > Column;
+
+    /**
+     * Values cached per point, combined as a bit mask.
+     */
+    enum Cache {
+        NONE         = 0,
+        RADIANS      = 1,  // latRad, lngRad
+        TRIG         = 2,  // sinLat, cosLat, sinLng, cosLng; implies RADIANS
+        UNIT_VECTORS = 4,  // x, y, z; implies RADIANS
+    };
+
+    /**
+     * A point handed out by the container. Carries the radians of the point, read
+     * from the cache when present.
+     */
+    struct Vertex {
+        double lat;     // The latitude  of this location
+        double lng;     // The longitude of this location
+        double latRad;  // The latitude  in radians
+        double lngRad;  // The longitude in radians
+
+        inline operator LatLng() const {
+            return LatLng(lat, lng);
+        }
+
+        friend inline double latRadians(const Vertex& vertex) {
+            return vertex.latRad;
+        }
+
+        friend inline double lngRadians(const Vertex& vertex) {
+            return vertex.lngRad;
+        }
+    };
+
+    class const_iterator {
+    public:
+        typedef std::random_access_iterator_tag iterator_category;
+        typedef Vertex    value_type;
+        typedef ptrdiff_t difference_type;
+        typedef const Vertex* pointer;
+        typedef Vertex    reference;
+
+        const_iterator(const LatLngArray* array, size_t index) : array(array), index(index) {}
+
+        inline Vertex operator*() const { return (*array)[index]; }
+        inline Vertex operator[](difference_type n) const { return (*array)[index + n]; }
+        inline const_iterator& operator++() { ++index; return *this; }
+        inline const_iterator& operator--() { --index; return *this; }
+        inline const_iterator operator++(int) { const_iterator copy = *this; ++index; return copy; }
+        inline const_iterator operator--(int) { const_iterator copy = *this; --index; return copy; }
+        inline const_iterator& operator+=(difference_type n) { index += n; return *this; }
+        inline const_iterator& operator-=(difference_type n) { index -= n; return *this; }
+        inline const_iterator operator+(difference_type n) const { return const_iterator(array, index + n); }
+        inline const_iterator operator-(difference_type n) const { return const_iterator(array, index - n); }
+        inline difference_type operator-(const const_iterator& other) const { return static_cast<difference_type>(index - other.index); }
+        inline bool operator==(const const_iterator& other) const { return index == other.index; }
+        inline bool operator!=(const const_iterator& other) const { return index != other.index; }
+        inline bool operator<(const const_iterator& other) const { return index < other.index; }
+
+    private:
+        const LatLngArray* array;
+        size_t index;
+    };
+
+    typedef const_iterator iterator;
+    typedef Vertex value_type;
+
+    explicit LatLngArray(unsigned caches = NONE)
+        : cached(LatLngArray::normalize(caches)) {}
+
+    /**
+     * Copies any LatLngList.
+     */
+    template <typename LatLngList, typename = typename std::enable_if<std::is_class<LatLngList>::value>::type>
+    explicit LatLngArray(const LatLngList& points, unsigned caches = NONE)
+        : cached(LatLngArray::normalize(caches)) {
+        reserve(points.size());
+        for (const auto& point : points) {
+            push_back(point);
+        }
+    }
+
+    inline void push_back(const LatLng& point) {
+        latColumn.push_back(point.lat);
+        lngColumn.push_back(point.lng);
+        if (cached != NONE) {
+            appendCaches(latColumn.size() - 1, cached);
+        }
+    }
+
+    inline void reserve(size_t capacity) {
+        for (auto column : columns(cached | COORDINATES)) {
+            column->reserve(capacity);
+        }
+    }
+
+    inline void clear() {
+        for (auto column : columns(cached | COORDINATES)) {
+            column->clear();
+        }
+    }
+
+    inline size_t size() const {
+        return latColumn.size();
+    }
+
+    inline bool empty() const {
+        return latColumn.empty();
+    }
+
+    inline Vertex operator[](size_t i) const {
+        Vertex vertex;
+        vertex.lat = latColumn[i];
+        vertex.lng = lngColumn[i];
+        vertex.latRad = (cached & RADIANS) != 0 ? latRadColumn[i] : deg2rad(vertex.lat);
+        vertex.lngRad = (cached & RADIANS) != 0 ? lngRadColumn[i] : deg2rad(vertex.lng);
+        return vertex;
+    }
+
+    /**
+     * Returns the unit vector of point i, read from the cache when present.
+     */
+    inline UnitVec3 unitVector(size_t i) const {
+        if ((cached & UNIT_VECTORS) != 0) {
+            return UnitVec3(xColumn[i], yColumn[i], zColumn[i]);
+        }
+        return UnitVec3(LatLng(latColumn[i], lngColumn[i]));
+    }
+
+    inline const_iterator begin() const {
+        return const_iterator(this, 0);
+    }
+
+    inline const_iterator end() const {
+        return const_iterator(this, size());
+    }
+
+    /**
+     * Returns the cached values, a combination of Cache flags.
+     */
+    inline unsigned caches() const {
+        return cached;
+    }
+
+    /**
+     * Computes additional cached values for all points, now and on later insertions.
+     */
+    inline void cache(unsigned caches) {
+        unsigned added = LatLngArray::normalize(caches) & ~cached;
+        if (added == 0) {
+            return;
+        }
+        for (auto column : columns(added)) {
+            column->reserve(latColumn.capacity());
+        }
+        for (size_t i = 0; i < size(); ++i) {
+            appendCaches(i, added);
+        }
+        cached |= added;
+    }
+
+    // Columns, size() elements each; null when the values are not cached (or the array is empty).
+    inline const double* lat() const { return latColumn.data(); }
+    inline const double* lng() const { return lngColumn.data(); }
+    inline const double* latRad() const { return column(RADIANS, latRadColumn); }
+    inline const double* lngRad() const { return column(RADIANS, lngRadColumn); }
+    inline const double* sinLat() const { return column(TRIG, sinLatColumn); }
+    inline const double* cosLat() const { return column(TRIG, cosLatColumn); }
+    inline const double* sinLng() const { return column(TRIG, sinLngColumn); }
+    inline const double* cosLng() const { return column(TRIG, cosLngColumn); }
+    inline const double* x() const { return column(UNIT_VECTORS, xColumn); }
+    inline const double* y() const { return column(UNIT_VECTORS, yColumn); }
+    inline const double* z() const { return column(UNIT_VECTORS, zColumn); }
+
+
+private:
+    static constexpr unsigned COORDINATES = 1U << 8;  // The lat and lng columns, for columns()
+
+    unsigned cached;
+    Column latColumn;
+    Column lngColumn;
+    Column latRadColumn;
+    Column lngRadColumn;
+    Column sinLatColumn;
+    Column cosLatColumn;
+    Column sinLngColumn;
+    Column cosLngColumn;
+    Column xColumn;
+    Column yColumn;
+    Column zColumn;
+
+    static inline unsigned normalize(unsigned caches) {
+        return caches & (TRIG | UNIT_VECTORS) ? caches | RADIANS : caches;
+    }
+
+    inline const double* column(Cache cache, const Column& values) const {
+        return (cached & cache) != 0 ? values.data() : nullptr;
+    }
+
+    /**
+     * Returns the columns holding the given caches.
+     */
+    inline std::vector<Column*> columns(unsigned caches) {
+        std::vector<Column*> result;
+        if (caches & COORDINATES) {
+            result.insert(result.end(), { &latColumn, &lngColumn });
+        }
+        if (caches & RADIANS) {
+            result.insert(result.end(), { &latRadColumn, &lngRadColumn });
+        }
+        if (caches & TRIG) {
+            result.insert(result.end(), { &sinLatColumn, &cosLatColumn, &sinLngColumn, &cosLngColumn });
+        }
+        if (caches & UNIT_VECTORS) {
+            result.insert(result.end(), { &xColumn, &yColumn, &zColumn });
+        }
+        return result;
+    }
+
+    /**
+     * Appends the given caches of point i; points before i already have them.
+     */
+    inline void appendCaches(size_t i, unsigned caches) {
+        double latRad = deg2rad(latColumn[i]);
+        double lngRad = deg2rad(lngColumn[i]);
+        if (caches & RADIANS) {
+            latRadColumn.push_back(latRad);
+            lngRadColumn.push_back(lngRad);
+        }
+        if (caches & (TRIG | UNIT_VECTORS)) {
+            double sinLat = sin(latRad);
+            double cosLat = cos(latRad);
+            double sinLng = sin(lngRad);
+            double cosLng = cos(lngRad);
+            if (caches & TRIG) {
+                sinLatColumn.push_back(sinLat);
+                cosLatColumn.push_back(cosLat);
+                sinLngColumn.push_back(sinLng);
+                cosLngColumn.push_back(cosLng);
+            }
+            if (caches & UNIT_VECTORS) {
+                xColumn.push_back(cosLat * cosLng);
+                yColumn.push_back(cosLat * sinLng);
+                zColumn.push_back(sinLat);
+            }
+        }
+    }
+};
+
+#endif // GEOMETRY_LIBRARY_LATLNG_ARRAY
@@ -0,0 +1,352 @@
+//******************************************************************************
+// Copyright 2013 Google Inc.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// This software and the related documents are provided  as is,  with no express
+// or implied  warranties,  other than  those that are  expressly stated  in the
+// License.
+//******************************************************************************
+
+#ifndef GEOMETRY_LIBRARY_LATLNG_BOUNDS
+#define GEOMETRY_LIBRARY_LATLNG_BOUNDS
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <utility>
+
+#include "MathUtil.hpp"
+#include "LatLng.hpp"
+#include "Policies.hpp"
+
+
+/**
+ * A latitude/longitude rectangle: the latitudes from southwest.lat to northeast.lat
+ * and the longitudes eastward from southwest.lng to northeast.lng. When
+ * southwest.lng > northeast.lng the bounds cross the antimeridian; from -180 to 180
+ * they cover every longitude.
+ *
+ * The default bounds are empty: they contain nothing, and extend() makes them the
+ * bounds of the first point.
+ */
+class LatLngBounds {
+public:
+    // Margin, in degrees (about 0.1 mm), added by fromPath() and fromPolygon() to
+    // absorb the rounding of the PolyUtil tests near the bounds.
+    static constexpr double MARGIN = 1e-9;
+
+    LatLng southwest; // The south-west corner of the bounds
+    LatLng northeast; // The north-east corner of the bounds
+
+    LatLngBounds()
+        : southwest(90, 0), northeast(-90, 0) {}
+
+    /**
+     * Constructs the bounds with the given corners; southwest.lng > northeast.lng
+     * crosses the antimeridian.
+     */
+    LatLngBounds(const LatLng& southwest, const LatLng& northeast)
+        : southwest(southwest), northeast(northeast) {}
+
+    LatLngBounds(const LatLngBounds & bounds) = default;
+
+    LatLngBounds& operator=(const LatLngBounds & other) = default;
+
+    /**
+     * Returns the bounds of a polyline: of its vertices and of the segments between
+     * them. Great circle segments bulge poleward of their ends, rhumb ones do not; the
+     * bounds of geodesic segments hold the rhumb ones too. A point within some distance
+     * of the polyline is within expanded(distance) of them.
+     */
+    template <typename LatLngList>
+    static inline LatLngBounds fromPath(const LatLngList& path, bool geodesic = true) {
+        return LatLngBounds::fromVertices(path, false, geodesic);
+    }
+
+    /**
+     * Returns the bounds of a polygon: of its edges, the closing one included, and of
+     * the points PolyUtil::containsLocation() finds inside, with the edges as for
+     * fromPath(). A polygon winding around a pole, or with an edge through a pole, is
+     * bounded up to the North Pole.
+     */
+    template <typename LatLngList>
+    static inline LatLngBounds fromPolygon(const LatLngList& polygon, bool geodesic = true) {
+        return LatLngBounds::fromVertices(polygon, true, geodesic);
+    }
+
+    inline bool isEmpty() const {
+        return southwest.lat > northeast.lat;
+    }
+
+    /**
+     * Computes whether the bounds cover every longitude.
+     */
+    inline bool isFullLng() const {
+        return lngSpan() >= 360;
+    }
+
+    /**
+     * Computes whether the given point lies within the bounds, edges included.
+     * The longitude of the point is wrapped as by MathUtil::wrap().
+     */
+    inline bool contains(const LatLng& point) const {
+        return point.lat >= southwest.lat && point.lat <= northeast.lat && containsLng(point.lng);
+    }
+
+    /**
+     * Computes whether the given bounds lie within these.
+     */
+    inline bool contains(const LatLngBounds& other) const {
+        if (other.isEmpty()) {
+            return true;
+        }
+        if (isEmpty() || other.southwest.lat < southwest.lat || other.northeast.lat > northeast.lat) {
+            return false;
+        }
+        return isFullLng() || MathUtil::mod(other.southwest.lng - southwest.lng, 360.0) + other.lngSpan() <= lngSpan();
+    }
+
+    /**
+     * Computes whether the bounds share a point with the given ones.
+     */
+    inline bool intersects(const LatLngBounds& other) const {
+        if (isEmpty() || other.isEmpty()) {
+            return false;
+        }
+        return std::max(southwest.lat, other.southwest.lat) <= std::min(northeast.lat, other.northeast.lat) &&
+               (containsLng(other.southwest.lng) || other.containsLng(southwest.lng));
+    }
+
+    /**
+     * Extends the bounds to the given point. Of the two ways around the globe, the
+     * longitudes grow in the shorter one, eastward on a tie.
+     */
+    inline LatLngBounds& extend(const LatLng& point) {
+        double lng = MathUtil::wrap(point.lng, -180, 180);
+        if (isEmpty()) {
+            southwest = LatLng(point.lat, lng);
+            northeast = LatLng(point.lat, lng);
+            return *this;
+        }
+        southwest.lat = std::min(southwest.lat, point.lat);
+        northeast.lat = std::max(northeast.lat, point.lat);
+        if (!containsLng(lng)) {
+            if (MathUtil::mod(lng - northeast.lng, 360.0) <= MathUtil::mod(southwest.lng - lng, 360.0)) {
+                northeast.lng = lng;
+            } else {
+                southwest.lng = lng;
+            }
+        }
+        return *this;
+    }
+
+    /**
+     * Extends the bounds to the union with the given ones. Disjoint longitude ranges
+     * are joined across the shorter of the two gaps between them.
+     */
+    inline LatLngBounds& extend(const LatLngBounds& other) {
+        if (other.isEmpty()) {
+            return *this;
+        }
+        if (isEmpty()) {
+            return *this = other;
+        }
+        southwest.lat = std::min(southwest.lat, other.southwest.lat);
+        northeast.lat = std::max(northeast.lat, other.northeast.lat);
+
+        double span = lngSpan();
+        double otherSpan = other.lngSpan();
+        double offset = MathUtil::mod(other.southwest.lng - southwest.lng, 360.0);
+        if (offset <= span) {
+            setLng(southwest.lng, std::max(span, offset + otherSpan));
+        } else if (MathUtil::mod(southwest.lng - other.southwest.lng, 360.0) <= otherSpan) {
+            setLng(other.southwest.lng, std::max(otherSpan, 360 - offset + span));
+        } else {
+            // Disjoint: gapEast from here to the other bounds, gapWest back.
+            double gapEast = offset - span;
+            double gapWest = 360 - offset - otherSpan;
+            if (gapEast <= gapWest) {
+                setLng(southwest.lng, offset + otherSpan);
+            } else {
+                setLng(other.southwest.lng, 360 - offset + span);
+            }
+        }
+        return *this;
+    }
+
+    /**
+     * Returns the bounds of the points within the given distance, in meters, of
+     * these, on the sphere of the Model policy (see Policies.hpp). Bounds reaching
+     * a pole cover every longitude.
+     */
+    template <typename Model = EarthSphere>
+    inline LatLngBounds expanded(double distance) const {
+        if (isEmpty()) {
+            return *this;
+        }
+        double angle = distance / Model::RADIUS;
+        double latMargin = rad2deg(angle);
+        if (southwest.lat - latMargin <= -90 || northeast.lat + latMargin >= 90) {
+            return LatLngBounds::widened(latMargin, 360);
+        }
+        // A point at latitude lat and angle from a center moves its longitude by at
+        // most asin(sin(angle) / cos(lat)); the poleward edge has the largest.
+        double maxLat = deg2rad(std::max(std::fabs(southwest.lat), std::fabs(northeast.lat)));
+        double sinLng = std::sin(angle) / std::cos(maxLat);
+        return LatLngBounds::widened(latMargin, sinLng >= 1 ? 360 : rad2deg(std::asin(sinLng)));
+    }
+
+    bool operator==(const LatLngBounds & other) const {
+        return southwest == other.southwest && northeast == other.northeast;
+    }
+
+
+private:
+    /**
+     * Returns the width of the longitude range, in [0, 360].
+     */
+    inline double lngSpan() const {
+        double span = northeast.lng - southwest.lng;
+        return span >= 0 ? span : span + 360;
+    }
+
+    inline bool containsLng(double lng) const {
+        return MathUtil::mod(lng - southwest.lng, 360.0) <= lngSpan();
+    }
+
+    /**
+     * Sets the longitude range to span degrees eastward of west.
+     */
+    inline void setLng(double west, double span) {
+        if (span >= 360) {
+            southwest.lng = -180;
+            northeast.lng = 180;
+        } else {
+            southwest.lng = west;
+            northeast.lng = MathUtil::wrap(west + span, -180, 180);
+        }
+    }
+
+    /**
+     * Returns the bounds grown by the given margins, in degrees, on every side.
+     */
+    inline LatLngBounds widened(double latMargin, double lngMargin) const {
+        LatLngBounds bounds(*this);
+        bounds.southwest.lat = std::max(southwest.lat - latMargin, -90.0);
+        bounds.northeast.lat = std::min(northeast.lat + latMargin, 90.0);
+        bounds.setLng(MathUtil::wrap(southwest.lng - lngMargin, -180, 180), lngSpan() + 2 * lngMargin);
+        return bounds;
+    }
+
+    /**
+     * The bounds of fromPath() or, if closed, fromPolygon(). The longitudes are
+     * unwrapped along the segments, each running the shorter way as in the PolyUtil
+     * tests; a closed ring ending a turn away from its start winds around a pole.
+     */
+    template <typename LatLngList>
+    static inline LatLngBounds fromVertices(const LatLngList& list, bool closed, bool geodesic) {
+        size_t size = list.size();
+        if (size == 0) {
+            return LatLngBounds();
+        }
+        auto first = list[closed ? size - 1 : 0];
+        double lat1 = first.lat;
+        double lng1 = first.lng;
+        double south = lat1;
+        double north = lat1;
+        double lng = 0;
+        double minLng = 0;
+        double maxLng = 0;
+        bool blocked = false;
+
+        for (auto val : list) {
+            double lat2 = val.lat;
+            double lng2 = val.lng;
+            double dLng = MathUtil::wrap(lng2 - lng1, -180, 180);
+            south = std::min(south, lat2);
+            north = std::max(north, lat2);
+            if (geodesic) {
+                MathUtil::extendGreatCircleLatRange(lat1, lat2, dLng, &south, &north);
+            }
+            // The segments containsLocation() never crosses.
+            blocked = blocked || std::fabs(lat1) >= 90 || std::fabs(lat2) >= 90 || dLng <= -180;
+
+            lng += dLng;
+            minLng = std::min(minLng, lng);
+            maxLng = std::max(maxLng, lng);
+            lat1 = lat2;
+            lng1 = lng2;
+        }
+
+        bool winding = closed && std::fabs(lng) > 180;
+        if (closed && (winding || blocked)) {
+            north = 90;
+        }
+        double west = first.lng + minLng;
+        double span = winding ? 360 : maxLng - minLng;
+        LatLngBounds bounds(LatLng(south, 0), LatLng(north, 0));
+        bounds.setLng(MathUtil::wrap(west, -180, 180), span);
+        return bounds.widened(MARGIN, MARGIN);
+    }
+};
+
+
+/**
+ * A LatLngList with its LatLngBounds::fromPolygon(), computed once. It is itself a
+ * LatLngList; PolyUtil::containsLocation(), isLocationOnEdge(), isLocationOnPath()
+ * and the other PolyUtil queries given a Bounded list first test the point against
+ * the bounds, so a point far away returns after a few comparisons. Answers are
+ * identical to the ones for the plain list.
+ *
+ * The list is stored by value: move a large one in, or use a reference type for
+ * LatLngList.
+ */
+template <typename LatLngList>
+class Bounded {
+public:
+    explicit Bounded(LatLngList points)
+        : points(std::move(points)), box(LatLngBounds::fromPolygon(this->points)) {}
+
+    inline const LatLngBounds& bounds() const {
+        return box;
+    }
+
+    inline const LatLngList& list() const {
+        return points;
+    }
+
+    inline size_t size() const {
+        return points.size();
+    }
+
+    inline decltype(auto) operator[](size_t i) const {
+        return points[i];
+    }
+
+    inline auto begin() const {
+        return points.begin();
+    }
+
+    inline auto end() const {
+        return points.end();
+    }
+
+
+private:
+    LatLngList points;
+    LatLngBounds box;
+};
+
+/**
+ * Returns the Bounded list of the given one, e.g. makeBounded(std::move(zone)).
+ */
+template <typename LatLngList>
+inline Bounded<typename std::decay<LatLngList>::type> makeBounded(LatLngList&& list) {
+    return Bounded<typename std::decay<LatLngList>::type>(std::forward<LatLngList>(list));
+}
+
+#endif // GEOMETRY_LIBRARY_LATLNG_BOUNDS
@@ -16,6 +16,7 @@
 #define GEOMETRY_LIBRARY_MATH_UTIL
 
 #include <cmath>
+#include <cstddef>
 #include <algorithm>
 
 #define M_PI 3.14159265358979323846
@@ -28,7 +29,34 @@ inline double rad2deg(double angle) {
     return angle * 180.0 / M_PI;
 }
 
+/**
+ * Returns the latitude of a path vertex in radians. The path templates read
+ * vertices through these two functions, so containers caching radians
+ * (see LatLngArray) can hand out vertices that overload them.
+ */
+template <typename Point>
+inline double latRadians(const Point& point) {
+    return deg2rad(point.lat);
+}
+
+/**
+ * Returns the longitude of a path vertex in radians.
+ */
+template <typename Point>
+inline double lngRadians(const Point& point) {
+    return deg2rad(point.lng);
+}
+
+/**
+ * The functions of MathUtil compute in the type of their first argument, double or
+ * float; the other arguments are converted to it.
+ */
 class MathUtil {
+    template <typename T>
+    struct Same {
+        typedef T type;
+    };
+
 public:
     /**
      * The earth's radius, in meters.
@@ -39,7 +67,8 @@ public:
     /**
      * Restrict x to the range [low, high].
      */
-    static inline double clamp(double x, double low, double high) {
+    template <typename Real>
+    static inline Real clamp(Real x, typename Same<Real>::type low, typename Same<Real>::type high) {
         return x < low ? low : (x > high ? high : x);
     }
 
@@ -49,7 +78,8 @@ public:
      * @param min The minimum.
      * @param max The maximum.
      */
-    static inline double wrap(double n, double min, double max) {
+    template <typename Real>
+    static inline Real wrap(Real n, typename Same<Real>::type min, typename Same<Real>::type max) {
         return (n >= min && n < max) ? n : (MathUtil::mod(n - min, max - min) + min);
     }
 
@@ -58,31 +88,35 @@ public:
      * @param x The operand.
      * @param m The modulus.
      */
-    static inline double mod(double x, double m) {
-        return remainder(remainder(x, m) + m, m);
+    template <typename Real>
+    static inline Real mod(Real x, typename Same<Real>::type m) {
+        return std::fmod(std::fmod(x, m) + m, m);
     }
 
     /**
      * Returns mercator Y corresponding to latitude.
      * See http://en.wikipedia.org/wiki/Mercator_projection .
      */
-    static inline double mercator(double lat) {
-        return log(tan(lat * 0.5 + M_PI / 4.0));
+    template <typename Real>
+    static inline Real mercator(Real lat) {
+        return std::log(std::tan(lat * Real(0.5) + Real(M_PI / 4.0)));
     }
 
     /**
      * Returns latitude from mercator Y.
      */
-    static inline double inverseMercator(double y) {
-        return 2.0 * atan(exp(y)) - M_PI / 2.0;
+    template <typename Real>
+    static inline Real inverseMercator(Real y) {
+        return Real(2.0) * std::atan(std::exp(y)) - Real(M_PI / 2.0);
     }
 
     /**
      * Returns haversine(angle-in-radians).
      * hav(x) == (1 - cos(x)) / 2 == sin(x / 2)^2.
      */
-    static inline double hav(double x) {
-        double sinHalf = sin(x * 0.5);
+    template <typename Real>
+    static inline Real hav(Real x) {
+        Real sinHalf = std::sin(x * Real(0.5));
         return sinHalf * sinHalf;
     }
 
@@ -91,34 +125,130 @@ public:
      * arcHav(x) == acos(1 - 2 * x) == 2 * asin(sqrt(x)).
      * The argument must be in [0, 1], and the result is positive.
      */
-    static inline double arcHav(double x) {
-        return 2.0 * asin(sqrt(x));
+    template <typename Real>
+    static inline Real arcHav(Real x) {
+        return Real(2.0) * std::asin(std::sqrt(x));
     }
 
     // Given h==hav(x), returns sin(abs(x)).
-    static inline double sinFromHav(double h) {
-        return 2.0 * sqrt(h * (1.0 - h));
+    template <typename Real>
+    static inline Real sinFromHav(Real h) {
+        return Real(2.0) * std::sqrt(h * (Real(1.0) - h));
     }
 
     // Returns hav(asin(x)).
-    static inline double havFromSin(double x) {
-        double x2 = x * x;
-        return x2 / (1.0 + sqrt(1.0 - x2)) * 0.5;
+    template <typename Real>
+    static inline Real havFromSin(Real x) {
+        Real x2 = x * x;
+        return x2 / (Real(1.0) + std::sqrt(Real(1.0) - x2)) * Real(0.5);
     }
 
     // Returns sin(arcHav(x) + arcHav(y)).
-    static inline double sinSumFromHav(double x, double y) {
-        double a = sqrt(x * (1 - x));
-        double b = sqrt(y * (1 - y));
-        return 2.0 * (a + b - 2 * (a * y + b * x));
+    template <typename Real>
+    static inline Real sinSumFromHav(Real x, typename Same<Real>::type y) {
+        Real a = std::sqrt(x * (1 - x));
+        Real b = std::sqrt(y * (1 - y));
+        return Real(2.0) * (a + b - 2 * (a * y + b * x));
     }
 
     /**
      * Returns hav() of distance from (lat1, lng1) to (lat2, lng2) on the unit sphere.
      */
-    static inline double havDistance(double lat1, double lat2, double dLng) {
-        return MathUtil::hav(lat1 - lat2) + MathUtil::hav(dLng) * cos(lat1) * cos(lat2);
+    template <typename Real>
+    static inline Real havDistance(Real lat1, typename Same<Real>::type lat2, typename Same<Real>::type dLng) {
+        return MathUtil::hav(lat1 - lat2) + MathUtil::hav(dLng) * std::cos(lat1) * std::cos(lat2);
+    }
+
+    /**
+     * Widens [*minLat, *maxLat] to the extreme latitude of the great circle segment from
+     * (lat1, lng1) to (lat2, lng1 + dLng), when it lies between the ends. Degrees.
+     */
+    static inline void extendGreatCircleLatRange(double lat1, double lat2, double dLng, double* minLat, double* maxLat) {
+        double phi1 = deg2rad(lat1);
+        double phi2 = deg2rad(lat2);
+        // With the start on the prime meridian; only the z coordinates matter.
+        double az = sin(phi1);
+        double bz = sin(phi2);
+        double cosAngle = MathUtil::clamp(cos(phi1) * cos(phi2) * cos(deg2rad(dLng)) + az * bz, -1, 1);
+        double angle = acos(cosAngle);
+        double sinAngle = sin(angle);
+        if (sinAngle < 1e-12) {
+            return;
+        }
+        // z(t) = az * cos(t) + cz * sin(t) along the segment, t in [0, angle].
+        double cz = (bz - az * cosAngle) / sinAngle;
+        double peak = atan2(cz, az);
+        for (double t : { peak, peak - M_PI, peak + M_PI }) {
+            if (t > 0 && t < angle) {
+                double lat = rad2deg(asin(MathUtil::clamp(az * cos(t) + cz * sin(t), -1, 1)));
+                *minLat = std::min(*minLat, lat);
+                *maxLat = std::max(*maxLat, lat);
+            }
+        }
+    }
+};
+
+/**
+ * A running sum with Neumaier's compensation: the rounding error of every addition is
+ * kept apart and added back at the end, so the result is nearly as accurate as a sum
+ * in twice the precision, whatever the order of magnitude of the terms.
+ */
+class CompensatedSum {
+public:
+    CompensatedSum() : sum(0), compensation(0) {}
+
+    inline void add(double x) {
+        double t = sum + x;
+        compensation += std::fabs(sum) >= std::fabs(x) ? (sum - t) + x : (x - t) + sum;
+        sum = t;
+    }
+
+    /**
+     * Adds the terms of another sum, e.g. one over the next part of a sequence.
+     */
+    inline void add(const CompensatedSum& other) {
+        add(other.sum);
+        add(other.compensation);
+    }
+
+    inline double value() const {
+        return sum + compensation;
     }
+
+private:
+    double sum;
+    double compensation;
+};
+
+/**
+ * A CompensatedSum over fixed chunks of CHUNK terms: every chunk is summed on its own,
+ * then the chunk sums are added in order. Summing the chunks in parallel and adding
+ * their sums in order gives the same bits, for any number of threads.
+ */
+class ChunkedSum {
+public:
+    static constexpr size_t CHUNK = 1 << 14;
+
+    ChunkedSum() : count(0) {}
+
+    inline void add(double x) {
+        chunk.add(x);
+        if (++count % CHUNK == 0) {
+            total.add(chunk);
+            chunk = CompensatedSum();
+        }
+    }
+
+    inline double value() const {
+        CompensatedSum sum = total;
+        sum.add(chunk);
+        return sum.value();
+    }
+
+private:
+    CompensatedSum total;  // The complete chunks
+    CompensatedSum chunk;  // The chunk being summed
+    size_t count;
 };
 
 #endif // GEOMETRY_LIBRARY_MATH_UTIL
@@ -0,0 +1,233 @@
+//******************************************************************************
+// Copyright 2013 Google Inc.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// This software and the related documents are provided  as is,  with no express
+// or implied  warranties,  other than  those that are  expressly stated  in the
+// License.
+//******************************************************************************
+
+#ifndef GEOMETRY_LIBRARY_MEASURED_PATH
+#define GEOMETRY_LIBRARY_MEASURED_PATH
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "MathUtil.hpp"
+#include "LatLng.hpp"
+#include "UnitVec3.hpp"
+#include "SphericalUtil.hpp"
+
+
+/**
+ * A polyline of great circle segments with the distance along it to every vertex,
+ * for linear referencing: the point a given distance along a route, and how far
+ * along the route a point lies.
+ *
+ * The constructor converts every vertex to a UnitVec3 and sums the segment lengths
+ * (SphericalUtil::computeAngleBetween(), compensated) into a prefix array, so
+ * length() agrees with SphericalUtil::computeLength() up to rounding. A query finds
+ * its segment by binary search, or by a cursor moving forward for sorted distances,
+ * and interpolates along it by one slerp.
+ */
+class MeasuredPath {
+public:
+    /**
+     * @param path a series of connected coordinates in an ordered sequence
+     */
+    template <typename LatLngList>
+    explicit MeasuredPath(const LatLngList& path) {
+        vertices.reserve(path.size());
+        units.reserve(path.size());
+        for (const auto& point : path) {
+            vertices.push_back(LatLng(point));
+            units.push_back(UnitVec3(vertices.back()));
+        }
+        size_t size = vertices.size();
+        distances.reserve(size);
+        angles.reserve(size);
+        CompensatedSum total;
+        for (size_t i = 0; i < size; ++i) {
+            if (i != 0) {
+                total.add(angles.back());
+            }
+            distances.push_back(total.value() * MathUtil::EARTH_RADIUS);
+            angles.push_back(i + 1 < size ? SphericalUtil::computeAngleBetween(vertices[i], vertices[i + 1]) : 0);
+        }
+    }
+
+    /**
+     * Returns the number of vertices.
+     */
+    inline size_t size() const {
+        return vertices.size();
+    }
+
+    /**
+     * Returns the length of the path, in meters.
+     */
+    inline double length() const {
+        return distances.empty() ? 0 : distances.back();
+    }
+
+    /**
+     * Returns the distance along the path from the first vertex to vertex i, in meters.
+     */
+    inline double distanceAt(size_t i) const {
+        return distances[i];
+    }
+
+    /**
+     * Returns the point the given distance, in meters, along the path. Distances are
+     * clamped to [0, length()]: the ends and the vertices are returned as they are,
+     * the points in between with longitudes in [-180, 180]. Returns NaN coordinates
+     * for an empty path.
+     */
+    inline LatLng pointAtDistance(double distance) const {
+        return pointOnSegment(segmentAt(distance), distance);
+    }
+
+    /**
+     * Returns the point the given fraction of length() along the path.
+     */
+    inline LatLng pointAtFraction(double fraction) const {
+        return pointAtDistance(fraction * length());
+    }
+
+    /**
+     * Writes pointAtDistance() of every distance into out[0 .. measures.size()).
+     * A cursor follows the segments forward, so sorted distances cost O(n + m) in
+     * all; a distance behind the cursor is found by binary search.
+     *
+     * @param measures Any container of distances in meters.
+     */
+    template <typename DistanceList>
+    inline void pointsAtDistances(const DistanceList& measures, LatLng* out) const {
+        size_t segment = 0;
+        for (double distance : measures) {
+            segment = cursorAt(segment, distance);
+            *out++ = pointOnSegment(segment, distance);
+        }
+    }
+
+    /**
+     * Returns the points every spacing meters along the path, from the first vertex,
+     * and the last vertex unless the spacing divides the length. Returns no points
+     * for an empty path or a spacing which is not positive.
+     */
+    inline std::vector<LatLng> resample(double spacing) const {
+        std::vector<LatLng> points;
+        if (vertices.empty() || !(spacing > 0)) {
+            return points;
+        }
+        double total = length();
+        size_t count = static_cast<size_t>(std::floor(total / spacing)) + 1;
+        points.reserve(count + 1);
+        size_t segment = 0;
+        for (size_t i = 0; i < count; ++i) {
+            double distance = i * spacing;
+            segment = cursorAt(segment, distance);
+            points.push_back(pointOnSegment(segment, distance));
+        }
+        if ((count - 1) * spacing < total) {
+            points.push_back(vertices.back());
+        }
+        return points;
+    }
+
+    /**
+     * Returns the distance along the path, in meters, of the point of the path closest
+     * to the given point: the along-track measure of its projection. The first closest
+     * segment wins; a linear scan of the segments, with dot and cross products only.
+     * Returns 0 for an empty path.
+     */
+    inline double measure(const LatLng& point) const {
+        size_t size = units.size();
+        if (size < 2U) {
+            return 0;
+        }
+        UnitVec3 p(point);
+        double bestChord2 = (p - units[0]).norm2();
+        double best = 0;
+        for (size_t i = 0; i + 1 < size; ++i) {
+            const UnitVec3& from = units[i];
+            const UnitVec3& to = units[i + 1];
+            double chord2;
+            double along;
+            UnitVec3 normal = from.cross(to);
+            double norm2 = normal.norm2();
+            double forward = norm2 > 0 ? p.dot(normal.cross(from)) : -1;
+            if (forward >= 0 && p.dot(to.cross(normal)) >= 0) {
+                // The projection lies within the segment: the squared chord to it is
+                // 2 (1 - cos(crossTrack)), along the segment the angle from from.
+                double sin2CrossTrack = std::min(1.0, p.dot(normal) * p.dot(normal) / norm2);
+                chord2 = 2 * sin2CrossTrack / (1 + std::sqrt(1 - sin2CrossTrack));
+                along = std::min(angles[i], std::atan2(forward / std::sqrt(norm2), p.dot(from)));
+            } else {
+                chord2 = (p - to).norm2();
+                along = angles[i];
+            }
+            if (chord2 < bestChord2) {
+                bestChord2 = chord2;
+                best = distances[i] + std::max(0.0, along) * MathUtil::EARTH_RADIUS;
+            }
+        }
+        return best;
+    }
+
+
+private:
+    std::vector<LatLng> vertices;
+    std::vector<UnitVec3> units;
+    std::vector<double> distances;  // Meters from the first vertex to each vertex
+    std::vector<double> angles;     // Radians from each vertex to the next one, 0 for the last
+
+    /**
+     * Returns the index i of the segment from vertex i to vertex i + 1 holding the
+     * distance: the last one starting at or before it, the last vertex past the end.
+     */
+    inline size_t segmentAt(double distance) const {
+        size_t i = static_cast<size_t>(std::upper_bound(distances.begin(), distances.end(), distance) - distances.begin());
+        return i == 0 ? 0 : i - 1;
+    }
+
+    /**
+     * Same as above, moving forward from the segment of the previous distance.
+     */
+    inline size_t cursorAt(size_t segment, double distance) const {
+        if (distances.empty() || distance < distances[segment]) {
+            return segmentAt(distance);
+        }
+        while (segment + 1 < distances.size() && distances[segment + 1] <= distance) {
+            ++segment;
+        }
+        return segment;
+    }
+
+    /**
+     * Returns the point the given distance along the path on segment i, by slerp.
+     */
+    inline LatLng pointOnSegment(size_t i, double distance) const {
+        if (vertices.empty()) {
+            return LatLng(NAN, NAN);
+        }
+        double offset = (distance - distances[i]) / MathUtil::EARTH_RADIUS;
+        if (!(offset > 0) || i + 1 == vertices.size()) {
+            return vertices[i];
+        }
+        double angle = angles[i];
+        if (offset >= angle) {
+            return vertices[i + 1];
+        }
+        // http://en.wikipedia.org/wiki/Slerp
+        double sinAngle = std::sin(angle);
+        return (units[i] * (std::sin(angle - offset) / sinAngle) + units[i + 1] * (std::sin(offset) / sinAngle)).toLatLng();
+    }
+};
+
+#endif // GEOMETRY_LIBRARY_MEASURED_PATH
@@ -0,0 +1,116 @@
+//******************************************************************************
+// Copyright 2013 Google Inc.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// This software and the related documents are provided  as is,  with no express
+// or implied  warranties,  other than  those that are  expressly stated  in the
+// License.
+//******************************************************************************
+
+#ifndef GEOMETRY_LIBRARY_POLICIES
+#define GEOMETRY_LIBRARY_POLICIES
+
+#include <cstdint>
+
+#include "MathUtil.hpp"
+
+
+/**
+ * Compile-time policies for the SphericalUtil and PolyUtil templates.
+ *
+ * A segment policy picks the segment kind, e.g. PolyUtil::containsLocation<Geodesic>()
+ * in place of containsLocation(point, polygon, true): the branch on the kind is
+ * resolved when the template is instantiated, not in every loop iteration.
+ *
+ * An earth model policy is any type with a static constexpr double RADIUS, in
+ * meters, e.g. SphericalUtil::computeDistanceBetween<SphereModel<6378137> >().
+ * The functions without a model use EarthSphere.
+ *
+ * An ellipsoid policy, for EllipsoidalUtil, is any type with static constexpr double
+ * EQUATORIAL_RADIUS, in meters, and FLATTENING; Wgs84Ellipsoid is the default.
+ *
+ * A math policy picks the type of the internal arithmetic: DoubleMath, the default,
+ * or FloatMath, e.g. SphericalUtil::computeDistanceBetween<EarthSphere, FloatMath>()
+ * on LatLngF points. The storage type is the one of the points either way.
+ */
+
+/**
+ * The segment kind of a segment policy. The constant lives in a template so that this
+ * header can define it: C++14 has no inline variables, and it may be odr-used.
+ */
+template <bool IsGeodesic>
+struct SegmentPolicy {
+    static constexpr bool GEODESIC = IsGeodesic;
+};
+
+template <bool IsGeodesic>
+constexpr bool SegmentPolicy<IsGeodesic>::GEODESIC;
+
+/**
+ * Great circle segments; the geodesic == true of the runtime signatures.
+ */
+struct Geodesic : SegmentPolicy<true> {};
+
+/**
+ * Rhumb (loxodromic) segments; the geodesic == false of the runtime signatures.
+ */
+struct Rhumb : SegmentPolicy<false> {};
+
+/**
+ * A sphere with the given radius, in whole meters.
+ */
+template <int64_t RadiusMeters>
+struct SphereModel {
+    static constexpr double RADIUS = static_cast<double>(RadiusMeters);
+};
+
+template <int64_t RadiusMeters>
+constexpr double SphereModel<RadiusMeters>::RADIUS;
+
+/**
+ * The sphere of MathUtil::EARTH_RADIUS.
+ */
+typedef SphereModel<6371009> EarthSphere;
+
+/**
+ * The constants of Wgs84Ellipsoid, in a template for the same reason as SegmentPolicy.
+ */
+template <typename = void>
+struct Wgs84EllipsoidT {
+    static constexpr double EQUATORIAL_RADIUS = 6378137.0;
+    static constexpr double FLATTENING = 1 / 298.257223563;
+};
+
+template <typename Unused>
+constexpr double Wgs84EllipsoidT<Unused>::EQUATORIAL_RADIUS;
+
+template <typename Unused>
+constexpr double Wgs84EllipsoidT<Unused>::FLATTENING;
+
+/**
+ * The WGS-84 ellipsoid of GPS.
+ */
+struct Wgs84Ellipsoid : Wgs84EllipsoidT<> {};
+
+/**
+ * Arithmetic in double; the default.
+ */
+struct DoubleMath {
+    typedef double Real;
+};
+
+/**
+ * Arithmetic in float: about 7 significant digits, see the README for the error of
+ * each function.
+ */
+struct FloatMath {
+    typedef float Real;
+};
+
+static_assert(EarthSphere::RADIUS == MathUtil::EARTH_RADIUS, "EarthSphere must match MathUtil::EARTH_RADIUS");
+
+#endif // GEOMETRY_LIBRARY_POLICIES
@@ -15,14 +15,49 @@
 #ifndef GEOMETRY_LIBRARY_POLY_UTIL
 #define GEOMETRY_LIBRARY_POLY_UTIL
 
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
 #include "MathUtil.hpp"
+#include "LatLngBounds.hpp"
 #include "SphericalUtil.hpp"
+#include "Policies.hpp"
+#include "DouglasPeucker.hpp"
+#include "EncodedPolyline.hpp"
+#include "Simd.hpp"
+#include "Instrumentation.hpp"
+
+
+template <typename Isa>
+struct ContainsLocationKernel;
+
+#ifdef GEOMETRY_LIBRARY_HAS_SIMD
+#pragma GCC push_options
+#pragma GCC target("avx2,fma")
+#define GEOMETRY_LIBRARY_SIMD_ISA SimdAvx2
+#include "ContainsLocationKernel.hpp"
+#undef GEOMETRY_LIBRARY_SIMD_ISA
+#pragma GCC pop_options
+
+#pragma GCC push_options
+#pragma GCC target("avx512f")
+#define GEOMETRY_LIBRARY_SIMD_ISA SimdAvx512
+#include "ContainsLocationKernel.hpp"
+#undef GEOMETRY_LIBRARY_SIMD_ISA
+#pragma GCC pop_options
+#endif
 
 
 class PolyUtil {
 public:
     static constexpr double DEFAULT_TOLERANCE = 0.1;  // meters
 
+    // Batches with fewer points are classified on the calling thread.
+    static constexpr size_t BATCH_PARALLEL_MIN_POINTS = 1 << 12;
+
     /**
      * Computes whether the given point lies inside the specified polygon.
      * The polygon is always cosidered closed, regardless of whether the last point equals
@@ -33,37 +68,70 @@ public:
      */
     template <typename LatLngList>
     static inline bool containsLocation(const LatLng& point, const LatLngList& polygon, bool geodesic = false) {
-        size_t size = polygon.size();
-
-        if (size == 0) {
-            return false;
-        }
-        double lat3 = deg2rad(point.lat);
-        double lng3 = deg2rad(point.lng);
-        LatLng prev = polygon[size - 1];
-        double lat1 = deg2rad(prev.lat);
-        double lng1 = deg2rad(prev.lng);
+        return geodesic ?
+            PolyUtil::containsLocation<Geodesic>(point, polygon) :
+            PolyUtil::containsLocation<Rhumb>(point, polygon);
+    }
 
-        size_t nIntersect = 0;
+    /**
+     * Same as above, with the segment kind given by the Segment policy, Geodesic or Rhumb,
+     * and the arithmetic by the Math policy, DoubleMath or FloatMath (see Policies.hpp).
+     */
+    template <typename Segment, typename Math = DoubleMath, typename LatLngList>
+    static inline bool containsLocation(const LatLng& point, const LatLngList& polygon) {
+        GEOMETRY_LIBRARY_TIMER(CONTAINS_LOCATION);
+        return PolyUtil::containsLocationUntimed<Segment, Math>(point, polygon);
+    }
 
-        for (auto val : polygon) {
-            double dLng3 = MathUtil::wrap(lng3 - lng1, -M_PI, M_PI);
-            // Special case: point equal to vertex is inside.
-            if (lat3 == lat1 && dLng3 == 0) {
-                return true;
+    /**
+     * Computes containsLocation(points[i], polygon, geodesic) for every point, into out[i].
+     *
+     * The polygon edges are converted to radians once. For every point a vector pass
+     * over the edges (AVX2 or AVX-512, picked at runtime by Simd::level()) keeps the
+     * few edges whose longitude span holds the point, and only those go through the
+     * exact crossing test; answers are identical to containsLocation().
+     *
+     * @param points  Any container with size() and operator[].
+     * @param out     Receives points.size() answers, in point order.
+     * @param threads the number of threads for long batches, 0 for one per hardware thread
+     */
+    template <typename PointList, typename LatLngList>
+    static inline void containsLocationBatch(const PointList& points, const LatLngList& polygon, bool* out,
+                                             bool geodesic = false, unsigned threads = 0) {
+        size_t count = points.size();
+        if (polygon.size() == 0) {
+            GEOMETRY_LIBRARY_COUNT(CONTAINS_LOCATION, CALLS, count);
+            GEOMETRY_LIBRARY_COUNT(CONTAINS_LOCATION, EXIT_EMPTY, count);
+            std::fill(out, out + count, false);
+            return;
+        }
+        BatchEdges edges(polygon, geodesic);
+        auto classify = [&](size_t first, size_t last) {
+            std::vector<uint32_t> candidates(edges.lat1.size());
+            Simd::Level level = Simd::level();
+            if (geodesic) {
+                PolyUtil::containsLocationRange<Geodesic>(points, polygon, edges, level, first, last, out, candidates.data());
+            } else {
+                PolyUtil::containsLocationRange<Rhumb>(points, polygon, edges, level, first, last, out, candidates.data());
             }
+        };
 
-            double lat2 = deg2rad(val.lat);
-            double lng2 = deg2rad(val.lng);
-
-            // Offset longitudes by -lng1.
-            if (PolyUtil::intersects(lat1, lat2, MathUtil::wrap(lng2 - lng1, -M_PI, M_PI), lat3, dLng3, geodesic)) {
-                ++nIntersect;
-            }
-            lat1 = lat2;
-            lng1 = lng2;
+        if (threads == 0) {
+            threads = std::max(std::thread::hardware_concurrency(), 1U);
+        }
+        if (threads == 1 || count < BATCH_PARALLEL_MIN_POINTS) {
+            classify(0, count);
+            return;
+        }
+        size_t chunk = (count + threads - 1) / threads;
+        std::vector<std::thread> workers;
+        for (size_t first = chunk; first < count; first += chunk) {
+            workers.emplace_back(classify, first, std::min(first + chunk, count));
+        }
+        classify(0, chunk);
+        for (auto& thread : workers) {
+            thread.join();
         }
-        return (nIntersect & 1) != 0;
     }
 
 
@@ -78,6 +146,16 @@ public:
         return PolyUtil::isLocationOnEdgeOrPath(point, polygon, true, geodesic, tolerance);
     }
 
+    /**
+     * Same as above, with the segment kind given by the Segment policy, the tolerance
+     * on the sphere of the Model policy and the arithmetic by the Math policy (see
+     * Policies.hpp).
+     */
+    template <typename Segment, typename Model = EarthSphere, typename Math = DoubleMath, typename LatLngList>
+    static inline bool isLocationOnEdge(const LatLng& point, const LatLngList& polygon, double tolerance = PolyUtil::DEFAULT_TOLERANCE) {
+        return PolyUtil::locationIndexOnEdgeOrPath<Segment, Model, Math>(point, polygon, true, tolerance) >= 0;
+    }
+
 
     /**
      * Computes whether the given point lies on or near a polyline, within a specified
@@ -90,6 +168,42 @@ public:
         return PolyUtil::isLocationOnEdgeOrPath(point, polyline, false, geodesic, tolerance);
     }
 
+    /**
+     * Same as above, with the segment kind given by the Segment policy, the tolerance
+     * on the sphere of the Model policy and the arithmetic by the Math policy.
+     */
+    template <typename Segment, typename Model = EarthSphere, typename Math = DoubleMath, typename LatLngList>
+    static inline bool isLocationOnPath(const LatLng& point, const LatLngList& polyline, double tolerance = PolyUtil::DEFAULT_TOLERANCE) {
+        return PolyUtil::locationIndexOnEdgeOrPath<Segment, Model, Math>(point, polyline, false, tolerance) >= 0;
+    }
+
+    /**
+     * Computes whether the given point lies on or near a polyline, or the edge of a polygon
+     * if closed, within a specified tolerance in meters.
+     */
+    template <typename LatLngList>
+    static inline bool isLocationOnEdgeOrPath(const LatLng& point, const LatLngList& poly, bool closed, bool geodesic, double toleranceEarth) {
+        return PolyUtil::locationIndexOnEdgeOrPath(point, poly, closed, geodesic, toleranceEarth) >= 0;
+    }
+
+    /**
+     * Computes whether (and where) a given point lies on or near the edge of a polygon,
+     * within a specified tolerance in meters. See locationIndexOnEdgeOrPath().
+     */
+    template <typename LatLngList>
+    static inline int locationIndexOnEdge(const LatLng& point, const LatLngList& polygon, double tolerance = PolyUtil::DEFAULT_TOLERANCE, bool geodesic = true) {
+        return PolyUtil::locationIndexOnEdgeOrPath(point, polygon, true, geodesic, tolerance);
+    }
+
+    /**
+     * Computes whether (and where) a given point lies on or near a polyline, within a
+     * specified tolerance in meters. See locationIndexOnEdgeOrPath().
+     */
+    template <typename LatLngList>
+    static inline int locationIndexOnPath(const LatLng& point, const LatLngList& polyline, double tolerance = PolyUtil::DEFAULT_TOLERANCE, bool geodesic = true) {
+        return PolyUtil::locationIndexOnEdgeOrPath(point, polyline, false, geodesic, tolerance);
+    }
+
     /**
      * Computes whether (and where) a given point lies on or near a polyline, within a specified tolerance.
      * If closed, the closing segment between the last and first points of the polyline is not considered.
@@ -107,74 +221,75 @@ public:
      * poly.size()-2 if between poly[poly.size() - 2] and poly[poly.size() - 1]
      */
     template <typename LatLngList>
-    static inline bool isLocationOnEdgeOrPath(const LatLng& point, const LatLngList& poly, bool closed, bool geodesic, double toleranceEarth) {
+    static inline int locationIndexOnEdgeOrPath(const LatLng& point, const LatLngList& poly, bool closed, bool geodesic, double toleranceEarth) {
+        return geodesic ?
+            PolyUtil::locationIndexOnEdgeOrPath<Geodesic>(point, poly, closed, toleranceEarth) :
+            PolyUtil::locationIndexOnEdgeOrPath<Rhumb>(point, poly, closed, toleranceEarth);
+    }
+
+    /**
+     * Same as above, with the segment kind given by the Segment policy, Geodesic or Rhumb,
+     * the tolerance on the sphere of the Model policy and the arithmetic by the Math
+     * policy (see Policies.hpp).
+     */
+    template <typename Segment, typename Model = EarthSphere, typename Math = DoubleMath, typename LatLngList>
+    static inline int locationIndexOnEdgeOrPath(const LatLng& point, const LatLngList& poly, bool closed, double toleranceEarth) {
+        typedef typename Math::Real Real;
+        GEOMETRY_LIBRARY_TIMER(LOCATION_ON_EDGE_OR_PATH);
+        GEOMETRY_LIBRARY_COUNT(LOCATION_ON_EDGE_OR_PATH, CALLS, 1);
         size_t size = poly.size();
 
         if (size == 0U) {
-            return false;
+            GEOMETRY_LIBRARY_COUNT(LOCATION_ON_EDGE_OR_PATH, EXIT_EMPTY, 1);
+            return -1;
+        }
+        if (!PolyUtil::mayBeNear<Model>(point, poly, toleranceEarth)) {
+            GEOMETRY_LIBRARY_COUNT(LOCATION_ON_EDGE_OR_PATH, EXIT_BOUNDS, 1);
+            return -1;
         }
 
-        double tolerance = toleranceEarth / MathUtil::EARTH_RADIUS;
-        double havTolerance = MathUtil::hav(tolerance);
-        double lat3 = deg2rad(point.lat);
-        double lng3 = deg2rad(point.lng);
-        LatLng prev = poly[closed ? size - 1 : 0];
-        double lat1 = deg2rad(prev.lat);
-        double lng1 = deg2rad(prev.lng);
+        Real tolerance = static_cast<Real>(toleranceEarth / Model::RADIUS);
+        Real havTolerance = MathUtil::hav(tolerance);
+        GEOMETRY_LIBRARY_COUNT(LOCATION_ON_EDGE_OR_PATH, TRIG, 1);
+        Real lat3 = static_cast<Real>(deg2rad(point.lat));
+        Real lng3 = static_cast<Real>(deg2rad(point.lng));
+        auto prev = poly[closed ? size - 1 : 0];
+        Real lat1 = static_cast<Real>(latRadians(prev));
+        Real lng1 = static_cast<Real>(lngRadians(prev));
+        int idx = 0;
 
-        if (geodesic) {
+        if (Segment::GEODESIC) {
             for (auto val : poly) {
-                double lat2 = deg2rad(val.lat);
-                double lng2 = deg2rad(val.lng);
+                GEOMETRY_LIBRARY_COUNT(LOCATION_ON_EDGE_OR_PATH, EDGES, 1);
+                Real lat2 = static_cast<Real>(latRadians(val));
+                Real lng2 = static_cast<Real>(lngRadians(val));
                 if (PolyUtil::isOnSegmentGC(lat1, lng1, lat2, lng2, lat3, lng3, havTolerance)) {
-                    return true;
+                    return std::max(0, idx - 1);
                 }
                 lat1 = lat2;
                 lng1 = lng2;
+                ++idx;
             }
         }else {
-            // We project the points to mercator space, where the Rhumb segment is a straight line,
-            // and compute the geodesic distance between point3 and the closest point on the
-            // segment. This method is an approximation, because it uses "closest" in mercator
-            // space which is not "closest" on the sphere -- but the error is small because
-            // "tolerance" is small.
-            double minAcceptable = lat3 - tolerance;
-            double maxAcceptable = lat3 + tolerance;
-            double y1 = MathUtil::mercator(lat1);
-            double y3 = MathUtil::mercator(lat3);
-            double xTry[3];
+            Real y1 = MathUtil::mercator(lat1);
+            Real y3 = MathUtil::mercator(lat3);
+            GEOMETRY_LIBRARY_COUNT(LOCATION_ON_EDGE_OR_PATH, TRIG, 4);
             for (auto val : poly) {
-                double lat2 = deg2rad(val.lat);
-                double y2 = MathUtil::mercator(lat2);
-                double lng2 = deg2rad(val.lng);
-                if (std::max(lat1, lat2) >= minAcceptable && std::min(lat1, lat2) <= maxAcceptable) {
-                    // We offset longitudes by -lng1; the implicit x1 is 0.
-                    double x2 = MathUtil::wrap(lng2 - lng1, -M_PI, M_PI);
-                    double x3Base = MathUtil::wrap(lng3 - lng1, -M_PI, M_PI);
-                    xTry[0] = x3Base;
-                    // Also explore wrapping of x3Base around the world in both directions.
-                    xTry[1] = x3Base + 2 * M_PI;
-                    xTry[2] = x3Base - 2 * M_PI;
-
-                    for (auto x3 : xTry) {
-                        double dy = y2 - y1;
-                        double len2 = x2 * x2 + dy * dy;
-                        double t = len2 <= 0 ? 0 : MathUtil::clamp((x3 * x2 + (y3 - y1) * dy) / len2, 0, 1);
-                        double xClosest = t * x2;
-                        double yClosest = y1 + t * dy;
-                        double latClosest = MathUtil::inverseMercator(yClosest);
-                        double havDist = MathUtil::havDistance(lat3, latClosest, x3 - xClosest);
-                        if (havDist < havTolerance) {
-                            return true;
-                        }
-                    }
+                GEOMETRY_LIBRARY_COUNT(LOCATION_ON_EDGE_OR_PATH, EDGES, 1);
+                GEOMETRY_LIBRARY_COUNT(LOCATION_ON_EDGE_OR_PATH, TRIG, 2);
+                Real lat2 = static_cast<Real>(latRadians(val));
+                Real y2 = MathUtil::mercator(lat2);
+                Real lng2 = static_cast<Real>(lngRadians(val));
+                if (PolyUtil::isOnSegmentRhumb(lat1, lng1, y1, lat2, lng2, y2, lat3, lng3, y3, tolerance, havTolerance)) {
+                    return std::max(0, idx - 1);
                 }
                 lat1 = lat2;
                 lng1 = lng2;
                 y1 = y2;
+                ++idx;
             }
         }
-        return false;
+        return -1;
     }
 
     /**
@@ -209,20 +324,308 @@ public:
         return SphericalUtil::computeDistanceBetween(p, su);
     }
 
+    /**
+     * Simplifies the given poly (polyline or polygon) using the Douglas-Peucker decimation
+     * algorithm. Increasing the tolerance will result in fewer points in the simplified
+     * polyline or polygon. The distance of a point to a segment is distanceToLine().
+     * As in android-maps-utils, the last point of a closed polygon is moved off the
+     * first one while simplifying, and kept as it was.
+     *
+     * @param poly      polyline or polygon to be simplified
+     * @param tolerance in meters, greater than zero; otherwise the result is empty
+     * @param threads   the number of threads for long paths, 0 for one per hardware thread
+     * @return a simplified poly produced by the Douglas-Peucker algorithm
+     */
+    template <typename LatLngList>
+    static inline std::vector<LatLng> simplify(const LatLngList& poly, double tolerance, unsigned threads = 0) {
+        std::vector<size_t> kept = PolyUtil::simplifyIndices(poly, tolerance, threads);
+        std::vector<LatLng> simplified;
+        simplified.reserve(kept.size());
+        auto next = kept.begin();
+        size_t i = 0;
+        for (const auto& point : poly) {
+            if (next != kept.end() && *next == i) {
+                simplified.push_back(LatLng(point.lat, point.lng));
+                ++next;
+            }
+            ++i;
+        }
+        return simplified;
+    }
+
+    /**
+     * Same as above, returning the indices of the kept points in increasing order.
+     */
+    template <typename LatLngList>
+    static inline std::vector<size_t> simplifyIndices(const LatLngList& poly, double tolerance, unsigned threads = 0) {
+        return DouglasPeucker(poly).simplify(tolerance, threads);
+    }
+
+    /**
+     * Decodes an encoded path string into a sequence of LatLngs.
+     * See PolylineDecoder and EncodedPolyline to decode without building a vector.
+     */
+    static inline std::vector<LatLng> decode(const std::string& encodedPath) {
+        std::vector<LatLng> path;
+        PolylineDecoder(encodedPath).readAll(path);
+        return path;
+    }
+
+    /**
+     * Encodes a sequence of LatLngs into an encoded path string.
+     */
+    template <typename LatLngList>
+    static inline std::string encode(const LatLngList& path) {
+        std::string result;
+        PolyUtil::encode(path, result);
+        return result;
+    }
+
+    /**
+     * Same as above, appending to out; reusing out across calls saves the allocations.
+     */
+    template <typename LatLngList>
+    static inline void encode(const LatLngList& path, std::string& out) {
+        int64_t lastLat = 0;
+        int64_t lastLng = 0;
+        for (const auto& point : path) {
+            // Math.round() of the Java original: halves round up.
+            int64_t lat = static_cast<int64_t>(std::floor(point.lat * 1e5 + 0.5));
+            int64_t lng = static_cast<int64_t>(std::floor(point.lng * 1e5 + 0.5));
+            PolyUtil::encodeValue(lat - lastLat, out);
+            PolyUtil::encodeValue(lng - lastLng, out);
+            lastLat = lat;
+            lastLng = lng;
+        }
+    }
+
 
 private:
+    friend class PreparedPath;
+
+    /**
+     * The polygon edges of containsLocation() in radians, one array per value.
+     * Edge i runs from vertex i - 1 (the last vertex for i == 0) to vertex i.
+     */
+    struct BatchEdges {
+        std::vector<double> lat1;
+        std::vector<double> lng1;
+        std::vector<double> lat2;
+        std::vector<double> lng2;     // End longitude offset by -lng1 and wrapped to [-PI, PI)
+        std::vector<double> f1;       // tan(lat1) if geodesic, mercator(lat1) otherwise
+        std::vector<double> f2;       // tan(lat2) if geodesic, mercator(lat2) otherwise
+        std::vector<double> sinLng2;  // sin(lng2), geodesic only
+
+        template <typename LatLngList>
+        BatchEdges(const LatLngList& polygon, bool geodesic) {
+            size_t size = polygon.size();
+            lat1.reserve(size);
+            lng1.reserve(size);
+            lat2.reserve(size);
+            lng2.reserve(size);
+            auto prev = polygon[size - 1];
+            double lat = latRadians(prev);
+            double lng = lngRadians(prev);
+            for (auto val : polygon) {
+                double nextLat = latRadians(val);
+                double nextLng = lngRadians(val);
+                lat1.push_back(lat);
+                lng1.push_back(lng);
+                lat2.push_back(nextLat);
+                lng2.push_back(MathUtil::wrap(nextLng - lng, -M_PI, M_PI));
+                f1.push_back(geodesic ? tan(lat) : MathUtil::mercator(lat));
+                f2.push_back(geodesic ? tan(nextLat) : MathUtil::mercator(nextLat));
+                sinLng2.push_back(geodesic ? sin(lng2.back()) : 0);
+                lat = nextLat;
+                lng = nextLng;
+            }
+        }
+    };
+
+    /**
+     * Returns false if the cached bounds of a Bounded polygon exclude the point; the
+     * overload below. Any other list may contain it.
+     */
+    template <typename Point, typename LatLngList>
+    static inline bool mayContain(const Point&, const LatLngList&) {
+        return true;
+    }
+
+    template <typename Point, typename LatLngList>
+    static inline bool mayContain(const Point& point, const Bounded<LatLngList>& polygon) {
+        return polygon.bounds().contains(LatLng(point.lat, point.lng));
+    }
+
+    /**
+     * Returns false if the cached bounds of a Bounded list are farther from the point
+     * than toleranceEarth meters on the sphere of Model.
+     */
+    template <typename Model, typename LatLngList>
+    static inline bool mayBeNear(const LatLng&, const LatLngList&, double) {
+        return true;
+    }
+
+    template <typename Model, typename LatLngList>
+    static inline bool mayBeNear(const LatLng& point, const Bounded<LatLngList>& poly, double toleranceEarth) {
+        return poly.bounds().template expanded<Model>(toleranceEarth).contains(point);
+    }
+
+    /**
+     * containsLocation() of points[first] to points[last - 1] of a batch, into out.
+     */
+    template <typename Segment, typename PointList, typename LatLngList>
+    static inline void containsLocationRange(const PointList& points, const LatLngList& polygon, const BatchEdges& edges,
+                                             Simd::Level level, size_t first, size_t last, bool* out, uint32_t* candidates) {
+        for (size_t i = first; i < last; ++i) {
+            if (!PolyUtil::mayContain(points[i], polygon)) {
+                GEOMETRY_LIBRARY_COUNT(CONTAINS_LOCATION, CALLS, 1);
+                GEOMETRY_LIBRARY_COUNT(CONTAINS_LOCATION, EXIT_BOUNDS, 1);
+                out[i] = false;
+                continue;
+            }
+            out[i] = PolyUtil::containsLocation<Segment>(points[i], polygon, edges, level, candidates);
+        }
+    }
+
+    /**
+     * containsLocation() without the timer, for the callers which time themselves.
+     */
+    template <typename Segment, typename Math, typename LatLngList>
+    static inline bool containsLocationUntimed(const LatLng& point, const LatLngList& polygon) {
+        typedef typename Math::Real Real;
+        GEOMETRY_LIBRARY_COUNT(CONTAINS_LOCATION, CALLS, 1);
+        size_t size = polygon.size();
+
+        if (size == 0) {
+            GEOMETRY_LIBRARY_COUNT(CONTAINS_LOCATION, EXIT_EMPTY, 1);
+            return false;
+        }
+        if (!PolyUtil::mayContain(point, polygon)) {
+            GEOMETRY_LIBRARY_COUNT(CONTAINS_LOCATION, EXIT_BOUNDS, 1);
+            return false;
+        }
+        Real lat3 = static_cast<Real>(deg2rad(point.lat));
+        Real lng3 = static_cast<Real>(deg2rad(point.lng));
+        auto prev = polygon[size - 1];
+        Real lat1 = static_cast<Real>(latRadians(prev));
+        Real lng1 = static_cast<Real>(lngRadians(prev));
+
+        size_t nIntersect = 0;
+
+        for (auto val : polygon) {
+            GEOMETRY_LIBRARY_COUNT(CONTAINS_LOCATION, EDGES, 1);
+            Real dLng3 = MathUtil::wrap(lng3 - lng1, -M_PI, M_PI);
+            // Special case: point equal to vertex is inside.
+            if (lat3 == lat1 && dLng3 == 0) {
+                GEOMETRY_LIBRARY_COUNT(CONTAINS_LOCATION, EXIT_VERTEX, 1);
+                return true;
+            }
+
+            Real lat2 = static_cast<Real>(latRadians(val));
+            Real lng2 = static_cast<Real>(lngRadians(val));
+
+            // Offset longitudes by -lng1.
+            if (PolyUtil::intersects<Segment>(lat1, lat2, MathUtil::wrap(lng2 - lng1, -M_PI, M_PI), lat3, dLng3)) {
+                ++nIntersect;
+            }
+            lat1 = lat2;
+            lng1 = lng2;
+        }
+        return (nIntersect & 1) != 0;
+    }
+
+    /**
+     * containsLocation() of one point of a batch. Edges are prefiltered on their
+     * longitude span, by the vector kernel first and by the scalar loop below for
+     * the rest; a point the prefilter cannot decide goes to containsLocation(), under
+     * the timer already running.
+     */
+    template <typename Segment, typename Point, typename LatLngList>
+    static inline bool containsLocation(const Point& point, const LatLngList& polygon, const BatchEdges& edges,
+                                        Simd::Level level, uint32_t* candidates) {
+        double lat3 = deg2rad(point.lat);
+        double lng3 = deg2rad(point.lng);
+        const double* lat1 = edges.lat1.data();
+        const double* lng1 = edges.lng1.data();
+        const double* lng2 = edges.lng2.data();
+        size_t size = edges.lat1.size();
+        GEOMETRY_LIBRARY_TIMER(CONTAINS_LOCATION);
+
+        size_t count = 0;
+        size_t i = 0;
+#ifdef GEOMETRY_LIBRARY_HAS_SIMD
+        if (level == Simd::AVX512) {
+            i = ContainsLocationKernel<SimdAvx512>::scan(lat3, lng3, lat1, lng1, lng2, size, candidates, &count);
+        } else if (level == Simd::AVX2) {
+            i = ContainsLocationKernel<SimdAvx2>::scan(lat3, lng3, lat1, lng1, lng2, size, candidates, &count);
+        }
+#else
+        (void) level;
+#endif
+        for (; i < size; ++i) {
+            double dLng3 = lng3 - lng1[i];
+            // MathUtil::wrap() would change dLng3, or the point equals the vertex.
+            if (!(dLng3 >= -M_PI && dLng3 < M_PI) || (lat3 == lat1[i] && dLng3 == 0)) {
+                return PolyUtil::containsLocationUntimed<Segment, DoubleMath>(LatLng(point.lat, point.lng), polygon);
+            }
+            // Not both ends on the same side of lng3.
+            if (!((dLng3 >= 0 && dLng3 >= lng2[i]) || (dLng3 < 0 && dLng3 < lng2[i]))) {
+                candidates[count++] = static_cast<uint32_t>(i);
+            }
+        }
+
+        GEOMETRY_LIBRARY_COUNT(CONTAINS_LOCATION, CALLS, 1);
+        GEOMETRY_LIBRARY_COUNT(CONTAINS_LOCATION, EDGES, size);
+        GEOMETRY_LIBRARY_COUNT(CONTAINS_LOCATION, EDGE_LONGITUDE, size - count);
+
+        // intersects(), with tan() or mercator() of the latitudes computed once.
+        double f3 = 0;
+        bool hasF3 = false;
+        size_t nIntersect = 0;
+        for (size_t j = 0; j < count; ++j) {
+            uint32_t edge = candidates[j];
+            double dLng2 = lng2[edge];
+            double dLng3 = lng3 - lng1[edge];
+            int linear = PolyUtil::intersectsLinear(lat1[edge], edges.lat2[edge], dLng2, lat3, dLng3);
+            if (linear < 0) {
+                if (!hasF3) {
+                    f3 = Segment::GEODESIC ? tan(lat3) : MathUtil::mercator(lat3);
+                    hasF3 = true;
+                    GEOMETRY_LIBRARY_COUNT(CONTAINS_LOCATION, TRIG, Segment::GEODESIC ? 1 : 2);
+                }
+                GEOMETRY_LIBRARY_COUNT(CONTAINS_LOCATION, TRIG, Segment::GEODESIC ? 2 : 0);
+                linear = Segment::GEODESIC ?
+                    f3 >= (edges.f1[edge] * sin(dLng2 - dLng3) + edges.f2[edge] * sin(dLng3)) / edges.sinLng2[edge] :
+                    f3 >= (edges.f1[edge] * (dLng2 - dLng3) + edges.f2[edge] * dLng3) / dLng2;
+            }
+            nIntersect += static_cast<size_t>(linear);
+        }
+        return (nIntersect & 1) != 0;
+    }
+
+    static inline void encodeValue(int64_t v, std::string& out) {
+        uint64_t value = v < 0 ? ~(static_cast<uint64_t>(v) << 1) : static_cast<uint64_t>(v) << 1;
+        while (value >= 0x20) {
+            out.push_back(static_cast<char>((0x20 | (value & 0x1f)) + 63));
+            value >>= 5;
+        }
+        out.push_back(static_cast<char>(value + 63));
+    }
+
     /**
      * Returns tan(latitude-at-lng3) on the great circle (lat1, lng1) to (lat2, lng2). lng1==0.
      * See http://williams.best.vwh.net/avform.htm .
      */
-    static inline double tanLatGC(double lat1, double lat2, double lng2, double lng3) {
-        return (tan(lat1) * sin(lng2 - lng3) + tan(lat2) * sin(lng3)) / sin(lng2);
+    template <typename Real>
+    static inline Real tanLatGC(Real lat1, Real lat2, Real lng2, Real lng3) {
+        return (std::tan(lat1) * std::sin(lng2 - lng3) + std::tan(lat2) * std::sin(lng3)) / std::sin(lng2);
     }
 
     /**
      * Returns mercator(latitude-at-lng3) on the Rhumb line (lat1, lng1) to (lat2, lng2). lng1==0.
      */
-    static inline double mercatorLatRhumb(double lat1, double lat2, double lng2, double lng3) {
+    template <typename Real>
+    static inline Real mercatorLatRhumb(Real lat1, Real lat2, Real lng2, Real lng3) {
         return (MathUtil::mercator(lat1) * (lng2 - lng3) + MathUtil::mercator(lat2) * lng3) / lng2;
     }
 
@@ -231,89 +634,174 @@ private:
      * (lat1, lng1) to (lat2, lng2).
      * Longitudes are offset by -lng1; the implicit lng1 becomes 0.
      */
-    static inline double intersects(double lat1, double lat2, double lng2, double lat3, double lng3, bool geodesic) {
+    static inline bool intersects(double lat1, double lat2, double lng2, double lat3, double lng3, bool geodesic) {
+        return geodesic ?
+            PolyUtil::intersects<Geodesic>(lat1, lat2, lng2, lat3, lng3) :
+            PolyUtil::intersects<Rhumb>(lat1, lat2, lng2, lat3, lng3);
+    }
+
+    /**
+     * Same as above, with the segment kind given by the Segment policy.
+     */
+    template <typename Segment, typename Real>
+    static inline bool intersects(Real lat1, Real lat2, Real lng2, Real lat3, Real lng3) {
+        int linear = PolyUtil::intersectsLinear(lat1, lat2, lng2, lat3, lng3);
+        if (linear >= 0) {
+            return linear != 0;
+        }
+        GEOMETRY_LIBRARY_COUNT(CONTAINS_LOCATION, TRIG, 6);
+        // Compare lat3 with latitude on the GC/Rhumb segment corresponding to lng3.
+        // Compare through a strictly-increasing function (tan() or mercator()) as convenient.
+        return Segment::GEODESIC ?
+            std::tan(lat3) >= PolyUtil::tanLatGC(lat1, lat2, lng2, lng3) :
+            MathUtil::mercator(lat3) >= PolyUtil::mercatorLatRhumb(lat1, lat2, lng2, lng3);
+    }
+
+    /**
+     * The part of intersects() decided without the segment: returns 1 if the segments
+     * intersect, 0 if they do not, and -1 if lat3 must be compared with the latitude
+     * on the segment at lng3.
+     */
+    template <typename Real>
+    static inline int intersectsLinear(Real lat1, Real lat2, Real lng2, Real lat3, Real lng3) {
         // Both ends on the same side of lng3.
         if ((lng3 >= 0 && lng3 >= lng2) || (lng3 < 0 && lng3 < lng2)) {
-            return false;
+            GEOMETRY_LIBRARY_COUNT(CONTAINS_LOCATION, EDGE_LONGITUDE, 1);
+            return 0;
         }
         // Point is South Pole.
-        if (lat3 <= -M_PI / 2) {
-            return false;
+        if (lat3 <= -Real(M_PI / 2)) {
+            GEOMETRY_LIBRARY_COUNT(CONTAINS_LOCATION, EDGE_LATITUDE, 1);
+            return 0;
         }
         // Any segment end is a pole.
-        if (lat1 <= -M_PI / 2 || lat2 <= -M_PI / 2 || lat1 >= M_PI / 2 || lat2 >= M_PI / 2) {
-            return false;
+        if (lat1 <= -Real(M_PI / 2) || lat2 <= -Real(M_PI / 2) || lat1 >= Real(M_PI / 2) || lat2 >= Real(M_PI / 2)) {
+            GEOMETRY_LIBRARY_COUNT(CONTAINS_LOCATION, EDGE_LATITUDE, 1);
+            return 0;
         }
-        if (lng2 <= -M_PI) {
-            return false;
+        if (lng2 <= Real(-M_PI)) {
+            GEOMETRY_LIBRARY_COUNT(CONTAINS_LOCATION, EDGE_LATITUDE, 1);
+            return 0;
         }
-        double linearLat = (lat1 * (lng2 - lng3) + lat2 * lng3) / lng2;
+        Real linearLat = (lat1 * (lng2 - lng3) + lat2 * lng3) / lng2;
         // Northern hemisphere and point under lat-lng line.
         if (lat1 >= 0 && lat2 >= 0 && lat3 < linearLat) {
-            return false;
+            GEOMETRY_LIBRARY_COUNT(CONTAINS_LOCATION, EDGE_LATITUDE, 1);
+            return 0;
         }
         // Southern hemisphere and point above lat-lng line.
         if (lat1 <= 0 && lat2 <= 0 && lat3 >= linearLat) {
-            return true;
+            GEOMETRY_LIBRARY_COUNT(CONTAINS_LOCATION, EDGE_LATITUDE, 1);
+            return 1;
         }
         // North Pole.
-        if (lat3 >= M_PI / 2) {
-            return true;
+        if (lat3 >= Real(M_PI / 2)) {
+            GEOMETRY_LIBRARY_COUNT(CONTAINS_LOCATION, EDGE_LATITUDE, 1);
+            return 1;
         }
-        // Compare lat3 with latitude on the GC/Rhumb segment corresponding to lng3.
-        // Compare through a strictly-increasing function (tan() or mercator()) as convenient.
-        return geodesic ?
-            tan(lat3) >= PolyUtil::tanLatGC(lat1, lat2, lng2, lng3) :
-            MathUtil::mercator(lat3) >= PolyUtil::mercatorLatRhumb(lat1, lat2, lng2, lng3);
+        return -1;
     }
 
     /**
      * Returns sin(initial bearing from (lat1,lng1) to (lat3,lng3) minus initial bearing
      * from (lat1, lng1) to (lat2,lng2)).
      */
-    static inline double sinDeltaBearing(double lat1, double lng1, double lat2, double lng2, double lat3, double lng3) {
-        double sinLat1 = sin(lat1);
-        double cosLat2 = cos(lat2);
-        double cosLat3 = cos(lat3);
-        double lat31 = lat3 - lat1;
-        double lng31 = lng3 - lng1;
-        double lat21 = lat2 - lat1;
-        double lng21 = lng2 - lng1;
-        double a = sin(lng31) * cosLat3;
-        double c = sin(lng21) * cosLat2;
-        double b = sin(lat31) + 2 * sinLat1 * cosLat3 * MathUtil::hav(lng31);
-        double d = sin(lat21) + 2 * sinLat1 * cosLat2 * MathUtil::hav(lng21);
-        double denom = (a * a + b * b) * (c * c + d * d);
-        return denom <= 0 ? 1 : (a * d - b * c) / sqrt(denom);
-    }
-
-    static inline bool isOnSegmentGC(double lat1, double lng1, double lat2, double lng2, double lat3, double lng3, double havTolerance) {
-        double havDist13 = MathUtil::havDistance(lat1, lat3, lng1 - lng3);
+    template <typename Real>
+    static inline Real sinDeltaBearing(Real lat1, Real lng1, Real lat2, Real lng2, Real lat3, Real lng3) {
+        Real sinLat1 = std::sin(lat1);
+        Real cosLat2 = std::cos(lat2);
+        Real cosLat3 = std::cos(lat3);
+        Real lat31 = lat3 - lat1;
+        Real lng31 = lng3 - lng1;
+        Real lat21 = lat2 - lat1;
+        Real lng21 = lng2 - lng1;
+        Real a = std::sin(lng31) * cosLat3;
+        Real c = std::sin(lng21) * cosLat2;
+        Real b = std::sin(lat31) + 2 * sinLat1 * cosLat3 * MathUtil::hav(lng31);
+        Real d = std::sin(lat21) + 2 * sinLat1 * cosLat2 * MathUtil::hav(lng21);
+        Real denom = (a * a + b * b) * (c * c + d * d);
+        return denom <= 0 ? 1 : (a * d - b * c) / std::sqrt(denom);
+    }
+
+    /**
+     * Computes whether (lat3, lng3) lies within tolerance of the Rhumb segment (lat1, lng1)
+     * to (lat2, lng2); y1, y2 and y3 are mercator() of the latitudes.
+     *
+     * We project the points to mercator space, where the Rhumb segment is a straight line,
+     * and compute the geodesic distance between point3 and the closest point on the
+     * segment. This method is an approximation, because it uses "closest" in mercator
+     * space which is not "closest" on the sphere -- but the error is small because
+     * "tolerance" is small.
+     */
+    template <typename Real>
+    static inline bool isOnSegmentRhumb(Real lat1, Real lng1, Real y1, Real lat2, Real lng2, Real y2,
+                                        Real lat3, Real lng3, Real y3, Real tolerance, Real havTolerance) {
+        Real minAcceptable = lat3 - tolerance;
+        Real maxAcceptable = lat3 + tolerance;
+        if (std::max(lat1, lat2) < minAcceptable || std::min(lat1, lat2) > maxAcceptable) {
+            GEOMETRY_LIBRARY_COUNT(LOCATION_ON_EDGE_OR_PATH, EDGE_LATITUDE, 1);
+            return false;
+        }
+        // We offset longitudes by -lng1; the implicit x1 is 0.
+        Real x2 = MathUtil::wrap(lng2 - lng1, -M_PI, M_PI);
+        Real x3Base = MathUtil::wrap(lng3 - lng1, -M_PI, M_PI);
+        Real xTry[3];
+        xTry[0] = x3Base;
+        // Also explore wrapping of x3Base around the world in both directions.
+        xTry[1] = x3Base + Real(2 * M_PI);
+        xTry[2] = x3Base - Real(2 * M_PI);
+
+        for (auto x3 : xTry) {
+            Real dy = y2 - y1;
+            Real len2 = x2 * x2 + dy * dy;
+            Real t = len2 <= 0 ? 0 : MathUtil::clamp((x3 * x2 + (y3 - y1) * dy) / len2, 0, 1);
+            Real xClosest = t * x2;
+            Real yClosest = y1 + t * dy;
+            Real latClosest = MathUtil::inverseMercator(yClosest);
+            Real havDist = MathUtil::havDistance(lat3, latClosest, x3 - xClosest);
+            GEOMETRY_LIBRARY_COUNT(LOCATION_ON_EDGE_OR_PATH, TRIG, 6);
+            if (havDist < havTolerance) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    template <typename Real>
+    static inline bool isOnSegmentGC(Real lat1, Real lng1, Real lat2, Real lng2, Real lat3, Real lng3, Real havTolerance) {
+        Real havDist13 = MathUtil::havDistance(lat1, lat3, lng1 - lng3);
+        GEOMETRY_LIBRARY_COUNT(LOCATION_ON_EDGE_OR_PATH, TRIG, 4);
         if (havDist13 <= havTolerance) {
+            GEOMETRY_LIBRARY_COUNT(LOCATION_ON_EDGE_OR_PATH, EXIT_VERTEX, 1);
             return true;
         }
-        double havDist23 = MathUtil::havDistance(lat2, lat3, lng2 - lng3);
+        Real havDist23 = MathUtil::havDistance(lat2, lat3, lng2 - lng3);
+        GEOMETRY_LIBRARY_COUNT(LOCATION_ON_EDGE_OR_PATH, TRIG, 4);
         if (havDist23 <= havTolerance) {
+            GEOMETRY_LIBRARY_COUNT(LOCATION_ON_EDGE_OR_PATH, EXIT_VERTEX, 1);
             return true;
         }
-        double sinBearing = PolyUtil::sinDeltaBearing(lat1, lng1, lat2, lng2, lat3, lng3);
-        double sinDist13 = MathUtil::sinFromHav(havDist13);
-        double havCrossTrack = MathUtil::havFromSin(sinDist13 * sinBearing);
+        Real sinBearing = PolyUtil::sinDeltaBearing(lat1, lng1, lat2, lng2, lat3, lng3);
+        Real sinDist13 = MathUtil::sinFromHav(havDist13);
+        Real havCrossTrack = MathUtil::havFromSin(sinDist13 * sinBearing);
+        GEOMETRY_LIBRARY_COUNT(LOCATION_ON_EDGE_OR_PATH, TRIG, 9);
         if (havCrossTrack > havTolerance) {
+            GEOMETRY_LIBRARY_COUNT(LOCATION_ON_EDGE_OR_PATH, EDGE_CROSS_TRACK, 1);
             return false;
         }
-        double havDist12 = MathUtil::havDistance(lat1, lat2, lng1 - lng2);
-        double term = havDist12 + havCrossTrack * (1 - 2 * havDist12);
+        Real havDist12 = MathUtil::havDistance(lat1, lat2, lng1 - lng2);
+        GEOMETRY_LIBRARY_COUNT(LOCATION_ON_EDGE_OR_PATH, TRIG, 4);
+        Real term = havDist12 + havCrossTrack * (1 - 2 * havDist12);
         if (havDist13 > term || havDist23 > term) {
             return false;
         }
-        if (havDist12 < 0.74) {
+        if (havDist12 < Real(0.74)) {
             return true;
         }
-        double cosCrossTrack = 1 - 2 * havCrossTrack;
-        double havAlongTrack13 = (havDist13 - havCrossTrack) / cosCrossTrack;
-        double havAlongTrack23 = (havDist23 - havCrossTrack) / cosCrossTrack;
-        double sinSumAlongTrack = MathUtil::sinSumFromHav(havAlongTrack13, havAlongTrack23);
+        Real cosCrossTrack = 1 - 2 * havCrossTrack;
+        Real havAlongTrack13 = (havDist13 - havCrossTrack) / cosCrossTrack;
+        Real havAlongTrack23 = (havDist23 - havCrossTrack) / cosCrossTrack;
+        Real sinSumAlongTrack = MathUtil::sinSumFromHav(havAlongTrack13, havAlongTrack23);
         return sinSumAlongTrack > 0;  // Compare with half-circle == PI using sign of sin().
     }
 };
@@ -0,0 +1,314 @@
+//******************************************************************************
+// Copyright 2013 Google Inc.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// This software and the related documents are provided  as is,  with no express
+// or implied  warranties,  other than  those that are  expressly stated  in the
+// License.
+//******************************************************************************
+
+#ifndef GEOMETRY_LIBRARY_POLYGON_INDEX
+#define GEOMETRY_LIBRARY_POLYGON_INDEX
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "MathUtil.hpp"
+#include "LatLng.hpp"
+#include "LatLngBounds.hpp"
+#include "PolyUtil.hpp"
+
+
+/**
+ * A spatial index over many polygons, answering which of them contain a point.
+ *
+ * The bounding boxes of the polygons are bulk-loaded into an R-tree (Sort-Tile-Recursive
+ * packing); a query walks down the boxes holding the point and runs the exact
+ * PolyUtil::containsLocation() on the candidates only. Answers are identical to calling
+ * containsLocation() with the same geodesic flag on every polygon.
+ *
+ * The boxes are the LatLngBounds::fromPolygon() of the polygons, which follow the
+ * containsLocation() semantics:
+ *   - every edge takes the shorter way in longitude, so a polygon crossing the
+ *     antimeridian gets a box on each side of it;
+ *   - a polygon winding around a pole contains everything north of it (the South Pole
+ *     is always outside), so its box spans all longitudes up to latitude 90;
+ *   - edges from a pole, or half way around the globe, are never crossed; a polygon
+ *     with such edges may extend north up to latitude 90;
+ *   - geodesic edges bulge poleward of their end points, and the boxes include that.
+ */
+class PolygonIndex {
+public:
+    // Children per R-tree node.
+    static constexpr size_t NODE_CAPACITY = 16;
+
+    /**
+     * A polygon of the index, a LatLngList over its vertices.
+     */
+    class Polygon {
+    public:
+        typedef const LatLng* const_iterator;
+        typedef const_iterator iterator;
+        typedef LatLng value_type;
+
+        Polygon(const LatLng* first, const LatLng* last) : first(first), last(last) {}
+
+        inline const_iterator begin() const { return first; }
+        inline const_iterator end() const { return last; }
+        inline size_t size() const { return static_cast<size_t>(last - first); }
+        inline const LatLng& operator[](size_t i) const { return first[i]; }
+
+    private:
+        const LatLng* first;
+        const LatLng* last;
+    };
+
+    /**
+     * Builds the index over a container of LatLngLists, e.g. a
+     * std::vector<std::vector<LatLng>>. Polygon i of the index is polygons[i].
+     */
+    template <typename PolygonList>
+    explicit PolygonIndex(const PolygonList& polygons, bool geodesic = false)
+        : geodesic(geodesic), root(NONE) {
+        std::vector<Box> boxes;
+        offsets.push_back(0);
+        for (const auto& polygon : polygons) {
+            for (const auto& point : polygon) {
+                vertices.push_back(LatLng(point.lat, point.lng));
+            }
+            offsets.push_back(static_cast<uint32_t>(vertices.size()));
+            addBoxes(static_cast<uint32_t>(offsets.size() - 2), boxes);
+        }
+        build(boxes);
+    }
+
+    /**
+     * Returns whether any polygon contains the given point, and stores the index of
+     * one of them.
+     */
+    inline bool findAny(const LatLng& point, size_t* index = nullptr) const {
+        return search(point, [&](uint32_t id) {
+            if (!PolyUtil::containsLocation(point, polygon(id), geodesic)) {
+                return false;
+            }
+            if (index != nullptr) {
+                *index = id;
+            }
+            return true;
+        });
+    }
+
+    /**
+     * Returns the indices of all polygons containing the given point, in increasing order.
+     */
+    inline std::vector<size_t> findAll(const LatLng& point) const {
+        std::vector<size_t> result;
+        findAll(point, result);
+        return result;
+    }
+
+    /**
+     * Same as above, appending to out; reusing out across calls saves the allocations.
+     */
+    inline void findAll(const LatLng& point, std::vector<size_t>& out) const {
+        size_t first = out.size();
+        search(point, [&](uint32_t id) {
+            if (PolyUtil::containsLocation(point, polygon(id), geodesic)) {
+                out.push_back(id);
+            }
+            return false;
+        });
+        std::sort(out.begin() + first, out.end());
+    }
+
+    /**
+     * Calls visit(i) for every polygon whose bounding box holds the given point, a
+     * superset of the polygons containing it, until visit returns true. Returns
+     * whether it did.
+     */
+    template <typename Visit>
+    inline bool candidates(const LatLng& point, Visit visit) const {
+        return search(point, [&](uint32_t id) {
+            return visit(static_cast<size_t>(id));
+        });
+    }
+
+    inline Polygon polygon(size_t i) const {
+        return Polygon(vertices.data() + offsets[i], vertices.data() + offsets[i + 1]);
+    }
+
+    /**
+     * Returns the number of polygons.
+     */
+    inline size_t size() const {
+        return offsets.size() - 1;
+    }
+
+    inline bool isGeodesic() const {
+        return geodesic;
+    }
+
+
+private:
+    // Writes the nodes into its files.
+    friend class PolygonStore;
+
+    static constexpr uint32_t NONE = ~static_cast<uint32_t>(0);
+
+    // Deep enough for 2^32 entries.
+    static constexpr size_t MAX_DEPTH = 8;
+
+    struct Box {
+        double minLat;
+        double maxLat;
+        double minLng;
+        double maxLng;
+        uint32_t id;  // Polygon index for the entries, node index above
+    };
+
+    struct Node {
+        double minLat[NODE_CAPACITY];
+        double maxLat[NODE_CAPACITY];
+        double minLng[NODE_CAPACITY];
+        double maxLng[NODE_CAPACITY];
+        uint32_t child[NODE_CAPACITY];  // Polygon index in the leaves, node index otherwise
+        uint32_t count;
+        bool leaf;
+    };
+
+    bool geodesic;
+    std::vector<LatLng> vertices;    // All polygons, one after another
+    std::vector<uint32_t> offsets;   // Polygon i is vertices[offsets[i] .. offsets[i + 1])
+    std::vector<Node> nodes;
+    uint32_t root;
+
+    /**
+     * Walks the nodes whose box holds the point, calling found(id) for the polygons
+     * in the leaves until it returns true.
+     */
+    template <typename Found>
+    inline bool search(const LatLng& point, Found found) const {
+        if (root == NONE) {
+            return false;
+        }
+        double lat = point.lat;
+        double lng = MathUtil::wrap(point.lng, -180, 180);
+
+        uint32_t stack[MAX_DEPTH * NODE_CAPACITY];
+        size_t depth = 0;
+        stack[depth++] = root;
+        while (depth != 0) {
+            const Node& node = nodes[stack[--depth]];
+            for (uint32_t i = 0; i < node.count; ++i) {
+                if (lat < node.minLat[i] || lat > node.maxLat[i] || lng < node.minLng[i] || lng > node.maxLng[i]) {
+                    continue;
+                }
+                if (!node.leaf) {
+                    stack[depth++] = node.child[i];
+                } else if (found(node.child[i])) {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    /**
+     * Appends the boxes of polygon id, one or two (across the antimeridian).
+     */
+    inline void addBoxes(uint32_t id, std::vector<Box>& boxes) const {
+        LatLngBounds bounds = LatLngBounds::fromPolygon(polygon(id), geodesic);
+        if (bounds.isEmpty()) {
+            return;
+        }
+        Box box;
+        box.id = id;
+        box.minLat = bounds.southwest.lat;
+        box.maxLat = bounds.northeast.lat;
+        if (bounds.isFullLng()) {
+            box.minLng = -180;
+            box.maxLng = 180;
+            boxes.push_back(box);
+            return;
+        }
+        // Eastward from the west edge, past 180 across the antimeridian.
+        box.minLng = bounds.southwest.lng;
+        box.maxLng = bounds.northeast.lng + (bounds.northeast.lng < bounds.southwest.lng ? 360 : 0);
+        boxes.push_back(box);
+        if (box.maxLng > 180) {
+            box.minLng -= 360;
+            box.maxLng -= 360;
+            boxes.push_back(box);
+        }
+    }
+
+    /**
+     * Packs the boxes into the R-tree, level by level from the leaves up.
+     */
+    inline void build(std::vector<Box>& boxes) {
+        if (boxes.empty()) {
+            return;
+        }
+        nodes.reserve(boxes.size() / (NODE_CAPACITY - 1) + 2);
+        bool leaf = true;
+        while (boxes.size() > 1 || leaf) {
+            boxes = pack(boxes, leaf);
+            leaf = false;
+        }
+        root = boxes[0].id;
+    }
+
+    /**
+     * Sort-Tile-Recursive: sorts the boxes into vertical slices by longitude, each slice
+     * by latitude, and fills the nodes of a level in that order. Returns the node boxes.
+     */
+    inline std::vector<Box> pack(std::vector<Box>& boxes, bool leaf) {
+        size_t count = boxes.size();
+        size_t nodeCount = (count + NODE_CAPACITY - 1) / NODE_CAPACITY;
+        size_t slices = static_cast<size_t>(std::ceil(std::sqrt(static_cast<double>(nodeCount))));
+        size_t sliceSize = slices * NODE_CAPACITY;
+
+        std::sort(boxes.begin(), boxes.end(), [](const Box& a, const Box& b) {
+            return a.minLng + a.maxLng < b.minLng + b.maxLng;
+        });
+        for (size_t first = 0; first < count; first += sliceSize) {
+            auto end = boxes.begin() + static_cast<ptrdiff_t>(std::min(first + sliceSize, count));
+            std::sort(boxes.begin() + static_cast<ptrdiff_t>(first), end, [](const Box& a, const Box& b) {
+                return a.minLat + a.maxLat < b.minLat + b.maxLat;
+            });
+        }
+
+        std::vector<Box> parents;
+        parents.reserve(nodeCount);
+        for (size_t first = 0; first < count; first += NODE_CAPACITY) {
+            Node node;
+            node.leaf = leaf;
+            node.count = static_cast<uint32_t>(std::min(count - first, static_cast<size_t>(NODE_CAPACITY)));
+            Box parent = boxes[first];
+            parent.id = static_cast<uint32_t>(nodes.size());
+            for (uint32_t i = 0; i < node.count; ++i) {
+                const Box& box = boxes[first + i];
+                node.minLat[i] = box.minLat;
+                node.maxLat[i] = box.maxLat;
+                node.minLng[i] = box.minLng;
+                node.maxLng[i] = box.maxLng;
+                node.child[i] = box.id;
+                parent.minLat = std::min(parent.minLat, box.minLat);
+                parent.maxLat = std::max(parent.maxLat, box.maxLat);
+                parent.minLng = std::min(parent.minLng, box.minLng);
+                parent.maxLng = std::max(parent.maxLng, box.maxLng);
+            }
+            nodes.push_back(node);
+            parents.push_back(parent);
+        }
+        return parents;
+    }
+};
+
+#endif // GEOMETRY_LIBRARY_POLYGON_INDEX
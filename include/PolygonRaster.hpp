@@ -0,0 +1,926 @@
+//******************************************************************************
+// Copyright 2013 Google Inc.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// This software and the related documents are provided  as is,  with no express
+// or implied  warranties,  other than  those that are  expressly stated  in the
+// License.
+//******************************************************************************
+
+#ifndef GEOMETRY_LIBRARY_POLYGON_RASTER
+#define GEOMETRY_LIBRARY_POLYGON_RASTER
+
+#include <algorithm>
+#include <bitset>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+#include "MathUtil.hpp"
+#include "LatLng.hpp"
+#include "Instrumentation.hpp"
+
+
+/**
+ * A polygon rasterized once for many PolyUtil::containsLocation() queries.
+ *
+ * The constructor lays a grid of cells over the bounds of the polygon and marks every
+ * cell an edge passes through a boundary cell, keeping the list of those edges; no
+ * edge passes through the other cells, so each of them is wholly inside or wholly
+ * outside. The cells are stored by 16 x 16 tiles: a tile of one state takes one word,
+ * a mixed tile two bitmaps and the edge lists of its boundary cells.
+ *
+ * A query in an inside or outside cell is answered by the bitmap alone. A query in a
+ * boundary cell walks down its column to the first cell of known state: the meridian
+ * from the point to the South Pole can only cross an edge in one of the boundary cells
+ * on the way, and only the edges stored there are tested. Columns the crossing test
+ * cannot be walked through (under edges from a pole, or half way around the globe),
+ * points within rounding of the meridian of a vertex, and polygons with vertices
+ * outside [-180, 180], are answered by a full scan.
+ *
+ * Answers are identical to PolyUtil::containsLocation() with the same geodesic flag.
+ */
+class PolygonRaster {
+public:
+    // Cells along the longer side of the grid: 0 picks 16 * sqrt(vertices) within
+    // [MIN_AUTO_RESOLUTION, MAX_AUTO_RESOLUTION], which keeps the walks down the columns
+    // of dense polygons short.
+    static constexpr size_t DEFAULT_RESOLUTION = 0;
+    static constexpr size_t MIN_AUTO_RESOLUTION = 256;
+    static constexpr size_t MAX_AUTO_RESOLUTION = 2048;
+
+    // memoryUsage() above which the resolution is halved, by default.
+    static constexpr size_t DEFAULT_MAX_BYTES = size_t(64) << 20;
+
+    // Cells along each side of a tile.
+    static constexpr int32_t TILE = 16;
+
+    /**
+     * An empty polygon, which contains nothing; see deserialize().
+     */
+    PolygonRaster() : geodesic(false) {
+        prepareEdges();
+        clearRaster();
+    }
+
+    /**
+     * @param polygon    the vertices of the polygon
+     * @param geodesic   great circle edges if true, rhumb edges otherwise
+     * @param resolution cells along the longer side of the grid, which has an empty
+     *                   row and column around the polygon; rounded up to TILE, 0 for
+     *                   a resolution after the number of vertices
+     * @param maxBytes   the resolution is halved, down to TILE, until memoryUsage()
+     *                   is at most maxBytes
+     */
+    template <typename LatLngList>
+    explicit PolygonRaster(const LatLngList& polygon, bool geodesic = false,
+                           size_t resolution = DEFAULT_RESOLUTION, size_t maxBytes = DEFAULT_MAX_BYTES)
+        : geodesic(geodesic) {
+        vertices.reserve(polygon.size());
+        for (const auto& point : polygon) {
+            vertices.push_back(LatLng(point));
+        }
+        prepareEdges();
+        if (resolution == 0) {
+            resolution = static_cast<size_t>(16 * std::sqrt(static_cast<double>(vertices.size())));
+            resolution = resolution < MIN_AUTO_RESOLUTION ? MIN_AUTO_RESOLUTION :
+                         resolution > MAX_AUTO_RESOLUTION ? MAX_AUTO_RESOLUTION : resolution;
+        }
+        for (resolution = std::max(resolution, static_cast<size_t>(TILE)); ; resolution /= 2) {
+            build(resolution);
+            if (memoryUsage() <= maxBytes || resolution / 2 < static_cast<size_t>(TILE)) {
+                break;
+            }
+        }
+    }
+
+    /**
+     * Computes whether the given point lies inside the polygon.
+     * Same semantics as PolyUtil::containsLocation().
+     */
+    inline bool containsLocation(const LatLng& point) const {
+        GEOMETRY_LIBRARY_TIMER(POLYGON_RASTER);
+        GEOMETRY_LIBRARY_COUNT(POLYGON_RASTER, CALLS, 1);
+        if (edges.empty()) {
+            GEOMETRY_LIBRARY_COUNT(POLYGON_RASTER, EXIT_EMPTY, 1);
+            return false;
+        }
+        double lat3 = deg2rad(point.lat);
+        double lng3 = deg2rad(point.lng);
+        if (!rastered || !(std::fabs(lat3) < M_PI / 2) || !std::isfinite(lng3)) {
+            return scan(lat3, lng3);
+        }
+        double offset = offsetOf(lng3);
+        int64_t col = static_cast<int64_t>(offset / cellWidth);
+        int64_t row = static_cast<int64_t>(std::floor((lat3 - baseLat) / cellHeight));
+        // No edge spans the longitude, or all of them are above the point.
+        if ((!circular && col >= cols) || row < 0) {
+            GEOMETRY_LIBRARY_COUNT(POLYGON_RASTER, EXIT_BOUNDS, 1);
+            return false;
+        }
+        // On the meridian of a vertex, up to rounding, the crossings of its two edges need
+        // not agree with the side of the meridian the cells were counted on.
+        double rel = offset - col * cellWidth;
+        col %= cols;
+        if (nearVertexMeridian(col, rel)) {
+            return scan(lat3, lng3);
+        }
+        // Nothing is above the grid: the top row answers for the points over it.
+        row = std::min<int64_t>(row, rows - 1);
+        int64_t cell = cellAt(col, row);
+        if (cell < 0) {
+            GEOMETRY_LIBRARY_COUNT(POLYGON_RASTER, EXIT_CELL, 1);
+            return cell == INSIDE_CELL;
+        }
+
+        // Special case: point equal to vertex is inside.
+        for (uint32_t i = cellStart[cell]; i < cellStart[cell + 1]; ++i) {
+            const Edge& edge = edges[cellEdges[i]];
+            if (lat3 == edge.lat1 && MathUtil::wrap(lng3 - edge.lng1, -M_PI, M_PI) == 0) {
+                GEOMETRY_LIBRARY_COUNT(POLYGON_RASTER, EXIT_VERTEX, 1);
+                return true;
+            }
+        }
+
+        // Down the column, the crossings of the meridian change only at the edges of the
+        // boundary cells; from the top to the bottom of each cell, count the changes.
+        bool inside = false;
+        double lat = lat3;
+        double f = transform(lat3);
+        GEOMETRY_LIBRARY_COUNT(POLYGON_RASTER, TRIG, geodesic ? 1 : 2);
+        for (;;) {
+            GEOMETRY_LIBRARY_COUNT(POLYGON_RASTER, EDGES, cellStart[cell + 1] - cellStart[cell]);
+            for (uint32_t i = cellStart[cell]; i < cellStart[cell + 1]; ++i) {
+                const Edge& edge = edges[cellEdges[i]];
+                inside ^= intersects(edge, lat, lng3, f) != intersects(edge, rowLat[row], lng3, rowF[row]);
+            }
+            if (row == 0) {
+                return scan(lat3, lng3);
+            }
+            lat = rowLat[row];
+            f = rowF[row];
+            cell = cellAt(col, --row);
+            if (cell < 0) {
+                GEOMETRY_LIBRARY_COUNT(POLYGON_RASTER, EXIT_CELL, 1);
+                return inside != (cell == INSIDE_CELL);
+            }
+        }
+    }
+
+    /**
+     * Returns the number of edges (equal to the number of vertices).
+     */
+    inline size_t size() const {
+        return edges.size();
+    }
+
+    inline bool isGeodesic() const {
+        return geodesic;
+    }
+
+    /**
+     * Returns the cells along the longitude and latitude of the grid, 0 if the polygon
+     * is answered by a full scan.
+     */
+    inline size_t columns() const {
+        return static_cast<size_t>(cols);
+    }
+
+    inline size_t rowCount() const {
+        return static_cast<size_t>(rows);
+    }
+
+    /**
+     * Returns the number of boundary cells.
+     */
+    inline size_t boundaryCells() const {
+        return cellStart.size() - 1;
+    }
+
+    /**
+     * Returns the approximate heap and object size, in bytes.
+     */
+    inline size_t memoryUsage() const {
+        return sizeof(*this) +
+               vertices.size() * sizeof(LatLng) +
+               edges.size() * sizeof(Edge) +
+               tiles.size() * sizeof(uint32_t) +
+               mixed.size() * sizeof(Tile) +
+               (cellStart.size() + cellEdges.size()) * sizeof(uint32_t) +
+               (rowLat.size() + rowF.size() + columnVertices.size()) * sizeof(double) +
+               columnStart.size() * sizeof(uint32_t) +
+               columnSlices.size() * sizeof(uint64_t);
+    }
+
+    /**
+     * Returns the vertices, the grid and the cells in a self-contained byte string, to
+     * be read back by deserialize() instead of building the raster again. The numbers
+     * are stored in the byte order of the machine.
+     */
+    inline std::vector<uint8_t> serialize() const {
+        std::vector<uint8_t> out;
+        uint32_t magic = MAGIC;
+        uint32_t version = VERSION;
+        write(out, magic);
+        write(out, version);
+        write(out, static_cast<uint8_t>(geodesic));
+        write(out, static_cast<uint8_t>(rastered));
+        write(out, static_cast<uint8_t>(circular));
+        write(out, cols);
+        write(out, rows);
+        write(out, baseLng);
+        write(out, baseLat);
+        write(out, cellWidth);
+        write(out, cellHeight);
+        write(out, static_cast<uint64_t>(vertices.size()));
+        for (const auto& vertex : vertices) {
+            write(out, vertex.lat);
+            write(out, vertex.lng);
+        }
+        writeVector(out, tiles);
+        writeVector(out, mixed);
+        writeVector(out, cellStart);
+        writeVector(out, cellEdges);
+        return out;
+    }
+
+    /**
+     * Reads the output of serialize() into raster. Returns false, leaving raster as it
+     * was, if the bytes are not a well-formed raster.
+     */
+    static inline bool deserialize(const uint8_t* data, size_t size, PolygonRaster* raster) {
+        Reader reader = { data, size };
+        PolygonRaster result;
+        uint32_t magic = 0;
+        uint32_t version = 0;
+        uint8_t flags[3] = {};
+        uint64_t count = 0;
+        if (!reader.read(&magic) || magic != MAGIC || !reader.read(&version) || version != VERSION ||
+            !reader.read(&flags[0]) || !reader.read(&flags[1]) || !reader.read(&flags[2]) ||
+            !reader.read(&result.cols) || !reader.read(&result.rows) ||
+            !reader.read(&result.baseLng) || !reader.read(&result.baseLat) ||
+            !reader.read(&result.cellWidth) || !reader.read(&result.cellHeight) ||
+            !reader.read(&count) || count > reader.size / (2 * sizeof(double))) {
+            return false;
+        }
+        result.geodesic = flags[0] != 0;
+        result.rastered = flags[1] != 0;
+        result.circular = flags[2] != 0;
+        result.vertices.reserve(static_cast<size_t>(count));
+        for (uint64_t i = 0; i < count; ++i) {
+            double lat = 0;
+            double lng = 0;
+            reader.read(&lat);
+            reader.read(&lng);
+            result.vertices.push_back(LatLng(lat, lng));
+        }
+        if (!reader.readVector(&result.tiles) || !reader.readVector(&result.mixed) ||
+            !reader.readVector(&result.cellStart) || !reader.readVector(&result.cellEdges) ||
+            reader.size != 0) {
+            return false;
+        }
+        result.prepareEdges();
+        if (!result.validate()) {
+            return false;
+        }
+        if (result.rastered) {
+            result.prepareRows();
+            result.prepareColumns();
+        }
+        *raster = std::move(result);
+        return true;
+    }
+
+
+private:
+    struct Edge {
+        double lat1;     // Start latitude, radians
+        double lng1;     // Start longitude, radians
+        double lat2;     // End latitude, radians
+        double lng2;     // End longitude offset by -lng1 and wrapped to [-PI, PI)
+        double f1;       // tan(lat1) if geodesic, mercator(lat1) otherwise
+        double f2;       // tan(lat2) if geodesic, mercator(lat2) otherwise
+        double sinLng2;  // sin(lng2)
+        bool   blocked;  // The edge can never be crossed
+    };
+
+    // The cells of a mixed tile, bit (row % TILE) * TILE + col % TILE. The edges of
+    // the boundary cells follow those of the previous tiles, in the order of the bits.
+    struct Tile {
+        uint64_t inside[4];
+        uint64_t boundary[4];
+        uint64_t firstCell;   // Boundary cells of the previous tiles
+    };
+
+    struct Reader {
+        const uint8_t* data;
+        size_t size;
+
+        template <typename T>
+        inline bool read(T* value) {
+            if (size < sizeof(T)) {
+                return false;
+            }
+            std::memcpy(value, data, sizeof(T));
+            data += sizeof(T);
+            size -= sizeof(T);
+            return true;
+        }
+
+        template <typename T>
+        inline bool readVector(std::vector<T>* values) {
+            uint64_t count = 0;
+            if (!read(&count) || count > size / sizeof(T)) {
+                return false;
+            }
+            values->resize(static_cast<size_t>(count));
+            if (count != 0) {
+                std::memcpy(values->data(), data, values->size() * sizeof(T));
+            }
+            data += values->size() * sizeof(T);
+            size -= values->size() * sizeof(T);
+            return true;
+        }
+    };
+
+    static constexpr uint32_t MAGIC = 0x52504c47;   // "GLPR"
+    static constexpr uint32_t VERSION = 1;
+
+    // Tile states; a mixed tile is MIXED + its index in mixed.
+    static constexpr uint32_t OUTSIDE_TILE = 0;
+    static constexpr uint32_t INSIDE_TILE = 1;
+    static constexpr uint32_t MIXED = 2;
+
+    // Cell states returned by cellAt(); boundary cells are their index, from 0.
+    static constexpr int64_t OUTSIDE_CELL = -1;
+    static constexpr int64_t INSIDE_CELL = -2;
+
+    // Radians an edge is widened by before it is rasterized: far above the rounding
+    // of the query arithmetic, far below any cell.
+    static constexpr double MARGIN = 1e-9;
+    static constexpr double MIN_CELL = 1e-7;
+
+    bool geodesic;
+    std::vector<LatLng> vertices;
+    std::vector<Edge> edges;
+    bool inRange;   // All vertices within [-90, 90] x [-180, 180]
+
+    // Cell (col, row) covers longitudes from baseLng + col * cellWidth and latitudes from
+    // rowLat[row] = baseLat + row * cellHeight. A circular grid covers all longitudes.
+    bool rastered;
+    bool circular;
+    int32_t cols;
+    int32_t rows;
+    double baseLng;
+    double baseLat;
+    double cellWidth;
+    double cellHeight;
+    std::vector<uint32_t> tiles;       // Row by row, a state or MIXED + index
+    std::vector<Tile> mixed;
+    std::vector<uint32_t> cellStart;   // Boundary cell i has cellEdges[cellStart[i] .. cellStart[i + 1])
+    std::vector<uint32_t> cellEdges;
+    std::vector<double> rowLat;        // Latitude of the bottom of every row, and of the top
+    std::vector<double> rowF;          // transform() of rowLat
+
+    // The longitudes of the vertices within MARGIN of every column, as sorted offsets from
+    // its west side in columnVertices[columnStart[col] .. columnStart[col + 1]), and the
+    // slices of the column they fall in.
+    std::vector<uint32_t> columnStart;
+    std::vector<double> columnVertices;
+    std::vector<uint64_t> columnSlices;
+
+    inline double transform(double lat) const {
+        return geodesic ? tan(lat) : MathUtil::mercator(lat);
+    }
+
+    /**
+     * Returns whether the meridian from the point to the South Pole crosses the edge.
+     * Mirrors PolyUtil::intersects().
+     */
+    inline bool intersects(const Edge& edge, double lat3, double lng3, double f3) const {
+        double dLng3 = MathUtil::wrap(lng3 - edge.lng1, -M_PI, M_PI);
+        // Both ends on the same side of lng3.
+        if ((dLng3 >= 0 && dLng3 >= edge.lng2) || (dLng3 < 0 && dLng3 < edge.lng2)) {
+            return false;
+        }
+        // Point is South Pole.
+        if (lat3 <= -M_PI / 2 || edge.blocked) {
+            return false;
+        }
+        double linearLat = (edge.lat1 * (edge.lng2 - dLng3) + edge.lat2 * dLng3) / edge.lng2;
+        // Northern hemisphere and point under lat-lng line.
+        if (edge.lat1 >= 0 && edge.lat2 >= 0 && lat3 < linearLat) {
+            return false;
+        }
+        // Southern hemisphere and point above lat-lng line.
+        if (edge.lat1 <= 0 && edge.lat2 <= 0 && lat3 >= linearLat) {
+            return true;
+        }
+        // North Pole.
+        if (lat3 >= M_PI / 2) {
+            return true;
+        }
+        return geodesic ?
+            f3 >= (edge.f1 * sin(edge.lng2 - dLng3) + edge.f2 * sin(dLng3)) / edge.sinLng2 :
+            f3 >= (edge.f1 * (edge.lng2 - dLng3) + edge.f2 * dLng3) / edge.lng2;
+    }
+
+    /**
+     * PolyUtil::containsLocation() over all the edges.
+     */
+    inline bool scan(double lat3, double lng3) const {
+        double f3 = transform(lat3);
+        GEOMETRY_LIBRARY_COUNT(POLYGON_RASTER, TRIG, geodesic ? 1 : 2);
+        size_t nIntersect = 0;
+        for (const auto& edge : edges) {
+            GEOMETRY_LIBRARY_COUNT(POLYGON_RASTER, EDGES, 1);
+            // Special case: point equal to vertex is inside.
+            if (lat3 == edge.lat1 && MathUtil::wrap(lng3 - edge.lng1, -M_PI, M_PI) == 0) {
+                GEOMETRY_LIBRARY_COUNT(POLYGON_RASTER, EXIT_VERTEX, 1);
+                return true;
+            }
+            nIntersect += intersects(edge, lat3, lng3, f3);
+        }
+        return (nIntersect & 1) != 0;
+    }
+
+    /**
+     * Returns the offset of the given longitude (radians) from baseLng, in [0, 2 * PI).
+     */
+    inline double offsetOf(double lng) const {
+        double offset = std::fmod(lng - baseLng, 2 * M_PI);
+        return offset < 0 ? offset + 2 * M_PI : offset;
+    }
+
+    /**
+     * Returns the slice of a column, of 64, at the given offset from its west side.
+     */
+    inline unsigned sliceOf(double rel) const {
+        return static_cast<unsigned>(MathUtil::clamp(rel / cellWidth * 64, 0, 63));
+    }
+
+    /**
+     * Returns whether the given offset from the west side of the column lies within
+     * MARGIN of the longitude of a vertex.
+     */
+    inline bool nearVertexMeridian(int64_t col, double rel) const {
+        if ((columnSlices[col] & (uint64_t(1) << sliceOf(rel))) == 0) {
+            return false;
+        }
+        auto last = columnVertices.begin() + columnStart[col + 1];
+        auto it = std::lower_bound(columnVertices.begin() + columnStart[col], last, rel - MARGIN);
+        return it != last && *it <= rel + MARGIN;
+    }
+
+    /**
+     * Returns the number of bits set in word; MSVC has no __builtin_popcountll.
+     */
+    static inline int popcount(uint64_t word) {
+#ifdef __GNUC__
+        return __builtin_popcountll(word);
+#else
+        return static_cast<int>(std::bitset<64>(word).count());
+#endif
+    }
+
+    /**
+     * Returns OUTSIDE_CELL, INSIDE_CELL or the index of a boundary cell.
+     */
+    inline int64_t cellAt(int64_t col, int64_t row) const {
+        uint32_t tile = tiles[static_cast<size_t>((row / TILE) * (cols / TILE) + col / TILE)];
+        if (tile < MIXED) {
+            return tile == INSIDE_TILE ? INSIDE_CELL : OUTSIDE_CELL;
+        }
+        const Tile& cells = mixed[tile - MIXED];
+        unsigned bit = static_cast<unsigned>((row % TILE) * TILE + col % TILE);
+        unsigned word = bit >> 6;
+        uint64_t mask = uint64_t(1) << (bit & 63);
+        if ((cells.boundary[word] & mask) == 0) {
+            return (cells.inside[word] & mask) != 0 ? INSIDE_CELL : OUTSIDE_CELL;
+        }
+        int64_t index = static_cast<int64_t>(cells.firstCell);
+        for (unsigned i = 0; i < word; ++i) {
+            index += PolygonRaster::popcount(cells.boundary[i]);
+        }
+        return index + PolygonRaster::popcount(cells.boundary[word] & (mask - 1));
+    }
+
+    inline void prepareEdges() {
+        size_t size = vertices.size();
+        edges.clear();
+        edges.reserve(size);
+        inRange = true;
+        if (size == 0) {
+            return;
+        }
+        double lat1 = deg2rad(vertices[size - 1].lat);
+        double lng1 = deg2rad(vertices[size - 1].lng);
+        for (const auto& vertex : vertices) {
+            double lat2 = deg2rad(vertex.lat);
+            double lng2 = deg2rad(vertex.lng);
+            inRange = inRange && std::fabs(lat2) <= M_PI / 2 && std::fabs(lng2) <= M_PI;
+
+            Edge edge;
+            edge.lat1 = lat1;
+            edge.lng1 = lng1;
+            edge.lat2 = lat2;
+            edge.lng2 = MathUtil::wrap(lng2 - lng1, -M_PI, M_PI);
+            edge.f1 = transform(lat1);
+            edge.f2 = transform(lat2);
+            edge.sinLng2 = sin(edge.lng2);
+            // Any segment end is a pole, or the segment spans half the globe.
+            edge.blocked = lat1 <= -M_PI / 2 || lat2 <= -M_PI / 2 || lat1 >= M_PI / 2 || lat2 >= M_PI / 2 ||
+                           edge.lng2 <= -M_PI;
+            edges.push_back(edge);
+
+            lat1 = lat2;
+            lng1 = lng2;
+        }
+    }
+
+    inline void prepareRows() {
+        rowLat.resize(static_cast<size_t>(rows) + 1);
+        rowF.resize(rowLat.size());
+        for (size_t row = 0; row < rowLat.size(); ++row) {
+            rowLat[row] = baseLat + static_cast<double>(row) * cellHeight;
+            rowF[row] = transform(rowLat[row]);
+        }
+    }
+
+    inline void prepareColumns() {
+        columnStart.assign(static_cast<size_t>(cols) + 1, 0);
+        columnSlices.assign(static_cast<size_t>(cols), 0);
+        forEachVertexColumn([&](size_t col, double) {
+            ++columnStart[col + 1];
+        });
+        for (size_t col = 0; col < static_cast<size_t>(cols); ++col) {
+            columnStart[col + 1] += columnStart[col];
+        }
+        columnVertices.resize(columnStart.back());
+        std::vector<uint32_t> fill(columnStart.begin(), columnStart.end() - 1);
+        forEachVertexColumn([&](size_t col, double rel) {
+            columnVertices[fill[col]++] = rel;
+            for (unsigned slice = sliceOf(rel - MARGIN); slice <= sliceOf(rel + MARGIN); ++slice) {
+                columnSlices[col] |= uint64_t(1) << slice;
+            }
+        });
+        for (size_t col = 0; col < static_cast<size_t>(cols); ++col) {
+            std::sort(columnVertices.begin() + columnStart[col], columnVertices.begin() + columnStart[col + 1]);
+        }
+    }
+
+    /**
+     * Calls visit(col, rel) for every column within MARGIN of the longitude of a vertex,
+     * rel the offset of the longitude from the west side of the column.
+     */
+    template <typename Visit>
+    inline void forEachVertexColumn(Visit visit) const {
+        for (const auto& edge : edges) {
+            double offset = offsetOf(edge.lng1);
+            int64_t first = static_cast<int64_t>(std::floor((offset - MARGIN) / cellWidth));
+            int64_t last  = static_cast<int64_t>(std::floor((offset + MARGIN) / cellWidth));
+            for (int64_t col = first; col <= last; ++col) {
+                if (circular || (col >= 0 && col < cols)) {
+                    visit(static_cast<size_t>(wrapColumn(col)), offset - col * cellWidth);
+                }
+            }
+        }
+    }
+
+    /**
+     * Stores the longitude of the column farthest from the meridians of the vertices, in
+     * the middle of the widest gap between them. Returns false if no gap is wider than
+     * 4 * MARGIN.
+     */
+    inline bool sweepMeridian(size_t col, double* lng) const {
+        double west = 0;
+        double widest = -1;
+        double middle = 0;
+        for (uint32_t i = columnStart[col]; i <= columnStart[col + 1]; ++i) {
+            double east = i < columnStart[col + 1] ? columnVertices[i] : cellWidth;
+            if (east - west > widest) {
+                widest = east - west;
+                middle = (west + east) / 2;
+            }
+            west = std::max(west, east);
+        }
+        *lng = baseLng + col * cellWidth + middle;
+        return widest > 4 * MARGIN;
+    }
+
+    inline void clearRaster() {
+        rastered = false;
+        circular = false;
+        cols = 0;
+        rows = 0;
+        baseLng = 0;
+        baseLat = 0;
+        cellWidth = 0;
+        cellHeight = 0;
+        tiles.clear();
+        mixed.clear();
+        cellStart.assign(1, 0);
+        cellEdges.clear();
+        rowLat.clear();
+        rowF.clear();
+        columnStart.clear();
+        columnVertices.clear();
+        columnSlices.clear();
+    }
+
+    /**
+     * Extends [*minLat, *maxLat] to the latitudes the crossing test sees on the edge
+     * between longitude offsets d0 <= d1 from its start, within [0, lng2]: the edge
+     * itself and the lat-lng line of the hemisphere shortcuts.
+     */
+    inline void extendLatRange(const Edge& edge, double d0, double d1, double* minLat, double* maxLat) const {
+        auto extend = [&](double lat) {
+            *minLat = std::min(*minLat, lat);
+            *maxLat = std::max(*maxLat, lat);
+        };
+        if (edge.lng2 == 0) {
+            extend(edge.lat1);
+            extend(edge.lat2);
+            return;
+        }
+        for (double d : { d0, d1 }) {
+            extend((edge.lat1 * (edge.lng2 - d) + edge.lat2 * d) / edge.lng2);
+            extend(geodesic ?
+                atan((edge.f1 * sin(edge.lng2 - d) + edge.f2 * sin(d)) / edge.sinLng2) :
+                MathUtil::inverseMercator((edge.f1 * (edge.lng2 - d) + edge.f2 * d) / edge.lng2));
+        }
+        if (geodesic) {
+            // f1 * sin(lng2 - d) + f2 * sin(d) == a * cos(d) + b * sin(d) peaks at atan2(b, a).
+            double a = edge.f1 * edge.sinLng2;
+            double b = edge.f2 - edge.f1 * cos(edge.lng2);
+            double peak = atan2(b, a);
+            for (double d : { peak, peak - M_PI, peak + M_PI }) {
+                if (d > d0 && d < d1) {
+                    extend(atan((edge.f1 * sin(edge.lng2 - d) + edge.f2 * sin(d)) / edge.sinLng2));
+                }
+            }
+        }
+    }
+
+    /**
+     * Calls visit(col, row) for every cell within MARGIN of the edge.
+     */
+    template <typename Visit>
+    inline void forEachCell(const Edge& edge, Visit visit) const {
+        double start = offsetOf(edge.lng1);
+        double lo = std::min(0.0, edge.lng2);
+        double hi = std::max(0.0, edge.lng2);
+        int64_t first = static_cast<int64_t>(std::floor((start + lo - MARGIN) / cellWidth));
+        int64_t last  = static_cast<int64_t>(std::floor((start + hi + MARGIN) / cellWidth));
+        for (int64_t col = first; col <= last; ++col) {
+            double d0 = MathUtil::clamp(col * cellWidth - start - MARGIN, lo, hi);
+            double d1 = MathUtil::clamp((col + 1) * cellWidth - start + MARGIN, lo, hi);
+            double minLat = INFINITY;
+            double maxLat = -INFINITY;
+            extendLatRange(edge, d0, d1, &minLat, &maxLat);
+            int64_t bottom = static_cast<int64_t>(std::floor((minLat - MARGIN - baseLat) / cellHeight));
+            int64_t top = static_cast<int64_t>(std::floor((maxLat + MARGIN - baseLat) / cellHeight));
+            int64_t column = wrapColumn(col);
+            for (int64_t row = std::max<int64_t>(bottom, 0); row <= std::min<int64_t>(top, rows - 1); ++row) {
+                visit(column, row);
+            }
+        }
+    }
+
+    inline int64_t wrapColumn(int64_t col) const {
+        if (circular) {
+            return ((col % cols) + cols) % cols;
+        }
+        return std::min<int64_t>(std::max<int64_t>(col, 0), cols - 1);
+    }
+
+    /**
+     * Marks the columns within MARGIN of the given longitude.
+     */
+    inline void blockColumns(double lng, std::vector<char>& blocked) const {
+        double offset = offsetOf(lng);
+        int64_t first = static_cast<int64_t>(std::floor((offset - MARGIN) / cellWidth));
+        int64_t last  = static_cast<int64_t>(std::floor((offset + MARGIN) / cellWidth));
+        for (int64_t col = first; col <= last; ++col) {
+            if (circular || (col >= 0 && col < cols)) {
+                blocked[static_cast<size_t>(wrapColumn(col))] = 1;
+            }
+        }
+    }
+
+    inline static int32_t roundUpToTile(double cells) {
+        return static_cast<int32_t>(std::ceil(cells / TILE - 1e-9)) * TILE;
+    }
+
+    inline void build(size_t resolution) {
+        clearRaster();
+        if (edges.empty() || !inRange) {
+            return;
+        }
+
+        // Unwrap the ring so every edge covers a continuous longitude axis, and take the
+        // latitudes the crossing test sees on it.
+        double lng = edges[0].lng1;
+        double minLng = lng;
+        double maxLng = lng;
+        double minLat = INFINITY;
+        double maxLat = -INFINITY;
+        for (const auto& edge : edges) {
+            lng += edge.lng2;
+            minLng = std::min(minLng, lng);
+            maxLng = std::max(maxLng, lng);
+            if (edge.blocked) {
+                minLat = std::min(minLat, std::min(edge.lat1, edge.lat2));
+                maxLat = std::max(maxLat, std::max(edge.lat1, edge.lat2));
+            } else {
+                extendLatRange(edge, std::min(0.0, edge.lng2), std::max(0.0, edge.lng2), &minLat, &maxLat);
+            }
+        }
+
+        // Square cells over the bounds, anything wider than half the globe (or winding
+        // around a pole) over all longitudes. An empty column on each side, and an empty
+        // row below, which the walk down a column stops at.
+        double width = maxLng - minLng;
+        circular = width >= M_PI;
+        double cell = std::max(circular ? 2 * M_PI : width, maxLat - minLat) / static_cast<double>(resolution - 2);
+        cell = cell > MIN_CELL ? cell : MIN_CELL;
+        if (circular) {
+            cols = roundUpToTile(2 * M_PI / cell);
+            cellWidth = 2 * M_PI / cols;
+            baseLng = -M_PI;
+        } else {
+            cols = roundUpToTile(width / cell + 2);
+            cellWidth = cell;
+            baseLng = minLng - cell;
+        }
+        rows = roundUpToTile((maxLat - minLat) / cell + 2);
+        cellHeight = cell;
+        baseLat = minLat - cell - 2 * MARGIN;
+        prepareRows();
+        prepareColumns();
+
+        // The edges of every cell, by counting sort.
+        size_t cellCount = static_cast<size_t>(cols) * static_cast<size_t>(rows);
+        std::vector<uint32_t> start(cellCount + 1, 0);
+        std::vector<char> blocked(static_cast<size_t>(cols), 0);
+        for (const auto& edge : edges) {
+            if (edge.blocked) {
+                blockColumns(edge.lng1, blocked);
+                blockColumns(edge.lng1 + edge.lng2, blocked);
+                continue;
+            }
+            forEachCell(edge, [&](int64_t col, int64_t row) {
+                ++start[static_cast<size_t>(row * cols + col) + 1];
+            });
+        }
+        for (size_t i = 0; i < cellCount; ++i) {
+            start[i + 1] += start[i];
+        }
+        std::vector<uint32_t> all(start[cellCount]);
+        std::vector<uint32_t> fill(start.begin(), start.end() - 1);
+        for (size_t i = 0; i < edges.size(); ++i) {
+            if (!edges[i].blocked) {
+                forEachCell(edges[i], [&](int64_t col, int64_t row) {
+                    all[fill[static_cast<size_t>(row * cols + col)]++] = static_cast<uint32_t>(i);
+                });
+            }
+        }
+        auto isBoundary = [&](size_t col, size_t row) {
+            size_t i = row * static_cast<size_t>(cols) + col;
+            return blocked[col] != 0 || start[i + 1] != start[i];
+        };
+
+        // Up every column from below the polygon, where nothing is crossed, counting the
+        // crossings the edges of the boundary cells add from bottom to top, along a
+        // meridian clear of the vertices.
+        std::vector<char> inside(cellCount, 0);
+        for (size_t col = 0; col < static_cast<size_t>(cols); ++col) {
+            if (blocked[col] != 0) {
+                continue;
+            }
+            double center;
+            if (!sweepMeridian(col, &center)) {
+                blocked[col] = 1;
+                continue;
+            }
+            bool state = false;
+            for (size_t row = 0; row < static_cast<size_t>(rows); ++row) {
+                size_t i = row * static_cast<size_t>(cols) + col;
+                for (uint32_t j = start[i]; j < start[i + 1]; ++j) {
+                    const Edge& edge = edges[all[j]];
+                    state ^= intersects(edge, rowLat[row + 1], center, rowF[row + 1]) !=
+                             intersects(edge, rowLat[row], center, rowF[row]);
+                }
+                inside[i] = state;
+            }
+        }
+
+        // Tiles of one state collapse; the others keep bitmaps and edge lists.
+        int32_t tilesX = cols / TILE;
+        int32_t tilesY = rows / TILE;
+        tiles.resize(static_cast<size_t>(tilesX) * static_cast<size_t>(tilesY));
+        for (int32_t ty = 0; ty < tilesY; ++ty) {
+            for (int32_t tx = 0; tx < tilesX; ++tx) {
+                Tile cells = {};
+                bool anyInside = false;
+                bool anyOutside = false;
+                bool anyBoundary = false;
+                for (unsigned bit = 0; bit < TILE * TILE; ++bit) {
+                    size_t col = static_cast<size_t>(tx * TILE) + bit % TILE;
+                    size_t row = static_cast<size_t>(ty * TILE) + bit / TILE;
+                    uint64_t mask = uint64_t(1) << (bit & 63);
+                    if (isBoundary(col, row)) {
+                        cells.boundary[bit >> 6] |= mask;
+                        anyBoundary = true;
+                    } else if (inside[row * static_cast<size_t>(cols) + col] != 0) {
+                        cells.inside[bit >> 6] |= mask;
+                        anyInside = true;
+                    } else {
+                        anyOutside = true;
+                    }
+                }
+                uint32_t& tile = tiles[static_cast<size_t>(ty * tilesX + tx)];
+                if (!anyBoundary && !(anyInside && anyOutside)) {
+                    tile = anyInside ? INSIDE_TILE : OUTSIDE_TILE;
+                    continue;
+                }
+                tile = MIXED + static_cast<uint32_t>(mixed.size());
+                cells.firstCell = cellStart.size() - 1;
+                for (unsigned bit = 0; bit < TILE * TILE; ++bit) {
+                    if ((cells.boundary[bit >> 6] & (uint64_t(1) << (bit & 63))) != 0) {
+                        size_t i = (static_cast<size_t>(ty * TILE) + bit / TILE) * static_cast<size_t>(cols) +
+                                   static_cast<size_t>(tx * TILE) + bit % TILE;
+                        cellEdges.insert(cellEdges.end(), all.begin() + start[i], all.begin() + start[i + 1]);
+                        cellStart.push_back(static_cast<uint32_t>(cellEdges.size()));
+                    }
+                }
+                mixed.push_back(cells);
+            }
+        }
+        rastered = true;
+    }
+
+    /**
+     * Checks deserialized fields against each other, so no query reads out of bounds.
+     */
+    inline bool validate() const {
+        if (!rastered) {
+            return cols == 0 && rows == 0 && tiles.empty() && mixed.empty() &&
+                   cellStart.size() == 1 && cellStart[0] == 0 && cellEdges.empty();
+        }
+        if (edges.empty() || !inRange || cols <= 0 || rows <= 0 || cols % TILE != 0 || rows % TILE != 0 ||
+            static_cast<int64_t>(cols) * rows > (int64_t(1) << 32) ||
+            !std::isfinite(baseLng) || !std::isfinite(baseLat) ||
+            !(cellWidth > 0) || !std::isfinite(cellWidth) || !(cellHeight > 0) || !std::isfinite(cellHeight) ||
+            tiles.size() != static_cast<size_t>(cols / TILE) * static_cast<size_t>(rows / TILE) ||
+            cellStart.empty() || cellStart[0] != 0 || cellStart.back() != cellEdges.size()) {
+            return false;
+        }
+        for (size_t i = 0; i + 1 < cellStart.size(); ++i) {
+            if (cellStart[i] > cellStart[i + 1]) {
+                return false;
+            }
+        }
+        for (uint32_t edge : cellEdges) {
+            if (edge >= edges.size()) {
+                return false;
+            }
+        }
+        for (uint32_t tile : tiles) {
+            if (tile >= MIXED && tile - MIXED >= mixed.size()) {
+                return false;
+            }
+        }
+        for (const auto& cells : mixed) {
+            uint64_t count = 0;
+            for (uint64_t word : cells.boundary) {
+                count += static_cast<uint64_t>(PolygonRaster::popcount(word));
+            }
+            if (cells.firstCell > cellStart.size() - 1 || count > cellStart.size() - 1 - cells.firstCell) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    template <typename T>
+    static inline void write(std::vector<uint8_t>& out, const T& value) {
+        const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&value);
+        out.insert(out.end(), bytes, bytes + sizeof(T));
+    }
+
+    template <typename T>
+    static inline void writeVector(std::vector<uint8_t>& out, const std::vector<T>& values) {
+        write(out, static_cast<uint64_t>(values.size()));
+        const uint8_t* bytes = reinterpret_cast<const uint8_t*>(values.data());
+        out.insert(out.end(), bytes, bytes + values.size() * sizeof(T));
+    }
+};
+
+#endif // GEOMETRY_LIBRARY_POLYGON_RASTER
@@ -0,0 +1,606 @@
+//******************************************************************************
+// Copyright 2013 Google Inc.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// This software and the related documents are provided  as is,  with no express
+// or implied  warranties,  other than  those that are  expressly stated  in the
+// License.
+//******************************************************************************
+
+#ifndef GEOMETRY_LIBRARY_POLYGON_STORE
+#define GEOMETRY_LIBRARY_POLYGON_STORE
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "MathUtil.hpp"
+#include "LatLng.hpp"
+#include "PolyUtil.hpp"
+#include "PolygonIndex.hpp"
+
+
+/**
+ * A LatLngList over consecutive LatLngs in memory it does not own, e.g. a feature
+ * of a PolygonStore: the PolyUtil and SphericalUtil templates take it as it is.
+ */
+class LatLngSpan {
+public:
+    typedef const LatLng* const_iterator;
+    typedef const_iterator iterator;
+    typedef LatLng value_type;
+
+    LatLngSpan() : first(nullptr), last(nullptr) {}
+    LatLngSpan(const LatLng* first, const LatLng* last) : first(first), last(last) {}
+
+    inline const_iterator begin() const { return first; }
+    inline const_iterator end() const { return last; }
+    inline size_t size() const { return static_cast<size_t>(last - first); }
+    inline bool empty() const { return first == last; }
+    inline const LatLng* data() const { return first; }
+    inline const LatLng& operator[](size_t i) const { return first[i]; }
+
+private:
+    const LatLng* first;
+    const LatLng* last;
+};
+
+
+/**
+ * Polygons and paths in a compact binary file, used in place: opening a store maps
+ * the file, and its features are LatLngSpans into the mapping.
+ *
+ * The format is little-endian, version 1, its sections aligned to 8 bytes:
+ *   header    64 bytes: magic "GLPS", version (uint16), flags (uint16, GEODESIC),
+ *             then as uint64 the feature and vertex counts, the byte offsets of
+ *             the offsets, kinds, vertices and index sections, and the index node count
+ *   offsets   features + 1 uint64: feature i is vertices [offsets[i], offsets[i + 1])
+ *   kinds     one byte a feature, POLYGON or PATH
+ *   vertices  latitude and longitude in degrees, as doubles: the layout of LatLng
+ *   index     optional, the R-tree of PolygonIndex over the polygons in 584-byte nodes,
+ *             children before their parents and the root last
+ *
+ * open() checks the header and the section bounds, in constant time; the offsets are
+ * checked as features are read and the index as it is walked, so a damaged file gives
+ * wrong answers but no access outside the mapping. Pages are read on first use.
+ * findAny() and findAll() answer as PolyUtil::containsLocation() on every polygon,
+ * with the geodesic flag the store was written with.
+ *
+ * Only little-endian hosts read stores in place; on others, open() returns false.
+ */
+class PolygonStore {
+    struct IndexNode;
+
+public:
+    static constexpr uint32_t MAGIC = 0x53504c47;  // "GLPS"
+    static constexpr uint16_t VERSION = 1;
+    static constexpr uint16_t GEODESIC = 1;        // Flag: the edges are great circle segments
+
+    enum Kind {
+        POLYGON = 0,
+        PATH = 1,
+    };
+
+    /**
+     * Collects features and writes them in the format above.
+     */
+    class Writer {
+    public:
+        /**
+         * @param geodesic the polygons are composed of great circle segments if geodesic
+         *                 is true, and of Rhumb segments otherwise
+         */
+        explicit Writer(bool geodesic = false) : geodesic(geodesic) {
+            offsets.push_back(0);
+        }
+
+        /**
+         * Adds a polygon; returns its index in the store.
+         */
+        template <typename LatLngList>
+        inline size_t addPolygon(const LatLngList& polygon) {
+            return add(polygon, POLYGON);
+        }
+
+        /**
+         * Adds a path, which findAny() and findAll() skip; returns its index in the store.
+         */
+        template <typename LatLngList>
+        inline size_t addPath(const LatLngList& path) {
+            return add(path, PATH);
+        }
+
+        inline size_t size() const {
+            return kinds.size();
+        }
+
+        /**
+         * Returns the bytes of the store, with the R-tree of the polygons if index is true.
+         */
+        inline std::vector<uint8_t> serialize(bool index = true) const {
+            std::vector<IndexNode> nodes;
+            if (index) {
+                buildIndex(nodes);
+            }
+            size_t count = kinds.size();
+            uint64_t offsetsAt = HEADER_SIZE;
+            uint64_t kindsAt = offsetsAt + (count + 1) * 8;
+            uint64_t verticesAt = align(kindsAt + count);
+            uint64_t indexAt = nodes.empty() ? 0 : align(verticesAt + vertices.size() * sizeof(LatLng));
+            uint64_t end = nodes.empty() ? verticesAt + vertices.size() * sizeof(LatLng) : indexAt + nodes.size() * sizeof(IndexNode);
+
+            std::vector<uint8_t> out;
+            out.reserve(static_cast<size_t>(end));
+            put(out, MAGIC, 4);
+            put(out, VERSION, 2);
+            put(out, geodesic ? GEODESIC : 0, 2);
+            put(out, count, 8);
+            put(out, vertices.size(), 8);
+            put(out, offsetsAt, 8);
+            put(out, kindsAt, 8);
+            put(out, verticesAt, 8);
+            put(out, indexAt, 8);
+            put(out, nodes.size(), 8);
+            for (uint64_t offset : offsets) {
+                put(out, offset, 8);
+            }
+            out.insert(out.end(), kinds.begin(), kinds.end());
+            out.resize(static_cast<size_t>(verticesAt), 0);
+            for (const LatLng& point : vertices) {
+                putDouble(out, point.lat);
+                putDouble(out, point.lng);
+            }
+            if (!nodes.empty()) {
+                out.resize(static_cast<size_t>(indexAt), 0);
+                for (const IndexNode& node : nodes) {
+                    for (const double* column : { node.minLat, node.maxLat, node.minLng, node.maxLng }) {
+                        for (size_t i = 0; i < NODE_CAPACITY; ++i) {
+                            putDouble(out, column[i]);
+                        }
+                    }
+                    for (size_t i = 0; i < NODE_CAPACITY; ++i) {
+                        put(out, node.child[i], 4);
+                    }
+                    put(out, node.count, 4);
+                    put(out, node.leaf, 4);
+                }
+            }
+            return out;
+        }
+
+        /**
+         * Writes serialize() to the file at path; returns false if it could not.
+         */
+        inline bool save(const std::string& path, bool index = true) const {
+            std::vector<uint8_t> bytes = serialize(index);
+            std::FILE* file = std::fopen(path.c_str(), "wb");
+            if (file == nullptr) {
+                return false;
+            }
+            bool written = std::fwrite(bytes.data(), 1, bytes.size(), file) == bytes.size();
+            return std::fclose(file) == 0 && written;
+        }
+
+    private:
+        bool geodesic;
+        std::vector<LatLng> vertices;
+        std::vector<uint64_t> offsets;
+        std::vector<uint8_t> kinds;
+
+        template <typename LatLngList>
+        inline size_t add(const LatLngList& feature, Kind kind) {
+            for (const auto& point : feature) {
+                vertices.push_back(LatLng(point.lat, point.lng));
+            }
+            offsets.push_back(vertices.size());
+            kinds.push_back(static_cast<uint8_t>(kind));
+            return kinds.size() - 1;
+        }
+
+        /**
+         * Copies the nodes of a PolygonIndex over the polygons, the paths left empty.
+         */
+        inline void buildIndex(std::vector<IndexNode>& nodes) const {
+            std::vector<LatLngSpan> rings;
+            rings.reserve(kinds.size());
+            for (size_t i = 0; i < kinds.size(); ++i) {
+                const LatLng* first = vertices.data() + offsets[i];
+                rings.push_back(kinds[i] == POLYGON ? LatLngSpan(first, vertices.data() + offsets[i + 1]) : LatLngSpan());
+            }
+            PolygonIndex index(rings, geodesic);
+            for (const PolygonIndex::Node& from : index.nodes) {
+                IndexNode node;
+                std::memset(&node, 0, sizeof(node));
+                for (size_t i = 0; i < from.count; ++i) {
+                    node.minLat[i] = from.minLat[i];
+                    node.maxLat[i] = from.maxLat[i];
+                    node.minLng[i] = from.minLng[i];
+                    node.maxLng[i] = from.maxLng[i];
+                    node.child[i] = from.child[i];
+                }
+                node.count = from.count;
+                node.leaf = from.leaf ? 1 : 0;
+                nodes.push_back(node);
+            }
+        }
+
+        static inline uint64_t align(uint64_t offset) {
+            return (offset + 7) & ~static_cast<uint64_t>(7);
+        }
+
+        static inline void put(std::vector<uint8_t>& out, uint64_t value, size_t bytes) {
+            for (size_t i = 0; i < bytes; ++i) {
+                out.push_back(static_cast<uint8_t>(value >> (8 * i)));
+            }
+        }
+
+        static inline void putDouble(std::vector<uint8_t>& out, double value) {
+            uint64_t bits;
+            std::memcpy(&bits, &value, sizeof(bits));
+            put(out, bits, 8);
+        }
+    };
+
+    PolygonStore() : view(nullptr), viewSize(0) {
+        clear();
+    }
+
+    ~PolygonStore() {
+        close();
+    }
+
+    PolygonStore(PolygonStore&& other) : view(nullptr), viewSize(0) {
+        clear();
+        *this = std::move(other);
+    }
+
+    PolygonStore& operator=(PolygonStore&& other) {
+        if (this != &other) {
+            close();
+            layout = other.layout;
+            view = other.view;
+            viewSize = other.viewSize;
+            other.view = nullptr;
+            other.viewSize = 0;
+            other.clear();
+        }
+        return *this;
+    }
+
+    PolygonStore(const PolygonStore&) = delete;
+    PolygonStore& operator=(const PolygonStore&) = delete;
+
+    /**
+     * Maps the file at path and reads the store in place. Returns false, leaving the
+     * store as it was, if the file cannot be mapped or is not a well-formed store.
+     */
+    inline bool open(const std::string& path) {
+        void* mapped = nullptr;
+        size_t size = 0;
+        if (!PolygonStore::map(path, &mapped, &size)) {
+            return false;
+        }
+        Layout parsed;
+        if (!PolygonStore::parse(static_cast<const uint8_t*>(mapped), size, &parsed)) {
+            PolygonStore::unmap(mapped, size);
+            return false;
+        }
+        close();
+        layout = parsed;
+        view = mapped;
+        viewSize = size;
+        return true;
+    }
+
+    /**
+     * Reads the store in place from memory the caller keeps alive and unchanged,
+     * aligned to 8 bytes. Returns false, leaving the store as it was, for bytes which
+     * are not a well-formed store.
+     */
+    inline bool attach(const uint8_t* data, size_t size) {
+        Layout parsed;
+        if (!PolygonStore::parse(data, size, &parsed)) {
+            return false;
+        }
+        close();
+        layout = parsed;
+        return true;
+    }
+
+    /**
+     * Unmaps the file, or forgets the attached memory; the store is then empty.
+     */
+    inline void close() {
+        if (view != nullptr) {
+            PolygonStore::unmap(view, viewSize);
+            view = nullptr;
+            viewSize = 0;
+        }
+        clear();
+    }
+
+    /**
+     * Returns the number of features, polygons and paths.
+     */
+    inline size_t size() const {
+        return layout.features;
+    }
+
+    inline Kind kind(size_t i) const {
+        return layout.kinds[i] == POLYGON ? POLYGON : PATH;
+    }
+
+    /**
+     * Returns the vertices of feature i, empty if its offsets are damaged.
+     */
+    inline LatLngSpan feature(size_t i) const {
+        uint64_t first = layout.offsets[i];
+        uint64_t last = layout.offsets[i + 1];
+        if (first > last || last > layout.vertexCount) {
+            return LatLngSpan();
+        }
+        return LatLngSpan(layout.vertices + first, layout.vertices + last);
+    }
+
+    inline bool isGeodesic() const {
+        return layout.geodesic;
+    }
+
+    inline bool hasIndex() const {
+        return layout.nodeCount != 0;
+    }
+
+    /**
+     * Returns whether any polygon contains the given point, and stores the index of
+     * one of them.
+     */
+    inline bool findAny(const LatLng& point, size_t* index = nullptr) const {
+        return search(point, [&](size_t i) {
+            if (!PolyUtil::containsLocation(point, feature(i), layout.geodesic)) {
+                return false;
+            }
+            if (index != nullptr) {
+                *index = i;
+            }
+            return true;
+        });
+    }
+
+    /**
+     * Returns the indices of all polygons containing the given point, in increasing order.
+     */
+    inline std::vector<size_t> findAll(const LatLng& point) const {
+        std::vector<size_t> result;
+        findAll(point, result);
+        return result;
+    }
+
+    /**
+     * Same as above, appending to out.
+     */
+    inline void findAll(const LatLng& point, std::vector<size_t>& out) const {
+        size_t first = out.size();
+        search(point, [&](size_t i) {
+            if (PolyUtil::containsLocation(point, feature(i), layout.geodesic)) {
+                out.push_back(i);
+            }
+            return false;
+        });
+        std::sort(out.begin() + first, out.end());
+        out.erase(std::unique(out.begin() + first, out.end()), out.end());
+    }
+
+
+private:
+    static constexpr size_t HEADER_SIZE = 64;
+    static constexpr size_t NODE_CAPACITY = PolygonIndex::NODE_CAPACITY;
+
+    // Deep enough for 2^32 entries.
+    static constexpr size_t MAX_DEPTH = 8;
+
+    // An R-tree node as stored, little-endian.
+    struct IndexNode {
+        double minLat[NODE_CAPACITY];
+        double maxLat[NODE_CAPACITY];
+        double minLng[NODE_CAPACITY];
+        double maxLng[NODE_CAPACITY];
+        uint32_t child[NODE_CAPACITY];  // Feature index in the leaves, node index otherwise
+        uint32_t count;
+        uint32_t leaf;
+    };
+
+    static_assert(sizeof(IndexNode) == 584, "IndexNode is the 584 bytes of a stored node");
+    static_assert(sizeof(LatLng) == 16 && std::is_standard_layout<LatLng>::value, "LatLng is two doubles");
+
+    // Where the sections of a store are.
+    struct Layout {
+        bool geodesic;
+        size_t features;
+        uint64_t vertexCount;
+        const uint64_t* offsets;
+        const uint8_t* kinds;
+        const LatLng* vertices;
+        const IndexNode* nodes;
+        size_t nodeCount;
+    };
+
+    Layout layout;
+    void* view;       // The mapping of open(), nullptr otherwise
+    size_t viewSize;
+
+    inline void clear() {
+        // A store of no features still has offsets[0].
+        static const uint64_t noOffsets[1] = { 0 };
+        layout.geodesic = false;
+        layout.features = 0;
+        layout.vertexCount = 0;
+        layout.offsets = noOffsets;
+        layout.kinds = nullptr;
+        layout.vertices = nullptr;
+        layout.nodes = nullptr;
+        layout.nodeCount = 0;
+    }
+
+    /**
+     * Calls found(i) for the polygons whose box holds the point, all of them without
+     * an index, until it returns true. Returns whether it did.
+     */
+    template <typename Found>
+    inline bool search(const LatLng& point, Found found) const {
+        if (layout.nodeCount == 0) {
+            for (size_t i = 0; i < layout.features; ++i) {
+                if (layout.kinds[i] == POLYGON && found(i)) {
+                    return true;
+                }
+            }
+            return false;
+        }
+        double lat = point.lat;
+        double lng = MathUtil::wrap(point.lng, -180, 180);
+
+        uint32_t stack[MAX_DEPTH * NODE_CAPACITY];
+        size_t depth = 0;
+        stack[depth++] = static_cast<uint32_t>(layout.nodeCount - 1);
+        while (depth != 0) {
+            uint32_t id = stack[--depth];
+            const IndexNode& node = layout.nodes[id];
+            uint32_t count = node.count < NODE_CAPACITY ? node.count : static_cast<uint32_t>(NODE_CAPACITY);
+            for (uint32_t i = 0; i < count; ++i) {
+                if (lat < node.minLat[i] || lat > node.maxLat[i] || lng < node.minLng[i] || lng > node.maxLng[i]) {
+                    continue;
+                }
+                uint32_t child = node.child[i];
+                if (!node.leaf) {
+                    // Children come before their parents: a damaged tree cannot loop.
+                    if (child < id && depth < MAX_DEPTH * NODE_CAPACITY) {
+                        stack[depth++] = child;
+                    }
+                } else if (child < layout.features && layout.kinds[child] == POLYGON && found(child)) {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    static inline uint64_t get(const uint8_t* data, size_t bytes) {
+        uint64_t value = 0;
+        for (size_t i = 0; i < bytes; ++i) {
+            value |= static_cast<uint64_t>(data[i]) << (8 * i);
+        }
+        return value;
+    }
+
+    /**
+     * Checks the header and the bounds of the sections, and locates them.
+     */
+    static inline bool parse(const uint8_t* data, size_t size, Layout* parsed) {
+        uint16_t probe = 1;
+        uint8_t lowByte;
+        std::memcpy(&lowByte, &probe, 1);
+        if (lowByte != 1 || data == nullptr || reinterpret_cast<uintptr_t>(data) % 8 != 0 || size < HEADER_SIZE) {
+            return false;
+        }
+        uint64_t features = get(data + 8, 8);
+        uint64_t vertexCount = get(data + 16, 8);
+        uint64_t offsetsAt = get(data + 24, 8);
+        uint64_t kindsAt = get(data + 32, 8);
+        uint64_t verticesAt = get(data + 40, 8);
+        uint64_t indexAt = get(data + 48, 8);
+        uint64_t nodeCount = get(data + 56, 8);
+        if (get(data, 4) != MAGIC || get(data + 4, 2) != VERSION) {
+            return false;
+        }
+        // Every section within the bytes, the counts first so the products do not overflow.
+        if (features >= size / 8 || vertexCount > size / sizeof(LatLng) || nodeCount > size / sizeof(IndexNode) ||
+            offsetsAt % 8 != 0 || offsetsAt > size || (features + 1) * 8 > size - offsetsAt ||
+            kindsAt > size || features > size - kindsAt ||
+            verticesAt % 8 != 0 || verticesAt > size || vertexCount * sizeof(LatLng) > size - verticesAt ||
+            (nodeCount != 0 && (indexAt % 8 != 0 || indexAt > size || nodeCount * sizeof(IndexNode) > size - indexAt))) {
+            return false;
+        }
+        parsed->geodesic = (get(data + 6, 2) & GEODESIC) != 0;
+        parsed->features = static_cast<size_t>(features);
+        parsed->vertexCount = vertexCount;
+        parsed->offsets = reinterpret_cast<const uint64_t*>(data + offsetsAt);
+        parsed->kinds = data + kindsAt;
+        parsed->vertices = reinterpret_cast<const LatLng*>(data + verticesAt);
+        parsed->nodes = reinterpret_cast<const IndexNode*>(data + indexAt);
+        parsed->nodeCount = static_cast<size_t>(nodeCount);
+        return true;
+    }
+
+    static inline bool map(const std::string& path, void** mapped, size_t* size) {
+#ifdef _WIN32
+        HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                  FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) {
+            return false;
+        }
+        LARGE_INTEGER length;
+        HANDLE mapping = nullptr;
+        if (GetFileSizeEx(file, &length) && length.QuadPart > 0 &&
+            static_cast<uint64_t>(length.QuadPart) <= static_cast<uint64_t>(SIZE_MAX)) {
+            mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        }
+        *mapped = mapping != nullptr ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+        *size = *mapped != nullptr ? static_cast<size_t>(length.QuadPart) : 0;
+        // The view keeps the mapping alive.
+        if (mapping != nullptr) {
+            CloseHandle(mapping);
+        }
+        CloseHandle(file);
+        return *mapped != nullptr;
+#else
+        int file = ::open(path.c_str(), O_RDONLY);
+        if (file < 0) {
+            return false;
+        }
+        struct stat status;
+        void* start = MAP_FAILED;
+        if (fstat(file, &status) == 0 && status.st_size > 0 &&
+            static_cast<uint64_t>(status.st_size) <= static_cast<uint64_t>(SIZE_MAX)) {
+            start = mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+        }
+        // The mapping outlives the descriptor.
+        ::close(file);
+        if (start == MAP_FAILED) {
+            return false;
+        }
+        *mapped = start;
+        *size = static_cast<size_t>(status.st_size);
+        return true;
+#endif
+    }
+
+    static inline void unmap(void* mapped, size_t size) {
+#ifdef _WIN32
+        (void) size;
+        UnmapViewOfFile(mapped);
+#else
+        munmap(mapped, size);
+#endif
+    }
+};
+
+#endif // GEOMETRY_LIBRARY_POLYGON_STORE
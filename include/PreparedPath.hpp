@@ -0,0 +1,310 @@
+//******************************************************************************
+// Copyright 2013 Google Inc.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// This software and the related documents are provided  as is,  with no express
+// or implied  warranties,  other than  those that are  expressly stated  in the
+// License.
+//******************************************************************************
+
+#ifndef GEOMETRY_LIBRARY_PREPARED_PATH
+#define GEOMETRY_LIBRARY_PREPARED_PATH
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "MathUtil.hpp"
+#include "LatLng.hpp"
+#include "PolyUtil.hpp"
+
+
+/**
+ * A polyline, or the edge of a polygon, prepared once for many
+ * PolyUtil::locationIndexOnEdgeOrPath() queries with a fixed tolerance.
+ *
+ * The constructor converts every vertex to radians (and mercator() for Rhumb
+ * segments) and builds a bounding volume hierarchy over the segments in path order:
+ * every segment box holds all points within the tolerance of the segment, and 16
+ * consecutive boxes make a node. A query walks down the boxes holding the point, in
+ * path order, and runs the exact segment test on those segments only; the first
+ * segment found is the one the linear scan would find.
+ *
+ * Answers are identical to PolyUtil::locationIndexOnEdgeOrPath() with the same
+ * closed, geodesic and tolerance arguments.
+ */
+class PreparedPath {
+public:
+    // Children per tree node.
+    static constexpr size_t NODE_CAPACITY = 16;
+
+    /**
+     * @param path      a series of connected coordinates in an ordered sequence
+     * @param closed    whether the path is closed by a segment from the last point back to the first one
+     * @param geodesic  the path is composed of great circle segments if geodesic is true, and of Rhumb segments otherwise
+     * @param tolerance tolerance, in meters
+     */
+    template <typename LatLngList>
+    explicit PreparedPath(const LatLngList& path, bool closed = false, bool geodesic = true,
+                          double tolerance = PolyUtil::DEFAULT_TOLERANCE)
+        : closed(closed), geodesic(geodesic), toleranceEarth(tolerance),
+          tolerance(tolerance / MathUtil::EARTH_RADIUS), havTolerance(MathUtil::hav(tolerance / MathUtil::EARTH_RADIUS)),
+          root(NONE) {
+        size_t size = path.size();
+        vertices.reserve(size);
+        for (const auto& point : path) {
+            Vertex vertex;
+            vertex.lat = point.lat;
+            vertex.lng = point.lng;
+            vertex.latRad = latRadians(point);
+            vertex.lngRad = lngRadians(point);
+            vertex.y = geodesic ? 0 : MathUtil::mercator(vertex.latRad);
+            vertices.push_back(vertex);
+        }
+        build();
+    }
+
+    /**
+     * Computes whether (and where) the given point lies on or near the path.
+     *
+     * @return -1 if the point does not lie on or near the path, otherwise the index i
+     * of the first segment from poly[i] to poly[i + 1] it lies near; the closing
+     * segment of a closed path counts as 0, as in PolyUtil::locationIndexOnEdgeOrPath().
+     */
+    inline int locationIndexOnEdgeOrPath(const LatLng& point) const {
+        GEOMETRY_LIBRARY_TIMER(LOCATION_ON_EDGE_OR_PATH);
+        GEOMETRY_LIBRARY_COUNT(LOCATION_ON_EDGE_OR_PATH, CALLS, 1);
+        if (root == NONE) {
+            GEOMETRY_LIBRARY_COUNT(LOCATION_ON_EDGE_OR_PATH, EXIT_EMPTY, 1);
+            return -1;
+        }
+        double lat = point.lat;
+        double lng = MathUtil::wrap(point.lng, -180, 180);
+        double lat3 = deg2rad(point.lat);
+        double lng3 = deg2rad(point.lng);
+        double y3 = geodesic ? 0 : MathUtil::mercator(lat3);
+        GEOMETRY_LIBRARY_COUNT(LOCATION_ON_EDGE_OR_PATH, TRIG, geodesic ? 0 : 2);
+
+        uint32_t stack[MAX_DEPTH * NODE_CAPACITY];
+        size_t depth = 0;
+        stack[depth++] = root;
+        while (depth != 0) {
+            const Node& node = nodes[stack[--depth]];
+            if (node.leaf) {
+                for (uint32_t i = 0; i < node.count; ++i) {
+                    if (holds(node, i, lat, lng) && isOnSegment(node.child[i], lat3, lng3, y3)) {
+                        return std::max(0, static_cast<int>(node.child[i]) - 1);
+                    }
+                }
+                continue;
+            }
+            // Children are pushed backwards, so they pop in path order.
+            for (uint32_t i = node.count; i-- != 0;) {
+                if (holds(node, i, lat, lng)) {
+                    stack[depth++] = node.child[i];
+                }
+            }
+        }
+        return -1;
+    }
+
+    /**
+     * Computes whether the given point lies on or near the path.
+     */
+    inline bool isLocationOnEdgeOrPath(const LatLng& point) const {
+        return locationIndexOnEdgeOrPath(point) >= 0;
+    }
+
+    /**
+     * Returns the number of vertices.
+     */
+    inline size_t size() const {
+        return vertices.size();
+    }
+
+    inline bool isClosed() const {
+        return closed;
+    }
+
+    inline bool isGeodesic() const {
+        return geodesic;
+    }
+
+    /**
+     * Returns the tolerance, in meters.
+     */
+    inline double getTolerance() const {
+        return toleranceEarth;
+    }
+
+
+private:
+    static constexpr uint32_t NONE = ~static_cast<uint32_t>(0);
+
+    // Deep enough for 2^32 segments.
+    static constexpr size_t MAX_DEPTH = 8;
+
+    struct Vertex {
+        double lat;     // Degrees
+        double lng;
+        double latRad;  // Radians
+        double lngRad;
+        double y;       // mercator(latRad), Rhumb segments only
+    };
+
+    /**
+     * Longitudes are unwrapped with minLng in [-180, 180), so a box may reach past 180
+     * and a longitude lng is in it if lng or lng + 360 is.
+     */
+    struct Box {
+        double minLat;
+        double maxLat;
+        double minLng;
+        double maxLng;
+        uint32_t id;  // Segment index for the entries, node index above
+    };
+
+    struct Node {
+        double minLat[NODE_CAPACITY];
+        double maxLat[NODE_CAPACITY];
+        double minLng[NODE_CAPACITY];
+        double maxLng[NODE_CAPACITY];
+        uint32_t child[NODE_CAPACITY];  // Segment index in the leaves, node index otherwise
+        uint32_t count;
+        bool leaf;
+    };
+
+    bool closed;
+    bool geodesic;
+    double toleranceEarth;  // Meters
+    double tolerance;       // Radians
+    double havTolerance;
+    std::vector<Vertex> vertices;
+    std::vector<Node> nodes;
+    uint32_t root;
+
+    /**
+     * Returns the start vertex of segment i, which ends at vertex i; segment 0 starts
+     * at the last vertex of a closed path and is the single first vertex otherwise.
+     */
+    inline const Vertex& start(size_t i) const {
+        return vertices[i != 0 ? i - 1 : (closed ? vertices.size() - 1 : 0)];
+    }
+
+    static inline bool holds(const Node& node, uint32_t i, double lat, double lng) {
+        return lat >= node.minLat[i] && lat <= node.maxLat[i] &&
+               ((lng >= node.minLng[i] && lng <= node.maxLng[i]) ||
+                (lng + 360 >= node.minLng[i] && lng + 360 <= node.maxLng[i]));
+    }
+
+    /**
+     * The loop body of PolyUtil::locationIndexOnEdgeOrPath() for segment i.
+     */
+    inline bool isOnSegment(uint32_t i, double lat3, double lng3, double y3) const {
+        const Vertex& from = start(i);
+        const Vertex& to = vertices[i];
+        GEOMETRY_LIBRARY_COUNT(LOCATION_ON_EDGE_OR_PATH, EDGES, 1);
+        return geodesic ?
+            PolyUtil::isOnSegmentGC(from.latRad, from.lngRad, to.latRad, to.lngRad, lat3, lng3, havTolerance) :
+            PolyUtil::isOnSegmentRhumb(from.latRad, from.lngRad, from.y, to.latRad, to.lngRad, to.y,
+                                       lat3, lng3, y3, tolerance, havTolerance);
+    }
+
+    /**
+     * Returns a box holding every point within the tolerance of segment i.
+     */
+    inline Box segmentBox(uint32_t i) const {
+        const Vertex& from = start(i);
+        const Vertex& to = vertices[i];
+        // Both segment kinds take the shorter way in longitude.
+        double delta = MathUtil::wrap(to.lng - from.lng, -180, 180);
+        double minLat = std::min(from.lat, to.lat);
+        double maxLat = std::max(from.lat, to.lat);
+        if (geodesic) {
+            MathUtil::extendGreatCircleLatRange(from.lat, to.lat, delta, &minLat, &maxLat);
+        }
+
+        // The exact tests compare haversines; a margin covers their rounding.
+        double buffer = std::fabs(tolerance) * 1.01 + 1e-12;
+        double bufferDeg = rad2deg(buffer);
+        Box box;
+        box.id = i;
+        box.minLat = minLat - bufferDeg;
+        box.maxLat = maxLat + bufferDeg;
+
+        // Within angular distance d of a point at latitude lat, longitudes differ by at
+        // most asin(sin(d) / cos(lat)). Segments near half the globe, whose shorter way
+        // is ambiguous, and boxes reaching a pole span all longitudes.
+        double maxAbsLat = deg2rad(std::max(std::fabs(minLat), std::fabs(maxLat)));
+        double sinLngBuffer = sin(buffer) / cos(maxAbsLat);
+        if (std::fabs(delta) >= 179 || box.maxLat >= 90 || box.minLat <= -90 || !(sinLngBuffer < 1)) {
+            box.minLng = -180;
+            box.maxLng = 180;
+            return box;
+        }
+        double lngBuffer = rad2deg(asin(sinLngBuffer)) * 1.01 + 1e-9;
+        double lng = MathUtil::wrap(from.lng, -180, 180);
+        box.minLng = std::min(lng, lng + delta) - lngBuffer;
+        box.maxLng = std::max(lng, lng + delta) + lngBuffer;
+        if (box.maxLng - box.minLng >= 360) {
+            box.minLng = -180;
+            box.maxLng = 180;
+        } else if (box.minLng < -180) {
+            box.minLng += 360;
+            box.maxLng += 360;
+        }
+        return box;
+    }
+
+    /**
+     * Groups the segment boxes, in path order, NODE_CAPACITY at a time into the
+     * nodes of a level, from the leaves up.
+     */
+    inline void build() {
+        if (vertices.empty()) {
+            return;
+        }
+        std::vector<Box> boxes;
+        boxes.reserve(vertices.size());
+        for (size_t i = 0; i < vertices.size(); ++i) {
+            boxes.push_back(segmentBox(static_cast<uint32_t>(i)));
+        }
+        nodes.reserve(boxes.size() / (NODE_CAPACITY - 1) + 2);
+        bool leaf = true;
+        while (boxes.size() > 1 || leaf) {
+            std::vector<Box> parents;
+            parents.reserve(boxes.size() / NODE_CAPACITY + 1);
+            for (size_t first = 0; first < boxes.size(); first += NODE_CAPACITY) {
+                Node node;
+                node.leaf = leaf;
+                node.count = static_cast<uint32_t>(std::min(boxes.size() - first, static_cast<size_t>(NODE_CAPACITY)));
+                Box parent = boxes[first];
+                parent.id = static_cast<uint32_t>(nodes.size());
+                for (uint32_t i = 0; i < node.count; ++i) {
+                    const Box& box = boxes[first + i];
+                    node.minLat[i] = box.minLat;
+                    node.maxLat[i] = box.maxLat;
+                    node.minLng[i] = box.minLng;
+                    node.maxLng[i] = box.maxLng;
+                    node.child[i] = box.id;
+                    parent.minLat = std::min(parent.minLat, box.minLat);
+                    parent.maxLat = std::max(parent.maxLat, box.maxLat);
+                    parent.minLng = std::min(parent.minLng, box.minLng);
+                    parent.maxLng = std::max(parent.maxLng, box.maxLng);
+                }
+                nodes.push_back(node);
+                parents.push_back(parent);
+            }
+            boxes.swap(parents);
+            leaf = false;
+        }
+        root = boxes[0].id;
+    }
+};
+
+#endif // GEOMETRY_LIBRARY_PREPARED_PATH
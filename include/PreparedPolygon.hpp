@@ -0,0 +1,315 @@
+//******************************************************************************
+// Copyright 2013 Google Inc.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// This software and the related documents are provided  as is,  with no express
+// or implied  warranties,  other than  those that are  expressly stated  in the
+// License.
+//******************************************************************************
+
+#ifndef GEOMETRY_LIBRARY_PREPARED_POLYGON
+#define GEOMETRY_LIBRARY_PREPARED_POLYGON
+
+#include <vector>
+#include <cstdint>
+
+#include "MathUtil.hpp"
+#include "LatLng.hpp"
+#include "Instrumentation.hpp"
+
+
+/**
+ * A polygon prepared once for many PolyUtil::containsLocation() queries.
+ *
+ * The constructor converts every vertex to radians and caches the per-edge
+ * values used by the crossing test (wrapped longitude delta, tan() or mercator()
+ * of the end latitudes, sin() of the longitude delta). Edges are bucketed by the
+ * longitude band they span, so a query only visits the edges whose band covers
+ * the point's longitude; the others can never be crossed by the point's meridian.
+ *
+ * Answers are identical to PolyUtil::containsLocation() with the same geodesic flag.
+ */
+class PreparedPolygon {
+public:
+    template <typename LatLngList>
+    explicit PreparedPolygon(const LatLngList& polygon, bool geodesic = false)
+        : geodesic(geodesic), indexed(false), base(0), bucketWidth(0), bucketCount(0), circular(false) {
+        size_t size = polygon.size();
+        if (size == 0) {
+            return;
+        }
+        edges.reserve(size);
+
+        // Vertices outside [-180, 180] are wrapped by MathUtil::wrap() in ways the
+        // band index does not model; such polygons are answered by a full scan.
+        bool inRange = true;
+        auto prev = polygon[size - 1];
+        double lat1 = latRadians(prev);
+        double lng1 = lngRadians(prev);
+        for (auto val : polygon) {
+            double lat2 = latRadians(val);
+            double lng2 = lngRadians(val);
+            inRange = inRange && std::fabs(lng2) <= M_PI;
+
+            Edge edge;
+            edge.lat1 = lat1;
+            edge.lng1 = lng1;
+            edge.lat2 = lat2;
+            edge.lng2 = MathUtil::wrap(lng2 - lng1, -M_PI, M_PI);
+            edge.f1 = geodesic ? tan(lat1) : MathUtil::mercator(lat1);
+            edge.f2 = geodesic ? tan(lat2) : MathUtil::mercator(lat2);
+            edge.sinLng2 = sin(edge.lng2);
+            // Any segment end is a pole, or the segment spans half the globe.
+            edge.blocked = lat1 <= -M_PI / 2 || lat2 <= -M_PI / 2 || lat1 >= M_PI / 2 || lat2 >= M_PI / 2 ||
+                           edge.lng2 <= -M_PI;
+            edges.push_back(edge);
+
+            lat1 = lat2;
+            lng1 = lng2;
+        }
+
+        if (inRange) {
+            buildIndex();
+        }
+    }
+
+    /**
+     * Computes whether the given point lies inside the prepared polygon.
+     * Same semantics as PolyUtil::containsLocation().
+     */
+    inline bool containsLocation(const LatLng& point) const {
+        GEOMETRY_LIBRARY_TIMER(PREPARED_POLYGON);
+        GEOMETRY_LIBRARY_COUNT(PREPARED_POLYGON, CALLS, 1);
+        if (edges.empty()) {
+            GEOMETRY_LIBRARY_COUNT(PREPARED_POLYGON, EXIT_EMPTY, 1);
+            return false;
+        }
+        double lat3 = deg2rad(point.lat);
+        double lng3 = deg2rad(point.lng);
+        double f3 = geodesic ? tan(lat3) : MathUtil::mercator(lat3);
+        GEOMETRY_LIBRARY_COUNT(PREPARED_POLYGON, TRIG, geodesic ? 1 : 2);
+
+        const uint32_t* first = nullptr;
+        const uint32_t* last  = nullptr;
+        if (indexed && std::fabs(lng3) <= M_PI) {
+            int64_t bucket = bucketOf(lng3);
+            if (bucket < 0) {
+                GEOMETRY_LIBRARY_COUNT(PREPARED_POLYGON, EXIT_BOUNDS, 1);
+                return false;
+            }
+            first = bucketEdges.data() + bucketStart[bucket];
+            last  = bucketEdges.data() + bucketStart[bucket + 1];
+        }
+
+        size_t nIntersect = 0;
+        if (first == nullptr) {
+            for (const auto& edge : edges) {
+                int result = crossing(edge, lat3, lng3, f3);
+                if (result < 0) {
+                    GEOMETRY_LIBRARY_COUNT(PREPARED_POLYGON, EXIT_VERTEX, 1);
+                    return true;
+                }
+                nIntersect += result;
+            }
+        } else {
+            for (; first != last; ++first) {
+                int result = crossing(edges[*first], lat3, lng3, f3);
+                if (result < 0) {
+                    GEOMETRY_LIBRARY_COUNT(PREPARED_POLYGON, EXIT_VERTEX, 1);
+                    return true;
+                }
+                nIntersect += result;
+            }
+        }
+        return (nIntersect & 1) != 0;
+    }
+
+    /**
+     * Returns the number of edges (equal to the number of vertices).
+     */
+    inline size_t size() const {
+        return edges.size();
+    }
+
+    inline bool isGeodesic() const {
+        return geodesic;
+    }
+
+
+private:
+    struct Edge {
+        double lat1;     // Start latitude, radians
+        double lng1;     // Start longitude, radians
+        double lat2;     // End latitude, radians
+        double lng2;     // End longitude offset by -lng1 and wrapped to [-PI, PI)
+        double f1;       // tan(lat1) if geodesic, mercator(lat1) otherwise
+        double f2;       // tan(lat2) if geodesic, mercator(lat2) otherwise
+        double sinLng2;  // sin(lng2)
+        bool   blocked;  // The edge can never be crossed
+    };
+
+    bool geodesic;
+    std::vector<Edge> edges;
+
+    // Longitude band index. Band i covers [base + i * bucketWidth, base + (i + 1) * bucketWidth)
+    // and bucketEdges[bucketStart[i] .. bucketStart[i + 1]) lists the edges spanning it.
+    bool indexed;
+    double base;
+    double bucketWidth;
+    int64_t bucketCount;
+    bool circular;   // Bands cover the whole circle and wrap around.
+    std::vector<uint32_t> bucketStart;
+    std::vector<uint32_t> bucketEdges;
+
+    /**
+     * Returns -1 if the point equals the edge start vertex, 1 if the meridian from the
+     * point to the South Pole crosses the edge and 0 otherwise.
+     * Mirrors the loop body of PolyUtil::containsLocation() and PolyUtil::intersects().
+     */
+    inline int crossing(const Edge& edge, double lat3, double lng3, double f3) const {
+        GEOMETRY_LIBRARY_COUNT(PREPARED_POLYGON, EDGES, 1);
+        double dLng3 = MathUtil::wrap(lng3 - edge.lng1, -M_PI, M_PI);
+        // Special case: point equal to vertex is inside.
+        if (lat3 == edge.lat1 && dLng3 == 0) {
+            return -1;
+        }
+        // Both ends on the same side of lng3.
+        if ((dLng3 >= 0 && dLng3 >= edge.lng2) || (dLng3 < 0 && dLng3 < edge.lng2)) {
+            GEOMETRY_LIBRARY_COUNT(PREPARED_POLYGON, EDGE_LONGITUDE, 1);
+            return 0;
+        }
+        // Point is South Pole.
+        if (lat3 <= -M_PI / 2 || edge.blocked) {
+            GEOMETRY_LIBRARY_COUNT(PREPARED_POLYGON, EDGE_LATITUDE, 1);
+            return 0;
+        }
+        double linearLat = (edge.lat1 * (edge.lng2 - dLng3) + edge.lat2 * dLng3) / edge.lng2;
+        // Northern hemisphere and point under lat-lng line.
+        if (edge.lat1 >= 0 && edge.lat2 >= 0 && lat3 < linearLat) {
+            GEOMETRY_LIBRARY_COUNT(PREPARED_POLYGON, EDGE_LATITUDE, 1);
+            return 0;
+        }
+        // Southern hemisphere and point above lat-lng line.
+        if (edge.lat1 <= 0 && edge.lat2 <= 0 && lat3 >= linearLat) {
+            GEOMETRY_LIBRARY_COUNT(PREPARED_POLYGON, EDGE_LATITUDE, 1);
+            return 1;
+        }
+        // North Pole.
+        if (lat3 >= M_PI / 2) {
+            GEOMETRY_LIBRARY_COUNT(PREPARED_POLYGON, EDGE_LATITUDE, 1);
+            return 1;
+        }
+        GEOMETRY_LIBRARY_COUNT(PREPARED_POLYGON, TRIG, geodesic ? 2 : 0);
+        return geodesic ?
+            f3 >= (edge.f1 * sin(edge.lng2 - dLng3) + edge.f2 * sin(dLng3)) / edge.sinLng2 :
+            f3 >= (edge.f1 * (edge.lng2 - dLng3) + edge.f2 * dLng3) / edge.lng2;
+    }
+
+    /**
+     * Returns the band holding the given longitude (radians, within [-PI, PI]),
+     * or -1 if no edge spans that longitude.
+     */
+    inline int64_t bucketOf(double lng) const {
+        double offset = std::fmod(lng - base, 2 * M_PI);
+        if (offset < 0) {
+            offset += 2 * M_PI;
+        }
+        int64_t bucket = static_cast<int64_t>(offset / bucketWidth);
+        if (circular) {
+            return bucket % bucketCount;
+        }
+        if (bucket < bucketCount) {
+            return bucket;
+        }
+        // Just below base, across the 2 * PI seam.
+        return offset > 2 * M_PI - bucketWidth ? 0 : -1;
+    }
+
+    inline void buildIndex() {
+        // Unwrap the ring so every edge covers [lo, hi] of a continuous longitude axis.
+        std::vector<double> lo(edges.size());
+        std::vector<double> hi(edges.size());
+        double lng = edges[0].lng1;
+        double minLng = lng;
+        double maxLng = lng;
+        for (size_t i = 0; i < edges.size(); ++i) {
+            double next = lng + edges[i].lng2;
+            lo[i] = std::min(lng, next);
+            hi[i] = std::max(lng, next);
+            minLng = std::min(minLng, lo[i]);
+            maxLng = std::max(maxLng, hi[i]);
+            lng = next;
+        }
+
+        // Narrow polygons get bands over their own extent, anything wider than
+        // half the globe (or winding around a pole) over the whole circle.
+        double span = maxLng - minLng;
+        circular = span >= M_PI;
+        base = circular ? -M_PI : minLng;
+        double width = circular ? 2 * M_PI : span;
+
+        // Aim for about one band per edge; coarsen the bands while long edges would
+        // blow the index up beyond a few entries per edge.
+        const double minBucketWidth = 1e-9;
+        size_t budget = 8 * edges.size() + 64;
+        int64_t target = static_cast<int64_t>(std::min<size_t>(edges.size(), 1U << 20));
+        std::vector<int64_t> firstBucket(edges.size());
+        std::vector<int64_t> bucketSpan(edges.size());
+        for (;;) {
+            bucketWidth = std::max(width / target, minBucketWidth);
+            bucketCount = circular ? target : static_cast<int64_t>(width / bucketWidth) + 1;
+            size_t total = 0;
+            for (size_t i = 0; i < edges.size(); ++i) {
+                // One extra band on each side absorbs the rounding of the query offset.
+                double offset = lo[i] - base;
+                if (circular) {
+                    offset = std::fmod(offset, 2 * M_PI);
+                    if (offset < 0) {
+                        offset += 2 * M_PI;
+                    }
+                }
+                int64_t first = static_cast<int64_t>(std::floor(offset / bucketWidth)) - 1;
+                int64_t last  = static_cast<int64_t>(std::floor((offset + hi[i] - lo[i]) / bucketWidth)) + 1;
+                if (!circular) {
+                    first = std::max<int64_t>(first, 0);
+                    last  = std::min<int64_t>(last, bucketCount - 1);
+                }
+                firstBucket[i] = first;
+                bucketSpan[i]  = std::min<int64_t>(last - first + 1, bucketCount);
+                total += static_cast<size_t>(bucketSpan[i]);
+            }
+            if (total <= budget || target == 1) {
+                break;
+            }
+            target /= 2;
+        }
+
+        bucketStart.assign(static_cast<size_t>(bucketCount) + 1, 0);
+        for (size_t i = 0; i < edges.size(); ++i) {
+            for (int64_t j = 0; j < bucketSpan[i]; ++j) {
+                ++bucketStart[wrapBucket(firstBucket[i] + j) + 1];
+            }
+        }
+        for (int64_t j = 0; j < bucketCount; ++j) {
+            bucketStart[j + 1] += bucketStart[j];
+        }
+        bucketEdges.resize(bucketStart[bucketCount]);
+        std::vector<uint32_t> fill(bucketStart.begin(), bucketStart.end() - 1);
+        for (size_t i = 0; i < edges.size(); ++i) {
+            for (int64_t j = 0; j < bucketSpan[i]; ++j) {
+                bucketEdges[fill[wrapBucket(firstBucket[i] + j)]++] = static_cast<uint32_t>(i);
+            }
+        }
+        indexed = true;
+    }
+
+    inline size_t wrapBucket(int64_t bucket) const {
+        return static_cast<size_t>(((bucket % bucketCount) + bucketCount) % bucketCount);
+    }
+};
+
+#endif // GEOMETRY_LIBRARY_PREPARED_POLYGON
@@ -0,0 +1,296 @@
+//******************************************************************************
+// Copyright 2013 Google Inc.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// This software and the related documents are provided  as is,  with no express
+// or implied  warranties,  other than  those that are  expressly stated  in the
+// License.
+//******************************************************************************
+
+#ifndef GEOMETRY_LIBRARY_SIMD
+#define GEOMETRY_LIBRARY_SIMD
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+// SIMD kernels are compiled with per-function target options and selected at
+// runtime, so the library still builds without -mavx2 and runs on any x86-64.
+// Define GEOMETRY_LIBRARY_NO_SIMD to build the scalar paths only.
+#if !defined(GEOMETRY_LIBRARY_NO_SIMD) && defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define GEOMETRY_LIBRARY_HAS_SIMD 1
+#include <immintrin.h>
+#endif
+
+
+class Simd {
+public:
+    /**
+     * Instruction set used by the batch kernels, ordered by preference.
+     */
+    enum Level {
+        SCALAR = 0,
+        AVX2   = 1,  // AVX2 + FMA, 4 doubles or 8 floats per vector
+        AVX512 = 2,  // AVX-512F,   8 doubles or 16 floats per vector
+    };
+
+    /**
+     * Returns the best level supported by this CPU, capped by setMaxLevel().
+     */
+    static inline Level level() {
+        Level detected = Simd::detectedLevel();
+        Level limit = static_cast<Level>(Simd::maxLevel().load(std::memory_order_relaxed));
+        return detected < limit ? detected : limit;
+    }
+
+    /**
+     * Returns the best level supported by this CPU.
+     */
+    static inline Level detectedLevel() {
+        static const Level detected = Simd::detect();
+        return detected;
+    }
+
+    /**
+     * Caps the level picked by the batch kernels, e.g. to compare the scalar and
+     * vector paths in tests and benchmarks.
+     */
+    static inline void setMaxLevel(Level level) {
+        Simd::maxLevel().store(level, std::memory_order_relaxed);
+    }
+
+
+private:
+    static inline std::atomic<int>& maxLevel() {
+        static std::atomic<int> limit(AVX512);
+        return limit;
+    }
+
+    static inline Level detect() {
+#ifdef GEOMETRY_LIBRARY_HAS_SIMD
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f")) {
+            return AVX512;
+        }
+        if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+            return AVX2;
+        }
+#endif
+        return SCALAR;
+    }
+};
+
+
+#ifdef GEOMETRY_LIBRARY_HAS_SIMD
+
+// Primitive operations per instruction set. Generic kernels are written once against
+// these and compiled per instruction set by including them inside the matching
+// "#pragma GCC target" region (see SphericalBatch.hpp).
+
+#pragma GCC push_options
+#pragma GCC target("avx2,fma")
+struct SimdAvx2 {
+    typedef double    Double    __attribute__((vector_size(32)));
+    typedef int64_t   Mask      __attribute__((vector_size(32)));
+    typedef float     Float     __attribute__((vector_size(32)));
+    typedef int32_t   FloatMask __attribute__((vector_size(32)));
+
+    static constexpr size_t LANES = 4;
+    static constexpr size_t FLOAT_LANES = 8;
+
+    static inline Double load(const double* p) {
+        Double v;
+        std::memcpy(&v, p, sizeof(v));
+        return v;
+    }
+
+    static inline void store(double* p, Double v) {
+        std::memcpy(p, &v, sizeof(v));
+    }
+
+    static inline Double broadcast(double x) {
+        return _mm256_set1_pd(x);
+    }
+
+    static inline Double sqrt(Double x) {
+        return _mm256_sqrt_pd(x);
+    }
+
+    static inline Double round(Double x) {
+        return _mm256_round_pd(x, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    }
+
+    static inline Double abs(Double x) {
+        return _mm256_andnot_pd(_mm256_set1_pd(-0.0), x);
+    }
+
+    static inline Double min(Double a, Double b) {
+        return _mm256_min_pd(a, b);
+    }
+
+    static inline Double max(Double a, Double b) {
+        return _mm256_max_pd(a, b);
+    }
+
+    static inline Double select(Mask mask, Double a, Double b) {
+        return mask ? a : b;
+    }
+
+    static inline bool any(Mask mask) {
+        return !_mm256_testz_si256(reinterpret_cast<__m256i>(mask), reinterpret_cast<__m256i>(mask));
+    }
+
+    static inline Float load(const float* p) {
+        Float v;
+        std::memcpy(&v, p, sizeof(v));
+        return v;
+    }
+
+    static inline void store(float* p, Float v) {
+        std::memcpy(p, &v, sizeof(v));
+    }
+
+    static inline Float broadcast(float x) {
+        return _mm256_set1_ps(x);
+    }
+
+    static inline Float sqrt(Float x) {
+        return _mm256_sqrt_ps(x);
+    }
+
+    static inline Float round(Float x) {
+        return _mm256_round_ps(x, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    }
+
+    static inline Float abs(Float x) {
+        return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), x);
+    }
+
+    static inline Float min(Float a, Float b) {
+        return _mm256_min_ps(a, b);
+    }
+
+    static inline Float max(Float a, Float b) {
+        return _mm256_max_ps(a, b);
+    }
+
+    static inline Float select(FloatMask mask, Float a, Float b) {
+        return mask ? a : b;
+    }
+
+    static inline bool any(FloatMask mask) {
+        return !_mm256_testz_si256(reinterpret_cast<__m256i>(mask), reinterpret_cast<__m256i>(mask));
+    }
+};
+#pragma GCC pop_options
+
+#pragma GCC push_options
+#pragma GCC target("avx512f")
+struct SimdAvx512 {
+    typedef double    Double    __attribute__((vector_size(64)));
+    typedef int64_t   Mask      __attribute__((vector_size(64)));
+    typedef float     Float     __attribute__((vector_size(64)));
+    typedef int32_t   FloatMask __attribute__((vector_size(64)));
+
+    static constexpr size_t LANES = 8;
+    static constexpr size_t FLOAT_LANES = 16;
+
+    // The masked intrinsics with every lane enabled avoid the unmasked forms'
+    // _mm512_undefined_pd() source operand, which GCC reports as uninitialized.
+    static constexpr __mmask8  ALL = 0xFF;
+    static constexpr __mmask16 ALL_FLOATS = 0xFFFF;
+
+    static inline Double load(const double* p) {
+        Double v;
+        std::memcpy(&v, p, sizeof(v));
+        return v;
+    }
+
+    static inline void store(double* p, Double v) {
+        std::memcpy(p, &v, sizeof(v));
+    }
+
+    static inline Double broadcast(double x) {
+        return _mm512_set1_pd(x);
+    }
+
+    static inline Double sqrt(Double x) {
+        return _mm512_mask_sqrt_pd(x, ALL, x);
+    }
+
+    static inline Double round(Double x) {
+        return _mm512_mask_roundscale_pd(x, ALL, x, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    }
+
+    static inline Double abs(Double x) {
+        return _mm512_abs_pd(x);
+    }
+
+    static inline Double min(Double a, Double b) {
+        return _mm512_mask_min_pd(a, ALL, a, b);
+    }
+
+    static inline Double max(Double a, Double b) {
+        return _mm512_mask_max_pd(a, ALL, a, b);
+    }
+
+    static inline Double select(Mask mask, Double a, Double b) {
+        return mask ? a : b;
+    }
+
+    static inline bool any(Mask mask) {
+        return _mm512_test_epi64_mask(reinterpret_cast<__m512i>(mask), reinterpret_cast<__m512i>(mask)) != 0;
+    }
+
+    static inline Float load(const float* p) {
+        Float v;
+        std::memcpy(&v, p, sizeof(v));
+        return v;
+    }
+
+    static inline void store(float* p, Float v) {
+        std::memcpy(p, &v, sizeof(v));
+    }
+
+    static inline Float broadcast(float x) {
+        return _mm512_set1_ps(x);
+    }
+
+    static inline Float sqrt(Float x) {
+        return _mm512_mask_sqrt_ps(x, ALL_FLOATS, x);
+    }
+
+    static inline Float round(Float x) {
+        return _mm512_mask_roundscale_ps(x, ALL_FLOATS, x, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    }
+
+    static inline Float abs(Float x) {
+        return _mm512_abs_ps(x);
+    }
+
+    static inline Float min(Float a, Float b) {
+        return _mm512_mask_min_ps(a, ALL_FLOATS, a, b);
+    }
+
+    static inline Float max(Float a, Float b) {
+        return _mm512_mask_max_ps(a, ALL_FLOATS, a, b);
+    }
+
+    static inline Float select(FloatMask mask, Float a, Float b) {
+        return mask ? a : b;
+    }
+
+    static inline bool any(FloatMask mask) {
+        return _mm512_test_epi32_mask(reinterpret_cast<__m512i>(mask), reinterpret_cast<__m512i>(mask)) != 0;
+    }
+};
+#pragma GCC pop_options
+
+#endif // GEOMETRY_LIBRARY_HAS_SIMD
+
+#endif // GEOMETRY_LIBRARY_SIMD
@@ -0,0 +1,229 @@
+//******************************************************************************
+// Copyright 2013 Google Inc.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// This software and the related documents are provided  as is,  with no express
+// or implied  warranties,  other than  those that are  expressly stated  in the
+// License.
+//******************************************************************************
+
+#ifndef GEOMETRY_LIBRARY_SPHERICAL_BATCH
+#define GEOMETRY_LIBRARY_SPHERICAL_BATCH
+
+#include <vector>
+#include <algorithm>
+
+#include "MathUtil.hpp"
+#include "LatLng.hpp"
+#include "LatLngArray.hpp"
+#include "Simd.hpp"
+#include "VecMath.hpp"
+
+
+template <typename Isa>
+struct SphericalBatchKernel;
+
+#ifdef GEOMETRY_LIBRARY_HAS_SIMD
+#pragma GCC push_options
+#pragma GCC target("avx2,fma")
+#define GEOMETRY_LIBRARY_SIMD_ISA SimdAvx2
+#include "SphericalBatchKernel.hpp"
+#undef GEOMETRY_LIBRARY_SIMD_ISA
+#pragma GCC pop_options
+
+#pragma GCC push_options
+#pragma GCC target("avx512f")
+#define GEOMETRY_LIBRARY_SIMD_ISA SimdAvx512
+#include "SphericalBatchKernel.hpp"
+#undef GEOMETRY_LIBRARY_SIMD_ISA
+#pragma GCC pop_options
+#endif
+
+
+/**
+ * Batch versions of SphericalUtil::computeDistanceBetween().
+ *
+ * The vector kernels (AVX2 and AVX-512, picked at runtime by Simd::level()) evaluate
+ * hav() and arcHav() with the VecMath::FAST approximations instead of libm. Compared with
+ * SphericalUtil::computeDistanceBetween() on the same pair, a result differs by at
+ * most MAX_ULP units in the last place while the points are less than
+ * MAX_ULP_ANGLE degrees of arc apart; closer to antipodal, arcHav() is ill-conditioned
+ * in both paths and the difference is bounded by MAX_ABSOLUTE_ERROR meters instead.
+ * The scalar path gives exactly the SphericalUtil results.
+ *
+ * The float versions read 8 bytes per target and use twice the vector lanes; see
+ * MAX_FLOAT_ERROR.
+ */
+class SphericalBatch {
+public:
+    static constexpr double MAX_ULP = 16;
+    static constexpr double MAX_ULP_ANGLE = 150;        // degrees
+    static constexpr double MAX_ABSOLUTE_ERROR = 1e-5;  // meters
+
+    // A float result differs from SphericalUtil::computeDistanceBetween() on the same
+    // points by at most MAX_FLOAT_ERROR meters while they are less than MAX_ULP_ANGLE
+    // degrees of arc apart, and by at most MAX_FLOAT_ANTIPODAL_ERROR closer to antipodal:
+    // float holds the coordinates in radians to about 1e-7 of pi, a few meters.
+    static constexpr double MAX_FLOAT_ERROR = 10;              // meters
+    static constexpr double MAX_FLOAT_ANTIPODAL_ERROR = 5000;  // meters
+
+    /**
+     * Computes the distances, in meters, from one LatLng to each of the targets.
+     *
+     * @param from    The origin.
+     * @param targets The targets. Any container with size() and iteration.
+     * @param out     Receives targets.size() distances, in target order.
+     */
+    template <typename LatLngList>
+    static inline void computeDistances(const LatLng& from, const LatLngList& targets, double* out) {
+        double lat1 = deg2rad(from.lat);
+        double lng1 = deg2rad(from.lng);
+        double cosLat1 = cos(lat1);
+        Simd::Level level = Simd::level();
+
+        double lat[TILE];
+        double lng[TILE];
+        size_t count = 0;
+        for (const auto& point : targets) {
+            lat[count] = deg2rad(point.lat);
+            lng[count] = deg2rad(point.lng);
+            if (++count == TILE) {
+                SphericalBatch::distances(level, lat1, lng1, cosLat1, lat, lng, nullptr, count, out);
+                out += count;
+                count = 0;
+            }
+        }
+        SphericalBatch::distances(level, lat1, lng1, cosLat1, lat, lng, nullptr, count, out);
+    }
+
+    /**
+     * Same as above in float, e.g. for targets in a std::vector<LatLngF>.
+     */
+    template <typename LatLngList>
+    static inline void computeDistances(const LatLng& from, const LatLngList& targets, float* out) {
+        float lat1 = static_cast<float>(deg2rad(from.lat));
+        float lng1 = static_cast<float>(deg2rad(from.lng));
+        float cosLat1 = std::cos(lat1);
+        Simd::Level level = Simd::level();
+
+        float lat[TILE];
+        float lng[TILE];
+        size_t count = 0;
+        for (const auto& point : targets) {
+            lat[count] = static_cast<float>(deg2rad(point.lat));
+            lng[count] = static_cast<float>(deg2rad(point.lng));
+            if (++count == TILE) {
+                SphericalBatch::distances(level, lat1, lng1, cosLat1, lat, lng, count, out);
+                out += count;
+                count = 0;
+            }
+        }
+        SphericalBatch::distances(level, lat1, lng1, cosLat1, lat, lng, count, out);
+    }
+
+    /**
+     * Same as above; targets caching LatLngArray::TRIG are read in place.
+     */
+    static inline void computeDistances(const LatLng& from, const LatLngArray& targets, double* out) {
+        if ((targets.caches() & LatLngArray::TRIG) == 0) {
+            SphericalBatch::computeDistances<LatLngArray>(from, targets, out);
+            return;
+        }
+        double lat1 = deg2rad(from.lat);
+        SphericalBatch::distances(Simd::level(), lat1, deg2rad(from.lng), cos(lat1),
+                                  targets.latRad(), targets.lngRad(), targets.cosLat(), targets.size(), out);
+    }
+
+    /**
+     * Computes the distance matrix, in meters, between origins and targets.
+     *
+     * @param origins The N row points.
+     * @param targets The M column points.
+     * @param out     Receives N * M distances, row-major: out[i * M + j] is the distance
+     *                from origins[i] to targets[j].
+     */
+    template <typename LatLngListA, typename LatLngListB>
+    static inline void computeDistanceMatrix(const LatLngListA& origins, const LatLngListB& targets, double* out) {
+        SphericalBatch::computeDistanceMatrix(origins, LatLngArray(targets, LatLngArray::TRIG), out);
+    }
+
+    /**
+     * Same as above; targets caching LatLngArray::TRIG are read in place.
+     */
+    template <typename LatLngList>
+    static inline void computeDistanceMatrix(const LatLngList& origins, const LatLngArray& targets, double* out) {
+        if ((targets.caches() & LatLngArray::TRIG) == 0) {
+            LatLngArray copy(targets, LatLngArray::TRIG);
+            SphericalBatch::computeDistanceMatrix(origins, copy, out);
+            return;
+        }
+        LatLngArray rows(origins, LatLngArray::TRIG);
+        size_t columns = targets.size();
+
+        // Column tiles keep the target columns in L1 while every row streams over them.
+        Simd::Level level = Simd::level();
+        for (size_t first = 0; first < columns; first += TILE) {
+            size_t count = columns - first < TILE ? columns - first : TILE;
+            for (size_t row = 0; row < rows.size(); ++row) {
+                SphericalBatch::distances(level, rows.latRad()[row], rows.lngRad()[row], rows.cosLat()[row],
+                                          targets.latRad() + first, targets.lngRad() + first, targets.cosLat() + first,
+                                          count, out + row * columns + first);
+            }
+        }
+    }
+
+
+private:
+    static constexpr size_t TILE = 512;
+
+    /**
+     * Distances from (lat1, lng1) to n targets, all in radians. cosLat may be null.
+     */
+    static inline void distances(Simd::Level level, double lat1, double lng1, double cosLat1,
+                                 const double* lat, const double* lng, const double* cosLat,
+                                 size_t n, double* out) {
+        size_t done = 0;
+#ifdef GEOMETRY_LIBRARY_HAS_SIMD
+        if (level == Simd::AVX512) {
+            done = SphericalBatchKernel<SimdAvx512>::distances(lat1, lng1, cosLat1, lat, lng, cosLat, n, out);
+        } else if (level == Simd::AVX2) {
+            done = SphericalBatchKernel<SimdAvx2>::distances(lat1, lng1, cosLat1, lat, lng, cosLat, n, out);
+        }
+#else
+        (void) level;
+#endif
+        // Scalar path and vector remainder; same arithmetic as SphericalUtil::computeDistanceBetween().
+        for (size_t i = done; i < n; ++i) {
+            double cosLat2 = cosLat != nullptr ? cosLat[i] : cos(lat[i]);
+            double havDistance = MathUtil::hav(lat1 - lat[i]) + MathUtil::hav(lng1 - lng[i]) * cosLat1 * cosLat2;
+            out[i] = MathUtil::arcHav(havDistance) * MathUtil::EARTH_RADIUS;
+        }
+    }
+
+    /**
+     * Same as above in float.
+     */
+    static inline void distances(Simd::Level level, float lat1, float lng1, float cosLat1,
+                                 const float* lat, const float* lng, size_t n, float* out) {
+        size_t done = 0;
+#ifdef GEOMETRY_LIBRARY_HAS_SIMD
+        if (level == Simd::AVX512) {
+            done = SphericalBatchKernel<SimdAvx512>::distances(lat1, lng1, cosLat1, lat, lng, n, out);
+        } else if (level == Simd::AVX2) {
+            done = SphericalBatchKernel<SimdAvx2>::distances(lat1, lng1, cosLat1, lat, lng, n, out);
+        }
+#else
+        (void) level;
+#endif
+        for (size_t i = done; i < n; ++i) {
+            float havDistance = MathUtil::hav(lat1 - lat[i]) + MathUtil::hav(lng1 - lng[i]) * cosLat1 * std::cos(lat[i]);
+            out[i] = MathUtil::arcHav(std::min(havDistance, 1.0f)) * static_cast<float>(MathUtil::EARTH_RADIUS);
+        }
+    }
+};
+
+#endif // GEOMETRY_LIBRARY_SPHERICAL_BATCH
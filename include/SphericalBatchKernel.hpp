@@ -0,0 +1,100 @@
+//******************************************************************************
+// Copyright 2013 Google Inc.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// This software and the related documents are provided  as is,  with no express
+// or implied  warranties,  other than  those that are  expressly stated  in the
+// License.
+//******************************************************************************
+
+// No include guard: SphericalBatch.hpp includes this file once per instruction set,
+// inside the matching "#pragma GCC target" region, with GEOMETRY_LIBRARY_SIMD_ISA
+// naming the primitive set from Simd.hpp.
+
+template <>
+struct SphericalBatchKernel<GEOMETRY_LIBRARY_SIMD_ISA> {
+    typedef GEOMETRY_LIBRARY_SIMD_ISA Isa;
+    typedef Isa::Double Double;
+    typedef Isa::Mask   Mask;
+    typedef Isa::Float     Float;
+    typedef Isa::FloatMask FloatMask;
+    typedef VecMathKernel<Isa> Math;
+
+    /**
+     * Writes the distances, in meters, from (lat1, lng1) to the first
+     * n - n % Isa::LANES targets and returns how many were written.
+     * All angles are in radians; cosLat may be null, then cos(lat) is computed here.
+     */
+    static inline size_t distances(double lat1, double lng1, double cosLat1,
+                                   const double* lat, const double* lng, const double* cosLat,
+                                   size_t n, double* out) {
+        Double vLat1 = Isa::broadcast(lat1);
+        Double vLng1 = Isa::broadcast(lng1);
+        Double vCosLat1 = Isa::broadcast(cosLat1);
+        Double radius = Isa::broadcast(MathUtil::EARTH_RADIUS);
+        size_t i = 0;
+        for (; i + Isa::LANES <= n; i += Isa::LANES) {
+            Double lat2 = Isa::load(lat + i);
+            Double cosLat2 = cosLat != nullptr ? Isa::load(cosLat + i) : Math::cos(lat2);
+            Double h = hav(vLat1 - lat2) + hav(vLng1 - Isa::load(lng + i)) * vCosLat1 * cosLat2;
+            Isa::store(out + i, arcHav(Isa::min(h, Isa::broadcast(1.0))) * radius);
+        }
+        return i;
+    }
+
+    /**
+     * Same as above in float, Isa::FLOAT_LANES targets per vector; cos(lat) is
+     * always computed here.
+     */
+    static inline size_t distances(float lat1, float lng1, float cosLat1,
+                                   const float* lat, const float* lng, size_t n, float* out) {
+        Float vLat1 = Isa::broadcast(lat1);
+        Float vLng1 = Isa::broadcast(lng1);
+        Float vCosLat1 = Isa::broadcast(cosLat1);
+        Float radius = Isa::broadcast(static_cast<float>(MathUtil::EARTH_RADIUS));
+        size_t i = 0;
+        for (; i + Isa::FLOAT_LANES <= n; i += Isa::FLOAT_LANES) {
+            Float lat2 = Isa::load(lat + i);
+            Float h = hav(vLat1 - lat2) + hav(vLng1 - Isa::load(lng + i)) * vCosLat1 * Math::cos(lat2);
+            Isa::store(out + i, arcHav(Isa::min(h, Isa::broadcast(1.0f))) * radius);
+        }
+        return i;
+    }
+
+private:
+    /**
+     * Returns hav(x) == sin(x / 2)^2.
+     */
+    static inline Double hav(Double x) {
+        Double s = Math::sin(0.5 * x);
+        return s * s;
+    }
+
+    /**
+     * Returns arcHav(h) == 2 * asin(sqrt(h)) for h in [0, 1].
+     */
+    static inline Double arcHav(Double h) {
+        // asin(sqrt(h)) == PI/2 - asin(sqrt(1 - h)), so only min(h, 1 - h) <= 0.5 is needed:
+        // near h == 1, sqrt(h) would lose the low bits of 1 - h.
+        Mask flip = h > 0.5;
+        Double result = Math::asin(Isa::sqrt(Isa::select(flip, 1.0 - h, h)));
+        result = Isa::select(flip, (M_PI / 2 - result) + 6.123233995736765886130E-17, result);
+        return result + result;
+    }
+
+    static inline Float hav(Float x) {
+        Float s = Math::sin(0.5f * x);
+        return s * s;
+    }
+
+    static inline Float arcHav(Float h) {
+        FloatMask flip = h > 0.5f;
+        Float result = Math::asin(Isa::sqrt(Isa::select(flip, 1.0f - h, h)));
+        result = Isa::select(flip, static_cast<float>(M_PI / 2) - result, result);
+        return result + result;
+    }
+};
@@ -15,9 +15,23 @@
 #ifndef GEOMETRY_LIBRARY_SPHERICAL_UTIL
 #define GEOMETRY_LIBRARY_SPHERICAL_UTIL
 
+#include <algorithm>
+#include <iterator>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
 #include "MathUtil.hpp"
 #include "LatLng.hpp"
+#include "Policies.hpp"
 
+/**
+ * The functions taking LatLngT<T> points return points of the same type: LatLngF
+ * storage halves the memory of large workloads. The arithmetic is in double, or in
+ * float with the FloatMath policy (see Policies.hpp); the README gives the error of
+ * each function in float.
+ */
 class SphericalUtil {
 public:
     /**
@@ -27,17 +41,26 @@ public:
      * @return The heading in degrees clockwise from north.
      */
     inline static double computeHeading(const LatLng& from, const LatLng& to) {
+        return SphericalUtil::computeHeading<DoubleMath>(from, to);
+    }
+
+    /**
+     * Same as above, with the arithmetic given by the Math policy.
+     */
+    template <typename Math = DoubleMath, typename T>
+    inline static typename Math::Real computeHeading(const LatLngT<T>& from, const LatLngT<T>& to) {
+        typedef typename Math::Real Real;
         // http://williams.best.vwh.net/avform.htm#Crs
-        double fromLat = deg2rad(from.lat);
-        double fromLng = deg2rad(from.lng);
-        double toLat = deg2rad(to.lat);
-        double toLng = deg2rad(to.lng);
-        double dLng = toLng - fromLng;
-        double heading = atan2(
-            sin(dLng) * cos(toLat),
-            cos(fromLat) * sin(toLat) - sin(fromLat) * cos(toLat) * cos(dLng));
+        Real fromLat = static_cast<Real>(deg2rad(from.lat));
+        Real fromLng = static_cast<Real>(deg2rad(from.lng));
+        Real toLat = static_cast<Real>(deg2rad(to.lat));
+        Real toLng = static_cast<Real>(deg2rad(to.lng));
+        Real dLng = toLng - fromLng;
+        Real heading = std::atan2(
+            std::sin(dLng) * std::cos(toLat),
+            std::cos(fromLat) * std::sin(toLat) - std::sin(fromLat) * std::cos(toLat) * std::cos(dLng));
 
-        return MathUtil::wrap(rad2deg(heading), -180, 180);
+        return MathUtil::wrap(static_cast<Real>(rad2deg(heading)), -180, 180);
     }
 
 
@@ -50,21 +73,137 @@ public:
      * @param heading  The heading in degrees clockwise from north.
      */
     inline static LatLng computeOffset(const LatLng& from, double distance, double heading) {
-        distance /= MathUtil::EARTH_RADIUS;
-        heading = deg2rad(heading);
+        return SphericalUtil::computeOffset<EarthSphere>(from, distance, heading);
+    }
+
+    /**
+     * Same as above, on the sphere of the Model policy and with the arithmetic given
+     * by the Math policy (see Policies.hpp).
+     */
+    template <typename Model, typename Math = DoubleMath, typename T>
+    inline static LatLngT<T> computeOffset(const LatLngT<T>& from, double distance, double heading) {
+        typedef typename Math::Real Real;
+        Real angle = static_cast<Real>(distance / Model::RADIUS);
+        Real bearing = static_cast<Real>(deg2rad(heading));
         // http://williams.best.vwh.net/avform.htm#LL
-        double fromLat = deg2rad(from.lat);
-        double fromLng = deg2rad(from.lng);
-        double cosDistance = cos(distance);
-        double sinDistance = sin(distance);
-        double sinFromLat = sin(fromLat);
-        double cosFromLat = cos(fromLat);
-        double sinLat = cosDistance * sinFromLat + sinDistance * cosFromLat * cos(heading);
-        double dLng = atan2(
-            sinDistance * cosFromLat * sin(heading),
-            cosDistance - sinFromLat * sinLat);
+        Real fromLat = static_cast<Real>(deg2rad(from.lat));
+        Real fromLng = static_cast<Real>(deg2rad(from.lng));
+        Real cosDistance = std::cos(angle);
+        Real sinDistance = std::sin(angle);
+        Real sinFromLat = std::sin(fromLat);
+        Real cosFromLat = std::cos(fromLat);
+        return SphericalUtil::offsetRadians<T>(sinFromLat, cosFromLat, fromLng, sinDistance, cosDistance,
+                                               std::sin(bearing), std::cos(bearing));
+    }
+
+    /**
+     * Writes computeOffset(from, distance, heading) of every heading into
+     * out[0 .. headings.size()). The sines and cosines of the origin and the distance
+     * are computed once; results are identical to computeOffset().
+     *
+     * @param headings Any container of headings in degrees clockwise from north.
+     */
+    template <typename HeadingList>
+    inline static void computeOffsets(const LatLng& from, double distance, const HeadingList& headings, LatLng* out) {
+        SphericalUtil::computeOffsets<EarthSphere>(from, distance, headings, out);
+    }
 
-        return LatLng(rad2deg(asin(sinLat)), rad2deg(fromLng + dLng));
+    /**
+     * Same as above, on the sphere of the Model policy and with the arithmetic given
+     * by the Math policy.
+     */
+    template <typename Model, typename Math = DoubleMath, typename T, typename HeadingList>
+    inline static void computeOffsets(const LatLngT<T>& from, double distance, const HeadingList& headings, LatLngT<T>* out) {
+        typedef typename Math::Real Real;
+        Real angle = static_cast<Real>(distance / Model::RADIUS);
+        Real fromLat = static_cast<Real>(deg2rad(from.lat));
+        Real fromLng = static_cast<Real>(deg2rad(from.lng));
+        Real cosDistance = std::cos(angle);
+        Real sinDistance = std::sin(angle);
+        Real sinFromLat = std::sin(fromLat);
+        Real cosFromLat = std::cos(fromLat);
+        for (double heading : headings) {
+            Real bearing = static_cast<Real>(deg2rad(heading));
+            *out++ = SphericalUtil::offsetRadians<T>(sinFromLat, cosFromLat, fromLng, sinDistance, cosDistance,
+                                                     std::sin(bearing), std::cos(bearing));
+        }
+    }
+
+    /**
+     * Writes computeOffset(from, distance, heading) of every distance into
+     * out[0 .. distances.size()). The sines and cosines of the origin and the heading
+     * are computed once; results are identical to computeOffset().
+     *
+     * @param distances Any container of distances in meters.
+     */
+    template <typename DistanceList>
+    inline static void computeOffsets(const LatLng& from, const DistanceList& distances, double heading, LatLng* out) {
+        SphericalUtil::computeOffsets<EarthSphere>(from, distances, heading, out);
+    }
+
+    /**
+     * Same as above, on the sphere of the Model policy and with the arithmetic given
+     * by the Math policy.
+     */
+    template <typename Model, typename Math = DoubleMath, typename T, typename DistanceList>
+    inline static void computeOffsets(const LatLngT<T>& from, const DistanceList& distances, double heading, LatLngT<T>* out) {
+        typedef typename Math::Real Real;
+        Real bearing = static_cast<Real>(deg2rad(heading));
+        Real fromLat = static_cast<Real>(deg2rad(from.lat));
+        Real fromLng = static_cast<Real>(deg2rad(from.lng));
+        Real sinFromLat = std::sin(fromLat);
+        Real cosFromLat = std::cos(fromLat);
+        Real sinBearing = std::sin(bearing);
+        Real cosBearing = std::cos(bearing);
+        for (double distance : distances) {
+            Real angle = static_cast<Real>(distance / Model::RADIUS);
+            *out++ = SphericalUtil::offsetRadians<T>(sinFromLat, cosFromLat, fromLng, std::sin(angle), std::cos(angle),
+                                                     sinBearing, cosBearing);
+        }
+    }
+
+    /**
+     * Writes the n vertices of a circle of the given radius, in meters, around center
+     * into out[0 .. n): the offsets at headings 0, 360 / n, 2 * 360 / n, ... degrees,
+     * clockwise. The first vertex is not repeated. The headings are generated by
+     * rotation, with the sine and cosine computed afresh every CIRCLE_RESEED vertices;
+     * a vertex is within 1e-12 degrees of its computeOffset().
+     */
+    inline static void circlePolygon(const LatLng& center, double radius, size_t n, LatLng* out) {
+        SphericalUtil::circlePolygon<EarthSphere>(center, radius, n, out);
+    }
+
+    /**
+     * Same as above, on the sphere of the Model policy and with the arithmetic given
+     * by the Math policy.
+     */
+    template <typename Model, typename Math = DoubleMath, typename T>
+    inline static void circlePolygon(const LatLngT<T>& center, double radius, size_t n, LatLngT<T>* out) {
+        typedef typename Math::Real Real;
+        Real angle = static_cast<Real>(radius / Model::RADIUS);
+        Real centerLat = static_cast<Real>(deg2rad(center.lat));
+        Real centerLng = static_cast<Real>(deg2rad(center.lng));
+        Real cosDistance = std::cos(angle);
+        Real sinDistance = std::sin(angle);
+        Real sinCenterLat = std::sin(centerLat);
+        Real cosCenterLat = std::cos(centerLat);
+        Real step = static_cast<Real>(2 * M_PI / n);
+        Real sinStep = std::sin(step);
+        Real cosStep = std::cos(step);
+        Real sinBearing = 0;
+        Real cosBearing = 1;
+        for (size_t i = 0; i < n; ++i) {
+            if (i % CIRCLE_RESEED == 0) {
+                Real bearing = static_cast<Real>(2 * M_PI * i / n);
+                sinBearing = std::sin(bearing);
+                cosBearing = std::cos(bearing);
+            }
+            out[i] = SphericalUtil::offsetRadians<T>(sinCenterLat, cosCenterLat, centerLng, sinDistance, cosDistance,
+                                                     sinBearing, cosBearing);
+            Real sinNext = sinBearing * cosStep + cosBearing * sinStep;
+            cosBearing = cosBearing * cosStep - sinBearing * sinStep;
+            sinBearing = sinNext;
+        }
     }
 
 
@@ -80,37 +219,47 @@ public:
      * @param heading  The heading in degrees clockwise from north.
      */
     inline static LatLng computeOffsetOrigin(const LatLng& to, double distance, double heading) {
-        heading = deg2rad(heading);
-        distance /= MathUtil::EARTH_RADIUS;
+        return SphericalUtil::computeOffsetOrigin<EarthSphere>(to, distance, heading);
+    }
+
+    /**
+     * Same as above, on the sphere of the Model policy and with the arithmetic given
+     * by the Math policy.
+     */
+    template <typename Model, typename Math = DoubleMath, typename T>
+    inline static LatLngT<T> computeOffsetOrigin(const LatLngT<T>& to, double distance, double heading) {
+        typedef typename Math::Real Real;
+        Real bearing = static_cast<Real>(deg2rad(heading));
+        Real angle = static_cast<Real>(distance / Model::RADIUS);
         // http://lists.maptools.org/pipermail/proj/2008-October/003939.html
-        double n1 = cos(distance);
-        double n2 = sin(distance) * cos(heading);
-        double n3 = sin(distance) * sin(heading);
-        double n4 = sin(deg2rad(to.lat));
+        Real n1 = std::cos(angle);
+        Real n2 = std::sin(angle) * std::cos(bearing);
+        Real n3 = std::sin(angle) * std::sin(bearing);
+        Real n4 = std::sin(static_cast<Real>(deg2rad(to.lat)));
         // There are two solutions for b. b = n2 * n4 +/- sqrt(), one solution results
         // in the latitude outside the [-90, 90] range. We first try one solution and
         // back off to the other if we are outside that range.
-        double n12 = n1 * n1;
-        double discriminant = n2 * n2 * n12 + n12 * n12 - n12 * n4 * n4;
+        Real n12 = n1 * n1;
+        Real discriminant = n2 * n2 * n12 + n12 * n12 - n12 * n4 * n4;
         
         // TODO: No real solution which would make sense in LatLng-space.
         // if (discriminant < 0) return null;
         
-        double b = n2 * n4 + sqrt(discriminant);
+        Real b = n2 * n4 + std::sqrt(discriminant);
         b /= n1 * n1 + n2 * n2;
-        double a = (n4 - n2 * b) / n1;
-        double fromLatRadians = atan2(a, b);
+        Real a = (n4 - n2 * b) / n1;
+        Real fromLatRadians = std::atan2(a, b);
         if (fromLatRadians < -M_PI / 2 || fromLatRadians > M_PI / 2) {
-            b = n2 * n4 - sqrt(discriminant);
+            b = n2 * n4 - std::sqrt(discriminant);
             b /= n1 * n1 + n2 * n2;
-            fromLatRadians = atan2(a, b);
+            fromLatRadians = std::atan2(a, b);
         }
 
         // TODO: No solution which would make sense in LatLng-space.
         // if (fromLatRadians < -M_PI / 2 || fromLatRadians > M_PI / 2) return null;
 
-        double fromLngRadians = rad2deg(to.lng) - atan2(n3, n1 * cos(fromLatRadians) - n2 * sin(fromLatRadians));
-        return LatLng(rad2deg(fromLatRadians), rad2deg(fromLngRadians));
+        Real fromLngRadians = static_cast<Real>(rad2deg(to.lng)) - std::atan2(n3, n1 * std::cos(fromLatRadians) - n2 * std::sin(fromLatRadians));
+        return LatLngT<T>(static_cast<T>(rad2deg(fromLatRadians)), static_cast<T>(rad2deg(fromLngRadians)));
     }
 
 
@@ -125,29 +274,38 @@ public:
      * @return The interpolated LatLng.
      */
     inline static LatLng interpolate(const LatLng& from, const LatLng& to, double fraction) {
+        return SphericalUtil::interpolate<DoubleMath>(from, to, fraction);
+    }
+
+    /**
+     * Same as above, with the arithmetic given by the Math policy.
+     */
+    template <typename Math = DoubleMath, typename T>
+    inline static LatLngT<T> interpolate(const LatLngT<T>& from, const LatLngT<T>& to, double fraction) {
+        typedef typename Math::Real Real;
         // http://en.wikipedia.org/wiki/Slerp
-        double fromLat = deg2rad(from.lat);
-        double fromLng = deg2rad(from.lng);
-        double toLat = deg2rad(to.lat);
-        double toLng = deg2rad(to.lng);
-        double cosFromLat = cos(fromLat);
-        double cosToLat = cos(toLat);
+        Real fromLat = static_cast<Real>(deg2rad(from.lat));
+        Real fromLng = static_cast<Real>(deg2rad(from.lng));
+        Real toLat = static_cast<Real>(deg2rad(to.lat));
+        Real toLng = static_cast<Real>(deg2rad(to.lng));
+        Real cosFromLat = std::cos(fromLat);
+        Real cosToLat = std::cos(toLat);
         // Computes Spherical interpolation coefficients.
-        double angle = SphericalUtil::computeAngleBetween(from, to);
-        double sinAngle = sin(angle);
+        Real angle = SphericalUtil::distanceRadians(fromLat, fromLng, toLat, toLng);
+        Real sinAngle = std::sin(angle);
         if (sinAngle < 1e-6) {
             return from;
         }
-        double a = sin((1 - fraction) * angle) / sinAngle;
-        double b = sin(fraction * angle) / sinAngle;
+        Real a = std::sin(static_cast<Real>(1 - fraction) * angle) / sinAngle;
+        Real b = std::sin(static_cast<Real>(fraction) * angle) / sinAngle;
         // Converts from polar to vector and interpolate.
-        double x = a * cosFromLat * cos(fromLng) + b * cosToLat * cos(toLng);
-        double y = a * cosFromLat * sin(fromLng) + b * cosToLat * sin(toLng);
-        double z = a * sin(fromLat) + b * sin(toLat);
+        Real x = a * cosFromLat * std::cos(fromLng) + b * cosToLat * std::cos(toLng);
+        Real y = a * cosFromLat * std::sin(fromLng) + b * cosToLat * std::sin(toLng);
+        Real z = a * std::sin(fromLat) + b * std::sin(toLat);
         // Converts interpolated vector back to polar.
-        double lat = atan2(z, sqrt(x * x + y * y));
-        double lng = atan2(y, x);
-        return LatLng(rad2deg(lat), rad2deg(lng));
+        Real lat = std::atan2(z, std::sqrt(x * x + y * y));
+        Real lng = std::atan2(y, x);
+        return LatLngT<T>(static_cast<T>(rad2deg(lat)), static_cast<T>(rad2deg(lng)));
     }
 
     /**
@@ -155,14 +313,35 @@ public:
      * on the unit sphere.
      */
     inline static double computeAngleBetween(const LatLng& from, const LatLng& to) {
-        return SphericalUtil::distanceRadians(deg2rad(from.lat), deg2rad(from.lng), deg2rad(to.lat), deg2rad(to.lng));
+        return SphericalUtil::computeAngleBetween<DoubleMath>(from, to);
+    }
+
+    /**
+     * Same as above, with the arithmetic given by the Math policy.
+     */
+    template <typename Math = DoubleMath, typename T>
+    inline static typename Math::Real computeAngleBetween(const LatLngT<T>& from, const LatLngT<T>& to) {
+        typedef typename Math::Real Real;
+        return SphericalUtil::distanceRadians(
+            static_cast<Real>(deg2rad(from.lat)), static_cast<Real>(deg2rad(from.lng)),
+            static_cast<Real>(deg2rad(to.lat)), static_cast<Real>(deg2rad(to.lng)));
     }
 
     /**
      * Returns the distance between two LatLngs, in meters.
      */
     inline static double computeDistanceBetween(const LatLng& from, const LatLng& to) {
-        return SphericalUtil::computeAngleBetween(from, to) * MathUtil::EARTH_RADIUS;
+        return SphericalUtil::computeDistanceBetween<EarthSphere>(from, to);
+    }
+
+    /**
+     * Same as above, on the sphere of the Model policy and with the arithmetic given
+     * by the Math policy.
+     */
+    template <typename Model, typename Math = DoubleMath, typename T>
+    inline static typename Math::Real computeDistanceBetween(const LatLngT<T>& from, const LatLngT<T>& to) {
+        typedef typename Math::Real Real;
+        return SphericalUtil::computeAngleBetween<Math>(from, to) * static_cast<Real>(Model::RADIUS);
     }
 
     /**
@@ -170,21 +349,31 @@ public:
      */
     template <typename LatLngList>
     inline static double computeLength(const LatLngList& path) {
-        if (path.size() < 2U) {
-            return 0;
-        }
-        double length = 0;
-        LatLng prev = path[0];
-        double prevLat = deg2rad(prev.lat);
-        double prevLng = deg2rad(prev.lng);
+        return SphericalUtil::computeLength<EarthSphere>(path);
+    }
+
+    /**
+     * Same as above, on the sphere of the Model policy. The Math policy gives the
+     * arithmetic of each segment; the sum is compensated, in double.
+     */
+    template <typename Model, typename Math = DoubleMath, typename LatLngList>
+    inline static double computeLength(const LatLngList& path) {
+        typedef typename Math::Real Real;
+        ChunkedSum length;
+        Real prevLat = 0;
+        Real prevLng = 0;
+        bool first = true;
         for (auto point : path) {
-            double lat = deg2rad(point.lat);
-            double lng = deg2rad(point.lng);
-            length += SphericalUtil::distanceRadians(prevLat, prevLng, lat, lng);
+            Real lat = static_cast<Real>(latRadians(point));
+            Real lng = static_cast<Real>(lngRadians(point));
+            if (!first) {
+                length.add(SphericalUtil::distanceRadians(prevLat, prevLng, lat, lng));
+            }
+            first = false;
             prevLat = lat;
             prevLng = lng;
         }
-        return length * MathUtil::EARTH_RADIUS;
+        return length.value() * Model::RADIUS;
     }
 
     /**
@@ -198,6 +387,15 @@ public:
         return abs(SphericalUtil::computeSignedArea(path));
     }
 
+    /**
+     * Same as above, on the sphere of the Model policy and with the arithmetic given
+     * by the Math policy.
+     */
+    template <typename Model, typename Math = DoubleMath, typename LatLngList>
+    inline static double computeArea(const LatLngList& path) {
+        return abs(SphericalUtil::computeSignedArea<Model, Math>(path));
+    }
+
     /**
      * Returns the signed area of a closed path on Earth. The sign of the area may be used to
      * determine the orientation of the path.
@@ -211,12 +409,131 @@ public:
         return SphericalUtil::computeSignedAreaP(path, MathUtil::EARTH_RADIUS);
     }
 
+    /**
+     * Same as above, on the sphere of the Model policy. The Math policy gives the
+     * arithmetic of each edge; the sum is compensated, in double.
+     */
+    template <typename Model, typename Math = DoubleMath, typename LatLngList>
+    inline static double computeSignedArea(const LatLngList& path) {
+        return SphericalUtil::computeSignedAreaP<Math>(path, Model::RADIUS);
+    }
+
+    /**
+     * Same as computeLength(), on several threads: the segments are summed by chunks
+     * of ChunkedSum::CHUNK, which are added in order, so the result is bit-identical
+     * to computeLength() for any number of threads.
+     *
+     * @param path    Any random-access container; the lazy lists (E7Path, EncodedPolyline)
+     *                would decode from the start at every path[i].
+     * @param threads the number of threads for long paths, 0 for one per hardware thread
+     */
+    template <typename LatLngList>
+    inline static double computeLengthParallel(const LatLngList& path, unsigned threads = 0) {
+        static_assert(SphericalUtil::isRandomAccess<LatLngList>(), "computeLengthParallel() needs a random-access path");
+        size_t size = path.size();
+        if (size < 2U) {
+            return 0;
+        }
+        auto segments = [&path](size_t first, size_t last, CompensatedSum* sum) {
+            double prevLat = latRadians(path[first]);
+            double prevLng = lngRadians(path[first]);
+            for (size_t i = first + 1; i <= last; ++i) {
+                auto point = path[i];
+                double lat = latRadians(point);
+                double lng = lngRadians(point);
+                sum->add(SphericalUtil::distanceRadians(prevLat, prevLng, lat, lng));
+                prevLat = lat;
+                prevLng = lng;
+            }
+        };
+        return SphericalUtil::sumParallel(size - 1, threads, segments) * MathUtil::EARTH_RADIUS;
+    }
+
+    /**
+     * Same as computeArea(), on several threads; see computeSignedAreaParallel().
+     */
+    template <typename LatLngList>
+    inline static double computeAreaParallel(const LatLngList& path, unsigned threads = 0) {
+        return std::fabs(SphericalUtil::computeSignedAreaParallel(path, threads));
+    }
+
+    /**
+     * Same as computeSignedArea(), on several threads: the polar triangles are summed
+     * by chunks of ChunkedSum::CHUNK, which are added in order, so the result is
+     * bit-identical to computeSignedArea() for any number of threads.
+     *
+     * @param path    Any random-access container; the lazy lists (E7Path, EncodedPolyline)
+     *                would decode from the start at every path[i].
+     * @param threads the number of threads for long paths, 0 for one per hardware thread
+     */
+    template <typename LatLngList>
+    inline static double computeSignedAreaParallel(const LatLngList& path, unsigned threads = 0) {
+        static_assert(SphericalUtil::isRandomAccess<LatLngList>(), "computeSignedAreaParallel() needs a random-access path");
+        size_t size = path.size();
+        if (size < 3U) {
+            return 0;
+        }
+        // Edge i runs from vertex i to vertex i + 1; the last one closes the path.
+        auto triangles = [&path, size](size_t first, size_t last, CompensatedSum* sum) {
+            double prevTanLat = SphericalUtil::polarTan<double>(latRadians(path[first]));
+            double prevLng = lngRadians(path[first]);
+            for (size_t i = first + 1; i <= last; ++i) {
+                auto point = path[i == size ? 0 : i];
+                double tanLat = SphericalUtil::polarTan<double>(latRadians(point));
+                double lng = lngRadians(point);
+                sum->add(SphericalUtil::polarTriangleArea(tanLat, lng, prevTanLat, prevLng));
+                prevTanLat = tanLat;
+                prevLng = lng;
+            }
+        };
+        return SphericalUtil::sumParallel(size, threads, triangles) * (MathUtil::EARTH_RADIUS * MathUtil::EARTH_RADIUS);
+    }
+
+    // Paths with fewer points are summed on the calling thread.
+    static constexpr size_t PARALLEL_MIN_POINTS = 1 << 16;
+
+    /**
+     * The number of circlePolygon() vertices between exact sines and cosines of the
+     * heading; the rotation in between drifts by about an ulp per vertex.
+     */
+    static constexpr size_t CIRCLE_RESEED = 64;
+
 
 private:
+    friend class LengthAccumulator;
+    friend class AreaAccumulator;
+
+    /**
+     * Whether the iterators of the container are random-access, so path[i] is O(1).
+     */
+    template <typename LatLngList>
+    static constexpr bool isRandomAccess() {
+        return std::is_base_of<std::random_access_iterator_tag,
+            typename std::iterator_traits<decltype(std::declval<const LatLngList&>().begin())>::iterator_category>::value;
+    }
+
+    /**
+     * Returns the offset from an origin at the latitude of the given sine and cosine and
+     * the given longitude, in radians, by the angular distance and bearing of the
+     * given sines and cosines.
+     */
+    template <typename T, typename Real>
+    inline static LatLngT<T> offsetRadians(Real sinFromLat, Real cosFromLat, Real fromLng,
+                                           Real sinDistance, Real cosDistance, Real sinBearing, Real cosBearing) {
+        // http://williams.best.vwh.net/avform.htm#LL
+        Real sinLat = cosDistance * sinFromLat + sinDistance * cosFromLat * cosBearing;
+        Real dLng = std::atan2(
+            sinDistance * cosFromLat * sinBearing,
+            cosDistance - sinFromLat * sinLat);
+
+        return LatLngT<T>(static_cast<T>(rad2deg(std::asin(sinLat))), static_cast<T>(rad2deg(fromLng + dLng)));
+    }
+
     /**
      * Returns distance on the unit sphere; the arguments are in radians.
      */
-    inline static double distanceRadians(double lat1, double lng1, double lat2, double lng2) {
+    template <typename Real>
+    inline static Real distanceRadians(Real lat1, Real lng1, Real lat2, Real lng2) {
         return MathUtil::arcHav(MathUtil::havDistance(lat1, lat2, lng1 - lng2));
     }
 
@@ -225,24 +542,83 @@ private:
      * The computed area uses the same units as the radius squared.
      * Used by SphericalUtilTest.
      */
-    template <typename LatLngList>
+    template <typename Math = DoubleMath, typename LatLngList>
     inline static double computeSignedAreaP(const LatLngList& path, double radius) {
-        size_t size = path.size();
-        if (size < 3U) { return 0; }
-        double total = 0;
-        LatLng prev = path[size - 1];
-        double prevTanLat = tan((M_PI / 2 - deg2rad(prev.lat)) / 2);
-        double prevLng = deg2rad(prev.lng);
+        typedef typename Math::Real Real;
+        if (path.size() < 3U) { return 0; }
+        ChunkedSum total;
+        Real firstTanLat = 0;
+        Real firstLng = 0;
+        Real prevTanLat = 0;
+        Real prevLng = 0;
+        bool first = true;
         // For each edge, accumulate the signed area of the triangle formed by the North Pole
         // and that edge ("polar triangle").
         for (auto point : path) {
-            double tanLat = tan((M_PI / 2 - deg2rad(point.lat)) / 2);
-            double lng = deg2rad(point.lng);
-            total += SphericalUtil::polarTriangleArea(tanLat, lng, prevTanLat, prevLng);
+            Real tanLat = SphericalUtil::polarTan<Real>(latRadians(point));
+            Real lng = static_cast<Real>(lngRadians(point));
+            if (first) {
+                firstTanLat = tanLat;
+                firstLng = lng;
+                first = false;
+            } else {
+                total.add(SphericalUtil::polarTriangleArea(tanLat, lng, prevTanLat, prevLng));
+            }
             prevTanLat = tanLat;
             prevLng = lng;
         }
-        return total * (radius * radius);
+        // The closing edge, from the last vertex back to the first.
+        total.add(SphericalUtil::polarTriangleArea(firstTanLat, firstLng, prevTanLat, prevLng));
+        return total.value() * (radius * radius);
+    }
+
+    /**
+     * Returns the ChunkedSum of count terms: terms(first, last, sum) adds the terms
+     * first to last - 1 to sum. The chunks are summed on up to threads threads, and
+     * their sums added in order.
+     */
+    template <typename Terms>
+    inline static double sumParallel(size_t count, unsigned threads, Terms terms) {
+        size_t chunks = (count + ChunkedSum::CHUNK - 1) / ChunkedSum::CHUNK;
+        std::vector<CompensatedSum> sums(chunks);
+        auto run = [&](size_t firstChunk, size_t lastChunk) {
+            for (size_t chunk = firstChunk; chunk < lastChunk; ++chunk) {
+                size_t first = chunk * ChunkedSum::CHUNK;
+                terms(first, std::min(first + ChunkedSum::CHUNK, count), &sums[chunk]);
+            }
+        };
+
+        if (threads == 0) {
+            threads = std::max(std::thread::hardware_concurrency(), 1U);
+        }
+        if (threads == 1 || count < PARALLEL_MIN_POINTS) {
+            run(0, chunks);
+        } else {
+            size_t perThread = (chunks + threads - 1) / threads;
+            std::vector<std::thread> workers;
+            for (size_t first = perThread; first < chunks; first += perThread) {
+                workers.emplace_back(run, first, std::min(first + perThread, chunks));
+            }
+            run(0, perThread);
+            for (auto& thread : workers) {
+                thread.join();
+            }
+        }
+
+        CompensatedSum total;
+        for (const auto& sum : sums) {
+            total.add(sum);
+        }
+        return total.value();
+    }
+
+    /**
+     * Returns tan((pi/2 - lat)/2) of a latitude in radians, the argument of
+     * polarTriangleArea().
+     */
+    template <typename Real>
+    inline static Real polarTan(double lat) {
+        return std::tan(static_cast<Real>((M_PI / 2 - lat) / 2));
     }
 
     /**
@@ -252,10 +628,11 @@ private:
      * See http://books.google.com/books?id=3uBHAAAAIAAJ&pg=PA71
      * The arguments named "tan" are tan((pi/2 - latitude)/2).
      */
-    inline static double polarTriangleArea(double tan1, double lng1, double tan2, double lng2) {
-        double deltaLng = lng1 - lng2;
-        double t = tan1 * tan2;
-        return 2 * atan2(t * sin(deltaLng), 1 + t * cos(deltaLng));
+    template <typename Real>
+    inline static Real polarTriangleArea(Real tan1, Real lng1, Real tan2, Real lng2) {
+        Real deltaLng = lng1 - lng2;
+        Real t = tan1 * tan2;
+        return 2 * std::atan2(t * std::sin(deltaLng), 1 + t * std::cos(deltaLng));
     }
 };
 
@@ -0,0 +1,95 @@
+//******************************************************************************
+// Copyright 2013 Google Inc.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// This software and the related documents are provided  as is,  with no express
+// or implied  warranties,  other than  those that are  expressly stated  in the
+// License.
+//******************************************************************************
+
+#ifndef GEOMETRY_LIBRARY_UNIT_VEC3
+#define GEOMETRY_LIBRARY_UNIT_VEC3
+
+#include <cmath>
+
+#include "MathUtil.hpp"
+#include "LatLng.hpp"
+
+
+/**
+ * A location as an n-vector: the ECEF unit vector of a point on the unit sphere, with
+ * x towards (0, 0), y towards (0, 90) and z towards the North Pole.
+ *
+ * Converting costs a few trig calls once; the VectorUtil functions then work on
+ * the vectors with dot and cross products only.
+ */
+class UnitVec3 {
+public:
+    double x;
+    double y;
+    double z;
+
+    UnitVec3(double x, double y, double z)
+        : x(x), y(y), z(z) {}
+
+    /**
+     * Constructs the unit vector of a location.
+     */
+    explicit UnitVec3(const LatLng& point) {
+        double lat = deg2rad(point.lat);
+        double lng = deg2rad(point.lng);
+        double cosLat = cos(lat);
+        x = cosLat * cos(lng);
+        y = cosLat * sin(lng);
+        z = sin(lat);
+    }
+
+    UnitVec3(const UnitVec3 & vector) = default;
+
+    UnitVec3& operator=(const UnitVec3 & other) = default;
+
+    /**
+     * Returns the location of this vector, which need not be normalized. The
+     * longitude is in [-180, 180]; it is 0 at the poles.
+     */
+    inline LatLng toLatLng() const {
+        return LatLng(rad2deg(atan2(z, sqrt(x * x + y * y))), rad2deg(atan2(y, x)));
+    }
+
+    inline double dot(const UnitVec3& other) const {
+        return x * other.x + y * other.y + z * other.z;
+    }
+
+    inline UnitVec3 cross(const UnitVec3& other) const {
+        return UnitVec3(y * other.z - z * other.y, z * other.x - x * other.z, x * other.y - y * other.x);
+    }
+
+    /**
+     * Returns the squared length of this vector.
+     */
+    inline double norm2() const {
+        return dot(*this);
+    }
+
+    inline UnitVec3 operator+(const UnitVec3& other) const {
+        return UnitVec3(x + other.x, y + other.y, z + other.z);
+    }
+
+    inline UnitVec3 operator-(const UnitVec3& other) const {
+        return UnitVec3(x - other.x, y - other.y, z - other.z);
+    }
+
+    inline UnitVec3 operator*(double factor) const {
+        return UnitVec3(x * factor, y * factor, z * factor);
+    }
+
+    bool operator==(const UnitVec3 & other) const {
+        return x == other.x && y == other.y && z == other.z;
+    }
+};
+
+#endif // GEOMETRY_LIBRARY_UNIT_VEC3
@@ -0,0 +1,218 @@
+//******************************************************************************
+// Copyright 2013 Google Inc.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// This software and the related documents are provided  as is,  with no express
+// or implied  warranties,  other than  those that are  expressly stated  in the
+// License.
+//******************************************************************************
+
+#ifndef GEOMETRY_LIBRARY_VEC_MATH
+#define GEOMETRY_LIBRARY_VEC_MATH
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "MathUtil.hpp"
+#include "Simd.hpp"
+
+
+template <typename Isa>
+struct VecMathKernel;
+
+/**
+ * Transcendental functions over arrays of doubles or floats, evaluated with the
+ * AVX2 and AVX-512 kernels picked at runtime by Simd::level().
+ *
+ * STRICT calls libm for every element and gives exactly the std:: results.
+ * FAST evaluates Cephes polynomial and rational approximations in vector registers.
+ * Compared with libm, FAST results differ by at most MAX_ULP (MAX_ULP_FLOAT for floats)
+ * units in the last place; the largest differences measured are:
+ *
+ *   function         double  float
+ *   sin, cos, sincos      2      2
+ *   tan                   3      3
+ *   asin                  1      2
+ *   atan2                 2      3
+ *   log                   1      1   (subnormals, zero, infinity and NaN included)
+ *   exp                   2      1   (for normal results)
+ *
+ * sin, cos and tan reduce their argument by Cody-Waite, which is accurate up to
+ * MAX_REDUCED (MAX_REDUCED_FLOAT); vectors holding a larger argument are evaluated
+ * by libm. Without vector support both modes call libm.
+ *
+ * The per-vector functions are in VecMathKernel<Isa>, for use by other kernels.
+ */
+class VecMath {
+public:
+    enum Accuracy {
+        STRICT = 0,
+        FAST   = 1,
+    };
+
+    static constexpr double MAX_ULP = 3;
+    static constexpr double MAX_ULP_FLOAT = 3;
+    static constexpr double MAX_REDUCED = 1e5;
+    static constexpr float  MAX_REDUCED_FLOAT = 8192;
+
+    /**
+     * Writes f(x[i]) to out[i] for i in [0, n); T is double or float. out may equal x.
+     */
+    template <typename T>
+    static inline void sin(const T* x, T* out, size_t n, Accuracy accuracy = FAST) {
+        VecMath::apply(SIN, x, out, n, accuracy);
+    }
+
+    template <typename T>
+    static inline void cos(const T* x, T* out, size_t n, Accuracy accuracy = FAST) {
+        VecMath::apply(COS, x, out, n, accuracy);
+    }
+
+    template <typename T>
+    static inline void tan(const T* x, T* out, size_t n, Accuracy accuracy = FAST) {
+        VecMath::apply(TAN, x, out, n, accuracy);
+    }
+
+    template <typename T>
+    static inline void asin(const T* x, T* out, size_t n, Accuracy accuracy = FAST) {
+        VecMath::apply(ASIN, x, out, n, accuracy);
+    }
+
+    template <typename T>
+    static inline void log(const T* x, T* out, size_t n, Accuracy accuracy = FAST) {
+        VecMath::apply(LOG, x, out, n, accuracy);
+    }
+
+    template <typename T>
+    static inline void exp(const T* x, T* out, size_t n, Accuracy accuracy = FAST) {
+        VecMath::apply(EXP, x, out, n, accuracy);
+    }
+
+    /**
+     * Writes sin(x[i]) to s[i] and cos(x[i]) to c[i] for i in [0, n).
+     */
+    template <typename T>
+    static inline void sincos(const T* x, T* s, T* c, size_t n, Accuracy accuracy = FAST);
+
+    /**
+     * Writes atan2(y[i], x[i]) to out[i] for i in [0, n).
+     */
+    template <typename T>
+    static inline void atan2(const T* y, const T* x, T* out, size_t n, Accuracy accuracy = FAST);
+
+
+private:
+    template <typename Isa>
+    friend struct VecMathKernel;
+
+    enum Function {
+        SIN,
+        COS,
+        TAN,
+        ASIN,
+        LOG,
+        EXP,
+    };
+
+    template <typename T>
+    static inline void apply(Function function, const T* x, T* out, size_t n, Accuracy accuracy);
+
+    template <typename T>
+    static inline T scalar(Function function, T x) {
+        switch (function) {
+            case SIN:  return std::sin(x);
+            case COS:  return std::cos(x);
+            case TAN:  return std::tan(x);
+            case ASIN: return std::asin(x);
+            case LOG:  return std::log(x);
+            case EXP:  return std::exp(x);
+        }
+        return x;
+    }
+};
+
+#ifdef GEOMETRY_LIBRARY_HAS_SIMD
+#pragma GCC push_options
+#pragma GCC target("avx2,fma")
+#define GEOMETRY_LIBRARY_SIMD_ISA SimdAvx2
+#include "VecMathKernel.hpp"
+#undef GEOMETRY_LIBRARY_SIMD_ISA
+#pragma GCC pop_options
+
+#pragma GCC push_options
+#pragma GCC target("avx512f")
+#define GEOMETRY_LIBRARY_SIMD_ISA SimdAvx512
+#include "VecMathKernel.hpp"
+#undef GEOMETRY_LIBRARY_SIMD_ISA
+#pragma GCC pop_options
+#endif
+
+
+template <typename T>
+inline void VecMath::apply(Function function, const T* x, T* out, size_t n, Accuracy accuracy) {
+#ifdef GEOMETRY_LIBRARY_HAS_SIMD
+    Simd::Level level = Simd::level();
+    if (level == Simd::AVX512) {
+        VecMathKernel<SimdAvx512>::apply(function, x, out, n, accuracy);
+        return;
+    }
+    if (level == Simd::AVX2) {
+        VecMathKernel<SimdAvx2>::apply(function, x, out, n, accuracy);
+        return;
+    }
+#else
+    (void) accuracy;
+#endif
+    for (size_t i = 0; i < n; ++i) {
+        out[i] = VecMath::scalar(function, x[i]);
+    }
+}
+
+template <typename T>
+inline void VecMath::sincos(const T* x, T* s, T* c, size_t n, Accuracy accuracy) {
+#ifdef GEOMETRY_LIBRARY_HAS_SIMD
+    Simd::Level level = Simd::level();
+    if (level == Simd::AVX512) {
+        VecMathKernel<SimdAvx512>::applySincos(x, s, c, n, accuracy);
+        return;
+    }
+    if (level == Simd::AVX2) {
+        VecMathKernel<SimdAvx2>::applySincos(x, s, c, n, accuracy);
+        return;
+    }
+#else
+    (void) accuracy;
+#endif
+    for (size_t i = 0; i < n; ++i) {
+        T value = x[i];
+        s[i] = std::sin(value);
+        c[i] = std::cos(value);
+    }
+}
+
+template <typename T>
+inline void VecMath::atan2(const T* y, const T* x, T* out, size_t n, Accuracy accuracy) {
+#ifdef GEOMETRY_LIBRARY_HAS_SIMD
+    Simd::Level level = Simd::level();
+    if (level == Simd::AVX512) {
+        VecMathKernel<SimdAvx512>::applyAtan2(y, x, out, n, accuracy);
+        return;
+    }
+    if (level == Simd::AVX2) {
+        VecMathKernel<SimdAvx2>::applyAtan2(y, x, out, n, accuracy);
+        return;
+    }
+#else
+    (void) accuracy;
+#endif
+    for (size_t i = 0; i < n; ++i) {
+        out[i] = std::atan2(y[i], x[i]);
+    }
+}
+
+#endif // GEOMETRY_LIBRARY_VEC_MATH
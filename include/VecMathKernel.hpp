@@ -0,0 +1,543 @@
+//******************************************************************************
+// Copyright 2013 Google Inc.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// This software and the related documents are provided  as is,  with no express
+// or implied  warranties,  other than  those that are  expressly stated  in the
+// License.
+//******************************************************************************
+
+// No include guard: VecMath.hpp includes this file once per instruction set,
+// inside the matching "#pragma GCC target" region, with GEOMETRY_LIBRARY_SIMD_ISA
+// naming the primitive set from Simd.hpp.
+
+template <>
+struct VecMathKernel<GEOMETRY_LIBRARY_SIMD_ISA> {
+    typedef GEOMETRY_LIBRARY_SIMD_ISA Isa;
+    typedef Isa::Double    Double;
+    typedef Isa::Mask      Mask;
+    typedef Isa::Float     Float;
+    typedef Isa::FloatMask FloatMask;
+    typedef VecMath::Accuracy Accuracy;
+
+    /**
+     * Array loops behind the VecMath functions; T is double or float. A partial last
+     * vector is padded, so every element goes through the same vector code.
+     */
+    template <typename T>
+    static inline void apply(VecMath::Function function, const T* x, T* out, size_t n, Accuracy accuracy) {
+        switch (function) {
+            case VecMath::SIN:  return each(x, out, n, [accuracy](auto v) { return sin(v, accuracy); });
+            case VecMath::COS:  return each(x, out, n, [accuracy](auto v) { return cos(v, accuracy); });
+            case VecMath::TAN:  return each(x, out, n, [accuracy](auto v) { return tan(v, accuracy); });
+            case VecMath::ASIN: return each(x, out, n, [accuracy](auto v) { return asin(v, accuracy); });
+            case VecMath::LOG:  return each(x, out, n, [accuracy](auto v) { return log(v, accuracy); });
+            case VecMath::EXP:  return each(x, out, n, [accuracy](auto v) { return exp(v, accuracy); });
+        }
+    }
+
+    template <typename T>
+    static inline void applySincos(const T* x, T* s, T* c, size_t n, Accuracy accuracy) {
+        typedef decltype(Isa::load(x)) Vector;
+        const size_t lanes = sizeof(Vector) / sizeof(T);
+        Vector sinV;
+        Vector cosV;
+        size_t i = 0;
+        for (; i + lanes <= n; i += lanes) {
+            sincos(Isa::load(x + i), &sinV, &cosV, accuracy);
+            Isa::store(s + i, sinV);
+            Isa::store(c + i, cosV);
+        }
+        if (i < n) {
+            T in[lanes];
+            T sinOut[lanes];
+            T cosOut[lanes];
+            std::fill(in, in + lanes, T(0));
+            std::copy(x + i, x + n, in);
+            sincos(Isa::load(in), &sinV, &cosV, accuracy);
+            Isa::store(sinOut, sinV);
+            Isa::store(cosOut, cosV);
+            std::copy(sinOut, sinOut + (n - i), s + i);
+            std::copy(cosOut, cosOut + (n - i), c + i);
+        }
+    }
+
+    template <typename T>
+    static inline void applyAtan2(const T* y, const T* x, T* out, size_t n, Accuracy accuracy) {
+        typedef decltype(Isa::load(x)) Vector;
+        const size_t lanes = sizeof(Vector) / sizeof(T);
+        size_t i = 0;
+        for (; i + lanes <= n; i += lanes) {
+            Isa::store(out + i, atan2(Isa::load(y + i), Isa::load(x + i), accuracy));
+        }
+        if (i < n) {
+            T inY[lanes];
+            T inX[lanes];
+            T result[lanes];
+            std::fill(inY, inY + lanes, T(0));
+            std::fill(inX, inX + lanes, T(1));
+            std::copy(y + i, y + n, inY);
+            std::copy(x + i, x + n, inX);
+            Isa::store(result, atan2(Isa::load(inY), Isa::load(inX), accuracy));
+            std::copy(result, result + (n - i), out + i);
+        }
+    }
+
+    static inline Double sin(Double x, Accuracy accuracy = VecMath::FAST) {
+        if (accuracy == VecMath::STRICT || Isa::any(Isa::abs(x) > VecMath::MAX_REDUCED)) {
+            return map(x, [](double v) { return std::sin(v); });
+        }
+        Mask quadrant;
+        Double r = reduce(Isa::abs(x), &quadrant);
+        Double y = Isa::select((quadrant & 1) != 0, cosPoly(r), sinPoly(r));
+        // sin(-x) == -sin(x)
+        Mask sign = (((quadrant & 2) != 0) & signBit(x)) ^ (bits(x) & signBit(x));
+        return fromBits(bits(y) ^ sign);
+    }
+
+    static inline Double cos(Double x, Accuracy accuracy = VecMath::FAST) {
+        if (accuracy == VecMath::STRICT || Isa::any(Isa::abs(x) > VecMath::MAX_REDUCED)) {
+            return map(x, [](double v) { return std::cos(v); });
+        }
+        Mask quadrant;
+        Double r = reduce(Isa::abs(x), &quadrant);
+        Double y = Isa::select((quadrant & 1) != 0, sinPoly(r), cosPoly(r));
+        Mask sign = ((((quadrant + 1) & 2) != 0) & signBit(x));
+        return fromBits(bits(y) ^ sign);
+    }
+
+    static inline void sincos(Double x, Double* s, Double* c, Accuracy accuracy = VecMath::FAST) {
+        if (accuracy == VecMath::STRICT || Isa::any(Isa::abs(x) > VecMath::MAX_REDUCED)) {
+            *s = map(x, [](double v) { return std::sin(v); });
+            *c = map(x, [](double v) { return std::cos(v); });
+            return;
+        }
+        Mask quadrant;
+        Double r = reduce(Isa::abs(x), &quadrant);
+        Double sinR = sinPoly(r);
+        Double cosR = cosPoly(r);
+        Mask odd = (quadrant & 1) != 0;
+        Mask sinSign = (((quadrant & 2) != 0) & signBit(x)) ^ (bits(x) & signBit(x));
+        Mask cosSign = ((((quadrant + 1) & 2) != 0) & signBit(x));
+        *s = fromBits(bits(Isa::select(odd, cosR, sinR)) ^ sinSign);
+        *c = fromBits(bits(Isa::select(odd, sinR, cosR)) ^ cosSign);
+    }
+
+    static inline Double tan(Double x, Accuracy accuracy = VecMath::FAST) {
+        if (accuracy == VecMath::STRICT || Isa::any(Isa::abs(x) > VecMath::MAX_REDUCED)) {
+            return map(x, [](double v) { return std::tan(v); });
+        }
+        Mask quadrant;
+        Double r = reduce(Isa::abs(x), &quadrant);
+        // Cephes tan: rational approximation on [-PI/4, PI/4].
+        Double z = r * r;
+        Double p = (-1.30936939181383777646E4 * z + 1.15351664838587416140E6) * z - 1.79565251976484877988E7;
+        Double q = (((z + 1.36812963470692954678E4) * z - 1.32089234440210967447E6) * z
+            + 2.50083801823357915839E7) * z - 5.38695755929454629881E7;
+        Double y = r + r * (z * p / q);
+        // tan(x + PI/2) == -1 / tan(x)
+        y = Isa::select((quadrant & 1) != 0, -1.0 / y, y);
+        return fromBits(bits(y) ^ (bits(x) & signBit(x)));
+    }
+
+    static inline Double asin(Double x, Accuracy accuracy = VecMath::FAST) {
+        if (accuracy == VecMath::STRICT) {
+            return map(x, [](double v) { return std::asin(v); });
+        }
+        Double a = Isa::abs(x);
+
+        // Cephes asin: rational approximation in a^2 for a <= 0.625.
+        Double g = a * a;
+        Double p = ((((4.253011369004428248960E-3 * g - 6.019598008014123785661E-1) * g
+            + 5.444622390564711410273E0) * g - 1.626247967210700244449E1) * g
+            + 1.956261983317594739197E1) * g - 8.198089802484824371615E0;
+        Double q = ((((g - 1.474091372988853791896E1) * g + 7.049610280856842141659E1) * g
+            - 1.471791292232726029859E2) * g + 1.395105614657485689735E2) * g
+            - 4.918853881490881290097E1;
+        Double result = a + a * (g * p / q);
+
+        // And in 1 - a above; NaN for a > 1 through the square root.
+        Mask big = a > 0.625;
+        if (Isa::any(big)) {
+            Double zz = 1.0 - a;
+            Double r = zz * ((((2.967721961301243206100E-3 * zz - 5.634242780008963776856E-1) * zz
+                + 6.968710824104713396794E0) * zz - 2.556901049652824852289E1) * zz
+                + 2.853665548261061424989E1);
+            Double u = (((zz - 2.194779531642920639778E1) * zz + 1.470656354026814941758E2) * zz
+                - 3.838770957603691357202E2) * zz + 3.424398657913078477438E2;
+            Double root = Isa::sqrt(zz + zz);
+            Double z = (M_PI / 4 - root) - (root * (r / u) - MORE_BITS);
+            result = Isa::select(big, z + M_PI / 4, result);
+        }
+        return fromBits(bits(result) ^ (bits(x) & signBit(x)));
+    }
+
+    static inline Double atan2(Double y, Double x, Accuracy accuracy = VecMath::FAST) {
+        if (accuracy == VecMath::STRICT) {
+            Double result;
+            for (size_t i = 0; i < Isa::LANES; ++i) {
+                result[i] = std::atan2(y[i], x[i]);
+            }
+            return result;
+        }
+        Double ax = Isa::abs(x);
+        Double ay = Isa::abs(y);
+        Double num = Isa::min(ax, ay);
+        Double den = Isa::max(ax, ay);
+
+        // Cephes atan on [0, 1]: atan(t) == PI/4 + atan((t - 1) / (t + 1)) above 0.66.
+        // Equal covers both zero and both infinite.
+        Mask equal = num == den;
+        Mask big = (num > 0.66 * den) | equal;
+        Double t = Isa::select(big, (num - den) / (num + den), num / den);
+        t = Isa::select(equal, Isa::broadcast(0.0), t);
+        Double z = t * t;
+        Double p = (((-8.750608600031904122785E-1 * z - 1.615753718733365076637E1) * z
+            - 7.500855792314704667340E1) * z - 1.228866684490136173410E2) * z - 6.485021904942025371773E1;
+        Double q = ((((z + 2.485846490142306297962E1) * z + 1.650270098316988542046E2) * z
+            + 4.328810604912902668951E2) * z + 4.853903996359136964868E2) * z + 1.945506571482613964425E2;
+        Double result = t + t * (z * p / q);
+        result = Isa::select(big, (M_PI / 4 + 0.5 * MORE_BITS) + result, result);
+        result = Isa::select(den == 0.0, Isa::broadcast(0.0), result);
+
+        // Back to the quadrant of (x, y).
+        result = Isa::select(ay > ax, (M_PI / 2 - result) + MORE_BITS, result);
+        result = Isa::select((bits(x) & signBit(x)) != 0, (M_PI - result) + 2 * MORE_BITS, result);
+        result = fromBits(bits(result) ^ (bits(y) & signBit(y)));
+        return Isa::select((x != x) | (y != y), x + y, result);
+    }
+
+    static inline Double log(Double x, Accuracy accuracy = VecMath::FAST) {
+        if (accuracy == VecMath::STRICT) {
+            return map(x, [](double v) { return std::log(v); });
+        }
+        // Scale subnormals into the normal range.
+        Mask subnormal = x < 2.2250738585072014e-308;
+        Double v = Isa::select(subnormal, x * 18014398509481984.0, x);  // 2^54
+
+        // x == f * 2^e, f in [sqrt(1/2), sqrt(2)).
+        Mask m = bits(v);
+        Mask e = ((m >> 52) & 0x7ff) - 1022;
+        Double f = fromBits((m & 0x000fffffffffffff) | bits(Isa::broadcast(0.5)));
+        Mask small = f < 0.70710678118654752440;
+        e += small;
+        f = Isa::select(small, f + f, f) - 1.0;
+        Double k = toDouble(e) - Isa::select(subnormal, Isa::broadcast(54.0), Isa::broadcast(0.0));
+
+        // Cephes log: log(1 + f) by a rational approximation, plus k * log(2) in two parts.
+        Double z = f * f;
+        Double p = ((((1.01875663804580931796E-4 * f + 4.97494994976747001425E-1) * f
+            + 4.70579119878881725854E0) * f + 1.44989225341610930846E1) * f
+            + 1.79368678507819816313E1) * f + 7.70838733755885391666E0;
+        Double q = ((((f + 1.12873587189167450590E1) * f + 4.52279145837532221105E1) * f
+            + 8.29875266912776603211E1) * f + 7.11544750618563894466E1) * f + 2.31251620126765340583E1;
+        Double r = f * (z * p / q);
+        r = r - k * 2.121944400546905827679E-4;
+        r = r - 0.5 * z;
+        Double result = (f + r) + k * 0.693359375;
+
+        result = Isa::select(x == 0.0, Isa::broadcast(-HUGE_VAL), result);
+        result = Isa::select(x == HUGE_VAL, x, result);
+        return Isa::select((x < 0.0) | (x != x), Isa::broadcast(std::numeric_limits<double>::quiet_NaN()), result);
+    }
+
+    static inline Double exp(Double x, Accuracy accuracy = VecMath::FAST) {
+        if (accuracy == VecMath::STRICT) {
+            return map(x, [](double v) { return std::exp(v); });
+        }
+        const double maxLog = 7.09782712893383996843E2;
+        const double minLog = -7.45133219101941108420E2;
+        Double v = Isa::min(Isa::max(x, Isa::broadcast(minLog)), Isa::broadcast(maxLog));
+
+        // exp(x) == 2^k * exp(r), |r| <= log(2) / 2.
+        Double k = Isa::round(v * 1.4426950408889634073599);
+        Double r = (v - k * 6.93145751953125E-1) - k * 1.42860682030941723212E-6;
+
+        // Cephes exp: exp(r) == 1 + 2 * r * P(r^2) / (Q(r^2) - r * P(r^2)).
+        Double z = r * r;
+        Double p = r * ((1.26177193074810590878E-4 * z + 3.02994407707441961300E-2) * z
+            + 9.99999999999999999910E-1);
+        Double q = ((3.00198505138664455042E-6 * z + 2.52448340349684104192E-3) * z
+            + 2.27265548208155028766E-1) * z + 2.00000000000000000009E0;
+        Double result = 1.0 + 2.0 * (p / (q - p));
+
+        // Scale in two steps, so both factors stay normal near the ends of the range.
+        Mask n = toInteger(k);
+        Mask half = n >> 1;
+        result = result * fromBits((half + 1023) << 52) * fromBits((n - half + 1023) << 52);
+
+        result = Isa::select(x > maxLog, Isa::broadcast(HUGE_VAL), result);
+        result = Isa::select(x < minLog, Isa::broadcast(0.0), result);
+        return Isa::select(x != x, x, result);
+    }
+
+    static inline Float sin(Float x, Accuracy accuracy = VecMath::FAST) {
+        if (accuracy == VecMath::STRICT || Isa::any(Isa::abs(x) > VecMath::MAX_REDUCED_FLOAT)) {
+            return map(x, [](float v) { return std::sin(v); });
+        }
+        FloatMask quadrant;
+        Float r = reduce(Isa::abs(x), &quadrant);
+        Float y = Isa::select((quadrant & 1) != 0, cosPoly(r), sinPoly(r));
+        FloatMask sign = (((quadrant & 2) != 0) & signBit(x)) ^ (bits(x) & signBit(x));
+        return fromBits(bits(y) ^ sign);
+    }
+
+    static inline Float cos(Float x, Accuracy accuracy = VecMath::FAST) {
+        if (accuracy == VecMath::STRICT || Isa::any(Isa::abs(x) > VecMath::MAX_REDUCED_FLOAT)) {
+            return map(x, [](float v) { return std::cos(v); });
+        }
+        FloatMask quadrant;
+        Float r = reduce(Isa::abs(x), &quadrant);
+        Float y = Isa::select((quadrant & 1) != 0, sinPoly(r), cosPoly(r));
+        FloatMask sign = ((((quadrant + 1) & 2) != 0) & signBit(x));
+        return fromBits(bits(y) ^ sign);
+    }
+
+    static inline void sincos(Float x, Float* s, Float* c, Accuracy accuracy = VecMath::FAST) {
+        if (accuracy == VecMath::STRICT || Isa::any(Isa::abs(x) > VecMath::MAX_REDUCED_FLOAT)) {
+            *s = map(x, [](float v) { return std::sin(v); });
+            *c = map(x, [](float v) { return std::cos(v); });
+            return;
+        }
+        FloatMask quadrant;
+        Float r = reduce(Isa::abs(x), &quadrant);
+        Float sinR = sinPoly(r);
+        Float cosR = cosPoly(r);
+        FloatMask odd = (quadrant & 1) != 0;
+        FloatMask sinSign = (((quadrant & 2) != 0) & signBit(x)) ^ (bits(x) & signBit(x));
+        FloatMask cosSign = ((((quadrant + 1) & 2) != 0) & signBit(x));
+        *s = fromBits(bits(Isa::select(odd, cosR, sinR)) ^ sinSign);
+        *c = fromBits(bits(Isa::select(odd, sinR, cosR)) ^ cosSign);
+    }
+
+    static inline Float tan(Float x, Accuracy accuracy = VecMath::FAST) {
+        if (accuracy == VecMath::STRICT || Isa::any(Isa::abs(x) > VecMath::MAX_REDUCED_FLOAT)) {
+            return map(x, [](float v) { return std::tan(v); });
+        }
+        FloatMask quadrant;
+        Float r = reduce(Isa::abs(x), &quadrant);
+        // Cephes tanf.
+        Float z = r * r;
+        Float y = (((((9.38540185543E-3f * z + 3.11992232697E-3f) * z + 2.44301354525E-2f) * z
+            + 5.34112807005E-2f) * z + 1.33387994085E-1f) * z + 3.33331568548E-1f) * z * r + r;
+        y = Isa::select((quadrant & 1) != 0, -1.0f / y, y);
+        return fromBits(bits(y) ^ (bits(x) & signBit(x)));
+    }
+
+    static inline Float asin(Float x, Accuracy accuracy = VecMath::FAST) {
+        if (accuracy == VecMath::STRICT) {
+            return map(x, [](float v) { return std::asin(v); });
+        }
+        // Cephes asinf: asin(a) == PI/2 - 2 * asin(sqrt((1 - a) / 2)) above 0.5.
+        Float a = Isa::abs(x);
+        FloatMask big = a > 0.5f;
+        Float z = Isa::select(big, 0.5f * (1.0f - a), a * a);
+        Float s = Isa::select(big, Isa::sqrt(z), a);
+        Float result = ((((4.2163199048E-2f * z + 2.4181311049E-2f) * z + 4.5470025998E-2f) * z
+            + 7.4953002686E-2f) * z + 1.6666752422E-1f) * z * s + s;
+        result = Isa::select(big, 1.5707963267948966192f - (result + result), result);
+        return fromBits(bits(result) ^ (bits(x) & signBit(x)));
+    }
+
+    static inline Float atan2(Float y, Float x, Accuracy accuracy = VecMath::FAST) {
+        if (accuracy == VecMath::STRICT) {
+            Float result;
+            for (size_t i = 0; i < Isa::FLOAT_LANES; ++i) {
+                result[i] = std::atan2(y[i], x[i]);
+            }
+            return result;
+        }
+        Float ax = Isa::abs(x);
+        Float ay = Isa::abs(y);
+        Float num = Isa::min(ax, ay);
+        Float den = Isa::max(ax, ay);
+
+        // Cephes atanf on [0, 1]: atan(t) == PI/4 + atan((t - 1) / (t + 1)) above tan(PI/8).
+        FloatMask equal = num == den;
+        FloatMask big = (num > 0.4142135623730950f * den) | equal;
+        Float t = Isa::select(big, (num - den) / (num + den), num / den);
+        t = Isa::select(equal, Isa::broadcast(0.0f), t);
+        Float z = t * t;
+        Float result = (((8.05374449538E-2f * z - 1.38776856032E-1f) * z + 1.99777106478E-1f) * z
+            - 3.33329491539E-1f) * z * t + t;
+        result = Isa::select(big, 0.78539816339744830962f + result, result);
+        result = Isa::select(den == 0.0f, Isa::broadcast(0.0f), result);
+
+        result = Isa::select(ay > ax, 1.5707963267948966192f - result, result);
+        result = Isa::select((bits(x) & signBit(x)) != 0, 3.14159265358979323846f - result, result);
+        result = fromBits(bits(result) ^ (bits(y) & signBit(y)));
+        return Isa::select((x != x) | (y != y), x + y, result);
+    }
+
+    static inline Float log(Float x, Accuracy accuracy = VecMath::FAST) {
+        if (accuracy == VecMath::STRICT) {
+            return map(x, [](float v) { return std::log(v); });
+        }
+        FloatMask subnormal = x < 1.17549435e-38f;
+        Float v = Isa::select(subnormal, x * 33554432.0f, x);  // 2^25
+
+        FloatMask m = bits(v);
+        FloatMask e = ((m >> 23) & 0xff) - 126;
+        Float f = fromBits((m & 0x007fffff) | bits(Isa::broadcast(0.5f)));
+        FloatMask small = f < 0.707106781186547524f;
+        e += small;
+        f = Isa::select(small, f + f, f) - 1.0f;
+        Float k = __builtin_convertvector(e, Float) - Isa::select(subnormal, Isa::broadcast(25.0f), Isa::broadcast(0.0f));
+
+        // Cephes logf.
+        Float z = f * f;
+        Float r = ((((((((7.0376836292E-2f * f - 1.1514610310E-1f) * f + 1.1676998740E-1f) * f
+            - 1.2420140846E-1f) * f + 1.4249322787E-1f) * f - 1.6668057665E-1f) * f
+            + 2.0000714765E-1f) * f - 2.4999993993E-1f) * f + 3.3333331174E-1f) * f * z;
+        r = r - k * 2.12194440e-4f;
+        r = r - 0.5f * z;
+        Float result = (f + r) + k * 0.693359375f;
+
+        result = Isa::select(x == 0.0f, Isa::broadcast(-HUGE_VALF), result);
+        result = Isa::select(x == HUGE_VALF, x, result);
+        return Isa::select((x < 0.0f) | (x != x), Isa::broadcast(std::numeric_limits<float>::quiet_NaN()), result);
+    }
+
+    static inline Float exp(Float x, Accuracy accuracy = VecMath::FAST) {
+        if (accuracy == VecMath::STRICT) {
+            return map(x, [](float v) { return std::exp(v); });
+        }
+        const float maxLog = 88.72283905206835f;
+        const float minLog = -103.278929903431851103f;
+        Float v = Isa::min(Isa::max(x, Isa::broadcast(minLog)), Isa::broadcast(maxLog));
+
+        Float k = Isa::round(v * 1.44269504088896341f);
+        Float r = (v - k * 0.693359375f) + k * 2.12194440e-4f;
+
+        // Cephes expf.
+        Float result = (((((1.9875691500E-4f * r + 1.3981999507E-3f) * r + 8.3334519073E-3f) * r
+            + 4.1665795894E-2f) * r + 1.6666665459E-1f) * r + 5.0000001201E-1f) * (r * r) + r + 1.0f;
+
+        FloatMask n = __builtin_convertvector(k, FloatMask);
+        FloatMask half = n >> 1;
+        result = result * fromBits((half + 127) << 23) * fromBits((n - half + 127) << 23);
+
+        result = Isa::select(x > maxLog, Isa::broadcast(HUGE_VALF), result);
+        result = Isa::select(x < minLog, Isa::broadcast(0.0f), result);
+        return Isa::select(x != x, x, result);
+    }
+
+private:
+    // Low part of PI/2: PI/2 == M_PI / 2 + MORE_BITS.
+    static constexpr double MORE_BITS = 6.123233995736765886130E-17;
+
+    template <typename T, typename F>
+    static inline void each(const T* x, T* out, size_t n, F f) {
+        typedef decltype(Isa::load(x)) Vector;
+        const size_t lanes = sizeof(Vector) / sizeof(T);
+        size_t i = 0;
+        for (; i + lanes <= n; i += lanes) {
+            Isa::store(out + i, f(Isa::load(x + i)));
+        }
+        if (i < n) {
+            // Padded with ones, inside the domain of every function.
+            T in[lanes];
+            T result[lanes];
+            std::fill(in, in + lanes, T(1));
+            std::copy(x + i, x + n, in);
+            Isa::store(result, f(Isa::load(in)));
+            std::copy(result, result + (n - i), out + i);
+        }
+    }
+
+    template <typename V, typename F>
+    static inline V map(V x, F f) {
+        for (size_t i = 0; i < sizeof(V) / sizeof(x[0]); ++i) {
+            x[i] = f(x[i]);
+        }
+        return x;
+    }
+
+    static inline Mask bits(Double x) {
+        return reinterpret_cast<Mask>(x);
+    }
+
+    static inline Double fromBits(Mask x) {
+        return reinterpret_cast<Double>(x);
+    }
+
+    static inline Mask signBit(Double) {
+        return bits(Isa::broadcast(-0.0));
+    }
+
+    static inline FloatMask bits(Float x) {
+        return reinterpret_cast<FloatMask>(x);
+    }
+
+    static inline Float fromBits(FloatMask x) {
+        return reinterpret_cast<Float>(x);
+    }
+
+    static inline FloatMask signBit(Float) {
+        return bits(Isa::broadcast(-0.0f));
+    }
+
+    /**
+     * Converts integral values below 2^51 in magnitude; AVX2 has no 64-bit conversions.
+     */
+    static inline Mask toInteger(Double x) {
+        return bits(x + 6755399441055744.0) - bits(Isa::broadcast(6755399441055744.0));
+    }
+
+    static inline Double toDouble(Mask x) {
+        return fromBits(x + bits(Isa::broadcast(6755399441055744.0))) - 6755399441055744.0;
+    }
+
+    /**
+     * Returns a - k * PI/2 in [-PI/4, PI/4] for a in [0, MAX_REDUCED] and sets quadrant
+     * to k. Cody-Waite: the first two parts of PI/2 have 33 bits, so k times them is exact.
+     */
+    static inline Double reduce(Double a, Mask* quadrant) {
+        Double k = Isa::round(a * (2 / M_PI));
+        *quadrant = toInteger(k);
+        return ((a - k * 1.57079632673412561417E0) - k * 6.07710050630396597660E-11) - k * 2.02226624879595063154E-21;
+    }
+
+    /**
+     * Same for floats, a in [0, MAX_REDUCED_FLOAT]; the first three parts of PI/2 have 11 bits.
+     */
+    static inline Float reduce(Float a, FloatMask* quadrant) {
+        Float k = Isa::round(a * 0.63661977236758134308f);
+        *quadrant = __builtin_convertvector(k, FloatMask);
+        return (((a - k * 1.5703125f) - k * 4.837512969970703125E-4f) - k * 7.54953362047672271729E-8f)
+            - k * 2.56334406825708960298E-12f;
+    }
+
+    // Cephes sin/cos coefficients on [-PI/4, PI/4].
+    static inline Double sinPoly(Double x) {
+        Double z = x * x;
+        Double p = ((((1.58962301576546568060E-10 * z - 2.50507477628578072866E-8) * z
+            + 2.75573136213857245213E-6) * z - 1.98412698295895385996E-4) * z
+            + 8.33333333332211858878E-3) * z - 1.66666666666666307295E-1;
+        return x + x * z * p;
+    }
+
+    static inline Double cosPoly(Double x) {
+        Double z = x * x;
+        Double p = ((((-1.13585365213876817300E-11 * z + 2.08757008419747316778E-9) * z
+            - 2.75573141792967388112E-7) * z + 2.48015872888517045348E-5) * z
+            - 1.38888888888730564116E-3) * z + 4.16666666666665929218E-2;
+        return 1.0 - 0.5 * z + z * z * p;
+    }
+
+    // Cephes sinf/cosf coefficients on [-PI/4, PI/4].
+    static inline Float sinPoly(Float x) {
+        Float z = x * x;
+        return ((-1.9515295891E-4f * z + 8.3321608736E-3f) * z - 1.6666654611E-1f) * z * x + x;
+    }
+
+    static inline Float cosPoly(Float x) {
+        Float z = x * x;
+        return ((2.443315711809948E-5f * z - 1.388731625493765E-3f) * z + 4.166664568298827E-2f) * z * z
+            - 0.5f * z + 1.0f;
+    }
+};
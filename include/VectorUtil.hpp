@@ -0,0 +1,186 @@
+//******************************************************************************
+// Copyright 2013 Google Inc.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// This software and the related documents are provided  as is,  with no express
+// or implied  warranties,  other than  those that are  expressly stated  in the
+// License.
+//******************************************************************************
+
+#ifndef GEOMETRY_LIBRARY_VECTOR_UTIL
+#define GEOMETRY_LIBRARY_VECTOR_UTIL
+
+#include <cmath>
+#include <cstddef>
+
+#include "MathUtil.hpp"
+#include "UnitVec3.hpp"
+#include "PolyUtil.hpp"
+
+
+/**
+ * Great circle functions on UnitVec3 points, counterparts of the SphericalUtil and
+ * PolyUtil ones. A caller converting its points once runs them without trig calls
+ * on the coordinates: the tests and havDistance() use multiplies and adds only,
+ * the angles one atan2() or asin() to leave vector space.
+ *
+ * Results agree with the LatLng versions up to rounding.
+ */
+class VectorUtil {
+public:
+    /**
+     * Returns hav() of the angle between two points, |from - to|^2 / 4. Cheaper than
+     * computeAngleBetween() for comparing distances: compare with MathUtil::hav()
+     * of the angle.
+     */
+    static inline double havDistance(const UnitVec3& from, const UnitVec3& to) {
+        return (from - to).norm2() * 0.25;
+    }
+
+    /**
+     * Returns the angle between two points, in radians. Accurate for any pair,
+     * close or nearly antipodal.
+     */
+    static inline double computeAngleBetween(const UnitVec3& from, const UnitVec3& to) {
+        return atan2(sqrt(from.cross(to).norm2()), from.dot(to));
+    }
+
+    /**
+     * Returns the distance between two points, in meters.
+     */
+    static inline double computeDistanceBetween(const UnitVec3& from, const UnitVec3& to) {
+        return VectorUtil::computeAngleBetween(from, to) * MathUtil::EARTH_RADIUS;
+    }
+
+    /**
+     * Returns the heading from one point to another, in degrees clockwise from north
+     * within the range [-180, 180). From a pole it depends on the rounding of the
+     * vector, as SphericalUtil::computeHeading() depends on the longitude.
+     */
+    static inline double computeHeading(const UnitVec3& from, const UnitVec3& to) {
+        // East and north at from, both scaled by cos(latitude).
+        double east = from.x * to.y - from.y * to.x;
+        double north = to.z * (from.x * from.x + from.y * from.y) - from.z * (from.x * to.x + from.y * to.y);
+        return MathUtil::wrap(rad2deg(atan2(east, north)), -180, 180);
+    }
+
+    /**
+     * Returns the distance in meters from point to the great circle through from and
+     * to: positive on the left of the heading from from to to, negative on the right.
+     * Returns 0 when from and to are equal or antipodal.
+     */
+    static inline double computeCrossTrackDistance(const UnitVec3& point, const UnitVec3& from, const UnitVec3& to) {
+        UnitVec3 normal = from.cross(to);
+        double norm2 = normal.norm2();
+        if (norm2 <= 0) {
+            return 0;
+        }
+        return asin(MathUtil::clamp(point.dot(normal) / sqrt(norm2), -1, 1)) * MathUtil::EARTH_RADIUS;
+    }
+
+    /**
+     * Returns the point which lies the given fraction of the way between from and to,
+     * as SphericalUtil::interpolate().
+     */
+    static inline UnitVec3 interpolate(const UnitVec3& from, const UnitVec3& to, double fraction) {
+        // http://en.wikipedia.org/wiki/Slerp
+        double angle = VectorUtil::computeAngleBetween(from, to);
+        double sinAngle = sin(angle);
+        if (sinAngle < 1e-6) {
+            return from;
+        }
+        double a = sin((1 - fraction) * angle) / sinAngle;
+        double b = sin(fraction * angle) / sinAngle;
+        return from * a + to * b;
+    }
+
+    /**
+     * Computes whether point lies within tolerance meters of the great circle segment
+     * from from to to.
+     */
+    static inline bool isLocationOnSegment(const UnitVec3& point, const UnitVec3& from, const UnitVec3& to,
+                                           double tolerance = PolyUtil::DEFAULT_TOLERANCE) {
+        double havTolerance = MathUtil::hav(tolerance / MathUtil::EARTH_RADIUS);
+        return VectorUtil::isOnSegment(point, from, to, havTolerance, VectorUtil::sin2FromHav(havTolerance));
+    }
+
+    /**
+     * Computes whether (and where) point lies within tolerance meters of a polyline
+     * of great circle segments, as PolyUtil::locationIndexOnPath() with geodesic true.
+     * The tolerance is converted once; the loop uses multiplies and adds only.
+     *
+     * @return -1 if the point is not on or near the polyline, otherwise the index i of
+     * the first segment from path[i] to path[i + 1] it lies near
+     */
+    template <typename UnitVecList>
+    static inline int locationIndexOnPath(const UnitVec3& point, const UnitVecList& path,
+                                          double tolerance = PolyUtil::DEFAULT_TOLERANCE) {
+        size_t size = path.size();
+        if (size == 0U) {
+            return -1;
+        }
+        double havTolerance = MathUtil::hav(tolerance / MathUtil::EARTH_RADIUS);
+        if (VectorUtil::havDistance(point, path[0]) <= havTolerance) {
+            return 0;
+        }
+        double sin2Tolerance = VectorUtil::sin2FromHav(havTolerance);
+        for (size_t i = 1; i < size; ++i) {
+            if (VectorUtil::isOnSegment(point, path[i - 1], path[i], havTolerance, sin2Tolerance)) {
+                return static_cast<int>(i - 1);
+            }
+        }
+        return -1;
+    }
+
+    /**
+     * Computes whether the great circle segments from a1 to a2 and from b1 to b2 cross.
+     * Segments touching at a point count as crossing; segments on one great circle,
+     * and segments between equal or antipodal points, do not.
+     */
+    static inline bool intersects(const UnitVec3& a1, const UnitVec3& a2, const UnitVec3& b1, const UnitVec3& b2) {
+        UnitVec3 normalA = a1.cross(a2);
+        UnitVec3 normalB = b1.cross(b2);
+        if (b1.dot(normalA) * b2.dot(normalA) > 0 || a1.dot(normalB) * a2.dot(normalB) > 0) {
+            return false;
+        }
+        // Each segment crosses the other's great circle at one of two antipodal points;
+        // both pick the one on the side of their midpoint.
+        UnitVec3 line = normalA.cross(normalB);
+        return (a1 + a2).dot(line) * (b1 + b2).dot(line) > 0;
+    }
+
+
+private:
+    /**
+     * Returns sin^2 of the angle whose hav() is given.
+     */
+    static inline double sin2FromHav(double h) {
+        return 4 * h * (1 - h);
+    }
+
+    /**
+     * Computes whether point lies within the tolerance of the segment from from to to.
+     * The closest point of the great circle lies on the segment if it is on the inner
+     * side of both planes through the normal and an end; otherwise an end is closest.
+     */
+    static inline bool isOnSegment(const UnitVec3& point, const UnitVec3& from, const UnitVec3& to,
+                                   double havTolerance, double sin2Tolerance) {
+        if (VectorUtil::havDistance(point, from) <= havTolerance ||
+            VectorUtil::havDistance(point, to) <= havTolerance) {
+            return true;
+        }
+        UnitVec3 normal = from.cross(to);
+        double norm2 = normal.norm2();
+        double sinCrossTrack = point.dot(normal);
+        if (norm2 <= 0 || sinCrossTrack * sinCrossTrack > sin2Tolerance * norm2) {
+            return false;
+        }
+        return point.dot(normal.cross(from)) >= 0 && point.dot(to.cross(normal)) >= 0;
+    }
+};
+
+#endif // GEOMETRY_LIBRARY_VECTOR_UTIL
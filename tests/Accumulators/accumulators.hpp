@@ -0,0 +1,70 @@
+#include <gtest/gtest.h>
+#include <vector>
+
+#include "SphericalUtil.hpp"
+#include "Accumulators.hpp"
+#include "../Fixtures.hpp"
+
+
+TEST(LengthAccumulator, push) {
+    std::vector<LatLng> track = randomLoop(2000, 1);
+    LengthAccumulator accumulator;
+    EXPECT_EQ(accumulator.length(), 0);
+    std::vector<LatLng> prefix;
+    for (const auto & point : track) {
+        accumulator.push(point);
+        prefix.push_back(point);
+        EXPECT_EQ(accumulator.length(), SphericalUtil::computeLength(prefix));
+    }
+    EXPECT_EQ(accumulator.size(), track.size());
+}
+
+TEST(LengthAccumulator, pop) {
+    std::vector<LatLng> track = randomLoop(2000, 2);
+    LengthAccumulator accumulator;
+    const size_t window = 100;
+    for (size_t i = 0; i < track.size(); ++i) {
+        accumulator.push(track[i]);
+        if (accumulator.size() > window) {
+            accumulator.pop();
+        }
+        size_t first = i + 1 > window ? i + 1 - window : 0;
+        double expected = SphericalUtil::computeLength(std::vector<LatLng>(track.begin() + first, track.begin() + i + 1));
+        EXPECT_NEAR(accumulator.length(), expected, expected * 1e-14);
+    }
+    while (accumulator.size() > 0) {
+        accumulator.pop();
+    }
+    EXPECT_EQ(accumulator.length(), 0);
+    accumulator.pop();
+}
+
+TEST(AreaAccumulator, push) {
+    std::vector<LatLng> track = randomLoop(2000, 3);
+    AreaAccumulator accumulator;
+    std::vector<LatLng> prefix;
+    for (const auto & point : track) {
+        accumulator.push(point);
+        prefix.push_back(point);
+        EXPECT_EQ(accumulator.signedArea(), SphericalUtil::computeSignedArea(prefix));
+    }
+    EXPECT_EQ(accumulator.area(), SphericalUtil::computeArea(track));
+}
+
+TEST(AreaAccumulator, pop) {
+    std::vector<LatLng> track = randomLoop(2000, 4);
+    AreaAccumulator accumulator;
+    const size_t window = 500;
+    for (size_t i = 0; i < track.size(); ++i) {
+        accumulator.push(track[i]);
+        if (accumulator.size() > window) {
+            accumulator.pop();
+        }
+        size_t first = i + 1 > window ? i + 1 - window : 0;
+        double expected = SphericalUtil::computeSignedArea(std::vector<LatLng>(track.begin() + first, track.begin() + i + 1));
+        // Relative to the polar triangles, of the order of the area of the whole cap.
+        EXPECT_NEAR(accumulator.signedArea(), expected, 1e-3);
+    }
+    accumulator.clear();
+    EXPECT_EQ(accumulator.signedArea(), 0);
+}
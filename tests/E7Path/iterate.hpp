@@ -0,0 +1,58 @@
+#include <gtest/gtest.h>
+#include <random>
+#include <vector>
+
+#include "PolyUtil.hpp"
+#include "SphericalUtil.hpp"
+#include "E7Path.hpp"
+#include "../Fixtures.hpp"
+
+
+TEST(E7LatLng, convert) {
+    E7LatLng point(557512345, -376123456);
+    EXPECT_EQ(LatLng(point), LatLng(55.7512345, -37.6123456));
+    EXPECT_EQ(static_cast<LatLng>(point).lat, 55.7512345);
+    EXPECT_EQ(E7LatLng(LatLng(55.7512345, -37.6123456)), point);
+    EXPECT_EQ(E7LatLng(LatLng(-90, 180)), E7LatLng(-900000000, 1800000000));
+}
+
+TEST(E7Path, iterate) {
+    std::vector<E7LatLng> track = randomE7Track(1000, 4);
+    track.push_back(E7LatLng(900000000, -1800000000));
+    track.push_back(E7LatLng(-900000000, 1800000000));
+    E7Path path(track);
+
+    EXPECT_EQ(path.size(), track.size());
+    EXPECT_EQ(std::vector<E7LatLng>(path.begin(), path.end()), track);
+    EXPECT_EQ(path[0], track[0]);
+    EXPECT_EQ(path[500], track[500]);
+    EXPECT_EQ(path[track.size() - 1], track.back());
+    // Steps of up to 1e-2 degrees take 3 bytes per coordinate.
+    EXPECT_LE(path.byteSize(), 6 * track.size() + 10);
+
+    E7Path empty;
+    EXPECT_TRUE(empty.empty());
+    EXPECT_TRUE(empty.begin() == empty.end());
+    EXPECT_EQ(SphericalUtil::computeLength(empty), 0);
+}
+
+TEST(E7Path, templates) {
+    std::vector<E7LatLng> track = randomE7Track(500, 5);
+    E7Path path(track);
+    std::vector<LatLng> expanded(track.begin(), track.end());
+
+    EXPECT_EQ(SphericalUtil::computeLength(path), SphericalUtil::computeLength(expanded));
+    EXPECT_EQ(SphericalUtil::computeSignedArea(path), SphericalUtil::computeSignedArea(expanded));
+    std::mt19937 random(6);
+    std::uniform_int_distribution<size_t> index(0, track.size() - 1);
+    for (int i = 0; i < 200; ++i) {
+        E7LatLng vertex = track[index(random)];
+        E7LatLng point(vertex.latE7 + 30000, vertex.lngE7 - 30000);
+        EXPECT_EQ(PolyUtil::containsLocation(point, path), PolyUtil::containsLocation(point, expanded));
+        EXPECT_EQ(PolyUtil::containsLocation(point, path, true), PolyUtil::containsLocation(point, expanded, true));
+        EXPECT_EQ(PolyUtil::isLocationOnPath(point, path, 100.0), PolyUtil::isLocationOnPath(point, expanded, 100.0));
+        // A vertex is inside, to the bit.
+        EXPECT_TRUE(PolyUtil::containsLocation(vertex, path));
+        EXPECT_TRUE(PolyUtil::isLocationOnPath(vertex, path, 0.0));
+    }
+}
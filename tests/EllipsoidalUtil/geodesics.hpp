@@ -0,0 +1,116 @@
+#include <gtest/gtest.h>
+#include <vector>
+
+#include "EllipsoidalUtil.hpp"
+#include "SphericalUtil.hpp"
+
+
+/**
+ * Expected values of GeographicLib 2.1 on WGS-84.
+ */
+struct EllipsoidalInverse {
+    LatLng from;
+    LatLng to;
+    double distance;
+    double heading;
+};
+
+static const EllipsoidalInverse ellipsoidalInverses[] = {
+    { {55.75, 37.61}, {59.93, 30.31}, 635481.799075686, -39.916330565501 },
+    { {40.6398, -73.7789}, {51.47, -0.4543}, 5555065.626956004, 51.380461744844 },
+    { {-33.9461, 151.1772}, {33.9425, -118.4081}, 12050688.505029608, 61.168155582224 },
+    { {-41.32, 174.81}, {40.96, -5.5}, 19959679.267353822, 161.067669986160 },
+    // Nearly antipodal, solved through the astroid
+    { {0, 0}, {0.5, 179.5}, 19936288.578965314, 25.671872868292 },
+    { {-30, 0}, {29.9, 179.8}, 19989832.827609532, 161.890524736327 },
+    // Along the equator, a meridian, and a short line
+    { {0, 0}, {0, 90}, 10018754.171394622, 90 },
+    { {0, 0}, {90, 0}, 10001965.729312724, 0 },
+    { {0, 0}, {0, 180}, 20003931.458625447, 0 },
+    { {10, 20}, {10, 20.000001}, 0.109639364, 89.999999913176 },
+};
+
+TEST(EllipsoidalUtil, computeDistanceBetween) {
+    for (const auto & expected : ellipsoidalInverses) {
+        EXPECT_NEAR(EllipsoidalUtil::computeDistanceBetween(expected.from, expected.to), expected.distance, 1e-8);
+        EXPECT_NEAR(EllipsoidalUtil::computeDistanceBetween(expected.to, expected.from), expected.distance, 1e-8);
+        EXPECT_NEAR(EllipsoidalUtil::computeHeading(expected.from, expected.to), expected.heading, 1e-11);
+    }
+
+    LatLng moscow(55.75, 37.61);
+    EXPECT_EQ(EllipsoidalUtil::computeDistanceBetween(moscow, moscow), 0);
+    EXPECT_EQ(EllipsoidalUtil::computeDistanceBetween(LatLng(90, 0), LatLng(-90, 0)), 2 * 10001965.729312724);
+
+    // Longitudes wrap.
+    EXPECT_NEAR(EllipsoidalUtil::computeDistanceBetween(LatLng(55.75, 37.61 + 360), LatLng(59.93, 30.31 - 720)),
+                635481.799075686, 1e-8);
+
+    // About 0.2% off the sphere between Moscow and Saint Petersburg.
+    double sphere = SphericalUtil::computeDistanceBetween(moscow, LatLng(59.93, 30.31));
+    EXPECT_NEAR(sphere / 635481.799075686, 1, 0.003);
+    EXPECT_NE(sphere, 635481.799075686);
+}
+
+TEST(EllipsoidalUtil, computeOffset) {
+    struct EllipsoidalDirect {
+        LatLng from;
+        double distance;
+        double heading;
+        LatLng to;
+    };
+    const EllipsoidalDirect directs[] = {
+        { {55.75, 37.61}, 10000e3, -39.9, {25.778957438903, -96.891998673688} },
+        { {0, 0}, 20000e3, 45, {-0.082241041390, 179.655126668589} },
+        { {-89.9, 10}, 1000e3, 30, {-80.959471678862, 39.685685338111} },
+        { {40, 179.9}, 500e3, 90, {39.852332258139, -174.253167529174} },
+        { {55.75, 37.61}, -250e3, 120, {56.822638076088, 34.062899796560} },
+    };
+    for (const auto & expected : directs) {
+        LatLng actual = EllipsoidalUtil::computeOffset(expected.from, expected.distance, expected.heading);
+        EXPECT_NEAR(actual.lat, expected.to.lat, 1e-11);
+        EXPECT_NEAR(actual.lng, expected.to.lng, 1e-11);
+    }
+
+    // The inverse of the inverse problem, within a nanometer.
+    for (const auto & expected : ellipsoidalInverses) {
+        double heading = EllipsoidalUtil::computeHeading(expected.from, expected.to);
+        double distance = EllipsoidalUtil::computeDistanceBetween(expected.from, expected.to);
+        LatLng actual = EllipsoidalUtil::computeOffset(expected.from, distance, heading);
+        EXPECT_LT(EllipsoidalUtil::computeDistanceBetween(actual, expected.to), 1e-8);
+    }
+}
+
+TEST(EllipsoidalUtil, origin) {
+    // The cached origin and line answer what the static functions do.
+    LatLng depot(55.75, 37.61);
+    EllipsoidalOrigin<> origin(depot);
+    std::vector<LatLng> targets;
+    for (int i = 0; i < 100; ++i) {
+        targets.push_back(LatLng(-89 + 1.78 * i, -180 + 7.3 * i));
+    }
+    std::vector<double> distances(targets.size());
+    origin.computeDistances(targets, distances.data());
+    for (size_t i = 0; i < targets.size(); ++i) {
+        EXPECT_EQ(distances[i], EllipsoidalUtil::computeDistanceBetween(depot, targets[i]));
+        EXPECT_EQ(origin.computeDistanceTo(targets[i]), distances[i]);
+        EXPECT_EQ(origin.computeHeadingTo(targets[i]), EllipsoidalUtil::computeHeading(depot, targets[i]));
+    }
+
+    EllipsoidalLine<> line = origin.line(-39.9);
+    double heading;
+    LatLng point = line.position(10000e3, heading);
+    EXPECT_EQ(point, origin.computeOffset(10000e3, -39.9));
+    EXPECT_NEAR(heading, -156.323278127576, 1e-11);
+    EXPECT_EQ(line.position(0), depot);
+    for (double distance = -20e6; distance <= 20e6; distance += 1e6) {
+        LatLng expected = EllipsoidalUtil::computeOffset(depot, distance, -39.9);
+        LatLng actual = line.position(distance);
+        EXPECT_EQ(actual.lat, expected.lat);
+        EXPECT_EQ(actual.lng, expected.lng);
+    }
+
+    // Length of a path.
+    std::vector<LatLng> path = { depot, {59.93, 30.31}, depot };
+    EXPECT_NEAR(EllipsoidalUtil::computeLength(path), 2 * 635481.799075686, 1e-8);
+    EXPECT_EQ(EllipsoidalUtil::computeLength(std::vector<LatLng>()), 0);
+}
@@ -0,0 +1,36 @@
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+#include "PolyUtil.hpp"
+#include "SphericalUtil.hpp"
+#include "EncodedPolyline.hpp"
+#include "../Fixtures.hpp"
+
+
+TEST(EncodedPolyline, iterate) {
+    std::string encoded = "_p~iF~ps|U_ulLnnqC_mqNvxq`@";
+    EncodedPolyline polyline(encoded);
+    std::vector<LatLng> expected = PolyUtil::decode(encoded);
+
+    EXPECT_EQ(polyline.size(), 3U);
+    EXPECT_EQ(std::vector<LatLng>(polyline.begin(), polyline.end()), expected);
+    EXPECT_EQ(polyline[0], expected[0]);
+    EXPECT_EQ(polyline[2], expected[2]);
+
+    EXPECT_TRUE(EncodedPolyline("", 0).empty());
+    EXPECT_TRUE(EncodedPolyline("", 0).begin() == EncodedPolyline("", 0).end());
+}
+
+TEST(EncodedPolyline, templates) {
+    std::string encoded = PolyUtil::encode(randomPolyline(500, 9));
+    EncodedPolyline polyline(encoded);
+    std::vector<LatLng> path = PolyUtil::decode(encoded);
+
+    EXPECT_EQ(SphericalUtil::computeLength(polyline), SphericalUtil::computeLength(path));
+    EXPECT_EQ(SphericalUtil::computeSignedArea(polyline), SphericalUtil::computeSignedArea(path));
+    for (const auto& point : randomPolyline(200, 10)) {
+        EXPECT_EQ(PolyUtil::containsLocation(point, polyline), PolyUtil::containsLocation(point, path));
+        EXPECT_EQ(PolyUtil::isLocationOnPath(point, polyline, 1e5), PolyUtil::isLocationOnPath(point, path, 1e5));
+    }
+}
@@ -0,0 +1,125 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "PolyUtil.hpp"
+#include "EncodedPolyline.hpp"
+#include "../Fixtures.hpp"
+
+
+TEST(PolylineDecoder, read) {
+    std::string encoded = PolyUtil::encode(randomPolyline(1000, 3));
+    std::vector<LatLng> expected = PolyUtil::decode(encoded);
+
+    // Buffers of any capacity see the same points.
+    for (size_t capacity : { 1, 7, 256, 5000 }) {
+        PolylineDecoder decoder(encoded);
+        std::vector<double> lat(capacity);
+        std::vector<double> lng(capacity);
+        size_t total = 0;
+        size_t count;
+        while ((count = decoder.read(lat.data(), lng.data(), capacity)) != 0) {
+            for (size_t i = 0; i < count; ++i) {
+                EXPECT_EQ(LatLng(lat[i], lng[i]), expected[total + i]);
+            }
+            total += count;
+        }
+        EXPECT_EQ(total, expected.size());
+        EXPECT_FALSE(decoder.failed());
+    }
+
+    LatLngArray array(LatLngArray::RADIANS);
+    PolylineDecoder(encoded).readAll(array);
+    ASSERT_EQ(array.size(), expected.size());
+    for (size_t i = 0; i < array.size(); ++i) {
+        EXPECT_EQ(static_cast<LatLng>(array[i]), expected[i]);
+    }
+}
+
+TEST(PolylineDecoder, windows) {
+    // Points with values of all lengths; after every third point a repeat of it, written
+    // with a redundant 10-byte encoding of zero that no window gathers in one piece.
+    std::vector<LatLng> path = randomPolyline(300, 5);
+    std::string original = PolyUtil::encode(path);
+    std::string encoded;
+    std::vector<LatLng> expected;
+    size_t values = 0;
+    for (char c : original) {
+        encoded += c;
+        if (c < '_' && ++values % 2 == 0) {
+            const LatLng& point = path[values / 2 - 1];
+            expected.push_back(LatLng(static_cast<int64_t>(std::floor(point.lat * 1e5 + 0.5)) * 1e-5,
+                                      static_cast<int64_t>(std::floor(point.lng * 1e5 + 0.5)) * 1e-5));
+            if (values % 6 == 0) {
+                encoded += "_________??";
+                expected.push_back(expected.back());
+            }
+        }
+    }
+
+    for (int level = Simd::detectedLevel(); level >= Simd::SCALAR; --level) {
+        Simd::setMaxLevel(static_cast<Simd::Level>(level));
+        EXPECT_EQ(PolyUtil::decode(encoded), expected);
+
+        // One point at a time, reading across the windows.
+        PolylineDecoder decoder(encoded);
+        LatLng point(0, 0);
+        for (const LatLng& expectedPoint : expected) {
+            ASSERT_TRUE(decoder.next(&point));
+            EXPECT_EQ(point, expectedPoint);
+        }
+        EXPECT_FALSE(decoder.next(&point));
+        EXPECT_FALSE(decoder.failed());
+
+        // A bad byte stops decoding before the point holding it.
+        for (size_t bad = 0; bad < 300; bad += 7) {
+            std::string broken = encoded;
+            broken[bad] = bad % 2 == 0 ? '>' : '\x80';
+            PolylineDecoder brokenDecoder(broken);
+            size_t count = 0;
+            while (brokenDecoder.next(&point)) {
+                EXPECT_EQ(point, expected[count]);
+                ++count;
+            }
+            EXPECT_TRUE(brokenDecoder.failed());
+            EXPECT_EQ(count, PolylineDecoder::count(broken.data(), broken.size()));
+        }
+    }
+    Simd::setMaxLevel(Simd::AVX512);
+}
+
+TEST(PolylineDecoder, failed) {
+    const char* truncated = "_p~iF~ps|U_ulLnnq";
+    PolylineDecoder decoder(truncated, std::strlen(truncated));
+    LatLng point(0, 0);
+    EXPECT_TRUE(decoder.next(&point));
+    EXPECT_FALSE(decoder.failed());
+    EXPECT_FALSE(decoder.next(&point));
+    EXPECT_TRUE(decoder.failed());
+    EXPECT_FALSE(decoder.next(&point));
+
+    PolylineDecoder complete("_p~iF~ps|U", 10);
+    EXPECT_TRUE(complete.next(&point));
+    EXPECT_FALSE(complete.next(&point));
+    EXPECT_FALSE(complete.failed());
+}
+
+TEST(PolylineDecoder, count) {
+    std::string encoded = PolyUtil::encode(randomPolyline(3000, 4));
+    for (int level = Simd::detectedLevel(); level >= Simd::SCALAR; --level) {
+        Simd::setMaxLevel(static_cast<Simd::Level>(level));
+        // Every prefix, also cut within a value, and a bad byte at every position.
+        for (size_t size = 0; size <= 200; ++size) {
+            EXPECT_EQ(PolylineDecoder::count(encoded.data(), size), PolyUtil::decode(encoded.substr(0, size)).size());
+        }
+        for (size_t bad = 0; bad < 200; bad += 3) {
+            std::string broken = encoded;
+            broken[bad] = bad % 2 == 0 ? ' ' : '\x7f';
+            EXPECT_EQ(PolylineDecoder::count(broken.data(), broken.size()), PolyUtil::decode(broken).size());
+        }
+        EXPECT_EQ(PolylineDecoder::count(encoded.data(), encoded.size()), 3000U);
+    }
+    Simd::setMaxLevel(Simd::AVX512);
+}
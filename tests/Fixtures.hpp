@@ -0,0 +1,89 @@
+#ifndef GEOMETRY_LIBRARY_TEST_FIXTURES
+#define GEOMETRY_LIBRARY_TEST_FIXTURES
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "MathUtil.hpp"
+#include "LatLng.hpp"
+#include "E7LatLng.hpp"
+
+
+// Seeded paths shared by the tests.
+
+/**
+ * A ring of the given number of vertices around the North Pole, with a jittered radius.
+ */
+static std::vector<LatLng> jitteredRing(size_t size, unsigned seed) {
+    std::mt19937 random(seed);
+    std::uniform_real_distribution<double> unit(0, 1);
+    std::vector<LatLng> ring;
+    for (size_t i = 0; i < size; ++i) {
+        ring.push_back(LatLng(60 + 10 * unit(random), i * 360.0 / size - 180));
+    }
+    return ring;
+}
+
+/**
+ * Points uniform over the latitude and longitude ranges.
+ */
+static std::vector<LatLng> randomPolyline(size_t size, unsigned seed) {
+    std::mt19937 random(seed);
+    std::uniform_real_distribution<double> unit(0, 1);
+    std::vector<LatLng> path;
+    for (size_t i = 0; i < size; ++i) {
+        path.push_back(LatLng(unit(random) * 180 - 90, unit(random) * 360 - 180));
+    }
+    return path;
+}
+
+/**
+ * A random walk around Moscow, steps of about ten meters.
+ */
+static std::vector<LatLng> randomTrack(size_t size, unsigned seed) {
+    std::mt19937 random(seed);
+    std::normal_distribution<double> step(0, 1e-4);
+    std::vector<LatLng> track;
+    LatLng point(55.75, 37.61);
+    for (size_t i = 0; i < size; ++i) {
+        point = LatLng(point.lat + step(random), point.lng + step(random));
+        track.push_back(point);
+    }
+    return track;
+}
+
+/**
+ * A GPS-like track looping around Moscow, steps of up to about a kilometer.
+ */
+static std::vector<LatLng> randomLoop(size_t size, unsigned seed) {
+    std::mt19937 random(seed);
+    std::uniform_real_distribution<double> step(-1e-2, 1e-2);
+    std::vector<LatLng> track;
+    for (size_t i = 0; i < size; ++i) {
+        double angle = i * 2 * M_PI / size;
+        track.push_back(LatLng(55.75 + 0.3 * sin(angle) + step(random), 37.61 + 0.5 * cos(angle) + step(random)));
+    }
+    return track;
+}
+
+/**
+ * A GPS-like track in E7 coordinates, crossing the antimeridian.
+ */
+static std::vector<E7LatLng> randomE7Track(size_t size, unsigned seed) {
+    std::mt19937 random(seed);
+    std::uniform_int_distribution<int32_t> step(-100000, 100000);
+    std::vector<E7LatLng> track;
+    E7LatLng point(557512345, 1799000000);
+    for (size_t i = 0; i < size; ++i) {
+        int64_t lng = static_cast<int64_t>(point.lngE7) + step(random);
+        if (lng > 1800000000) {
+            lng -= 3600000000LL;
+        }
+        point = E7LatLng(point.latE7 + step(random), static_cast<int32_t>(lng));
+        track.push_back(point);
+    }
+    return track;
+}
+
+#endif // GEOMETRY_LIBRARY_TEST_FIXTURES
@@ -0,0 +1,164 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "GeofenceRegistry.hpp"
+#include "PolyUtil.hpp"
+
+
+static std::vector<LatLng> registrySquare(double lat, double lng, double size) {
+    return { {lat, lng}, {lat, lng + size}, {lat + size, lng + size}, {lat + size, lng} };
+}
+
+TEST(GeofenceRegistry, updates) {
+    GeofenceRegistry registry(true);
+    GeofenceRegistry::Reader reader(registry);
+    EXPECT_EQ(registry.size(), 0U);
+    EXPECT_EQ(registry.version(), 0U);
+    EXPECT_FALSE(reader.findAny(LatLng(0, 0)));
+    EXPECT_TRUE(reader.findAll(LatLng(0, 0)).empty());
+
+    EXPECT_EQ(registry.insert(7, registrySquare(0, 0, 10)), 1U);
+    EXPECT_EQ(registry.insert(3, registrySquare(5, 5, 10)), 2U);
+    EXPECT_EQ(registry.insert(9, registrySquare(10, 175, 10)), 3U);
+    EXPECT_EQ(reader.findAll(LatLng(7, 7)), std::vector<uint64_t>({ 3, 7 }));
+    EXPECT_EQ(reader.findAll(LatLng(2, 2)), std::vector<uint64_t>({ 7 }));
+    EXPECT_EQ(reader.findAll(LatLng(15, -178)), std::vector<uint64_t>({ 9 }));
+    EXPECT_EQ(reader.findAll(LatLng(15, 180)), std::vector<uint64_t>({ 9 }));
+    uint64_t id = 0;
+    EXPECT_TRUE(reader.findAny(LatLng(12, 12), &id));
+    EXPECT_EQ(id, 3U);
+    EXPECT_FALSE(reader.findAny(LatLng(-5, -5)));
+
+    // Replace and erase; an unknown id is no change to the zones, but a version.
+    registry.insert(7, registrySquare(-10, -10, 5));
+    EXPECT_EQ(reader.findAll(LatLng(2, 2)), std::vector<uint64_t>());
+    EXPECT_EQ(reader.findAll(LatLng(-7, -7)), std::vector<uint64_t>({ 7 }));
+    registry.erase(3);
+    registry.erase(4);
+    EXPECT_EQ(reader.findAll(LatLng(7, 7)), std::vector<uint64_t>());
+    EXPECT_EQ(registry.size(), 2U);
+    EXPECT_EQ(registry.version(), 6U);
+    EXPECT_TRUE(reader.snapshot().contains(7));
+    EXPECT_FALSE(reader.snapshot().contains(3));
+
+    // In a batch, the last change of an id wins; an empty batch publishes nothing.
+    GeofenceRegistry::Batch batch(registry);
+    batch.insert(1, registrySquare(0, 0, 1));
+    batch.erase(1);
+    batch.insert(2, registrySquare(0, 0, 1));
+    batch.erase(9);
+    batch.insert(2, registrySquare(0, 0, 2));
+    batch.insert(1, registrySquare(0, 0, 3));
+    EXPECT_EQ(registry.apply(batch), 7U);
+    EXPECT_EQ(registry.apply(GeofenceRegistry::Batch(registry)), 7U);
+    EXPECT_EQ(reader.findAll(LatLng(1.5, 1.5)), std::vector<uint64_t>({ 1, 2 }));
+    EXPECT_EQ(reader.findAll(LatLng(2.5, 2.5)), std::vector<uint64_t>({ 1 }));
+    EXPECT_EQ(registry.size(), 3U);
+
+    // Against containsLocation() on every zone.
+    std::mt19937 random(23);
+    std::uniform_real_distribution<double> unit(0, 1);
+    std::vector<std::vector<LatLng>> zones;
+    GeofenceRegistry scan(false);
+    GeofenceRegistry::Reader scanReader(scan);
+    for (uint64_t i = 0; i < 200; ++i) {
+        zones.push_back(registrySquare(unit(random) * 120 - 60, unit(random) * 360 - 180, unit(random) * 20));
+        scan.insert(i, zones.back());
+    }
+    for (int i = 0; i < 2000; ++i) {
+        LatLng point(unit(random) * 140 - 70, unit(random) * 360 - 180);
+        std::vector<uint64_t> expected;
+        for (uint64_t zone = 0; zone < zones.size(); ++zone) {
+            if (PolyUtil::containsLocation(point, zones[zone], false)) {
+                expected.push_back(zone);
+            }
+        }
+        EXPECT_EQ(scanReader.findAll(point), expected);
+    }
+}
+
+TEST(GeofenceRegistry, reclaim) {
+    GeofenceRegistry registry;
+    registry.insert(1, registrySquare(0, 0, 10));
+    EXPECT_EQ(registry.reclaim(), 0U);
+
+    // A reader holds back the snapshots replaced since its last quiescent state.
+    std::unique_ptr<GeofenceRegistry::Reader> reader(new GeofenceRegistry::Reader(registry));
+    const GeofenceRegistry::Snapshot& held = reader->snapshot();
+    registry.insert(2, registrySquare(20, 20, 10));
+    registry.erase(1);
+    EXPECT_EQ(registry.reclaim(), 2U);
+    EXPECT_EQ(held.size(), 1U);
+    EXPECT_TRUE(reader->findAny(LatLng(25, 25)));
+    reader->quiescent();
+    EXPECT_EQ(registry.reclaim(), 0U);
+
+    reader->offline();
+    registry.insert(3, registrySquare(40, 40, 10));
+    EXPECT_EQ(registry.reclaim(), 0U);
+    reader->online();
+    registry.insert(4, registrySquare(60, 60, 10));
+    EXPECT_EQ(registry.reclaim(), 1U);
+    reader.reset();
+    EXPECT_EQ(registry.reclaim(), 0U);
+}
+
+TEST(GeofenceRegistry, concurrent) {
+    // Zones come and go in pairs, 2k and 2k + 1 over the same square, in one batch each:
+    // any snapshot has both or neither. Run it under ThreadSanitizer with make tsan.
+    GeofenceRegistry registry;
+    std::atomic<bool> done(false);
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 4; ++t) {
+        readers.emplace_back([&registry, &done, t] {
+            GeofenceRegistry::Reader reader(registry);
+            std::mt19937 random(static_cast<unsigned>(t));
+            std::uniform_real_distribution<double> unit(0, 1);
+            std::vector<uint64_t> found;
+            size_t queries = 0;
+            while (!done.load() || queries < 1000) {
+                found.clear();
+                reader.findAll(LatLng(unit(random) * 20, unit(random) * 20), found);
+                ASSERT_EQ(found.size() % 2, 0U);
+                for (size_t i = 0; i < found.size(); i += 2) {
+                    ASSERT_EQ(found[i] % 2, 0U);
+                    ASSERT_EQ(found[i + 1], found[i] + 1);
+                }
+                if (++queries % 16 == 0) {
+                    reader.quiescent();
+                }
+                if (queries % 256 == 0) {
+                    reader.offline();
+                    std::this_thread::yield();
+                    reader.online();
+                }
+            }
+        });
+    }
+
+    std::mt19937 random(99);
+    for (int update = 0; update < 300; ++update) {
+        uint64_t pair = random() % 10;
+        GeofenceRegistry::Batch batch(registry);
+        if (random() % 3 == 0) {
+            batch.erase(2 * pair);
+            batch.erase(2 * pair + 1);
+        } else {
+            std::vector<LatLng> square = registrySquare(pair * 2, pair * 2, 1 + random() % 8);
+            batch.insert(2 * pair, square);
+            batch.insert(2 * pair + 1, square);
+        }
+        registry.apply(batch);
+    }
+    done.store(true);
+    for (auto& thread : readers) {
+        thread.join();
+    }
+    EXPECT_EQ(registry.reclaim(), 0U);
+    EXPECT_EQ(registry.version(), 300U);
+}
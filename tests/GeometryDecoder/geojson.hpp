@@ -0,0 +1,203 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "GeometryDecoder.hpp"
+#include "LatLngArray.hpp"
+
+
+// The events as text: G<type> for a geometry, R<ring> for a ring, the point count of
+// each points() call, and ) for each end.
+struct EventLog : public GeometryHandler {
+    std::string text;
+    std::vector<LatLng> received;
+
+    void beginGeometry(Type type) { text += "G" + std::to_string(type); }
+    void beginRing(Ring ring) { text += "R" + std::to_string(ring); }
+    void endRing() { text += ")"; }
+    void endGeometry() { text += ")"; }
+
+    void points(const double* lat, const double* lng, size_t count) {
+        text += std::to_string(count);
+        for (size_t i = 0; i < count; ++i) {
+            received.push_back(LatLng(lat[i], lng[i]));
+        }
+    }
+};
+
+TEST(GeoJsonDecoder, geometries) {
+    std::string text = R"({
+        "type": "FeatureCollection",
+        "features": [
+            { "type": "Feature", "properties": { "name": "a \"quoted\" \\ name", "tags": [1, 2.5e3, true, false, null, {}] },
+              "geometry": { "type": "Point", "coordinates": [30.5, -10.25, 100] } },
+            { "type": "Feature", "geometry": { "coordinates": [[0, 0], [1, 2], [3, 4]], "type": "LineString" } },
+            { "type": "Feature", "geometry": { "type": "Polygon", "coordinates": [
+                [[0, 0], [10, 0], [10, 10], [0, 10], [0, 0]],
+                [[2, 2], [2, 3], [3, 3], [2, 2]] ] } },
+            { "type": "Feature", "geometry": { "type": "MultiPolygon", "coordinates": [
+                [[[170, -5], [-170, -5], [-170, 5], [170, 5], [170, -5]]],
+                [],
+                [[[0, 80], [90, 80], [180, 80], [0, 80]]] ] } },
+            { "type": "Feature", "geometry": { "type": "Polygon", "coordinates": [] } },
+            { "type": "Feature", "geometry": null }
+        ]
+    })";
+    GeoJsonDecoder decoder(text);
+    EventLog log;
+    EXPECT_TRUE(decoder.decode(log));
+    EXPECT_FALSE(decoder.decode(log));
+    EXPECT_FALSE(decoder.failed());
+    EXPECT_EQ(log.text, "G1R01))G2R13))G3R25)R34))G6R25)R24))");
+    std::vector<LatLng> expected = {
+        {-10.25, 30.5},
+        {0, 0}, {2, 1}, {4, 3},
+        {0, 0}, {0, 10}, {10, 10}, {10, 0}, {0, 0}, {2, 2}, {3, 2}, {3, 3}, {2, 2},
+        {-5, 170}, {-5, -170}, {5, -170}, {5, 170}, {-5, 170}, {80, 0}, {80, 90}, {80, 180}, {80, 0},
+    };
+    EXPECT_EQ(log.received, expected);
+
+    // Into a structure of arrays, in chunks of 256 points.
+    std::string line = "{\"type\":\"LineString\",\"coordinates\":[";
+    for (int i = 0; i < 1000; ++i) {
+        line += (i == 0 ? "[" : ",[") + std::to_string(i % 360 - 180) + "," + std::to_string(i * 0.05 - 25) + "]";
+    }
+    line += "]}\n" + text;
+    LatLngArray array;
+    GeometryCollector<LatLngArray> collector(array);
+    GeoJsonDecoder lines(line);
+    EXPECT_TRUE(lines.decode(collector));
+    EXPECT_TRUE(lines.decode(collector));
+    EXPECT_FALSE(lines.decode(collector));
+    ASSERT_EQ(collector.size(), 7U);
+    EXPECT_EQ(collector.kind(0), GeometryHandler::LINE);
+    EXPECT_EQ(collector.kind(1), GeometryHandler::VERTEX);
+    EXPECT_EQ(collector.kind(3), GeometryHandler::SHELL);
+    EXPECT_EQ(collector.kind(4), GeometryHandler::HOLE);
+    EXPECT_EQ(collector.offset(1), 1000U);
+    EXPECT_EQ(collector.offset(7), 1000 + expected.size());
+    EXPECT_EQ(array.size(), 1000 + expected.size());
+    for (int i = 0; i < 1000; ++i) {
+        EXPECT_EQ(array[i].lng, i % 360 - 180);
+        EXPECT_EQ(array[i].lat, std::strtod(std::to_string(i * 0.05 - 25).c_str(), nullptr));
+    }
+    collector.clear();
+    EXPECT_EQ(collector.size(), 0U);
+    EXPECT_EQ(collector.offset(0), array.size());
+}
+
+TEST(GeoJsonDecoder, types) {
+    // The type before or after the coordinates.
+    for (const char* text : { R"({"type": "LineString", "coordinates": [[0, 0], [1, 2]]})",
+                              R"({"coordinates": [[0, 0], [1, 2]], "bbox": [0, 0, 2, 1], "type": "LineString"})" }) {
+        EventLog log;
+        GeoJsonDecoder decoder(text, std::strlen(text));
+        EXPECT_TRUE(decoder.decode(log)) << text;
+        EXPECT_EQ(log.text, "G2R12))") << text;
+    }
+
+    // Empty parts before the first position are read as such; only coordinates
+    // without any position are skipped.
+    for (const char* text : { R"({"type": "MultiPolygon", "coordinates": [[], [[[0, 0], [1, 1], [0, 1], [0, 0]]]]})",
+                              R"({"type": "MultiPolygon", "coordinates": [[[[0, 0], [1, 1], [0, 1], [0, 0]]], []]})" }) {
+        EventLog log;
+        GeoJsonDecoder decoder(text, std::strlen(text));
+        EXPECT_TRUE(decoder.decode(log)) << text;
+        EXPECT_EQ(log.text, "G6R24))") << text;
+        EXPECT_EQ(log.received.size(), 4U) << text;
+    }
+    for (const char* text : { R"({"type": "Polygon", "coordinates": [[], [ ]]})",
+                              R"({"type": "MultiPolygon", "coordinates": [[], [[]]]})" }) {
+        EventLog log;
+        GeoJsonDecoder decoder(text, std::strlen(text));
+        EXPECT_TRUE(decoder.decode(log)) << text;
+        EXPECT_FALSE(decoder.failed()) << text;
+        EXPECT_EQ(log.text, "") << text;
+    }
+
+    // Other types are skipped, not read as the type of their nesting.
+    for (const char* text : { R"({"type": "MultiPoint", "coordinates": [[0, 0], [1, 2]]})",
+                              R"({"coordinates": [[0, 0], [1, 2]], "type": "MultiPoint"})",
+                              R"({"type": "MultiLineString", "coordinates": [[[0, 0], [1, 2]], [[3, 4], [5, 6]]]})",
+                              R"({"coordinates": [[[0, 0], [1, 2]], [[3, 4], [5, 6]]], "type": "MultiLineString"})",
+                              R"({"type": "GeometryCollection", "geometries": [{"type": "Point", "coordinates": [1, 2]}]})",
+                              R"({"geometries": [{"type": "Point", "coordinates": [1, 2]}], "type": "GeometryCollection"})",
+                              R"({"coordinates": [1, 2]})",
+                              R"({"type": "Feature", "coordinates": [1, 2]})" }) {
+        EventLog log;
+        GeoJsonDecoder decoder(text, std::strlen(text));
+        EXPECT_TRUE(decoder.decode(log)) << text;
+        EXPECT_FALSE(decoder.failed()) << text;
+        EXPECT_EQ(log.text, "") << text;
+    }
+
+    // Around them, the rest is read.
+    std::string text = R"([{"type": "MultiPoint", "coordinates": [[0, 0]]},
+                           {"type": "Feature", "geometry": {"coordinates": [5, 6], "type": "Point"}},
+                           {"type": "MultiLineString", "coordinates": [[[0, 0], [1, 1]]]}])";
+    EventLog log;
+    GeoJsonDecoder decoder(text);
+    EXPECT_TRUE(decoder.decode(log));
+    EXPECT_EQ(log.text, "G1R01))");
+    EXPECT_EQ(log.received, std::vector<LatLng>({ { 6, 5 } }));
+}
+
+TEST(GeoJsonDecoder, numbers) {
+    // Correctly rounded, as std::strtod.
+    std::vector<std::string> numbers = {
+        "0", "-0", "-0.0", "1", "0.1", "-73.9857", "40.748400", "1e-7", "1E+2", "2.5e-3", "179.99999999999997",
+        "123456789012345678901234", "0.30000000000000004", "1e23", "4.9e-324", "1.7976931348623157e308",
+        "0.000000000000000000000000000001", "9007199254740993", "1234567.1234567e-10",
+    };
+    std::mt19937 random(25);
+    std::uniform_real_distribution<double> coordinate(-180, 180);
+    char buffer[64];
+    for (int i = 0; i < 3000; ++i) {
+        std::snprintf(buffer, sizeof(buffer), i % 3 == 0 ? "%.17g" : i % 3 == 1 ? "%.7f" : "%.15g", coordinate(random));
+        numbers.push_back(buffer);
+    }
+    for (const std::string& number : numbers) {
+        std::string point = "{\"type\": \"Point\", \"coordinates\": [" + number + ", " + number + "]}";
+        EventLog log;
+        GeoJsonDecoder decoder(point);
+        ASSERT_TRUE(decoder.decode(log)) << number;
+        ASSERT_EQ(log.received.size(), 1U);
+        double expected = std::strtod(number.c_str(), nullptr);
+        EXPECT_EQ(log.received[0].lat, expected) << number;
+        EXPECT_EQ(std::signbit(log.received[0].lng), std::signbit(expected)) << number;
+    }
+}
+
+TEST(GeoJsonDecoder, malformed) {
+    std::string text = R"({"type":"Feature","properties":{"a":[1,"b",null]},"geometry":{"type":"Polygon","coordinates":[[[0,0],[1,0],[1,1],[0,0]]]}})";
+    for (size_t size = 1; size < text.size(); ++size) {
+        EventLog log;
+        GeoJsonDecoder decoder(text.data(), size);
+        EXPECT_FALSE(decoder.decode(log)) << size;
+        EXPECT_TRUE(decoder.failed()) << size;
+    }
+    for (const char* bad : { "[1,]", "{\"a\" 1}", "[01]", "[1.]", "[-]", "[1e]", "tru", "\"open", "{\"a\":1,}",
+                             "{\"type\":\"Point\",\"coordinates\":[0]}", "{\"type\":\"MultiPolygon\",\"coordinates\":[[[[[0,0]]]]]}",
+                             "{\"type\":\"LineString\",\"coordinates\":[[0,0],[\"x\",0]]}", "{\"type\":\"LineString\",\"coordinates\":[[0,0],0]}",
+                             "{\"coordinates\":[[0,0],[1,1]],\"type\":\"Polygon\"}", "{\"type\":\"Point\",\"coordinates\":[[0,0]]}",
+                             "{\"coordinates\":[[0,0],[1,]],\"type\":\"MultiPoint\"}", "}" }) {
+        EventLog log;
+        GeoJsonDecoder decoder(bad, std::strlen(bad));
+        EXPECT_FALSE(decoder.decode(log)) << bad;
+        EXPECT_TRUE(decoder.failed()) << bad;
+    }
+    // Deep nesting fails rather than exhausting the stack.
+    std::string deep(100000, '[');
+    EventLog log;
+    GeoJsonDecoder decoder(deep);
+    EXPECT_FALSE(decoder.decode(log));
+    EXPECT_TRUE(decoder.failed());
+
+    std::string spaces = " \n\t ";
+    GeoJsonDecoder blank(spaces);
+    EXPECT_FALSE(blank.decode(log));
+    EXPECT_FALSE(blank.failed());
+}
@@ -0,0 +1,145 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "GeometryDecoder.hpp"
+
+
+// EventLog comes from geojson.hpp.
+
+static std::string wkbFromHex(const std::string& hex) {
+    std::string bytes;
+    for (size_t i = 0; i + 1 < hex.size(); i += 2) {
+        bytes += static_cast<char>(std::stoi(hex.substr(i, 2), nullptr, 16));
+    }
+    return bytes;
+}
+
+// Writes WKB in either byte order, with extra values per point.
+struct WkbWriter {
+    bool bigEndian;
+    std::string bytes;
+
+    void integer(uint64_t value, size_t size) {
+        for (size_t i = 0; i < size; ++i) {
+            bytes += static_cast<char>(value >> (8 * (bigEndian ? size - 1 - i : i)));
+        }
+    }
+
+    void number(double value) {
+        uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        integer(bits, 8);
+    }
+
+    void header(uint32_t type) {
+        bytes += static_cast<char>(bigEndian ? 0 : 1);
+        integer(type, 4);
+    }
+
+    void ring(const std::vector<LatLng>& points, size_t extra) {
+        integer(points.size(), 4);
+        for (const LatLng& point : points) {
+            number(point.lng);
+            number(point.lat);
+            for (size_t i = 0; i < extra; ++i) {
+                number(1000);
+            }
+        }
+    }
+};
+
+TEST(WkbDecoder, geometries) {
+    // POINT(1 2) little- and big-endian, and in EWKB with SRID 4326.
+    std::string points = wkbFromHex("0101000000000000000000F03F0000000000000040") +
+                         wkbFromHex("00000000013FF00000000000004000000000000000") +
+                         wkbFromHex("0101000020E6100000000000000000F03F0000000000000040");
+    WkbDecoder pointDecoder(points);
+    EventLog log;
+    for (uint32_t srid : { 0, 0, 4326 }) {
+        EXPECT_TRUE(pointDecoder.decode(log));
+        EXPECT_EQ(pointDecoder.srid(), srid);
+    }
+    EXPECT_FALSE(pointDecoder.decode(log));
+    EXPECT_FALSE(pointDecoder.failed());
+    EXPECT_EQ(log.text, "G1R01))G1R01))G1R01))");
+    EXPECT_EQ(log.received, std::vector<LatLng>(3, LatLng(2, 1)));
+
+    std::vector<LatLng> line;
+    for (int i = 0; i < 600; ++i) {
+        line.push_back(LatLng(i * 0.1 - 30, i * 0.5 - 150));
+    }
+    std::vector<LatLng> shell = { {0, 0}, {0, 10}, {10, 10}, {10, 0}, {0, 0} };
+    std::vector<LatLng> hole = { {2, 2}, {3, 2}, {3, 3}, {2, 2} };
+
+    // Plain, EWKB Z and M flags, ISO Z and ZM codes.
+    struct Variant {
+        bool bigEndian;
+        uint32_t flags;
+        uint32_t iso;
+        size_t extra;
+    };
+    for (Variant variant : { Variant{ false, 0, 0, 0 }, Variant{ true, 0, 0, 0 }, Variant{ false, 0xc0000000, 0, 2 },
+                             Variant{ true, 0x20000000, 0, 0 }, Variant{ false, 0, 1000, 1 }, Variant{ true, 0, 3000, 2 } }) {
+        WkbWriter writer = { variant.bigEndian, "" };
+        writer.header(2 + variant.flags + variant.iso);
+        if (variant.flags & 0x20000000) {
+            writer.integer(3857, 4);
+        }
+        writer.ring(line, variant.extra);
+        std::vector<size_t> ends = { writer.bytes.size() };
+        uint32_t dimensions = variant.flags & 0xc0000000;
+        writer.header(3 + dimensions + variant.iso);
+        writer.integer(2, 4);
+        writer.ring(shell, variant.extra);
+        writer.ring(hole, variant.extra);
+        ends.push_back(writer.bytes.size());
+        writer.header(6 + dimensions + variant.iso);
+        writer.integer(2, 4);
+        for (int i = 0; i < 2; ++i) {
+            // The parts in the other byte order.
+            WkbWriter part = { !variant.bigEndian, "" };
+            part.header(3 + dimensions + variant.iso);
+            part.integer(1, 4);
+            part.ring(shell, variant.extra);
+            writer.bytes += part.bytes;
+        }
+
+        EventLog geometries;
+        WkbDecoder decoder(writer.bytes);
+        EXPECT_TRUE(decoder.decode(geometries));
+        EXPECT_EQ(decoder.srid(), variant.flags & 0x20000000 ? 3857U : 0U);
+        while (decoder.decode(geometries)) {}
+        EXPECT_FALSE(decoder.failed());
+        EXPECT_EQ(geometries.text, "G2R125625688))G3R25)R34))G6R25)R25))");
+        std::vector<LatLng> expected = line;
+        expected.insert(expected.end(), shell.begin(), shell.end());
+        expected.insert(expected.end(), hole.begin(), hole.end());
+        expected.insert(expected.end(), shell.begin(), shell.end());
+        expected.insert(expected.end(), shell.begin(), shell.end());
+        EXPECT_EQ(geometries.received, expected);
+
+        // Cut short anywhere but between geometries, the data fails.
+        for (size_t size = 1; size < writer.bytes.size(); ++size) {
+            if (size == ends[0] || size == ends[1]) {
+                continue;
+            }
+            EventLog cut;
+            WkbDecoder truncated(reinterpret_cast<const uint8_t*>(writer.bytes.data()), size);
+            while (truncated.decode(cut)) {}
+            EXPECT_TRUE(truncated.failed()) << size;
+        }
+    }
+
+    // Other types, byte orders and counts beyond the data.
+    for (const char* hex : { "010400000000000000", "0201000000000000000000F03F0000000000000040", "0102000000FFFFFFFF",
+                             "010600000001000000010200000000000000" }) {
+        EventLog bad;
+        std::string bytes = wkbFromHex(hex);
+        WkbDecoder decoder(bytes);
+        EXPECT_FALSE(decoder.decode(bad)) << hex;
+        EXPECT_TRUE(decoder.failed()) << hex;
+    }
+}
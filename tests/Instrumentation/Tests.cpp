@@ -0,0 +1,11 @@
+// The Instrumentation tests, with the counting compiled in; tests/Tests.cpp runs
+// everything else as built by default, without it.
+#define GEOMETRY_LIBRARY_INSTRUMENT
+
+#include "counters.hpp"
+
+
+int main(int argc, char** argv) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
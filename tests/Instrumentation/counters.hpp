@@ -0,0 +1,137 @@
+#include <gtest/gtest.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Instrumentation.hpp"
+#include "PolyUtil.hpp"
+#include "PreparedPath.hpp"
+#include "PreparedPolygon.hpp"
+#include "PolygonRaster.hpp"
+
+
+// Instrumentation/Tests.cpp defines GEOMETRY_LIBRARY_INSTRUMENT before including the library.
+TEST(Instrumentation, counters) {
+    bool enabled = Instrumentation::ENABLED;
+    ASSERT_TRUE(enabled);
+    std::vector<LatLng> empty;
+    std::vector<LatLng> triangle = { {0, 0}, {10, 12}, {20, 5} };
+    std::vector<LatLng> points = { {10, 11}, {19, 5}, {0, 1}, {11, 12}, {30, 5}, {-10, 6}, {5, 20} };
+
+    for (bool geodesic : { true, false }) {
+        Instrumentation::reset();
+        EXPECT_FALSE(PolyUtil::containsLocation(LatLng(0, 0), empty, geodesic));
+        EXPECT_TRUE(PolyUtil::containsLocation(LatLng(10, 12), triangle, geodesic));
+        for (const auto & point : points) {
+            PolyUtil::containsLocation(point, triangle, geodesic);
+        }
+        Instrumentation::Counters counters = Instrumentation::snapshot();
+        auto get = [&](Instrumentation::Event event) {
+            return counters.get(Instrumentation::CONTAINS_LOCATION, event);
+        };
+        EXPECT_EQ(get(Instrumentation::CALLS), 2 + points.size());
+        EXPECT_EQ(get(Instrumentation::EXIT_EMPTY), 1U);
+        EXPECT_EQ(get(Instrumentation::EXIT_VERTEX), 1U);
+        // The loop starts at the closing edge: it finds the second vertex at the third one.
+        EXPECT_EQ(get(Instrumentation::EDGES), 3 + 3 * points.size());
+        uint64_t decided = get(Instrumentation::EDGE_LONGITUDE) + get(Instrumentation::EDGE_LATITUDE);
+        EXPECT_GT(get(Instrumentation::EDGE_LONGITUDE), 0U);
+        EXPECT_LT(decided, get(Instrumentation::EDGES) - 1);
+        // 6 of sin, tan or log for every edge left to the crossing test.
+        EXPECT_EQ(get(Instrumentation::TRIG), 6 * (get(Instrumentation::EDGES) - 1 - decided));
+        EXPECT_EQ(counters.get(Instrumentation::PREPARED_POLYGON, Instrumentation::CALLS), 0U);
+    }
+
+    // The prepared classes count under their own function, the path queries under one.
+    Instrumentation::reset();
+    PreparedPolygon prepared(triangle, true);
+    PolygonRaster raster(triangle, true);
+    for (const auto & point : points) {
+        EXPECT_EQ(prepared.containsLocation(point), raster.containsLocation(point));
+    }
+    Instrumentation::Counters counters = Instrumentation::snapshot();
+    EXPECT_EQ(counters.get(Instrumentation::PREPARED_POLYGON, Instrumentation::CALLS), points.size());
+    EXPECT_EQ(counters.get(Instrumentation::POLYGON_RASTER, Instrumentation::CALLS), points.size());
+    EXPECT_GT(counters.get(Instrumentation::POLYGON_RASTER, Instrumentation::EXIT_CELL) +
+              counters.get(Instrumentation::POLYGON_RASTER, Instrumentation::EXIT_BOUNDS), 0U);
+    EXPECT_EQ(counters.get(Instrumentation::CONTAINS_LOCATION, Instrumentation::CALLS), 0U);
+
+    Instrumentation::reset();
+    PreparedPath path(triangle, true);
+    EXPECT_EQ(PolyUtil::locationIndexOnEdge(LatLng(10, 12), triangle), path.locationIndexOnEdgeOrPath(LatLng(10, 12)));
+    EXPECT_EQ(PolyUtil::locationIndexOnEdge(LatLng(-10, 6), triangle, 1e6), -1);
+    EXPECT_EQ(PolyUtil::locationIndexOnEdge(LatLng(-10, 6), triangle, 1, false), -1);
+    counters = Instrumentation::snapshot();
+    auto get = [&](Instrumentation::Event event) {
+        return counters.get(Instrumentation::LOCATION_ON_EDGE_OR_PATH, event);
+    };
+    EXPECT_EQ(get(Instrumentation::CALLS), 4U);
+    EXPECT_EQ(get(Instrumentation::EXIT_VERTEX), 2U);
+    EXPECT_GT(get(Instrumentation::EDGE_CROSS_TRACK), 0U);
+    EXPECT_GT(get(Instrumentation::EDGE_LATITUDE), 0U);
+    EXPECT_GT(get(Instrumentation::TRIG), get(Instrumentation::EDGES));
+
+    EXPECT_EQ(std::string(Instrumentation::functionName(Instrumentation::POLYGON_RASTER)), "PolygonRaster");
+    EXPECT_EQ(std::string(Instrumentation::eventName(Instrumentation::EXIT_BOUNDS)), "exitBounds");
+}
+
+TEST(Instrumentation, threads) {
+    std::vector<LatLng> triangle = { {0, 0}, {10, 12}, {20, 5} };
+    Instrumentation::reset();
+    uint64_t before = Instrumentation::threadSnapshot().get(Instrumentation::CONTAINS_LOCATION, Instrumentation::CALLS);
+
+    // The counts of threads which have exited stay in the sum.
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&triangle] {
+            for (int i = 0; i < 1000; ++i) {
+                PolyUtil::containsLocation(LatLng(i % 20, 5), triangle);
+            }
+            EXPECT_EQ(Instrumentation::threadSnapshot().get(Instrumentation::CONTAINS_LOCATION, Instrumentation::CALLS), 1000U);
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(Instrumentation::snapshot().get(Instrumentation::CONTAINS_LOCATION, Instrumentation::CALLS), 4000U);
+    EXPECT_EQ(Instrumentation::threadSnapshot().get(Instrumentation::CONTAINS_LOCATION, Instrumentation::CALLS), before);
+
+    // Batch workers too.
+    std::vector<LatLng> points(PolyUtil::BATCH_PARALLEL_MIN_POINTS * 2, LatLng(10, 8));
+    std::vector<char> out(points.size());
+    Instrumentation::reset();
+    PolyUtil::containsLocationBatch(points, triangle, reinterpret_cast<bool*>(out.data()), true, 4);
+    EXPECT_EQ(Instrumentation::snapshot().get(Instrumentation::CONTAINS_LOCATION, Instrumentation::CALLS), points.size());
+
+    Instrumentation::reset();
+    EXPECT_EQ(Instrumentation::snapshot().get(Instrumentation::CONTAINS_LOCATION, Instrumentation::CALLS), 0U);
+}
+
+TEST(Instrumentation, timerHook) {
+    struct Calls {
+        int count[Instrumentation::FUNCTION_COUNT];
+    } calls = {};
+    Instrumentation::setTimerHook([](Instrumentation::Function function, uint64_t, void* context) {
+        ++static_cast<Calls*>(context)->count[function];
+    }, &calls);
+
+    std::vector<LatLng> triangle = { {0, 0}, {10, 12}, {20, 5} };
+    PreparedPolygon prepared(triangle);
+    for (int i = 0; i < 10; ++i) {
+        PolyUtil::containsLocation(LatLng(i, 5), triangle);
+        prepared.containsLocation(LatLng(i, 5));
+    }
+    PolyUtil::isLocationOnPath(LatLng(5, 5), triangle);
+    // One call each in a batch, the vertex too, which goes to the scalar loop.
+    std::vector<LatLng> batch = { {10, 8}, {10, 12} };
+    bool out[2];
+    PolyUtil::containsLocationBatch(batch, triangle, out, false, 1);
+    EXPECT_TRUE(out[0] && out[1]);
+    Instrumentation::setTimerHook(nullptr);
+    PolyUtil::containsLocation(LatLng(5, 5), triangle);
+
+    EXPECT_EQ(calls.count[Instrumentation::CONTAINS_LOCATION], 12);
+    EXPECT_EQ(calls.count[Instrumentation::PREPARED_POLYGON], 10);
+    EXPECT_EQ(calls.count[Instrumentation::LOCATION_ON_EDGE_OR_PATH], 1);
+    EXPECT_EQ(calls.count[Instrumentation::POLYGON_RASTER], 0);
+}
@@ -0,0 +1,30 @@
+#include <gtest/gtest.h>
+#include <vector>
+
+#include "Instrumentation.hpp"
+#include "PolyUtil.hpp"
+#include "PreparedPolygon.hpp"
+
+
+// Tests.cpp leaves GEOMETRY_LIBRARY_INSTRUMENT undefined: nothing is counted or timed.
+TEST(Instrumentation, disabled) {
+    bool enabled = Instrumentation::ENABLED;
+    EXPECT_FALSE(enabled);
+    int hooked = 0;
+    Instrumentation::setTimerHook([](Instrumentation::Function, uint64_t, void* context) {
+        ++*static_cast<int*>(context);
+    }, &hooked);
+
+    std::vector<LatLng> triangle = { {0, 0}, {10, 12}, {20, 5} };
+    Instrumentation::reset();
+    EXPECT_TRUE(PolyUtil::containsLocation(LatLng(10, 8), triangle));
+    EXPECT_TRUE(PreparedPolygon(triangle).containsLocation(LatLng(10, 8)));
+    EXPECT_TRUE(PolyUtil::isLocationOnPath(LatLng(10, 12), triangle));
+    Instrumentation::setTimerHook(nullptr);
+
+    Instrumentation::Counters counters = Instrumentation::snapshot();
+    EXPECT_EQ(counters.get(Instrumentation::CONTAINS_LOCATION, Instrumentation::CALLS), 0U);
+    EXPECT_EQ(counters.get(Instrumentation::PREPARED_POLYGON, Instrumentation::CALLS), 0U);
+    EXPECT_EQ(counters.get(Instrumentation::LOCATION_ON_EDGE_OR_PATH, Instrumentation::CALLS), 0U);
+    EXPECT_EQ(hooked, 0);
+}
@@ -0,0 +1,70 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <vector>
+
+#include "LatLngArray.hpp"
+
+
+TEST(LatLngArray, caches) {
+    std::vector<LatLng> points = { {0, 0}, {90, 0}, {-45, 120}, {12.5, -179.5} };
+
+    // Plain columns.
+    LatLngArray plain(points);
+    ASSERT_EQ(plain.size(), points.size());
+    EXPECT_EQ(plain.caches(), static_cast<unsigned>(LatLngArray::NONE));
+    EXPECT_EQ(plain.latRad(), nullptr);
+    EXPECT_EQ(plain.x(), nullptr);
+    for (size_t i = 0; i < points.size(); ++i) {
+        EXPECT_EQ(plain.lat()[i], points[i].lat);
+        EXPECT_EQ(plain.lng()[i], points[i].lng);
+        EXPECT_TRUE(LatLng(plain[i]) == points[i]);
+        EXPECT_EQ(latRadians(plain[i]), deg2rad(points[i].lat));
+    }
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(plain.lat()) % 64, 0U);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(plain.lng()) % 64, 0U);
+
+    // Every cache, then points added later.
+    LatLngArray cached(LatLngArray::UNIT_VECTORS | LatLngArray::TRIG);
+    EXPECT_EQ(cached.caches(), static_cast<unsigned>(LatLngArray::RADIANS | LatLngArray::TRIG | LatLngArray::UNIT_VECTORS));
+    for (const auto & point : points) {
+        cached.push_back(point);
+    }
+    for (size_t i = 0; i < points.size(); ++i) {
+        double lat = deg2rad(points[i].lat);
+        double lng = deg2rad(points[i].lng);
+        EXPECT_EQ(cached.latRad()[i], lat);
+        EXPECT_EQ(cached.lngRad()[i], lng);
+        EXPECT_EQ(cached.sinLat()[i], sin(lat));
+        EXPECT_EQ(cached.cosLat()[i], cos(lat));
+        EXPECT_EQ(cached.sinLng()[i], sin(lng));
+        EXPECT_EQ(cached.cosLng()[i], cos(lng));
+        EXPECT_NEAR(cached.x()[i], cos(lat) * cos(lng), 1e-15);
+        EXPECT_NEAR(cached.y()[i], cos(lat) * sin(lng), 1e-15);
+        EXPECT_NEAR(cached.z()[i], sin(lat), 1e-15);
+    }
+
+    // Caches computed after the fact.
+    plain.cache(LatLngArray::TRIG);
+    ASSERT_NE(plain.cosLat(), nullptr);
+    EXPECT_EQ(plain.latRad(), plain.latRad());
+    for (size_t i = 0; i < points.size(); ++i) {
+        EXPECT_EQ(plain.cosLat()[i], cached.cosLat()[i]);
+        EXPECT_EQ(plain.lngRad()[i], cached.lngRad()[i]);
+    }
+    plain.push_back(LatLng(1, 2));
+    EXPECT_EQ(plain.size(), points.size() + 1);
+    EXPECT_EQ(plain.sinLng()[points.size()], sin(deg2rad(2)));
+
+    // Iteration.
+    size_t count = 0;
+    for (auto vertex : cached) {
+        EXPECT_EQ(vertex.lat, points[count].lat);
+        EXPECT_EQ(lngRadians(vertex), deg2rad(points[count].lng));
+        ++count;
+    }
+    EXPECT_EQ(count, points.size());
+    EXPECT_EQ(cached.end() - cached.begin(), static_cast<ptrdiff_t>(points.size()));
+
+    cached.clear();
+    EXPECT_TRUE(cached.empty());
+}
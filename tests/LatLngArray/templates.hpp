@@ -0,0 +1,51 @@
+#include <gtest/gtest.h>
+#include <random>
+#include <vector>
+
+#include "SphericalUtil.hpp"
+#include "PolyUtil.hpp"
+#include "SphericalBatch.hpp"
+#include "LatLngArray.hpp"
+
+
+TEST(LatLngArray, templates) {
+    std::mt19937 random(5);
+    std::uniform_real_distribution<double> unit(0, 1);
+
+    std::vector<LatLng> track;
+    for (int i = 0; i < 500; ++i) {
+        track.push_back(LatLng(40 + 5 * std::sin(i * 0.05) + 0.1 * unit(random), -3 + i * 0.02));
+    }
+
+    // The templates accept the container and give exactly the std::vector results,
+    // with or without cached radians.
+    for (unsigned caches : { static_cast<unsigned>(LatLngArray::NONE), static_cast<unsigned>(LatLngArray::RADIANS) }) {
+        LatLngArray array(track, caches);
+        EXPECT_EQ(SphericalUtil::computeLength(array), SphericalUtil::computeLength(track));
+        EXPECT_EQ(SphericalUtil::computeSignedArea(array), SphericalUtil::computeSignedArea(track));
+        EXPECT_EQ(SphericalUtil::computeArea(array), SphericalUtil::computeArea(track));
+
+        for (int i = 0; i < 200; ++i) {
+            LatLng point(40 + 6 * (unit(random) * 2 - 1), -3 + 10 * unit(random));
+            EXPECT_EQ(PolyUtil::containsLocation(point, array, true), PolyUtil::containsLocation(point, track, true));
+            EXPECT_EQ(PolyUtil::containsLocation(point, array, false), PolyUtil::containsLocation(point, track, false));
+        }
+        for (size_t i = 0; i < track.size(); i += 7) {
+            LatLng point = SphericalUtil::interpolate(track[i], track[i + 1], unit(random));
+            for (bool geodesic : { true, false }) {
+                EXPECT_EQ(PolyUtil::isLocationOnPath(point, array, 1.0, geodesic), PolyUtil::isLocationOnPath(point, track, 1.0, geodesic));
+                EXPECT_EQ(PolyUtil::isLocationOnEdge(point, array, 1.0, geodesic), PolyUtil::isLocationOnEdge(point, track, 1.0, geodesic));
+            }
+        }
+    }
+
+    // Batch distances read cached columns in place.
+    LatLngArray targets(track, LatLngArray::TRIG);
+    std::vector<double> fromArray(track.size());
+    std::vector<double> fromVector(track.size());
+    Simd::setMaxLevel(Simd::SCALAR);
+    SphericalBatch::computeDistances(track[3], targets, fromArray.data());
+    SphericalBatch::computeDistances(track[3], track, fromVector.data());
+    EXPECT_EQ(fromArray, fromVector);
+    Simd::setMaxLevel(Simd::AVX512);
+}
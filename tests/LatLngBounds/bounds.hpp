@@ -0,0 +1,196 @@
+#include <gtest/gtest.h>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "LatLngBounds.hpp"
+#include "PolyUtil.hpp"
+
+
+static LatLngBounds boundsOf(double south, double west, double north, double east) {
+    return LatLngBounds(LatLng(south, west), LatLng(north, east));
+}
+
+TEST(LatLngBounds, extend) {
+    LatLngBounds bounds;
+    EXPECT_TRUE(bounds.isEmpty());
+    EXPECT_FALSE(bounds.contains(LatLng(0, 0)));
+
+    bounds.extend(LatLng(10, 20));
+    EXPECT_EQ(bounds, boundsOf(10, 20, 10, 20));
+    bounds.extend(LatLng(-5, 30)).extend(LatLng(0, 25));
+    EXPECT_EQ(bounds, boundsOf(-5, 20, 10, 30));
+
+    // Across the antimeridian, the shorter way.
+    LatLngBounds pacific;
+    pacific.extend(LatLng(0, 170)).extend(LatLng(5, -170));
+    EXPECT_EQ(pacific, boundsOf(0, 170, 5, -170));
+    EXPECT_TRUE(pacific.contains(LatLng(3, 180)));
+    EXPECT_TRUE(pacific.contains(LatLng(3, -180)));
+    EXPECT_TRUE(pacific.contains(LatLng(3, 540)));
+    EXPECT_FALSE(pacific.contains(LatLng(3, 0)));
+    EXPECT_FALSE(pacific.contains(LatLng(6, 175)));
+
+    // Union.
+    LatLngBounds west = boundsOf(0, 160, 10, 170);
+    LatLngBounds east = boundsOf(-10, -170, 5, -160);
+    EXPECT_EQ(LatLngBounds(west).extend(east), boundsOf(-10, 160, 10, -160));
+    EXPECT_EQ(LatLngBounds(east).extend(west), boundsOf(-10, 160, 10, -160));
+    EXPECT_EQ(LatLngBounds(west).extend(LatLngBounds()), west);
+    EXPECT_EQ(LatLngBounds().extend(west), west);
+    EXPECT_EQ(boundsOf(0, 0, 1, 10).extend(boundsOf(0, 5, 1, 20)), boundsOf(0, 0, 1, 20));
+    EXPECT_EQ(boundsOf(0, 5, 1, 20).extend(boundsOf(0, 0, 1, 10)), boundsOf(0, 0, 1, 20));
+    EXPECT_EQ(boundsOf(0, 0, 1, 10).extend(boundsOf(0, 2, 1, 3)), boundsOf(0, 0, 1, 10));
+    EXPECT_TRUE(boundsOf(0, 0, 1, 170).extend(boundsOf(0, 160, 1, 10)).isFullLng());
+    EXPECT_EQ(boundsOf(0, 0, 1, 170).extend(boundsOf(0, -170, 1, -10)), boundsOf(0, -170, 1, 170));
+}
+
+TEST(LatLngBounds, containsIntersects) {
+    LatLngBounds pacific = boundsOf(-10, 170, 10, -170);
+    EXPECT_TRUE(pacific.contains(boundsOf(-5, 175, 5, -175)));
+    EXPECT_TRUE(pacific.contains(boundsOf(-5, 171, 5, 179)));
+    EXPECT_TRUE(pacific.contains(LatLngBounds()));
+    EXPECT_FALSE(pacific.contains(boundsOf(-5, 160, 5, 175)));
+    EXPECT_FALSE(pacific.contains(boundsOf(-5, -175, 5, 175)));
+    EXPECT_FALSE(boundsOf(-5, -175, 5, 175).contains(pacific));
+
+    EXPECT_TRUE(pacific.intersects(boundsOf(0, -175, 20, 0)));
+    EXPECT_TRUE(pacific.intersects(boundsOf(0, 100, 20, 171)));
+    EXPECT_TRUE(pacific.intersects(boundsOf(10, -170, 20, -160)));
+    EXPECT_TRUE(boundsOf(0, 100, 20, 171).intersects(pacific));
+    EXPECT_FALSE(pacific.intersects(boundsOf(0, 100, 20, 160)));
+    EXPECT_FALSE(pacific.intersects(boundsOf(11, 175, 20, -175)));
+    EXPECT_FALSE(pacific.intersects(LatLngBounds()));
+
+    LatLngBounds full = boundsOf(-90, -180, 90, 180);
+    EXPECT_TRUE(full.isFullLng());
+    EXPECT_TRUE(full.contains(pacific));
+    EXPECT_TRUE(full.contains(LatLng(0, 180)));
+    EXPECT_TRUE(full.contains(LatLng(-90, 0)));
+}
+
+TEST(LatLngBounds, expanded) {
+    double degree = deg2rad(1) * MathUtil::EARTH_RADIUS;
+
+    // On the equator a degree of longitude is a degree of arc.
+    LatLngBounds equator = boundsOf(-1, -1, 1, 1).expanded(degree);
+    EXPECT_NEAR(equator.southwest.lat, -2, 1e-12);
+    EXPECT_NEAR(equator.northeast.lat,  2, 1e-12);
+    EXPECT_NEAR(equator.southwest.lng, -2, 1e-3);
+    EXPECT_NEAR(equator.northeast.lng,  2, 1e-3);
+
+    // At 60 degrees it is half of one.
+    LatLngBounds north = boundsOf(59, 179, 60, -179).expanded(degree);
+    EXPECT_NEAR(north.northeast.lat, 61, 1e-12);
+    EXPECT_NEAR(north.southwest.lng, 177, 1e-2);
+    EXPECT_NEAR(north.northeast.lng, -177, 1e-2);
+    EXPECT_LT(north.southwest.lng, 177);
+
+    // Reaching a pole.
+    LatLngBounds pole = boundsOf(85, 10, 89.5, 20).expanded(degree);
+    EXPECT_TRUE(pole.isFullLng());
+    EXPECT_EQ(pole.northeast.lat, 90);
+
+    // A point within the distance of a corner is within the expanded bounds.
+    LatLngBounds box = boundsOf(40, 10, 50, 20);
+    for (double heading = 0; heading < 360; heading += 15) {
+        LatLng corner = heading < 180 ? box.northeast : box.southwest;
+        LatLng point = SphericalUtil::computeOffset(corner, 50000, heading);
+        EXPECT_TRUE(box.expanded(50001).contains(point)) << heading;
+    }
+    EXPECT_TRUE(LatLngBounds().expanded(degree).isEmpty());
+}
+
+TEST(LatLngBounds, fromPolygon) {
+    EXPECT_TRUE(LatLngBounds::fromPolygon(std::vector<LatLng>()).isEmpty());
+
+    // The great circle bulges north of its ends, to atan(tan(40) / cos(60)).
+    std::vector<LatLng> arc = { {40, -60}, {40, 60} };
+    LatLngBounds path = LatLngBounds::fromPath(arc);
+    EXPECT_NEAR(path.northeast.lat, rad2deg(atan(tan(deg2rad(40)) / cos(deg2rad(60)))), 1e-8);
+    EXPECT_NEAR(path.southwest.lat, 40, 1e-8);
+    EXPECT_NEAR(path.southwest.lng, -60, 1e-8);
+    EXPECT_NEAR(path.northeast.lng,  60, 1e-8);
+    // A rhumb line keeps its latitude.
+    LatLngBounds rhumb = LatLngBounds::fromPath(arc, false);
+    EXPECT_NEAR(rhumb.northeast.lat, 40, 1e-8);
+    EXPECT_TRUE(path.contains(rhumb));
+
+    // Across the antimeridian.
+    std::vector<LatLng> pacific = { {-10, 170}, {10, 170}, {10, -170}, {-10, -170} };
+    LatLngBounds bounds = LatLngBounds::fromPolygon(pacific);
+    EXPECT_NEAR(bounds.southwest.lng, 170, 1e-8);
+    EXPECT_NEAR(bounds.northeast.lng, -170, 1e-8);
+    EXPECT_FALSE(bounds.contains(LatLng(0, 0)));
+
+    // Winding around a pole.
+    std::vector<LatLng> polar = { {80, 0}, {80, 120}, {80, -120} };
+    bounds = LatLngBounds::fromPolygon(polar);
+    EXPECT_TRUE(bounds.isFullLng());
+    EXPECT_EQ(bounds.northeast.lat, 90);
+    EXPECT_LT(bounds.southwest.lat, 80);
+}
+
+TEST(LatLngBounds, bounded) {
+    // Answers for a Bounded list are the ones for the plain list.
+    std::mt19937 random(17);
+    std::uniform_real_distribution<double> unit(0, 1);
+    std::vector<std::vector<LatLng> > polygons = {
+        { {-10, 170}, {10, 170}, {10, -170}, {-10, -170} },
+        { {80, 0}, {80, 120}, {80, -120} },
+        { {-80, 0}, {-80, -120}, {-80, 120} },
+        { {-90, 0}, {10, 10}, {10, -10} },
+        { {0, 0}, {90, 0}, {0, 90} },
+        { {40, -60}, {40, 60}, {30, 0} },
+        { {0, 0}, {0, 180}, {10, 90} },
+    };
+    for (int iteration = 0; iteration < 40; ++iteration) {
+        double centerLat = unit(random) * 160 - 80;
+        double centerLng = unit(random) * 360 - 180;
+        double radius = iteration % 3 == 0 ? 60 * unit(random) : 2 * unit(random);
+        size_t size = 3 + random() % 50;
+        std::vector<LatLng> polygon;
+        for (size_t i = 0; i < size; ++i) {
+            double angle = (iteration % 2 == 0 ? i * 2 * M_PI / size : unit(random) * 2 * M_PI);
+            double r = radius * (0.3 + 0.7 * unit(random));
+            polygon.push_back(LatLng(MathUtil::clamp(centerLat + r * std::sin(angle), -90, 90),
+                                     MathUtil::wrap(centerLng + r * std::cos(angle), -180, 180)));
+        }
+        polygons.push_back(polygon);
+    }
+
+    for (const auto & polygon : polygons) {
+        Bounded<std::vector<LatLng> > bounded(polygon);
+        const LatLngBounds& bounds = bounded.bounds();
+        ASSERT_EQ(bounded.size(), polygon.size());
+
+        std::vector<LatLng> points(polygon);
+        for (int i = 0; i < 150; ++i) {
+            double lat = bounds.southwest.lat - 2 + unit(random) * (bounds.northeast.lat - bounds.southwest.lat + 4);
+            double lng = bounds.southwest.lng - 2 + unit(random) * 40;
+            points.push_back(LatLng(MathUtil::clamp(lat, -90, 90), lng));
+            points.push_back(LatLng(unit(random) * 180 - 90, unit(random) * 360 - 180));
+        }
+        for (const auto & point : points) {
+            for (bool geodesic : { true, false }) {
+                EXPECT_EQ(PolyUtil::containsLocation(point, polygon, geodesic),
+                          PolyUtil::containsLocation(point, bounded, geodesic))
+                    << "point (" << point.lat << ", " << point.lng << "), geodesic " << geodesic;
+                for (double tolerance : { PolyUtil::DEFAULT_TOLERANCE, 1e5 }) {
+                    EXPECT_EQ(PolyUtil::locationIndexOnEdge(point, polygon, tolerance, geodesic),
+                              PolyUtil::locationIndexOnEdge(point, bounded, tolerance, geodesic));
+                    EXPECT_EQ(PolyUtil::locationIndexOnPath(point, polygon, tolerance, geodesic),
+                              PolyUtil::locationIndexOnPath(point, bounded, tolerance, geodesic));
+                }
+            }
+        }
+
+        std::unique_ptr<bool[]> expected(new bool[points.size()]);
+        std::unique_ptr<bool[]> actual(new bool[points.size()]);
+        PolyUtil::containsLocationBatch(points, polygon, expected.get(), true, 1);
+        PolyUtil::containsLocationBatch(points, bounded, actual.get(), true, 1);
+        for (size_t i = 0; i < points.size(); ++i) {
+            EXPECT_EQ(expected[i], actual[i]) << i;
+        }
+    }
+}
@@ -0,0 +1,102 @@
+#include <gtest/gtest.h>
+#include <vector>
+
+#include "MeasuredPath.hpp"
+#include "SphericalUtil.hpp"
+
+
+/**
+ * Returns the point the given distance along the path by the loop over
+ * computeDistanceBetween() and interpolate() MeasuredPath replaces.
+ */
+static LatLng measuredPathWalk(const std::vector<LatLng>& path, double distance) {
+    for (size_t i = 1; i < path.size(); ++i) {
+        double length = SphericalUtil::computeDistanceBetween(path[i - 1], path[i]);
+        if (distance <= length) {
+            return SphericalUtil::interpolate(path[i - 1], path[i], distance / length);
+        }
+        distance -= length;
+    }
+    return path.back();
+}
+
+static std::vector<LatLng> measuredPathRoute() {
+    return { {55.75, 37.61}, {55.76, 37.70}, {55.80, 37.70}, {55.80, 37.70}, {56.00, 38.50}, {59.93, 30.31} };
+}
+
+TEST(MeasuredPath, pointAtDistance) {
+    std::vector<LatLng> route = measuredPathRoute();
+    MeasuredPath path(route);
+    ASSERT_EQ(path.size(), route.size());
+    EXPECT_NEAR(path.length(), SphericalUtil::computeLength(route), 1e-6);
+    EXPECT_EQ(path.distanceAt(0), 0);
+    EXPECT_EQ(path.distanceAt(2), path.distanceAt(3));
+
+    // The ends, clamped, and the vertices as they are.
+    EXPECT_EQ(path.pointAtDistance(-5), route.front());
+    EXPECT_EQ(path.pointAtDistance(0), route.front());
+    EXPECT_EQ(path.pointAtDistance(path.length() + 5), route.back());
+    EXPECT_EQ(path.pointAtFraction(1), route.back());
+    for (size_t i = 0; i < route.size(); ++i) {
+        LatLng vertex = path.pointAtDistance(path.distanceAt(i));
+        EXPECT_EQ(vertex.lat, route[i].lat);
+        EXPECT_EQ(vertex.lng, route[i].lng);
+    }
+
+    for (double distance = 0; distance < path.length(); distance += 1234.5) {
+        LatLng expected = measuredPathWalk(route, distance);
+        LatLng actual = path.pointAtDistance(distance);
+        EXPECT_LT(SphericalUtil::computeDistanceBetween(actual, expected), 1e-6) << distance;
+        EXPECT_NEAR(path.measure(actual), distance, 1e-6) << distance;
+    }
+    LatLng half = path.pointAtFraction(0.5);
+    EXPECT_EQ(half, path.pointAtDistance(path.length() / 2));
+
+    // Empty and single vertex paths.
+    MeasuredPath empty((std::vector<LatLng>()));
+    EXPECT_EQ(empty.length(), 0);
+    EXPECT_TRUE(std::isnan(empty.pointAtDistance(10).lat));
+    EXPECT_TRUE(empty.resample(10).empty());
+    EXPECT_EQ(empty.measure(LatLng(0, 0)), 0);
+    MeasuredPath single(std::vector<LatLng>(1, LatLng(10, 20)));
+    EXPECT_EQ(single.pointAtDistance(10), LatLng(10, 20));
+    EXPECT_EQ(single.resample(10).size(), 1U);
+}
+
+TEST(MeasuredPath, resample) {
+    std::vector<LatLng> route = measuredPathRoute();
+    MeasuredPath path(route);
+    std::vector<LatLng> points = path.resample(1000);
+    ASSERT_EQ(points.size(), static_cast<size_t>(path.length() / 1000) + 2);
+    for (size_t i = 0; i + 1 < points.size(); ++i) {
+        EXPECT_EQ(points[i], path.pointAtDistance(i * 1000.0));
+    }
+    EXPECT_EQ(points.back(), route.back());
+
+    // Any order of distances, with the cursor.
+    std::vector<double> distances = { 0, 500, 1e4, 2e4, 5e3, 5e3, 7e5, -1, 3e4, 1e9 };
+    std::vector<LatLng> out(distances.size(), LatLng(0, 0));
+    path.pointsAtDistances(distances, out.data());
+    for (size_t i = 0; i < distances.size(); ++i) {
+        EXPECT_EQ(out[i], path.pointAtDistance(distances[i]));
+    }
+    EXPECT_TRUE(path.resample(0).empty());
+    EXPECT_EQ(path.resample(path.length() / 2).size(), 3U);
+}
+
+TEST(MeasuredPath, measure) {
+    // Along the equator, a point north of it projects straight down.
+    std::vector<LatLng> equator = { {0, 0}, {0, 10}, {0, 20} };
+    MeasuredPath path(equator);
+    double degree = deg2rad(1) * MathUtil::EARTH_RADIUS;
+    EXPECT_NEAR(path.measure(LatLng(1, 5)), 5 * degree, 1e-6);
+    EXPECT_NEAR(path.measure(LatLng(-1, 15)), 15 * degree, 1e-6);
+    // Beyond the ends, the nearest end.
+    EXPECT_EQ(path.measure(LatLng(0, -5)), 0);
+    EXPECT_NEAR(path.measure(LatLng(3, 30)), 20 * degree, 1e-6);
+
+    // The first closest segment wins on a path that comes back.
+    std::vector<LatLng> back = { {0, 0}, {0, 10}, {0, 0} };
+    MeasuredPath twice(back);
+    EXPECT_NEAR(twice.measure(LatLng(1, 4)), 4 * degree, 1e-6);
+}
@@ -0,0 +1,138 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "PolyUtil.hpp"
+#include "SphericalUtil.hpp"
+#include "Policies.hpp"
+
+
+TEST(Policies, segment) {
+    std::mt19937 random(16);
+    std::uniform_real_distribution<double> unit(0, 1);
+    std::vector<std::vector<LatLng> > polygons = {
+        { {0, 0}, {10, 12}, {20, 5} },
+        { {89, 0}, {89, 120}, {89, -120} },
+        { {10, 170}, {10, -170}, {-10, -170}, {-10, 170} },
+    };
+    for (const auto & polygon : polygons) {
+        for (int i = 0; i < 2000; ++i) {
+            LatLng point(unit(random) * 180 - 90, unit(random) * 360 - 180);
+            EXPECT_EQ(PolyUtil::containsLocation<Geodesic>(point, polygon), PolyUtil::containsLocation(point, polygon, true));
+            EXPECT_EQ(PolyUtil::containsLocation<Rhumb>(point, polygon),    PolyUtil::containsLocation(point, polygon, false));
+        }
+        for (const auto & vertex : polygon) {
+            LatLng point(vertex.lat + 1e-7, vertex.lng);
+            for (double tolerance : { 0.1, 100.0 }) {
+                EXPECT_EQ(PolyUtil::locationIndexOnEdgeOrPath<Geodesic>(point, polygon, true, tolerance),
+                          PolyUtil::locationIndexOnEdgeOrPath(point, polygon, true, true, tolerance));
+                EXPECT_EQ(PolyUtil::isLocationOnPath<Rhumb>(point, polygon, tolerance),
+                          PolyUtil::isLocationOnPath(point, polygon, tolerance, false));
+                EXPECT_EQ(PolyUtil::isLocationOnEdge<Geodesic>(point, polygon, tolerance),
+                          PolyUtil::isLocationOnEdge(point, polygon, tolerance, true));
+            }
+        }
+    }
+}
+
+TEST(Policies, model) {
+    typedef SphereModel<1000> Small;
+    LatLng up    = { 90.0, 0.0 };
+    LatLng down  = {-90.0, 0.0 };
+    LatLng front = {  0.0, 0.0 };
+    std::vector<LatLng> octant = { {0, 0}, {0, 90}, {90, 0} };
+
+    EXPECT_NEAR(SphericalUtil::computeDistanceBetween<Small>(up, down), M_PI * 1000, 1e-9);
+    EXPECT_NEAR(SphericalUtil::computeLength<Small>(octant), M_PI * 1000, 1e-9);
+    EXPECT_NEAR(SphericalUtil::computeArea<Small>(octant), M_PI / 2 * 1000 * 1000, 1e-6);
+    EXPECT_NEAR(SphericalUtil::computeSignedArea<Small>(octant), M_PI / 2 * 1000 * 1000, 1e-6);
+    EXPECT_NEAR(SphericalUtil::computeOffset<Small>(front, M_PI * 1000 / 2, 0).lat, 90, 1e-6);
+    EXPECT_NEAR(SphericalUtil::computeOffsetOrigin<Small>(LatLng(45, 0), M_PI * 1000 / 4, 0).lat, 0, 1e-6);
+
+    // One meter on the Earth is far more on the small sphere.
+    std::vector<LatLng> equator = { {0, 90}, {0, 180} };
+    EXPECT_FALSE(PolyUtil::isLocationOnPath<Geodesic>(LatLng(1e-3, 135), equator, 1));
+    EXPECT_TRUE((PolyUtil::isLocationOnPath<Geodesic, Small>(LatLng(1e-3, 135), equator, 1)));
+
+    // The default model is the Earth.
+    EXPECT_EQ(SphericalUtil::computeDistanceBetween<EarthSphere>(up, front), SphericalUtil::computeDistanceBetween(up, front));
+    EXPECT_EQ(SphericalUtil::computeLength<EarthSphere>(octant), SphericalUtil::computeLength(octant));
+
+    // The constants are defined, so binding them to references links.
+    EXPECT_EQ(std::max(EarthSphere::RADIUS, 0.0), 6371009.0);
+    EXPECT_EQ(std::min(Wgs84Ellipsoid::EQUATORIAL_RADIUS, 1e7), 6378137.0);
+    EXPECT_EQ(std::max(Wgs84Ellipsoid::FLATTENING, 0.0), 1 / 298.257223563);
+    EXPECT_EQ(std::max(Geodesic::GEODESIC, Rhumb::GEODESIC), true);
+}
+
+TEST(Policies, math) {
+    std::mt19937 random(13);
+    std::uniform_real_distribution<double> unit(0, 1);
+
+    // Float storage; the conversion to LatLng is exact.
+    LatLngF stored(55.75f, 37.61f);
+    LatLng widened = stored;
+    EXPECT_EQ(widened.lat, static_cast<double>(stored.lat));
+    EXPECT_EQ(LatLngF(widened).lng, stored.lng);
+    EXPECT_EQ(sizeof(LatLngF), 8U);
+
+    for (int i = 0; i < 1000; ++i) {
+        LatLngF from(static_cast<float>(unit(random) * 170 - 85), static_cast<float>(unit(random) * 360 - 180));
+        LatLngF to(static_cast<float>(from.lat + (unit(random) - 0.5) * 8), static_cast<float>(from.lng + (unit(random) - 0.5) * 8));
+        LatLng from64 = from;
+        LatLng to64 = to;
+
+        // Double arithmetic on float storage gives the LatLng results.
+        EXPECT_EQ(SphericalUtil::computeDistanceBetween<EarthSphere>(from, to), SphericalUtil::computeDistanceBetween(from64, to64));
+        EXPECT_EQ(SphericalUtil::computeHeading(from, to), SphericalUtil::computeHeading(from64, to64));
+
+        // Float arithmetic, within the errors given in the README for up to 1000 km.
+        double distance = SphericalUtil::computeDistanceBetween(from64, to64);
+        EXPECT_NEAR((SphericalUtil::computeDistanceBetween<EarthSphere, FloatMath>(from, to)), distance, 5);
+        double heading = SphericalUtil::computeHeading(from64, to64);
+        double dHeading = MathUtil::wrap(SphericalUtil::computeHeading<FloatMath>(from, to) - heading, -180, 180);
+        EXPECT_LE(std::fabs(deg2rad(dHeading)) * distance, 5);
+        LatLng interpolated = SphericalUtil::interpolate<FloatMath>(from, to, 0.3);
+        EXPECT_LE(SphericalUtil::computeDistanceBetween(interpolated, SphericalUtil::interpolate(from64, to64, 0.3)), 5);
+        LatLng offset = SphericalUtil::computeOffset<EarthSphere, FloatMath>(from, distance, heading);
+        EXPECT_LE(SphericalUtil::computeDistanceBetween(offset, SphericalUtil::computeOffset(from64, distance, heading)), 300);
+    }
+
+    // A jagged ring of short segments; float sums of them stay within a few 1e-6 of
+    // the double ones, and the areas within a few 1e-5, whatever the radii drawn.
+    std::mt19937 radii(13);
+    std::vector<LatLngF> ring;
+    std::vector<LatLng> ring64;
+    for (int i = 0; i < 1000; ++i) {
+        double angle = i * 2 * M_PI / 1000;
+        double r = 0.2 * (0.8 + 0.4 * unit(radii));
+        ring.push_back(LatLngF(static_cast<float>(55.75 + r * sin(angle)), static_cast<float>(37.61 + 1.7 * r * cos(angle))));
+        ring64.push_back(ring.back());
+    }
+    double length = SphericalUtil::computeLength(ring64);
+    EXPECT_NEAR((SphericalUtil::computeLength<EarthSphere, FloatMath>(ring)), length, length * 1e-5);
+    double area = SphericalUtil::computeSignedArea(ring64);
+    EXPECT_NEAR((SphericalUtil::computeSignedArea<EarthSphere, FloatMath>(ring)), area, std::fabs(area) * 5e-5);
+
+    // Points farther than a few meters from the edge are classified alike, against
+    // every tenth vertex of the ring.
+    std::vector<LatLngF> coarse;
+    std::vector<LatLng> coarse64;
+    for (size_t i = 0; i < ring.size(); i += 10) {
+        coarse.push_back(ring[i]);
+        coarse64.push_back(ring64[i]);
+    }
+    for (int i = 0; i < 300; ++i) {
+        LatLng point(55.75 + (unit(random) - 0.5) * 0.6, 37.61 + (unit(random) - 0.5) * 1.0);
+        if (PolyUtil::isLocationOnEdge(point, coarse64, 10.0)) {
+            continue;
+        }
+        bool inside = PolyUtil::containsLocation(point, coarse64, true);
+        EXPECT_EQ((PolyUtil::containsLocation<Geodesic, FloatMath>(point, coarse)), inside);
+        EXPECT_EQ((PolyUtil::containsLocation<Rhumb, FloatMath>(point, coarse)), PolyUtil::containsLocation(point, coarse64, false));
+        EXPECT_FALSE((PolyUtil::isLocationOnEdge<Geodesic, EarthSphere, FloatMath>(point, coarse, 5.0)));
+    }
+    EXPECT_TRUE((PolyUtil::isLocationOnEdge<Geodesic, EarthSphere, FloatMath>(LatLng(coarse[10]), coarse, 5.0)));
+    EXPECT_TRUE((PolyUtil::isLocationOnPath<Rhumb, EarthSphere, FloatMath>(LatLng(coarse[10]), coarse, 5.0)));
+}
@@ -46,7 +46,7 @@ TEST(PolyUtil, containsLocation) {
 
     // Around North Pole.
     std::vector<LatLng> northPole = { {89, 0}, {89, 120}, {89, -120} };
-    for (const auto & point : { LatLng(90, 0), /* LatLng(90, 180), */ LatLng(90, -90) }) {
+    for (const auto & point : { LatLng(90, 0), LatLng(90, 180), LatLng(90, -90) }) {
         EXPECT_TRUE(PolyUtil::containsLocation(point, northPole,  true));
         EXPECT_TRUE(PolyUtil::containsLocation(point, northPole, false));
     }
@@ -57,7 +57,7 @@ TEST(PolyUtil, containsLocation) {
 
     // Around South Pole.
     std::vector<LatLng> southPole = { {-89, 0}, {-89, 120}, {-89, -120} };
-    for (const auto & point : { LatLng(90, 0), /* LatLng(90, 180), */ LatLng(90, -90), LatLng(0, 0) }) {
+    for (const auto & point : { LatLng(90, 0), LatLng(90, 180), LatLng(90, -90), LatLng(0, 0) }) {
         EXPECT_TRUE(PolyUtil::containsLocation(point, southPole,  true));
         EXPECT_TRUE(PolyUtil::containsLocation(point, southPole, false));
     }
@@ -66,6 +66,20 @@ TEST(PolyUtil, containsLocation) {
         EXPECT_FALSE(PolyUtil::containsLocation(point, southPole, false));
     }
 
+    // Across the antimeridian, both orientations.
+    std::vector<LatLng> antimeridian = { {10, 170}, {10, -170}, {-10, -170}, {-10, 170} };
+    std::vector<LatLng> antimeridianReversed(antimeridian.rbegin(), antimeridian.rend());
+    for (const auto & polygon : { antimeridian, antimeridianReversed }) {
+        for (const auto & point : { LatLng(0, 180), LatLng(0, -180), LatLng(0, 175), LatLng(5, -175) }) {
+            EXPECT_TRUE(PolyUtil::containsLocation(point, polygon,  true));
+            EXPECT_TRUE(PolyUtil::containsLocation(point, polygon, false));
+        }
+        for (const auto & point : { LatLng(0, 0), LatLng(0, 165), LatLng(20, 180) }) {
+            EXPECT_FALSE(PolyUtil::containsLocation(point, polygon,  true));
+            EXPECT_FALSE(PolyUtil::containsLocation(point, polygon, false));
+        }
+    }
+
     // Over/under segment on meridian and equator.
     std::vector<LatLng> poly = { {5, 10}, {10, 10}, {0, 20}, {0, -10} };
     for (const auto & point : { LatLng(2.5, 10), LatLng(1, 0) }) {
@@ -0,0 +1,77 @@
+#include <gtest/gtest.h>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "PolyUtil.hpp"
+#include "LatLngArray.hpp"
+
+
+static void expectSameAsContainsLocation(const std::vector<LatLng>& points, const std::vector<LatLng>& polygon, unsigned threads) {
+    std::unique_ptr<bool[]> out(new bool[points.size()]);
+    for (bool geodesic : { true, false }) {
+        for (int level = Simd::detectedLevel(); level >= Simd::SCALAR; --level) {
+            Simd::setMaxLevel(static_cast<Simd::Level>(level));
+            PolyUtil::containsLocationBatch(points, polygon, out.get(), geodesic, threads);
+            for (size_t i = 0; i < points.size(); ++i) {
+                ASSERT_EQ(out[i], PolyUtil::containsLocation(points[i], polygon, geodesic))
+                    << "point (" << points[i].lat << ", " << points[i].lng << "), geodesic " << geodesic
+                    << ", level " << level;
+            }
+        }
+    }
+    Simd::setMaxLevel(Simd::AVX512);
+}
+
+TEST(PolyUtil, containsLocationBatch) {
+    std::vector<LatLng> points = {
+        {90, 0}, {90, 180}, {-90, 0}, {0, 0}, {1, 2}, {0, 180}, {0, -180}, {0, 190}, {0, -540}, {10, 12},
+        {10, 11}, {19, 5}, {89.5, 60}, {5, 175}, {5, -175}, {10, 170}, {-10, -170}, {2.5, 10}, {0, -15},
+    };
+
+    // Empty polygon.
+    std::unique_ptr<bool[]> out(new bool[points.size()]);
+    PolyUtil::containsLocationBatch(points, std::vector<LatLng>(), out.get());
+    for (size_t i = 0; i < points.size(); ++i) {
+        EXPECT_FALSE(out[i]);
+    }
+
+    // Vertices, poles, the antimeridian and longitudes outside [-180, 180].
+    std::vector<std::vector<LatLng> > polygons = {
+        { {1, 2} },
+        { {0, 0}, {10, 12}, {20, 5} },
+        { {89, 0}, {89, 120}, {89, -120} },
+        { {-89, 0}, {-89, 120}, {-89, -120} },
+        { {10, 170}, {10, -170}, {-10, -170}, {-10, 170} },
+        { {10, 170}, {10, 190}, {-10, 190}, {-10, 170} },
+        { {0, 0}, {90, 0}, {0, 90} },
+        { {5, 10}, {10, 10}, {0, 20}, {0, -10} },
+    };
+    for (const auto& polygon : polygons) {
+        expectSameAsContainsLocation(points, polygon, 1);
+    }
+
+    // A city-like polygon against random points around it, split among threads.
+    std::mt19937 random(8);
+    std::uniform_real_distribution<double> unit(0, 1);
+    std::vector<LatLng> city;
+    for (size_t i = 0; i < 203; ++i) {
+        double angle = i * 2 * M_PI / 203;
+        double r = 0.2 * (0.5 + unit(random));
+        city.push_back(LatLng(55.75 + r * std::sin(angle), 37.61 + r * std::cos(angle)));
+    }
+    points.clear();
+    for (size_t i = 0; i < PolyUtil::BATCH_PARALLEL_MIN_POINTS + 100; ++i) {
+        points.push_back(LatLng(55.75 + (unit(random) - 0.5) * 0.6, 37.61 + (unit(random) - 0.5) * 0.6));
+    }
+    points.push_back(city[17]);
+    expectSameAsContainsLocation(points, city, 1);
+    expectSameAsContainsLocation(points, city, 4);
+
+    // Cached radians.
+    std::unique_ptr<bool[]> cached(new bool[points.size()]);
+    PolyUtil::containsLocationBatch(LatLngArray(points), LatLngArray(city, LatLngArray::RADIANS), cached.get(), true, 3);
+    for (size_t i = 0; i < points.size(); ++i) {
+        EXPECT_EQ(cached[i], PolyUtil::containsLocation(points[i], city, true));
+    }
+}
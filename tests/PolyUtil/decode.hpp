@@ -0,0 +1,22 @@
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+#include "PolyUtil.hpp"
+
+
+TEST(PolyUtil, decode) {
+    std::vector<LatLng> path = PolyUtil::decode("_p~iF~ps|U_ulLnnqC_mqNvxq`@");
+    ASSERT_EQ(path.size(), 3U);
+    EXPECT_EQ(path[0], LatLng(38.5, -120.2));
+    EXPECT_EQ(path[1], LatLng(40.7, -120.95));
+    EXPECT_EQ(path[2], LatLng(43.252, -126.453));
+
+    EXPECT_TRUE(PolyUtil::decode("").empty());
+
+    // Malformed input: decoding stops before the broken point.
+    EXPECT_EQ(PolyUtil::decode("_p~iF~ps|U_ulL").size(), 1U);       // Latitude without longitude
+    EXPECT_EQ(PolyUtil::decode("_p~iF~ps|U_ulLnnq").size(), 1U);    // Value cut short
+    EXPECT_EQ(PolyUtil::decode("_p~iF~ps|U_ul Lnnq").size(), 1U);   // Byte outside the alphabet
+    EXPECT_EQ(PolyUtil::decode(std::string("_p~iF~ps|U\x80_ulLnnqC", 20)).size(), 1U);
+}
@@ -0,0 +1,46 @@
+#include <gtest/gtest.h>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "PolyUtil.hpp"
+
+
+TEST(PolyUtil, encode) {
+    std::vector<LatLng> path = { {38.5, -120.2}, {40.7, -120.95}, {43.252, -126.453} };
+    EXPECT_EQ(PolyUtil::encode(path), "_p~iF~ps|U_ulLnnqC_mqNvxq`@");
+
+    EXPECT_EQ(PolyUtil::encode(std::vector<LatLng>()), "");
+    // Halves round up, as Math.round() does.
+    EXPECT_EQ(PolyUtil::encode(std::vector<LatLng>{ {0.000005, -0.000005} }), "A?");
+
+    // Appending to a reused string.
+    std::string out = "prefix";
+    PolyUtil::encode(path, out);
+    EXPECT_EQ(out, "prefix_p~iF~ps|U_ulLnnqC_mqNvxq`@");
+}
+
+TEST(PolyUtil, encode_RoundTrip) {
+    std::mt19937 random(5);
+    std::uniform_real_distribution<double> unit(0, 1);
+
+    std::vector<LatLng> path = { {90, 180}, {-90, -180}, {0, 0}, {90, -180} };
+    for (int i = 0; i < 10000; ++i) {
+        // Large jumps and short steps alike.
+        double scale = i % 2 == 0 ? 1 : 1e-3;
+        const LatLng& last = path.back();
+        double lat = std::max(-90.0, std::min(90.0, last.lat + (unit(random) - 0.5) * 180 * scale));
+        double lng = std::max(-180.0, std::min(180.0, last.lng + (unit(random) - 0.5) * 360 * scale));
+        path.push_back(LatLng(lat, lng));
+    }
+
+    std::vector<LatLng> decoded = PolyUtil::decode(PolyUtil::encode(path));
+    ASSERT_EQ(decoded.size(), path.size());
+    for (size_t i = 0; i < path.size(); ++i) {
+        EXPECT_NEAR(decoded[i].lat, path[i].lat, 0.5e-5 + 1e-12);
+        EXPECT_NEAR(decoded[i].lng, path[i].lng, 0.5e-5 + 1e-12);
+    }
+
+    // Decoded points encode to the same string.
+    EXPECT_EQ(PolyUtil::encode(decoded), PolyUtil::encode(path));
+}
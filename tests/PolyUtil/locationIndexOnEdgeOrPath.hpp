@@ -0,0 +1,36 @@
+#include <gtest/gtest.h>
+#include <vector>
+
+#include "PolyUtil.hpp"
+
+
+TEST(PolyUtil, locationIndexOnEdgeOrPath) {
+    // Empty.
+    std::vector<LatLng> empty;
+    EXPECT_EQ(PolyUtil::locationIndexOnPath(LatLng(0, 0), empty), -1);
+    EXPECT_EQ(PolyUtil::locationIndexOnEdge(LatLng(0, 0), empty), -1);
+
+    // One point.
+    std::vector<LatLng> one = { {1, 2} };
+    EXPECT_EQ(PolyUtil::locationIndexOnPath(LatLng(1, 2), one), 0);
+    EXPECT_EQ(PolyUtil::locationIndexOnPath(LatLng(3, 5), one), -1);
+
+    // Along a path, for both segment kinds.
+    std::vector<LatLng> path = { {0, 0}, {0, 10}, {10, 10}, {10, 20} };
+    for (bool geodesic : { true, false }) {
+        EXPECT_EQ(PolyUtil::locationIndexOnPath(LatLng(0, 0),  path, 1, geodesic), 0);
+        EXPECT_EQ(PolyUtil::locationIndexOnPath(LatLng(0, 5),  path, 1, geodesic), 0);
+        EXPECT_EQ(PolyUtil::locationIndexOnPath(LatLng(0, 10), path, 1, geodesic), 0);
+        EXPECT_EQ(PolyUtil::locationIndexOnPath(LatLng(5, 10), path, 1, geodesic), 1);
+        EXPECT_EQ(PolyUtil::locationIndexOnPath(LatLng(10, 20), path, 1, geodesic), 2);
+        EXPECT_EQ(PolyUtil::locationIndexOnPath(LatLng(5, 5),  path, 1, geodesic), -1);
+
+        // The closing segment of a polygon edge counts as 0.
+        std::vector<LatLng> square = { {0, 0}, {0, 10}, {10, 10}, {10, 0} };
+        EXPECT_EQ(PolyUtil::locationIndexOnEdge(LatLng(0, 5),  square, 1, geodesic), 0);
+        EXPECT_EQ(PolyUtil::locationIndexOnEdge(LatLng(5, 10), square, 1, geodesic), 1);
+        EXPECT_EQ(PolyUtil::locationIndexOnEdge(LatLng(5, 0),  square, 1, geodesic), 0);
+        EXPECT_EQ(PolyUtil::locationIndexOnPath(LatLng(5, 0),  square, 1, geodesic), -1);
+        EXPECT_EQ(PolyUtil::locationIndexOnEdge(LatLng(5, 5),  square, 1, geodesic), -1);
+    }
+}
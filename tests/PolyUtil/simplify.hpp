@@ -0,0 +1,83 @@
+#include <gtest/gtest.h>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "PolyUtil.hpp"
+#include "../Fixtures.hpp"
+
+
+/**
+ * Douglas-Peucker as in the Java original: distanceToLine() for every point.
+ */
+static std::vector<size_t> simplifyReference(const std::vector<LatLng>& poly, double tolerance) {
+    size_t n = poly.size();
+    std::vector<char> keep(n, 0);
+    keep[0] = 1;
+    keep[n - 1] = 1;
+    std::vector<std::pair<size_t, size_t> > stack(1, std::make_pair(size_t(0), n - 1));
+    while (!stack.empty()) {
+        std::pair<size_t, size_t> current = stack.back();
+        stack.pop_back();
+        double maxDist = 0;
+        size_t maxIdx = 0;
+        for (size_t idx = current.first + 1; idx < current.second; ++idx) {
+            double dist = PolyUtil::distanceToLine(poly[idx], poly[current.first], poly[current.second]);
+            if (dist > maxDist) {
+                maxDist = dist;
+                maxIdx = idx;
+            }
+        }
+        if (maxDist > tolerance) {
+            keep[maxIdx] = 1;
+            stack.push_back(std::make_pair(current.first, maxIdx));
+            stack.push_back(std::make_pair(maxIdx, current.second));
+        }
+    }
+    std::vector<size_t> kept;
+    for (size_t i = 0; i < n; ++i) {
+        if (keep[i] != 0) {
+            kept.push_back(i);
+        }
+    }
+    return kept;
+}
+
+TEST(PolyUtil, simplify) {
+    std::string encoded = "elfjD~a}uNOnFN~Em@fJv@tEMhGDjDe@hG^nF??@lA?n@IvAC`Ay@A{@DwCA{CF_EC{CEi@PBTFDJBJ?V?n@?D@?A@?@?F?F?LAf@?n@@`@@T@~@FpA?fA?p@?r@?vAH`@OR@^ETFJCLD?JA^?J?P?fAC`B@d@?b@A\\@`@Ad@@\\?`@?f@?V?H?DD@DDBBDBD?D?B?B@B@@@B@B@B@D?D?JAF@H@FCLADBDBDCFAN?b@Af@@x@@";
+    std::vector<LatLng> line = PolyUtil::decode(encoded);
+    ASSERT_EQ(line.size(), 95U);
+
+    std::vector<std::pair<double, size_t> > expected = {
+        { 5, 20 }, { 10, 14 }, { 15, 10 }, { 20, 8 }, { 500, 3 }, { 1000, 2 },
+    };
+    for (const auto& tolerance : expected) {
+        std::vector<LatLng> simplified = PolyUtil::simplify(line, tolerance.first);
+        EXPECT_EQ(simplified.size(), tolerance.second);
+        EXPECT_EQ(simplified.front(), line.front());
+        EXPECT_EQ(simplified.back(), line.back());
+    }
+
+    // Closed polygon: the last point is moved off the first one while simplifying,
+    // and comes back unchanged.
+    std::vector<LatLng> triangle = { {28.06025, -82.41030}, {28.06129, -82.40945}, {28.06206, -82.40917}, {28.06025, -82.41030} };
+    EXPECT_EQ(PolyUtil::simplifyIndices(triangle, 10), (std::vector<size_t>{ 0, 1, 2, 3 }));
+    EXPECT_EQ(PolyUtil::simplifyIndices(triangle, 100), (std::vector<size_t>{ 0, 2, 3 }));
+    EXPECT_EQ(PolyUtil::simplify(triangle, 1000), (std::vector<LatLng>{ triangle[0], triangle[0] }));
+
+    EXPECT_TRUE(PolyUtil::simplify(std::vector<LatLng>(), 10).empty());
+    EXPECT_EQ(PolyUtil::simplifyIndices(std::vector<LatLng>(1, LatLng(1, 2)), 10), std::vector<size_t>{ 0 });
+
+    // A tolerance of zero or below is rejected.
+    EXPECT_TRUE(PolyUtil::simplify(line, 0).empty());
+    EXPECT_TRUE(PolyUtil::simplifyIndices(line, -1).empty());
+}
+
+TEST(PolyUtil, simplify_SameAsReference) {
+    // Long enough to be split among threads.
+    std::vector<LatLng> track = randomTrack(DouglasPeucker::PARALLEL_MIN_POINTS + 1000, 6);
+    std::vector<size_t> expected = simplifyReference(track, 20);
+    EXPECT_EQ(PolyUtil::simplifyIndices(track, 20, 1), expected);
+    EXPECT_EQ(PolyUtil::simplifyIndices(track, 20, 4), expected);
+    EXPECT_EQ(PolyUtil::simplifyIndices(LatLngArray(track, LatLngArray::RADIANS), 20, 4), expected);
+}
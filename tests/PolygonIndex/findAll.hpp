@@ -0,0 +1,115 @@
+#include <gtest/gtest.h>
+#include <random>
+#include <vector>
+
+#include "PolyUtil.hpp"
+#include "PolygonIndex.hpp"
+
+
+static void expectSameAsScan(const std::vector<std::vector<LatLng> >& polygons, const std::vector<LatLng>& points) {
+    for (bool geodesic : { true, false }) {
+        PolygonIndex index(polygons, geodesic);
+        ASSERT_EQ(index.size(), polygons.size());
+        for (const auto& point : points) {
+            std::vector<size_t> expected;
+            for (size_t i = 0; i < polygons.size(); ++i) {
+                if (PolyUtil::containsLocation(point, polygons[i], geodesic)) {
+                    expected.push_back(i);
+                }
+            }
+            EXPECT_EQ(index.findAll(point), expected)
+                << "point (" << point.lat << ", " << point.lng << "), geodesic " << geodesic;
+
+            size_t any = polygons.size();
+            EXPECT_EQ(index.findAny(point, &any), !expected.empty());
+            if (!expected.empty()) {
+                EXPECT_TRUE(std::find(expected.begin(), expected.end(), any) != expected.end());
+            }
+        }
+    }
+}
+
+TEST(PolygonIndex, findAll) {
+    // Empty index and empty polygons.
+    std::vector<std::vector<LatLng> > none;
+    EXPECT_TRUE(PolygonIndex(none).findAll(LatLng(0, 0)).empty());
+    EXPECT_FALSE(PolygonIndex(none).findAny(LatLng(0, 0)));
+
+    // Around the poles, across the antimeridian, long geodesic edges and a one point polygon.
+    std::vector<std::vector<LatLng> > special = {
+        { {89, 0}, {89, 120}, {89, -120} },
+        { {-89, 0}, {-89, 120}, {-89, -120} },
+        { {10, 170}, {10, -170}, {-10, -170}, {-10, 170} },
+        { {50, -100}, {50, 60}, {40, -20} },
+        { {-50, 100}, {-50, -60}, {-40, 20} },
+        { {0, 0}, {90, 0}, {0, 90} },
+        {},
+        { {1, 2} },
+        { {5, 180}, {5, 175}, {0, 175} },
+    };
+    std::vector<LatLng> points = {
+        {90, 0}, {90, -90}, {-90, 0}, {0, 0}, {1, 2}, {0, 180}, {0, -180}, {5, 175}, {5, -175}, {0, 170},
+        {10, 170}, {-10, -170}, {89.5, 60}, {70, -20}, {60, -20}, {-70, 20}, {-60, 20}, {45, 45}, {4, 179},
+        {5, 180}, {5, -180}, {-80, 0},
+    };
+    expectSameAsScan(special, points);
+
+    // Random polygons of all sizes, anywhere, against random points concentrated around them.
+    std::mt19937 random(7);
+    std::uniform_real_distribution<double> unit(0, 1);
+    std::vector<std::vector<LatLng> > polygons;
+    points.clear();
+    for (int iteration = 0; iteration < 300; ++iteration) {
+        double centerLat = unit(random) * 180 - 90;
+        double centerLng = unit(random) * 360 - 180;
+        double radius = iteration % 10 == 0 ? 40 * unit(random) : 3 * unit(random);
+        size_t size = 3 + random() % 20;
+
+        std::vector<LatLng> polygon;
+        for (size_t i = 0; i < size; ++i) {
+            double angle = (iteration % 2 == 0 ? i * 2 * M_PI / size : unit(random) * 2 * M_PI);
+            double r = radius * (0.3 + 0.7 * unit(random));
+            double lat = MathUtil::clamp(centerLat + r * std::sin(angle), -90, 90);
+            double lng = MathUtil::wrap(centerLng + r * std::cos(angle), -180, 180);
+            polygon.push_back(LatLng(lat, lng));
+        }
+        points.push_back(polygon[0]);
+        for (int i = 0; i < 10; ++i) {
+            double lat = MathUtil::clamp(centerLat + (unit(random) * 2 - 1) * radius * 1.5, -90, 90);
+            double lng = MathUtil::wrap(centerLng + (unit(random) * 2 - 1) * radius * 1.5, -180, 180);
+            points.push_back(LatLng(lat, lng));
+        }
+        polygons.push_back(polygon);
+    }
+    expectSameAsScan(polygons, points);
+}
+
+TEST(PolygonIndex, candidates) {
+    std::vector<std::vector<LatLng> > polygons = {
+        { {0, 0}, {0, 10}, {10, 10}, {10, 0} },
+        { {0, 0}, {0, 10}, {10, 0} },
+    };
+    PolygonIndex index(polygons);
+
+    // The box of the triangle holds (9, 9), the triangle does not.
+    std::vector<size_t> candidates;
+    EXPECT_FALSE(index.candidates(LatLng(9, 9), [&](size_t i) {
+        candidates.push_back(i);
+        return false;
+    }));
+    std::sort(candidates.begin(), candidates.end());
+    EXPECT_EQ(candidates, (std::vector<size_t>{ 0, 1 }));
+    EXPECT_EQ(index.findAll(LatLng(9, 9)), std::vector<size_t>{ 0 });
+
+    // Stops once visit returns true.
+    size_t visited = 0;
+    EXPECT_TRUE(index.candidates(LatLng(9, 9), [&](size_t) {
+        ++visited;
+        return true;
+    }));
+    EXPECT_EQ(visited, 1U);
+    EXPECT_FALSE(index.candidates(LatLng(20, 20), [](size_t) { return true; }));
+
+    EXPECT_EQ(index.polygon(1).size(), 3U);
+    EXPECT_EQ(index.polygon(1)[2], LatLng(10, 0));
+}
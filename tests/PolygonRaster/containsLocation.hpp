@@ -0,0 +1,187 @@
+#include <gtest/gtest.h>
+#include <random>
+#include <vector>
+
+#include "PolyUtil.hpp"
+#include "PolygonRaster.hpp"
+
+
+static void expectRasterSameAsPolyUtil(const std::vector<LatLng>& polygon, const std::vector<LatLng>& points,
+                                       size_t resolution = PolygonRaster::DEFAULT_RESOLUTION) {
+    for (bool geodesic : { true, false }) {
+        PolygonRaster raster(polygon, geodesic, resolution);
+        for (const auto & point : points) {
+            EXPECT_EQ(PolyUtil::containsLocation(point, polygon, geodesic), raster.containsLocation(point))
+                << "point (" << point.lat << ", " << point.lng << "), geodesic " << geodesic
+                << ", resolution " << resolution;
+        }
+    }
+}
+
+TEST(PolygonRaster, containsLocation) {
+    // Empty.
+    std::vector<LatLng> empty;
+    EXPECT_FALSE(PolygonRaster(empty,  true).containsLocation(LatLng(0, 0)));
+    EXPECT_FALSE(PolygonRaster(empty, false).containsLocation(LatLng(0, 0)));
+    EXPECT_FALSE(PolygonRaster().containsLocation(LatLng(0, 0)));
+
+    // One point.
+    std::vector<LatLng> one = { {1, 2} };
+    EXPECT_TRUE(PolygonRaster(one, true).containsLocation(LatLng(1, 2)));
+    EXPECT_FALSE(PolygonRaster(one, true).containsLocation(LatLng(0, 0)));
+
+    // Some arbitrary triangle.
+    std::vector<LatLng> triangle = { {0, 0}, {10, 12}, {20, 5} };
+    for (bool geodesic : { true, false }) {
+        PolygonRaster raster(triangle, geodesic);
+        for (const auto & point : { LatLng(10, 12), LatLng(10, 11), LatLng(19, 5) }) {
+            EXPECT_TRUE(raster.containsLocation(point));
+        }
+        for (const auto & point : { LatLng(0, 1), LatLng(11, 12), LatLng(30, 5), LatLng(0, -180), LatLng(0, 90) }) {
+            EXPECT_FALSE(raster.containsLocation(point));
+        }
+        EXPECT_EQ(raster.columns() % PolygonRaster::TILE, 0U);
+        EXPECT_GT(raster.boundaryCells(), 0U);
+    }
+
+    // Around the poles, across the antimeridian, on meridians of vertices, with pole
+    // vertices, half way around the globe and out of range.
+    std::vector<std::vector<LatLng>> polygons = {
+        { {89, 0}, {89, 120}, {89, -120} },
+        { {-89, 0}, {-89, 120}, {-89, -120} },
+        { {60, -180}, {60, -60}, {60, 60} },
+        { {10, 170}, {10, -170}, {-10, -170}, {-10, 170} },
+        { {5, 10}, {10, 10}, {0, 20}, {0, -10} },
+        { {0, 0}, {90, 50}, {0, 40} },
+        { {-90, 0}, {10, 20}, {10, 30} },
+        { {0, -30}, {0, 150}, {20, 150}, {20, 0} },
+        { {10, 10}, {10, 20}, {20, 200} },
+    };
+    std::vector<LatLng> points = {
+        {90, 0}, {90, -90}, {-90, 0}, {0, 0}, {2.5, 10}, {1, 0}, {15, 10}, {0, -15}, {0, 25}, {-1, 0},
+        {0, 180}, {0, -180}, {5, 175}, {5, -175}, {0, 170}, {10, 170}, {-10, -170}, {0, 165}, {89.5, 60},
+        {70, 0}, {70, 100}, {50, 45}, {5, 50}, {5, 30}, {-5, 20}, {5, 25}, {10, 150}, {10, -30}, {15, 200},
+    };
+    for (const auto & polygon : polygons) {
+        for (size_t resolution : { 16, 256 }) {
+            expectRasterSameAsPolyUtil(polygon, points, resolution);
+        }
+    }
+
+    // Two vertices a few ulps apart in longitude: on the meridian of one, the crossing
+    // test rounds the edges of the other to its far side.
+    std::vector<LatLng> ulps = {
+        {20.416093020780721, -114.80381757776513}, {40.191331519794005, -101.96010026581257},
+        {57.31363133058926, -140.80684267525447}, {34.562310541064988, 155.28474629793806},
+        {53.184236002756641, 98.528657783474245}, {37.808018819416588, 64.913648923822294},
+        {20.416093020780721, 118.76151939464572}, {3.6022853115247706, 67.917638634564241},
+        {-11.760860279425494, 99.552628349209755}, {-9.0592361070843666, 155.28474629793803},
+        {-8.2865113115232774, -155.00088468896485}, {5.7289412382530092, -128.39857438462064},
+    };
+    std::vector<LatLng> meridian;
+    for (double lat = -20; lat <= 85; lat += 0.5) {
+        meridian.push_back(LatLng(lat, 155.28474629793803));
+        meridian.push_back(LatLng(lat, 155.28474629793806));
+    }
+    expectRasterSameAsPolyUtil(ulps, meridian);
+}
+
+TEST(PolygonRaster, randomPolygons) {
+    // Random polygons, both star-shaped around a center and arbitrary, against random points
+    // concentrated around them, on the meridians of vertices and on the vertices.
+    std::mt19937 random(42);
+    std::uniform_real_distribution<double> unit(0, 1);
+    for (int iteration = 0; iteration < 60; ++iteration) {
+        double centerLat = unit(random) * 160 - 80;
+        double centerLng = unit(random) * 360 - 180;
+        double radius = iteration % 3 == 0 ? 60 * unit(random) : 2 * unit(random);
+        size_t size = 3 + random() % 200;
+
+        std::vector<LatLng> polygon;
+        for (size_t i = 0; i < size; ++i) {
+            double angle = (iteration % 2 == 0 ? i * 2 * M_PI / size : unit(random) * 2 * M_PI);
+            double r = radius * (0.3 + 0.7 * unit(random));
+            double lat = MathUtil::clamp(centerLat + r * std::sin(angle), -90, 90);
+            double lng = MathUtil::wrap(centerLng + r * std::cos(angle), -180, 180);
+            polygon.push_back(LatLng(lat, lng));
+        }
+
+        std::vector<LatLng> queries(polygon.begin(), polygon.begin() + std::min<size_t>(size, 5));
+        for (int i = 0; i < 500; ++i) {
+            double lat = MathUtil::clamp(centerLat + (unit(random) * 2 - 1) * radius * 1.5, -90, 90);
+            double lng = MathUtil::wrap(centerLng + (unit(random) * 2 - 1) * radius * 1.5, -180, 180);
+            queries.push_back(LatLng(lat, lng));
+            queries.push_back(LatLng(lat, polygon[i % size].lng));
+            queries.push_back(LatLng(polygon[i % size].lat, lng));
+        }
+        expectRasterSameAsPolyUtil(polygon, queries, iteration % 4 == 0 ? 16 : 256);
+    }
+}
+
+TEST(PolygonRaster, memoryBudget) {
+    std::vector<LatLng> polygon;
+    for (int i = 0; i < 360; ++i) {
+        double radius = i % 2 == 0 ? 10 : 8;
+        polygon.push_back(LatLng(radius * std::sin(deg2rad(i)), radius * std::cos(deg2rad(i))));
+    }
+    PolygonRaster fine(polygon, false, 1024);
+    PolygonRaster coarse(polygon, false, 1024, fine.memoryUsage() / 2);
+    EXPECT_EQ(fine.columns(), 1024U);
+    EXPECT_LT(coarse.columns(), fine.columns());
+    EXPECT_LE(coarse.memoryUsage(), fine.memoryUsage() / 2);
+
+    // Never coarser than one tile.
+    PolygonRaster tiny(polygon, false, 1024, 0);
+    EXPECT_EQ(tiny.columns(), static_cast<size_t>(PolygonRaster::TILE));
+    EXPECT_TRUE(tiny.containsLocation(LatLng(0, 0)));
+    EXPECT_FALSE(tiny.containsLocation(LatLng(0, 11)));
+}
+
+TEST(PolygonRaster, serialize) {
+    std::vector<std::vector<LatLng>> polygons = {
+        {},
+        { {0, 0}, {10, 12}, {20, 5} },
+        { {89, 0}, {89, 120}, {89, -120} },
+        { {10, 10}, {10, 20}, {20, 200} },
+    };
+    std::vector<LatLng> points;
+    for (double lat = -90; lat <= 90; lat += 2.5) {
+        for (double lng = -180; lng <= 180; lng += 2.5) {
+            points.push_back(LatLng(lat, lng));
+        }
+    }
+    for (const auto & polygon : polygons) {
+        for (bool geodesic : { true, false }) {
+            PolygonRaster raster(polygon, geodesic);
+            std::vector<uint8_t> bytes = raster.serialize();
+            PolygonRaster copy;
+            ASSERT_TRUE(PolygonRaster::deserialize(bytes.data(), bytes.size(), &copy));
+            EXPECT_EQ(copy.isGeodesic(), geodesic);
+            EXPECT_EQ(copy.size(), polygon.size());
+            EXPECT_EQ(copy.memoryUsage(), raster.memoryUsage());
+            EXPECT_EQ(copy.serialize(), bytes);
+            for (const auto & point : points) {
+                EXPECT_EQ(copy.containsLocation(point), raster.containsLocation(point));
+            }
+        }
+    }
+
+    // Truncated or damaged bytes leave the raster as it was.
+    std::vector<LatLng> triangle = { {0, 0}, {10, 12}, {20, 5} };
+    std::vector<uint8_t> bytes = PolygonRaster(triangle).serialize();
+    PolygonRaster copy;
+    for (size_t size = 0; size < bytes.size(); ++size) {
+        EXPECT_FALSE(PolygonRaster::deserialize(bytes.data(), size, &copy));
+    }
+    std::vector<uint8_t> damaged = bytes;
+    damaged[0] ^= 1;
+    EXPECT_FALSE(PolygonRaster::deserialize(damaged.data(), damaged.size(), &copy));
+    damaged = bytes;
+    damaged.back() = 0xff;
+    EXPECT_FALSE(PolygonRaster::deserialize(damaged.data(), damaged.size(), &copy));
+    damaged = bytes;
+    damaged.push_back(0);
+    EXPECT_FALSE(PolygonRaster::deserialize(damaged.data(), damaged.size(), &copy));
+    EXPECT_EQ(copy.size(), 0U);
+    EXPECT_FALSE(copy.containsLocation(LatLng(10, 8)));
+}
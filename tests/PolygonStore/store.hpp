@@ -0,0 +1,147 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "PolygonStore.hpp"
+#include "PolygonIndex.hpp"
+#include "PolyUtil.hpp"
+#include "SphericalUtil.hpp"
+
+
+static std::vector<LatLng> storeSquare(double lat, double lng, double size) {
+    return { {lat, lng}, {lat, lng + size}, {lat + size, lng + size}, {lat + size, lng} };
+}
+
+// The bytes of a store in memory aligned like a mapping.
+static std::vector<uint64_t> storeWords(const std::vector<uint8_t>& bytes) {
+    std::vector<uint64_t> words((bytes.size() + 7) / 8);
+    std::memcpy(words.data(), bytes.data(), bytes.size());
+    return words;
+}
+
+TEST(PolygonStore, roundTrip) {
+    std::vector<LatLng> path = { {0, 0}, {10, 10}, {20, 0} };
+    PolygonStore::Writer writer(true);
+    EXPECT_EQ(writer.addPolygon(storeSquare(0, 0, 10)), 0U);
+    EXPECT_EQ(writer.addPath(path), 1U);
+    EXPECT_EQ(writer.addPolygon(std::vector<LatLng>()), 2U);
+    EXPECT_EQ(writer.addPolygon(storeSquare(10, 175, 10)), 3U);
+
+    for (bool index : { true, false }) {
+        std::vector<uint8_t> bytes = writer.serialize(index);
+        std::vector<uint64_t> words = storeWords(bytes);
+        PolygonStore store;
+        ASSERT_TRUE(store.attach(reinterpret_cast<const uint8_t*>(words.data()), bytes.size()));
+        EXPECT_EQ(store.size(), 4U);
+        EXPECT_EQ(store.hasIndex(), index);
+        EXPECT_TRUE(store.isGeodesic());
+        EXPECT_EQ(store.kind(0), PolygonStore::POLYGON);
+        EXPECT_EQ(store.kind(1), PolygonStore::PATH);
+        EXPECT_TRUE(store.feature(2).empty());
+
+        // The spans go to the templates as they are.
+        LatLngSpan span = store.feature(1);
+        ASSERT_EQ(span.size(), path.size());
+        EXPECT_EQ(span[2], path[2]);
+        EXPECT_EQ(SphericalUtil::computeLength(span), SphericalUtil::computeLength(path));
+        EXPECT_TRUE(PolyUtil::isLocationOnPath(LatLng(5, 5), span, 10000));
+        EXPECT_EQ(SphericalUtil::computeArea(store.feature(0)), SphericalUtil::computeArea(storeSquare(0, 0, 10)));
+
+        // Paths are not searched.
+        EXPECT_EQ(store.findAll(LatLng(5, 5)), std::vector<size_t>({ 0 }));
+        EXPECT_EQ(store.findAll(LatLng(15, -178)), std::vector<size_t>({ 3 }));
+        EXPECT_EQ(store.findAll(LatLng(15, 180)), std::vector<size_t>({ 3 }));
+        size_t found = 99;
+        EXPECT_TRUE(store.findAny(LatLng(15, 179), &found));
+        EXPECT_EQ(found, 3U);
+        EXPECT_FALSE(store.findAny(LatLng(15, 0)));
+    }
+
+    PolygonStore empty;
+    EXPECT_EQ(empty.size(), 0U);
+    EXPECT_TRUE(empty.findAll(LatLng(0, 0)).empty());
+    std::vector<uint8_t> bytes = PolygonStore::Writer().serialize();
+    std::vector<uint64_t> words = storeWords(bytes);
+    ASSERT_TRUE(empty.attach(reinterpret_cast<const uint8_t*>(words.data()), bytes.size()));
+    EXPECT_EQ(empty.size(), 0U);
+    EXPECT_FALSE(empty.hasIndex());
+    EXPECT_FALSE(empty.findAny(LatLng(0, 0)));
+}
+
+TEST(PolygonStore, findAll) {
+    // Against PolygonIndex, over a file.
+    std::mt19937 random(24);
+    std::uniform_real_distribution<double> unit(0, 1);
+    std::vector<std::vector<LatLng>> zones;
+    PolygonStore::Writer writer;
+    for (int i = 0; i < 500; ++i) {
+        zones.push_back(storeSquare(unit(random) * 120 - 60, unit(random) * 360 - 180, unit(random) * 20));
+        writer.addPolygon(zones.back());
+    }
+    PolygonIndex index(zones);
+
+    std::string path = testing::TempDir() + "PolygonStore.findAll.glps";
+    ASSERT_TRUE(writer.save(path));
+    PolygonStore store;
+    ASSERT_TRUE(store.open(path));
+    EXPECT_TRUE(store.hasIndex());
+    EXPECT_FALSE(store.isGeodesic());
+    for (int i = 0; i < 2000; ++i) {
+        LatLng point(unit(random) * 140 - 70, unit(random) * 360 - 180);
+        EXPECT_EQ(store.findAll(point), index.findAll(point));
+    }
+
+    // The mapping moves with the store, and stays until it closes.
+    PolygonStore moved(std::move(store));
+    EXPECT_EQ(store.size(), 0U);
+    EXPECT_EQ(moved.size(), zones.size());
+    EXPECT_EQ(moved.feature(42)[3], zones[42][3]);
+    moved.close();
+    EXPECT_EQ(moved.size(), 0U);
+    EXPECT_FALSE(moved.open(path + ".missing"));
+    std::remove(path.c_str());
+}
+
+TEST(PolygonStore, damaged) {
+    PolygonStore::Writer writer;
+    writer.addPolygon(storeSquare(0, 0, 10));
+    writer.addPolygon(storeSquare(5, 5, 10));
+    std::vector<uint8_t> bytes = writer.serialize();
+    std::vector<uint64_t> words = storeWords(bytes);
+    const uint8_t* data = reinterpret_cast<const uint8_t*>(words.data());
+
+    PolygonStore store;
+    ASSERT_TRUE(store.attach(data, bytes.size()));
+    for (size_t size = 0; size < bytes.size(); size += 8) {
+        EXPECT_FALSE(store.attach(data, size)) << size;
+    }
+    EXPECT_FALSE(store.attach(data + 8, bytes.size() - 8));
+    EXPECT_FALSE(store.attach(nullptr, 0));
+
+    // Misaligned memory, and a wrong magic or version.
+    std::vector<uint64_t> shifted(words.size() + 1);
+    std::memcpy(reinterpret_cast<uint8_t*>(shifted.data()) + 4, bytes.data(), bytes.size());
+    EXPECT_FALSE(store.attach(reinterpret_cast<const uint8_t*>(shifted.data()) + 4, bytes.size()));
+    for (size_t at : { 0, 4 }) {
+        std::vector<uint64_t> copy = words;
+        reinterpret_cast<uint8_t*>(copy.data())[at] ^= 1;
+        EXPECT_FALSE(store.attach(reinterpret_cast<const uint8_t*>(copy.data()), bytes.size()));
+    }
+    // A failed attach leaves the store as it was.
+    EXPECT_EQ(store.size(), 2U);
+    EXPECT_EQ(store.findAll(LatLng(7, 7)), std::vector<size_t>({ 0, 1 }));
+
+    // Damaged offsets and index nodes give empty features and missed polygons, no more.
+    std::vector<uint64_t> copy = words;
+    copy[64 / 8 + 1] = ~static_cast<uint64_t>(0);
+    uint8_t* node = reinterpret_cast<uint8_t*>(copy.data()) + copy[48 / 8];
+    std::memset(node + 512, 0xff, 72);
+    ASSERT_TRUE(store.attach(reinterpret_cast<const uint8_t*>(copy.data()), bytes.size()));
+    EXPECT_TRUE(store.feature(0).empty());
+    EXPECT_TRUE(store.feature(1).empty());
+    EXPECT_TRUE(store.findAll(LatLng(7, 7)).empty());
+}
@@ -0,0 +1,72 @@
+#include <gtest/gtest.h>
+#include <random>
+#include <vector>
+
+#include "PolyUtil.hpp"
+#include "PreparedPath.hpp"
+#include "SphericalUtil.hpp"
+
+
+static void expectSameAsPolyUtil(const std::vector<LatLng>& path, const std::vector<LatLng>& points, double tolerance) {
+    for (bool closed : { true, false }) {
+        for (bool geodesic : { true, false }) {
+            PreparedPath prepared(path, closed, geodesic, tolerance);
+            for (const auto & point : points) {
+                EXPECT_EQ(PolyUtil::locationIndexOnEdgeOrPath(point, path, closed, geodesic, tolerance),
+                          prepared.locationIndexOnEdgeOrPath(point))
+                    << "point (" << point.lat << ", " << point.lng << "), closed " << closed << ", geodesic " << geodesic;
+            }
+        }
+    }
+}
+
+TEST(PreparedPath, locationIndexOnEdgeOrPath) {
+    // Empty and one point.
+    EXPECT_EQ(PreparedPath(std::vector<LatLng>()).locationIndexOnEdgeOrPath(LatLng(0, 0)), -1);
+    std::vector<LatLng> one = { {1, 2} };
+    EXPECT_EQ(PreparedPath(one).locationIndexOnEdgeOrPath(LatLng(1, 2)), 0);
+    EXPECT_FALSE(PreparedPath(one).isLocationOnEdgeOrPath(LatLng(3, 5)));
+
+    // Across the antimeridian, through the poles and half way around the globe.
+    std::vector<LatLng> points = {
+        {0, 0}, {0, 180}, {0, -180}, {90, 0}, {-90, 0}, {-45, 180}, {-45, -180}, {-45, 0}, {-45, 90}, {10, 175},
+        {10, -175}, {0, 90}, {0, 135}, {45, 45}, {89.9999999, 0}, {0, 540}, {5, 5},
+    };
+    double small = 5e-7;
+    for (const auto & point : std::vector<LatLng>(points)) {
+        points.push_back(LatLng(point.lat + small, point.lng));
+        points.push_back(LatLng(point.lat, point.lng - small));
+    }
+    std::vector<std::vector<LatLng> > paths = {
+        { {0, 90}, {0, 180} },
+        { {-45, -180}, {-45, -small} },
+        { {10, 170}, {10, -170}, {-10, -170} },
+        { {0, 0}, {90, 0}, {0, 90}, {-90, 45} },
+        { {0, 0}, {0, 180}, {45, 45} },
+        { {5, 5}, {5, 5}, {5, 5} },
+    };
+    for (const auto & path : paths) {
+        expectSameAsPolyUtil(path, points, PolyUtil::DEFAULT_TOLERANCE);
+        expectSameAsPolyUtil(path, points, 1e5);
+    }
+
+    // A long route with points around it, some within the tolerance.
+    std::mt19937 random(9);
+    std::normal_distribution<double> turn(0, 20);
+    std::uniform_real_distribution<double> unit(0, 1);
+    std::vector<LatLng> route;
+    LatLng point(55.75, 37.61);
+    double heading = 0;
+    for (int i = 0; i < 200; ++i) {
+        heading += turn(random);
+        point = SphericalUtil::computeOffset(point, 30 + 100 * unit(random), heading);
+        route.push_back(point);
+    }
+    points.clear();
+    for (int i = 0; i < 200; ++i) {
+        const LatLng& near = route[random() % route.size()];
+        points.push_back(SphericalUtil::computeOffset(near, 30 * unit(random), 360 * unit(random)));
+    }
+    expectSameAsPolyUtil(route, points, 10);
+    expectSameAsPolyUtil(route, points, 1);
+}
@@ -0,0 +1,85 @@
+#include <gtest/gtest.h>
+#include <random>
+#include <vector>
+
+#include "PolyUtil.hpp"
+#include "PreparedPolygon.hpp"
+
+
+static void expectSameAsPolyUtil(const std::vector<LatLng>& polygon, const std::vector<LatLng>& points) {
+    for (bool geodesic : { true, false }) {
+        PreparedPolygon prepared(polygon, geodesic);
+        for (const auto & point : points) {
+            EXPECT_EQ(PolyUtil::containsLocation(point, polygon, geodesic), prepared.containsLocation(point))
+                << "point (" << point.lat << ", " << point.lng << "), geodesic " << geodesic;
+        }
+    }
+}
+
+TEST(PreparedPolygon, containsLocation) {
+    // Empty.
+    std::vector<LatLng> empty;
+    EXPECT_FALSE(PreparedPolygon(empty,  true).containsLocation(LatLng(0, 0)));
+    EXPECT_FALSE(PreparedPolygon(empty, false).containsLocation(LatLng(0, 0)));
+
+    // One point.
+    std::vector<LatLng> one = { {1, 2} };
+    EXPECT_TRUE(PreparedPolygon(one, true).containsLocation(LatLng(1, 2)));
+    EXPECT_FALSE(PreparedPolygon(one, true).containsLocation(LatLng(0, 0)));
+
+    // Some arbitrary triangle.
+    std::vector<LatLng> triangle = { {0, 0}, {10, 12}, {20, 5} };
+    for (bool geodesic : { true, false }) {
+        PreparedPolygon prepared(triangle, geodesic);
+        for (const auto & point : { LatLng(10, 12), LatLng(10, 11), LatLng(19, 5) }) {
+            EXPECT_TRUE(prepared.containsLocation(point));
+        }
+        for (const auto & point : { LatLng(0, 1), LatLng(11, 12), LatLng(30, 5), LatLng(0, -180), LatLng(0, 90) }) {
+            EXPECT_FALSE(prepared.containsLocation(point));
+        }
+    }
+
+    // Around the poles, across the antimeridian and on meridians of vertices.
+    std::vector<LatLng> northPole = { {89, 0}, {89, 120}, {89, -120} };
+    std::vector<LatLng> southPole = { {-89, 0}, {-89, 120}, {-89, -120} };
+    std::vector<LatLng> antimeridian = { {10, 170}, {10, -170}, {-10, -170}, {-10, 170} };
+    std::vector<LatLng> poly = { {5, 10}, {10, 10}, {0, 20}, {0, -10} };
+    std::vector<LatLng> points = {
+        {90, 0}, {90, -90}, {-90, 0}, {0, 0}, {2.5, 10}, {1, 0}, {15, 10}, {0, -15}, {0, 25}, {-1, 0},
+        {0, 180}, {0, -180}, {5, 175}, {5, -175}, {0, 170}, {10, 170}, {-10, -170}, {0, 165}, {89.5, 60},
+    };
+    expectSameAsPolyUtil(northPole, points);
+    expectSameAsPolyUtil(southPole, points);
+    expectSameAsPolyUtil(antimeridian, points);
+    expectSameAsPolyUtil(poly, points);
+
+    // Random polygons, both star-shaped around a center and arbitrary, against random points
+    // concentrated around them.
+    std::mt19937 random(42);
+    std::uniform_real_distribution<double> unit(0, 1);
+    for (int iteration = 0; iteration < 60; ++iteration) {
+        double centerLat = unit(random) * 160 - 80;
+        double centerLng = unit(random) * 360 - 180;
+        double radius = iteration % 3 == 0 ? 60 * unit(random) : 2 * unit(random);
+        size_t size = 3 + random() % 200;
+
+        std::vector<LatLng> polygon;
+        for (size_t i = 0; i < size; ++i) {
+            double angle = (iteration % 2 == 0 ? i * 2 * M_PI / size : unit(random) * 2 * M_PI);
+            double r = radius * (0.3 + 0.7 * unit(random));
+            double lat = MathUtil::clamp(centerLat + r * std::sin(angle), -90, 90);
+            double lng = MathUtil::wrap(centerLng + r * std::cos(angle), -180, 180);
+            polygon.push_back(LatLng(lat, lng));
+        }
+
+        std::vector<LatLng> queries(polygon.begin(), polygon.begin() + std::min<size_t>(size, 5));
+        for (int i = 0; i < 300; ++i) {
+            double lat = MathUtil::clamp(centerLat + (unit(random) * 2 - 1) * radius * 1.5, -90, 90);
+            double lng = MathUtil::wrap(centerLng + (unit(random) * 2 - 1) * radius * 1.5, -180, 180);
+            queries.push_back(LatLng(lat, lng));
+            // Same longitude as a vertex.
+            queries.push_back(LatLng(lat, polygon[i % size].lng));
+        }
+        expectSameAsPolyUtil(polygon, queries);
+    }
+}
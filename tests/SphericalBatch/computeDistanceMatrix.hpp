@@ -0,0 +1,45 @@
+#include <gtest/gtest.h>
+#include <random>
+#include <vector>
+
+#include "SphericalUtil.hpp"
+#include "SphericalBatch.hpp"
+
+
+TEST(SphericalBatch, computeDistanceMatrix) {
+    std::mt19937 random(11);
+    std::uniform_real_distribution<double> unit(0, 1);
+
+    // More columns than one tile, and a count that is not a multiple of the vector width.
+    std::vector<LatLng> origins;
+    std::vector<LatLng> targets;
+    for (int i = 0; i < 37; ++i) {
+        origins.push_back(LatLng(unit(random) * 180 - 90, unit(random) * 360 - 180));
+    }
+    for (int i = 0; i < 1203; ++i) {
+        targets.push_back(LatLng(unit(random) * 180 - 90, unit(random) * 360 - 180));
+    }
+
+    std::vector<double> matrix(origins.size() * targets.size());
+    std::vector<double> row(targets.size());
+    for (int level = Simd::detectedLevel(); level >= Simd::SCALAR; --level) {
+        Simd::setMaxLevel(static_cast<Simd::Level>(level));
+        SphericalBatch::computeDistanceMatrix(origins, targets, matrix.data());
+        for (size_t i = 0; i < origins.size(); ++i) {
+            SphericalBatch::computeDistances(origins[i], targets, row.data());
+            for (size_t j = 0; j < targets.size(); ++j) {
+                double expected = SphericalUtil::computeDistanceBetween(origins[i], targets[j]);
+                EXPECT_NEAR(matrix[i * targets.size() + j], expected, SphericalBatch::MAX_ABSOLUTE_ERROR);
+                if (level == Simd::SCALAR) {
+                    EXPECT_EQ(matrix[i * targets.size() + j], expected);
+                    EXPECT_EQ(row[j], expected);
+                }
+            }
+        }
+    }
+    Simd::setMaxLevel(Simd::AVX512);
+
+    // No rows or no columns.
+    SphericalBatch::computeDistanceMatrix(std::vector<LatLng>(), targets, matrix.data());
+    SphericalBatch::computeDistanceMatrix(origins, std::vector<LatLng>(), matrix.data());
+}
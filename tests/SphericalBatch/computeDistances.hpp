@@ -0,0 +1,82 @@
+#include <gtest/gtest.h>
+#include <random>
+#include <vector>
+
+#include "SphericalUtil.hpp"
+#include "SphericalBatch.hpp"
+
+
+static void expectWithinBatchBound(double actual, double expected) {
+    if (expected < deg2rad(SphericalBatch::MAX_ULP_ANGLE) * MathUtil::EARTH_RADIUS) {
+        double ulp = std::nextafter(expected, INFINITY) - expected;
+        double bound = SphericalBatch::MAX_ULP * ulp;
+        EXPECT_LE(std::fabs(actual - expected), bound) << expected;
+    }
+    EXPECT_NEAR(actual, expected, SphericalBatch::MAX_ABSOLUTE_ERROR);
+}
+
+TEST(SphericalBatch, computeDistances) {
+    std::mt19937 random(7);
+    std::uniform_real_distribution<double> unit(0, 1);
+
+    std::vector<LatLng> targets = { {90, 0}, {-90, 0}, {0, 0}, {0, 180}, {0, -180}, {45, 45} };
+    for (int i = 0; i < 20000; ++i) {
+        targets.push_back(LatLng(unit(random) * 180 - 90, unit(random) * 360 - 180));
+    }
+    // Close pairs, down to a few millimeters.
+    for (int i = 0; i < 2000; ++i) {
+        double scale = std::pow(10.0, -1 - 7 * unit(random));
+        targets.push_back(LatLng(12.5 + scale * (unit(random) - 0.5), 30.25 + scale * (unit(random) - 0.5)));
+    }
+
+    std::vector<LatLng> origins = { {12.5, 30.25}, {0, 0}, {90, 0}, {-45.5, 179.9} };
+    std::vector<double> out(targets.size());
+    for (int level = Simd::detectedLevel(); level >= Simd::SCALAR; --level) {
+        Simd::setMaxLevel(static_cast<Simd::Level>(level));
+        for (const auto & from : origins) {
+            SphericalBatch::computeDistances(from, targets, out.data());
+            for (size_t i = 0; i < targets.size(); ++i) {
+                double expected = SphericalUtil::computeDistanceBetween(from, targets[i]);
+                if (level == Simd::SCALAR) {
+                    EXPECT_EQ(out[i], expected);
+                } else {
+                    expectWithinBatchBound(out[i], expected);
+                }
+            }
+        }
+    }
+    Simd::setMaxLevel(Simd::AVX512);
+
+    // Empty target list.
+    SphericalBatch::computeDistances(LatLng(0, 0), std::vector<LatLng>(), out.data());
+}
+
+TEST(SphericalBatch, computeDistancesFloat) {
+    std::mt19937 random(8);
+    std::uniform_real_distribution<double> unit(0, 1);
+
+    std::vector<LatLngF> targets = { {90, 0}, {-90, 0}, {0, 0}, {0, 180}, {0, -180}, {45, 45} };
+    for (int i = 0; i < 20000; ++i) {
+        targets.push_back(LatLngF(static_cast<float>(unit(random) * 180 - 90), static_cast<float>(unit(random) * 360 - 180)));
+    }
+    for (int i = 0; i < 2000; ++i) {
+        double scale = std::pow(10.0, -1 - 7 * unit(random));
+        targets.push_back(LatLngF(static_cast<float>(12.5 + scale * (unit(random) - 0.5)),
+                                  static_cast<float>(30.25 + scale * (unit(random) - 0.5))));
+    }
+
+    std::vector<LatLng> origins = { {12.5, 30.25}, {0, 0}, {90, 0}, {-45.5, 179.9} };
+    std::vector<float> out(targets.size());
+    for (int level = Simd::detectedLevel(); level >= Simd::SCALAR; --level) {
+        Simd::setMaxLevel(static_cast<Simd::Level>(level));
+        for (const auto & from : origins) {
+            SphericalBatch::computeDistances(from, targets, out.data());
+            for (size_t i = 0; i < targets.size(); ++i) {
+                double expected = SphericalUtil::computeDistanceBetween(from, targets[i]);
+                bool antipodal = expected >= deg2rad(SphericalBatch::MAX_ULP_ANGLE) * MathUtil::EARTH_RADIUS;
+                EXPECT_NEAR(out[i], expected, antipodal ? SphericalBatch::MAX_FLOAT_ANTIPODAL_ERROR : SphericalBatch::MAX_FLOAT_ERROR);
+            }
+        }
+    }
+    Simd::setMaxLevel(Simd::AVX512);
+}
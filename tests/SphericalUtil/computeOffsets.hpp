@@ -0,0 +1,66 @@
+#include <gtest/gtest.h>
+#include <vector>
+
+#include "SphericalUtil.hpp"
+
+
+TEST(SphericalUtil, computeOffsets) {
+    std::vector<LatLng> origins = { {55.75, 37.61}, {0, 0}, {-89.5, 10}, {10, 179.9} };
+    std::vector<double> headings;
+    for (double heading = -180; heading <= 360; heading += 7.5) {
+        headings.push_back(heading);
+    }
+    std::vector<double> distances = { 0, 1, 1000, 250e3, 5e6, 2e7, -3000 };
+
+    for (const auto & from : origins) {
+        // Identical to computeOffset() one by one.
+        std::vector<LatLng> fan(headings.size(), LatLng(0, 0));
+        SphericalUtil::computeOffsets(from, 50000.0, headings, fan.data());
+        for (size_t i = 0; i < headings.size(); ++i) {
+            LatLng expected = SphericalUtil::computeOffset(from, 50000, headings[i]);
+            EXPECT_EQ(fan[i].lat, expected.lat);
+            EXPECT_EQ(fan[i].lng, expected.lng);
+        }
+
+        std::vector<LatLng> ray(distances.size(), LatLng(0, 0));
+        SphericalUtil::computeOffsets(from, distances, 30.0, ray.data());
+        for (size_t i = 0; i < distances.size(); ++i) {
+            LatLng expected = SphericalUtil::computeOffset(from, distances[i], 30);
+            EXPECT_EQ(ray[i].lat, expected.lat);
+            EXPECT_EQ(ray[i].lng, expected.lng);
+        }
+
+        // The same with policies, on LatLngF points.
+        LatLngF fromF(from);
+        std::vector<LatLngF> fanF(headings.size(), LatLngF(0, 0));
+        SphericalUtil::computeOffsets<SphereModel<6378137>, FloatMath>(fromF, 50000.0, headings, fanF.data());
+        for (size_t i = 0; i < headings.size(); ++i) {
+            LatLngF expected = SphericalUtil::computeOffset<SphereModel<6378137>, FloatMath>(fromF, 50000, headings[i]);
+            EXPECT_EQ(fanF[i].lat, expected.lat);
+            EXPECT_EQ(fanF[i].lng, expected.lng);
+        }
+    }
+}
+
+TEST(SphericalUtil, circlePolygon) {
+    std::vector<LatLng> centers = { {55.75, 37.61}, {0, 180}, {89.9, 0}, {-60, -45} };
+    for (const auto & center : centers) {
+        for (size_t n : { 1U, 3U, 64U, 360U, 100000U }) {
+            std::vector<LatLng> circle(n, LatLng(0, 0));
+            SphericalUtil::circlePolygon(center, 10000, n, circle.data());
+            for (size_t i = 0; i < n; ++i) {
+                LatLng expected = SphericalUtil::computeOffset(center, 10000, 360.0 * i / n);
+                EXPECT_NEAR(circle[i].lat, expected.lat, 1e-12);
+                EXPECT_NEAR(circle[i].lng, expected.lng, 1e-12);
+                EXPECT_NEAR(SphericalUtil::computeDistanceBetween(center, circle[i]), 10000, 1e-4);
+            }
+        }
+    }
+
+    // Clockwise around the center, so the area is negative.
+    std::vector<LatLng> circle(360, LatLng(0, 0));
+    SphericalUtil::circlePolygon(LatLng(55.75, 37.61), 10000, circle.size(), circle.data());
+    EXPECT_EQ(circle[0].lng, 37.61);
+    EXPECT_NEAR(SphericalUtil::computeSignedArea(circle), -M_PI * 10000 * 10000, 0.01 * M_PI * 10000 * 10000);
+    SphericalUtil::circlePolygon(LatLng(0, 0), 10000, 0, nullptr);
+}
@@ -0,0 +1,39 @@
+#include <gtest/gtest.h>
+#include <vector>
+
+#include "SphericalUtil.hpp"
+#include "LatLngArray.hpp"
+#include "../Fixtures.hpp"
+
+
+TEST(SphericalUtil, computeLengthParallel) {
+    // Several chunks and a partial one.
+    std::vector<LatLng> ring = jitteredRing(5 * ChunkedSum::CHUNK + 123, 1);
+    double expected = SphericalUtil::computeLength(ring);
+    for (unsigned threads : { 1U, 2U, 3U, 7U, 0U }) {
+        EXPECT_EQ(SphericalUtil::computeLengthParallel(ring, threads), expected);
+    }
+    EXPECT_EQ(SphericalUtil::computeLengthParallel(LatLngArray(ring, LatLngArray::RADIANS), 4), expected);
+
+    // Whole chunks only.
+    std::vector<LatLng> whole = jitteredRing(4 * ChunkedSum::CHUNK + 1, 2);
+    EXPECT_EQ(SphericalUtil::computeLengthParallel(whole, 4), SphericalUtil::computeLength(whole));
+
+    EXPECT_EQ(SphericalUtil::computeLengthParallel(std::vector<LatLng>(), 4), 0);
+    EXPECT_EQ(SphericalUtil::computeLengthParallel(std::vector<LatLng>(1, LatLng(0, 0)), 4), 0);
+}
+
+TEST(SphericalUtil, computeSignedAreaParallel) {
+    std::vector<LatLng> ring = jitteredRing(5 * ChunkedSum::CHUNK + 123, 3);
+    double expected = SphericalUtil::computeSignedArea(ring);
+    for (unsigned threads : { 1U, 2U, 3U, 7U, 0U }) {
+        EXPECT_EQ(SphericalUtil::computeSignedAreaParallel(ring, threads), expected);
+    }
+    EXPECT_EQ(SphericalUtil::computeSignedAreaParallel(LatLngArray(ring, LatLngArray::RADIANS), 4), expected);
+    EXPECT_EQ(SphericalUtil::computeAreaParallel(ring, 4), SphericalUtil::computeArea(ring));
+
+    std::vector<LatLng> whole = jitteredRing(4 * ChunkedSum::CHUNK, 4);
+    EXPECT_EQ(SphericalUtil::computeSignedAreaParallel(whole, 4), SphericalUtil::computeSignedArea(whole));
+
+    EXPECT_EQ(SphericalUtil::computeSignedAreaParallel(std::vector<LatLng>(2, LatLng(0, 0)), 4), 0);
+}
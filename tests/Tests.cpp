@@ -8,11 +8,67 @@
 #include "SphericalUtil/computeHeading.hpp"
 #include "SphericalUtil/computeOffsetOrigin.hpp"
 #include "SphericalUtil/computeDistanceBetween.hpp"
+#include "SphericalUtil/parallel.hpp"
+#include "SphericalUtil/computeOffsets.hpp"
 
 #include "PolyUtil/containsLocation.hpp"
+#include "PolyUtil/containsLocationBatch.hpp"
 #include "PolyUtil/isLocationOnEdge.hpp"
 #include "PolyUtil/isLocationOnPath.hpp"
+#include "PolyUtil/locationIndexOnEdgeOrPath.hpp"
 #include "PolyUtil/distanceToLine.hpp"
+#include "PolyUtil/encode.hpp"
+#include "PolyUtil/decode.hpp"
+#include "PolyUtil/simplify.hpp"
+
+#include "Policies/policies.hpp"
+
+#include "LatLngBounds/bounds.hpp"
+
+#include "EllipsoidalUtil/geodesics.hpp"
+
+#include "MeasuredPath/measure.hpp"
+
+#include "PolygonRaster/containsLocation.hpp"
+
+#include "PreparedPolygon/containsLocation.hpp"
+
+#include "PolygonIndex/findAll.hpp"
+
+#include "GeofenceRegistry/registry.hpp"
+
+#include "PolygonStore/store.hpp"
+
+#include "GeometryDecoder/geojson.hpp"
+#include "GeometryDecoder/wkb.hpp"
+
+#include "PreparedPath/locationIndexOnEdgeOrPath.hpp"
+
+#include "SphericalBatch/computeDistances.hpp"
+#include "SphericalBatch/computeDistanceMatrix.hpp"
+
+#include "LatLngArray/caches.hpp"
+#include "LatLngArray/templates.hpp"
+
+#include "VecMath/trigonometric.hpp"
+#include "VecMath/inverse.hpp"
+#include "VecMath/exponential.hpp"
+
+#include "VectorUtil/computeAngleBetween.hpp"
+#include "VectorUtil/computeHeading.hpp"
+#include "VectorUtil/computeCrossTrackDistance.hpp"
+#include "VectorUtil/interpolate.hpp"
+#include "VectorUtil/locationIndexOnPath.hpp"
+#include "VectorUtil/intersects.hpp"
+
+#include "EncodedPolyline/read.hpp"
+#include "EncodedPolyline/iterate.hpp"
+
+#include "E7Path/iterate.hpp"
+
+#include "Accumulators/accumulators.hpp"
+
+#include "Instrumentation/disabled.hpp"
 
 
 int main(int argc, char** argv) {
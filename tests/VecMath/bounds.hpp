@@ -0,0 +1,58 @@
+#ifndef GEOMETRY_LIBRARY_TESTS_VEC_MATH_BOUNDS
+#define GEOMETRY_LIBRARY_TESTS_VEC_MATH_BOUNDS
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include "VecMath.hpp"
+
+
+template <typename T>
+static void expectSameValue(T actual, T expected, size_t i) {
+    if (std::isnan(expected)) {
+        EXPECT_TRUE(std::isnan(actual)) << i;
+    } else {
+        EXPECT_EQ(actual, expected) << i;
+        EXPECT_EQ(std::signbit(actual), std::signbit(expected)) << i;
+    }
+}
+
+template <typename T>
+static void expectWithinVecMathBound(T actual, T expected, size_t i) {
+    if (std::isnan(expected) || std::isinf(expected) || expected == 0) {
+        expectSameValue(actual, expected, i);
+        return;
+    }
+    double maxUlp = sizeof(T) == sizeof(double) ? VecMath::MAX_ULP : VecMath::MAX_ULP_FLOAT;
+    T magnitude = std::fabs(expected);
+    T ulp = std::nextafter(magnitude, std::numeric_limits<T>::infinity()) - magnitude;
+    EXPECT_LE(std::fabs(actual - expected), maxUlp * ulp) << i << ": " << expected;
+}
+
+/**
+ * Runs compute(out, accuracy) at every Simd level in both accuracies and compares
+ * out[i] with expected(i): exactly in STRICT mode or on the scalar path, within
+ * VecMath::MAX_ULP otherwise.
+ */
+template <typename T, typename Compute, typename Expected>
+static void expectVecMath(size_t n, Compute compute, Expected expected) {
+    std::vector<T> out(n);
+    for (int level = Simd::detectedLevel(); level >= Simd::SCALAR; --level) {
+        Simd::setMaxLevel(static_cast<Simd::Level>(level));
+        for (auto accuracy : { VecMath::STRICT, VecMath::FAST }) {
+            compute(out.data(), accuracy);
+            for (size_t i = 0; i < n; ++i) {
+                if (accuracy == VecMath::STRICT || level == Simd::SCALAR) {
+                    expectSameValue<T>(out[i], expected(i), i);
+                } else {
+                    expectWithinVecMathBound<T>(out[i], expected(i), i);
+                }
+            }
+        }
+    }
+    Simd::setMaxLevel(Simd::AVX512);
+}
+
+#endif // GEOMETRY_LIBRARY_TESTS_VEC_MATH_BOUNDS
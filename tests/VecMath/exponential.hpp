@@ -0,0 +1,40 @@
+#include <gtest/gtest.h>
+#include <random>
+#include <vector>
+
+#include "VecMath.hpp"
+#include "bounds.hpp"
+
+
+template <typename T>
+static void expectExponential(double maxLog) {
+    const T inf = std::numeric_limits<T>::infinity();
+    const T nan = std::numeric_limits<T>::quiet_NaN();
+    std::mt19937 random(17);
+    std::uniform_real_distribution<double> unit(-1, 1);
+
+    std::vector<T> x = { 0, -T(0), std::numeric_limits<T>::denorm_min(), std::numeric_limits<T>::min(),
+                         std::numeric_limits<T>::max(), 1, T(0.5), T(M_SQRT1_2), T(M_SQRT2), -1, inf, -inf, nan };
+    for (int i = 0; i < 30001; ++i) {
+        // Log-uniform over the whole range, subnormals included.
+        x.push_back(static_cast<T>(std::exp(unit(random) * (maxLog + 30))));
+    }
+    expectVecMath<T>(x.size(),
+        [&](T* out, VecMath::Accuracy accuracy) { VecMath::log(x.data(), out, x.size(), accuracy); },
+        [&](size_t i) { return std::log(x[i]); });
+
+    // Results below the normal range are exact zeros but may be off as subnormals; skip those.
+    x = { 0, -T(0), std::numeric_limits<T>::denorm_min(), 1, -1, T(0.5), T(-0.5), T(maxLog), T(maxLog + 1),
+          T(-maxLog - 50), T(1e30), T(-1e30), inf, -inf, nan };
+    for (int i = 0; i < 30001; ++i) {
+        x.push_back(static_cast<T>(unit(random) * (i % 2 == 0 ? maxLog : 1)));
+    }
+    expectVecMath<T>(x.size(),
+        [&](T* out, VecMath::Accuracy accuracy) { VecMath::exp(x.data(), out, x.size(), accuracy); },
+        [&](size_t i) { return std::exp(x[i]); });
+}
+
+TEST(VecMath, exponential) {
+    expectExponential<double>(std::log(std::numeric_limits<double>::max()) - 1);
+    expectExponential<float>(std::log(std::numeric_limits<float>::max()) - 1);
+}
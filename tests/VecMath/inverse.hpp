@@ -0,0 +1,47 @@
+#include <gtest/gtest.h>
+#include <random>
+#include <vector>
+
+#include "VecMath.hpp"
+#include "bounds.hpp"
+
+
+template <typename T>
+static void expectInverse() {
+    const T inf = std::numeric_limits<T>::infinity();
+    const T nan = std::numeric_limits<T>::quiet_NaN();
+    std::mt19937 random(13);
+    std::uniform_real_distribution<double> unit(-1, 1);
+
+    std::vector<T> x = { 0, -T(0), std::numeric_limits<T>::denorm_min(), T(0.5), T(0.625), T(-0.625),
+                         1, -1, T(1.5), inf, nan };
+    for (int i = 0; i < 30001; ++i) {
+        x.push_back(static_cast<T>(unit(random) * (i % 2 == 0 ? 1 : 1e-3)));
+    }
+    expectVecMath<T>(x.size(),
+        [&](T* out, VecMath::Accuracy accuracy) { VecMath::asin(x.data(), out, x.size(), accuracy); },
+        [&](size_t i) { return std::asin(x[i]); });
+
+    // Every quadrant and both axes, with signed zeros and infinities.
+    std::vector<T> special = { 0, -T(0), 1, -1, T(1e-30), inf, -inf, nan };
+    std::vector<T> y;
+    x.clear();
+    for (T a : special) {
+        for (T b : special) {
+            y.push_back(a);
+            x.push_back(b);
+        }
+    }
+    for (int i = 0; i < 30001; ++i) {
+        y.push_back(static_cast<T>(unit(random) * std::exp(10 * unit(random))));
+        x.push_back(static_cast<T>(unit(random) * std::exp(10 * unit(random))));
+    }
+    expectVecMath<T>(x.size(),
+        [&](T* out, VecMath::Accuracy accuracy) { VecMath::atan2(y.data(), x.data(), out, x.size(), accuracy); },
+        [&](size_t i) { return std::atan2(y[i], x[i]); });
+}
+
+TEST(VecMath, inverse) {
+    expectInverse<double>();
+    expectInverse<float>();
+}
@@ -0,0 +1,71 @@
+#include <gtest/gtest.h>
+#include <random>
+#include <vector>
+
+#include "VecMath.hpp"
+#include "bounds.hpp"
+
+
+/**
+ * Angles over the fast range and beyond, special values first; an odd count
+ * leaves a partial last vector.
+ */
+template <typename T>
+static std::vector<T> trigonometricArguments(T limit) {
+    const T inf = std::numeric_limits<T>::infinity();
+    std::vector<T> x = {
+        0, -T(0), std::numeric_limits<T>::denorm_min(), -std::numeric_limits<T>::min(), T(1e-20),
+        T(M_PI / 4), T(M_PI / 2), T(M_PI), T(-M_PI), T(3 * M_PI / 2), T(100 * M_PI),
+        limit, -limit, limit * 2, T(1e30), inf, -inf, std::numeric_limits<T>::quiet_NaN(),
+    };
+    std::mt19937 random(11);
+    std::uniform_real_distribution<double> unit(-1, 1);
+    for (int i = 0; i < 30001; ++i) {
+        double scale = i % 3 == 0 ? 4 : i % 3 == 1 ? 100 : static_cast<double>(limit);
+        x.push_back(static_cast<T>(unit(random) * scale));
+    }
+    return x;
+}
+
+template <typename T>
+static void expectTrigonometric(T limit) {
+    std::vector<T> x = trigonometricArguments<T>(limit);
+    expectVecMath<T>(x.size(),
+        [&](T* out, VecMath::Accuracy accuracy) { VecMath::sin(x.data(), out, x.size(), accuracy); },
+        [&](size_t i) { return std::sin(x[i]); });
+    expectVecMath<T>(x.size(),
+        [&](T* out, VecMath::Accuracy accuracy) { VecMath::cos(x.data(), out, x.size(), accuracy); },
+        [&](size_t i) { return std::cos(x[i]); });
+    expectVecMath<T>(x.size(),
+        [&](T* out, VecMath::Accuracy accuracy) { VecMath::tan(x.data(), out, x.size(), accuracy); },
+        [&](size_t i) { return std::tan(x[i]); });
+
+    // sincos() gives the same values as sin() and cos().
+    std::vector<T> s(x.size());
+    std::vector<T> c(x.size());
+    std::vector<T> expected(x.size());
+    for (auto accuracy : { VecMath::STRICT, VecMath::FAST }) {
+        VecMath::sincos(x.data(), s.data(), c.data(), x.size(), accuracy);
+        VecMath::sin(x.data(), expected.data(), x.size(), accuracy);
+        for (size_t i = 0; i < x.size(); ++i) {
+            expectSameValue(s[i], expected[i], i);
+        }
+        VecMath::cos(x.data(), expected.data(), x.size(), accuracy);
+        for (size_t i = 0; i < x.size(); ++i) {
+            expectSameValue(c[i], expected[i], i);
+        }
+    }
+
+    // In place.
+    std::vector<T> inPlace = x;
+    VecMath::sin(inPlace.data(), inPlace.data(), inPlace.size());
+    VecMath::sin(x.data(), expected.data(), x.size());
+    for (size_t i = 0; i < x.size(); ++i) {
+        expectSameValue(inPlace[i], expected[i], i);
+    }
+}
+
+TEST(VecMath, trigonometric) {
+    expectTrigonometric<double>(static_cast<double>(VecMath::MAX_REDUCED));
+    expectTrigonometric<float>(static_cast<float>(VecMath::MAX_REDUCED_FLOAT));
+}
@@ -0,0 +1,49 @@
+#include <gtest/gtest.h>
+#include <random>
+#include <vector>
+
+#include "SphericalUtil.hpp"
+#include "LatLngArray.hpp"
+#include "UnitVec3.hpp"
+#include "VectorUtil.hpp"
+
+
+TEST(VectorUtil, computeAngleBetween) {
+    UnitVec3 up(LatLng(90, 0));
+    UnitVec3 down(LatLng(-90, 0));
+    UnitVec3 front(LatLng(0, 0));
+    UnitVec3 right(LatLng(0, 90));
+
+    EXPECT_NEAR(VectorUtil::computeAngleBetween(up, up), 0, 1e-12);
+    EXPECT_NEAR(VectorUtil::computeAngleBetween(up, down), M_PI, 1e-12);
+    EXPECT_NEAR(VectorUtil::computeAngleBetween(front, right), M_PI / 2, 1e-12);
+    EXPECT_NEAR(VectorUtil::havDistance(up, down), 1, 1e-12);
+
+    std::mt19937 random(10);
+    std::uniform_real_distribution<double> unit(0, 1);
+    for (int i = 0; i < 10000; ++i) {
+        LatLng from(unit(random) * 180 - 90, unit(random) * 360 - 180);
+        double scale = std::pow(10.0, -8 * unit(random));
+        LatLng to(MathUtil::clamp(from.lat + scale * (unit(random) * 180 - 90), -90, 90), from.lng + scale * (unit(random) * 360 - 180));
+        double angle = SphericalUtil::computeAngleBetween(from, to);
+        UnitVec3 a(from);
+        UnitVec3 b(to);
+        EXPECT_NEAR(VectorUtil::computeAngleBetween(a, b), angle, 1e-12 + angle * 1e-12);
+        EXPECT_NEAR(VectorUtil::computeDistanceBetween(a, b), SphericalUtil::computeDistanceBetween(from, to), 1e-5);
+        EXPECT_NEAR(VectorUtil::havDistance(a, b), MathUtil::hav(angle), 1e-15);
+
+        // Back to a location.
+        LatLng back = a.toLatLng();
+        EXPECT_NEAR(back.lat, from.lat, 1e-9);
+        EXPECT_NEAR(MathUtil::wrap(back.lng - from.lng, -180, 180), 0, 1e-9);
+    }
+
+    // The unit vectors of a LatLngArray, cached or not.
+    std::vector<LatLng> points = { {90, 0}, {0, 180}, {-45.5, 179.9}, {12.5, 30.25} };
+    LatLngArray plain(points);
+    LatLngArray cached(points, LatLngArray::UNIT_VECTORS);
+    for (size_t i = 0; i < points.size(); ++i) {
+        EXPECT_EQ(plain.unitVector(i), UnitVec3(points[i]));
+        EXPECT_EQ(cached.unitVector(i), UnitVec3(points[i]));
+    }
+}
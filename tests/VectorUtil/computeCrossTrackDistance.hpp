@@ -0,0 +1,37 @@
+#include <gtest/gtest.h>
+#include <random>
+
+#include "SphericalUtil.hpp"
+#include "UnitVec3.hpp"
+#include "VectorUtil.hpp"
+
+
+TEST(VectorUtil, computeCrossTrackDistance) {
+    UnitVec3 front(LatLng(0, 0));
+    UnitVec3 right(LatLng(0, 90));
+    double quarter = M_PI / 2 * MathUtil::EARTH_RADIUS;
+
+    // Along the equator, eastward: north is on the left.
+    EXPECT_NEAR(VectorUtil::computeCrossTrackDistance(UnitVec3(LatLng(90, 0)), front, right),   quarter, 1e-6);
+    EXPECT_NEAR(VectorUtil::computeCrossTrackDistance(UnitVec3(LatLng(-90, 0)), front, right), -quarter, 1e-6);
+    EXPECT_NEAR(VectorUtil::computeCrossTrackDistance(UnitVec3(LatLng(0, -135)), front, right), 0, 1e-6);
+    EXPECT_NEAR(VectorUtil::computeCrossTrackDistance(UnitVec3(LatLng(1, 45)), front, right),
+                SphericalUtil::computeDistanceBetween(LatLng(1, 45), LatLng(0, 45)), 1e-6);
+
+    // No great circle.
+    EXPECT_EQ(VectorUtil::computeCrossTrackDistance(right, front, front), 0);
+
+    // Against the spherical trigonometry formula.
+    std::mt19937 random(12);
+    std::uniform_real_distribution<double> unit(0, 1);
+    for (int i = 0; i < 10000; ++i) {
+        LatLng from(unit(random) * 178 - 89, unit(random) * 360 - 180);
+        LatLng to(unit(random) * 180 - 90, unit(random) * 360 - 180);
+        LatLng point(unit(random) * 180 - 90, unit(random) * 360 - 180);
+        double angle13 = SphericalUtil::computeAngleBetween(from, point);
+        double bearing = deg2rad(SphericalUtil::computeHeading(from, point) - SphericalUtil::computeHeading(from, to));
+        double expected = -asin(sin(angle13) * sin(bearing)) * MathUtil::EARTH_RADIUS;
+        double actual = VectorUtil::computeCrossTrackDistance(UnitVec3(point), UnitVec3(from), UnitVec3(to));
+        EXPECT_NEAR(actual, expected, 1e-3);
+    }
+}
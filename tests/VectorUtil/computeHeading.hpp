@@ -0,0 +1,42 @@
+#include <gtest/gtest.h>
+#include <random>
+
+#include "SphericalUtil.hpp"
+#include "UnitVec3.hpp"
+#include "VectorUtil.hpp"
+
+
+TEST(VectorUtil, computeHeading) {
+    UnitVec3 up(LatLng(90, 0));
+    UnitVec3 down(LatLng(-90, 0));
+    UnitVec3 front(LatLng(0, 0));
+    UnitVec3 right(LatLng(0, 90));
+    UnitVec3 back(LatLng(0, -180));
+    UnitVec3 left(LatLng(0, -90));
+
+    EXPECT_NEAR(VectorUtil::computeHeading(front, up), 0, 1e-6);
+    EXPECT_NEAR(VectorUtil::computeHeading(right, up), 0, 1e-6);
+    EXPECT_NEAR(VectorUtil::computeHeading(back, up),  0, 1e-6);
+
+    EXPECT_NEAR(VectorUtil::computeHeading(front, down), -180, 1e-6);
+    EXPECT_NEAR(VectorUtil::computeHeading(right, down), -180, 1e-6);
+    EXPECT_NEAR(VectorUtil::computeHeading(left, down),  -180, 1e-6);
+
+    EXPECT_NEAR(VectorUtil::computeHeading(right, front), -90, 1e-6);
+    EXPECT_NEAR(VectorUtil::computeHeading(left, front),   90, 1e-6);
+    EXPECT_NEAR(VectorUtil::computeHeading(front, right),  90, 1e-6);
+    EXPECT_NEAR(VectorUtil::computeHeading(back, right),  -90, 1e-6);
+
+    // From a pole converted from a location.
+    EXPECT_NEAR(VectorUtil::computeHeading(up, front), -180, 1e-6);
+
+    std::mt19937 random(11);
+    std::uniform_real_distribution<double> unit(0, 1);
+    for (int i = 0; i < 10000; ++i) {
+        LatLng from(unit(random) * 178 - 89, unit(random) * 360 - 180);
+        LatLng to(unit(random) * 180 - 90, unit(random) * 360 - 180);
+        double expected = SphericalUtil::computeHeading(from, to);
+        double actual = VectorUtil::computeHeading(UnitVec3(from), UnitVec3(to));
+        EXPECT_NEAR(MathUtil::wrap(actual - expected, -180, 180), 0, 1e-8);
+    }
+}
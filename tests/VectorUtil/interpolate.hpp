@@ -0,0 +1,31 @@
+#include <gtest/gtest.h>
+#include <random>
+
+#include "SphericalUtil.hpp"
+#include "UnitVec3.hpp"
+#include "VectorUtil.hpp"
+
+
+TEST(VectorUtil, interpolate) {
+    UnitVec3 up(LatLng(90, 0));
+    UnitVec3 front(LatLng(0, 0));
+
+    // Same point.
+    EXPECT_EQ(VectorUtil::interpolate(up, up, 0.5), up);
+    // Ends and middle.
+    EXPECT_NEAR(VectorUtil::computeAngleBetween(VectorUtil::interpolate(front, up, 0), front), 0, 1e-12);
+    EXPECT_NEAR(VectorUtil::computeAngleBetween(VectorUtil::interpolate(front, up, 1), up), 0, 1e-12);
+    EXPECT_NEAR(VectorUtil::interpolate(front, up, 0.5).toLatLng().lat, 45, 1e-12);
+
+    std::mt19937 random(13);
+    std::uniform_real_distribution<double> unit(0, 1);
+    for (int i = 0; i < 10000; ++i) {
+        LatLng from(unit(random) * 180 - 90, unit(random) * 360 - 180);
+        LatLng to(unit(random) * 180 - 90, unit(random) * 360 - 180);
+        double fraction = unit(random) * 1.5 - 0.25;
+        UnitVec3 expected(SphericalUtil::interpolate(from, to, fraction));
+        UnitVec3 actual = VectorUtil::interpolate(UnitVec3(from), UnitVec3(to), fraction);
+        EXPECT_NEAR(actual.norm2(), 1, 1e-12);
+        EXPECT_NEAR(VectorUtil::computeAngleBetween(actual, expected), 0, 1e-9);
+    }
+}
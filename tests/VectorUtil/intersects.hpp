@@ -0,0 +1,31 @@
+#include <gtest/gtest.h>
+
+#include "UnitVec3.hpp"
+#include "VectorUtil.hpp"
+
+
+static bool intersects(LatLng a1, LatLng a2, LatLng b1, LatLng b2) {
+    return VectorUtil::intersects(UnitVec3(a1), UnitVec3(a2), UnitVec3(b1), UnitVec3(b2));
+}
+
+TEST(VectorUtil, intersects) {
+    // Crossing.
+    EXPECT_TRUE(intersects({0, 0}, {0, 10}, {-5, 5}, {5, 5}));
+    EXPECT_TRUE(intersects({0, 0}, {0, 10}, {5, 5}, {-5, 5}));
+    EXPECT_TRUE(intersects({10, 170}, {10, -170}, {0, 180}, {20, 180}));
+    EXPECT_TRUE(intersects({80, 0}, {80, 180}, {80, 90}, {80, -90}));
+
+    // Touching.
+    EXPECT_TRUE(intersects({0, 0}, {0, 10}, {0, 5}, {5, 5}));
+    EXPECT_TRUE(intersects({0, 0}, {0, 10}, {0, 10}, {5, 15}));
+
+    // Apart.
+    EXPECT_FALSE(intersects({0, 0}, {0, 10}, {1, 5}, {5, 5}));
+    EXPECT_FALSE(intersects({0, 0}, {0, 10}, {-5, 15}, {5, 15}));
+    // The great circles cross at the antipode of the segments' crossing.
+    EXPECT_FALSE(intersects({0, 0}, {0, 10}, {-5, -175}, {5, -175}));
+
+    // On one great circle, and degenerate.
+    EXPECT_FALSE(intersects({0, 0}, {0, 10}, {0, 5}, {0, 15}));
+    EXPECT_FALSE(intersects({0, 0}, {0, 0}, {-5, 0}, {5, 0}));
+}
@@ -0,0 +1,52 @@
+#include <gtest/gtest.h>
+#include <random>
+#include <vector>
+
+#include "PolyUtil.hpp"
+#include "SphericalUtil.hpp"
+#include "UnitVec3.hpp"
+#include "VectorUtil.hpp"
+
+
+TEST(VectorUtil, locationIndexOnPath) {
+    // On equator, as in PolyUtil.isLocationOnPath.
+    UnitVec3 from(LatLng(0, 90));
+    UnitVec3 to(LatLng(0, 180));
+    double small = 5e-7; // Half the default tolerance.
+    double big   = 2e-6; // Double the default tolerance.
+    EXPECT_TRUE(VectorUtil::isLocationOnSegment(UnitVec3(LatLng(0, 90 - small)), from, to));
+    EXPECT_FALSE(VectorUtil::isLocationOnSegment(UnitVec3(LatLng(0, 90 - big)), from, to));
+    EXPECT_TRUE(VectorUtil::isLocationOnSegment(UnitVec3(LatLng(small, 135)), from, to));
+    EXPECT_FALSE(VectorUtil::isLocationOnSegment(UnitVec3(LatLng(big, 135)), from, to));
+    EXPECT_FALSE(VectorUtil::isLocationOnSegment(UnitVec3(LatLng(0, -90)), from, to));
+    EXPECT_TRUE(VectorUtil::isLocationOnSegment(UnitVec3(LatLng(0, 90)), from, from));
+
+    // Empty.
+    std::vector<UnitVec3> path;
+    EXPECT_EQ(VectorUtil::locationIndexOnPath(from, path), -1);
+
+    // A route with points around it, against PolyUtil; points right at the tolerance are skipped.
+    std::mt19937 random(14);
+    std::normal_distribution<double> turn(0, 20);
+    std::uniform_real_distribution<double> unit(0, 1);
+    std::vector<LatLng> route;
+    LatLng point(55.75, 37.61);
+    double heading = 0;
+    for (int i = 0; i < 500; ++i) {
+        heading += turn(random);
+        point = SphericalUtil::computeOffset(point, 30 + 100 * unit(random), heading);
+        route.push_back(point);
+        path.push_back(UnitVec3(point));
+    }
+    double tolerance = 10;
+    for (int i = 0; i < 2000; ++i) {
+        const LatLng& near = route[random() % route.size()];
+        LatLng location = SphericalUtil::computeOffset(near, 30 * unit(random), 360 * unit(random));
+        int expected = PolyUtil::locationIndexOnPath(location, route, tolerance);
+        if (expected != PolyUtil::locationIndexOnPath(location, route, tolerance * (1 - 1e-6)) ||
+            expected != PolyUtil::locationIndexOnPath(location, route, tolerance * (1 + 1e-6))) {
+            continue;
+        }
+        EXPECT_EQ(VectorUtil::locationIndexOnPath(UnitVec3(location), path, tolerance), expected);
+    }
+}